@@ -19,32 +19,100 @@
 
 #include "message.h"
 
+#if defined(_MSC_VER)
+#define OGS_ASN_THREAD_LOCAL __declspec(thread)
+#else
+#define OGS_ASN_THREAD_LOCAL __thread
+#endif
+
+/*
+ * PDUs are encoded here and then copied into a pkbuf of their own size
+ * instead of trimming a zeroed OGS_MAX_SDU_LEN pkbuf.
+ */
+static OGS_ASN_THREAD_LOCAL uint8_t encode_buffer[OGS_MAX_SDU_LEN];
+
+#if OGS_USE_TALLOC == 1
+/*
+ * Decoded trees are allocated from a per-message arena which is released
+ * at once by ogs_asn_free_decoded() instead of walking the tree.
+ *
+ * The arena is looked up by the structure passed to ogs_asn_decode().
+ * Only ogs_asn_free_decoded() does so : a PDU being built is freed by
+ * ogs_asn_free() and never mistaken for a decoded one.
+ *
+ * A handler may decode a container (e.g. an N2 SM transfer) while its
+ * NGAP message is still alive, hence a few slots per thread.
+ * Running out of them means a decoded message was not freed.
+ */
+#define OGS_ASN_MAX_DECODE_ARENA    8
+#define OGS_ASN_DECODE_POOL_SIZE    8192
+
+typedef struct ogs_asn_decode_arena_s {
+    void *struct_ptr;
+    size_t struct_size;
+    ogs_mem_arena_t *arena;
+} ogs_asn_decode_arena_t;
+
+static OGS_ASN_THREAD_LOCAL
+    ogs_asn_decode_arena_t decode_arena[OGS_ASN_MAX_DECODE_ARENA];
+
+static ogs_asn_decode_arena_t *decode_arena_find(void *struct_ptr)
+{
+    int i;
+
+    for (i = 0; i < OGS_ASN_MAX_DECODE_ARENA; i++) {
+        if (decode_arena[i].struct_ptr == struct_ptr)
+            return &decode_arena[i];
+    }
+
+    return NULL;
+}
+
+static void decode_arena_release(ogs_asn_decode_arena_t *slot)
+{
+    ogs_assert(slot);
+    ogs_assert(slot->arena);
+
+    memset(slot->struct_ptr, 0, slot->struct_size);
+    ogs_mem_arena_destroy(slot->arena);
+    memset(slot, 0, sizeof(*slot));
+}
+#endif
+
 ogs_pkbuf_t *ogs_asn_encode(const asn_TYPE_descriptor_t *td, void *sptr)
+{
+    return ogs_asn_encode_adopted(td, sptr, NULL);
+}
+
+ogs_pkbuf_t *ogs_asn_encode_adopted(const asn_TYPE_descriptor_t *td,
+        void *sptr, ogs_asn_adopted_t *adopted)
 {
     asn_enc_rval_t enc_ret = {0};
     ogs_pkbuf_t *pkbuf = NULL;
+    size_t len;
 
     ogs_assert(td);
     ogs_assert(sptr);
 
-    pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
-    if (!pkbuf) {
-        ogs_error("ogs_pkbuf_alloc() failed");
-        return NULL;
-    }
-    ogs_pkbuf_put(pkbuf, OGS_MAX_SDU_LEN);
-
     enc_ret = aper_encode_to_buffer(td, NULL,
-                    sptr, pkbuf->data, OGS_MAX_SDU_LEN);
+                    sptr, encode_buffer, sizeof(encode_buffer));
+    if (adopted)
+        ogs_asn_adopted_release(adopted);
     ogs_asn_free(td, sptr);
 
     if (enc_ret.encoded < 0) {
         ogs_error("Failed to encode ASN-PDU [%d]", (int)enc_ret.encoded);
-        ogs_pkbuf_free(pkbuf);
         return NULL;
     }
 
-    ogs_pkbuf_trim(pkbuf, ((enc_ret.encoded + 7) >> 3));
+    len = (enc_ret.encoded + 7) >> 3;
+
+    pkbuf = ogs_pkbuf_alloc(NULL, len);
+    if (!pkbuf) {
+        ogs_error("ogs_pkbuf_alloc() failed");
+        return NULL;
+    }
+    ogs_pkbuf_put_data(pkbuf, encode_buffer, len);
 
     return pkbuf;
 }
@@ -53,6 +121,10 @@ int ogs_asn_decode(const asn_TYPE_descriptor_t *td,
         void *struct_ptr, size_t struct_size, ogs_pkbuf_t *pkbuf)
 {
     asn_dec_rval_t dec_ret = {0};
+#if OGS_USE_TALLOC == 1
+    ogs_asn_decode_arena_t *slot = NULL;
+    ogs_mem_arena_t *prev = NULL;
+#endif
 
     ogs_assert(td);
     ogs_assert(struct_ptr);
@@ -61,13 +133,44 @@ int ogs_asn_decode(const asn_TYPE_descriptor_t *td,
     ogs_assert(pkbuf->data);
     ogs_assert(pkbuf->len);
 
+#if OGS_USE_TALLOC == 1
+    /* The previous tree in this structure was never freed */
+    slot = decode_arena_find(struct_ptr);
+    if (slot)
+        decode_arena_release(slot);
+    else
+        slot = decode_arena_find(NULL);
+
+    if (slot) {
+        slot->arena = ogs_mem_arena_create_pool(
+                "asn", OGS_ASN_DECODE_POOL_SIZE);
+        ogs_assert(slot->arena);
+        slot->struct_ptr = struct_ptr;
+        slot->struct_size = struct_size;
+
+        prev = ogs_mem_arena_switch(slot->arena);
+    } else {
+        ogs_error("All %d decode arenas in use : "
+                "ogs_asn_free_decoded() missing?", OGS_ASN_MAX_DECODE_ARENA);
+    }
+#endif
+
     memset(struct_ptr, 0, struct_size);
     dec_ret = aper_decode(NULL, td, (void **)&struct_ptr,
             pkbuf->data, pkbuf->len, 0, 0);
 
+#if OGS_USE_TALLOC == 1
+    if (slot)
+        ogs_mem_arena_switch(prev);
+#endif
+
     if (dec_ret.code != RC_OK) {
         ogs_warn("Failed to decode ASN-PDU [code:%d,consumed:%d]",
                 dec_ret.code, (int)dec_ret.consumed);
+#if OGS_USE_TALLOC == 1
+        if (slot)
+            decode_arena_release(slot);
+#endif
         return OGS_ERROR;
     }
 
@@ -81,3 +184,186 @@ void ogs_asn_free(const asn_TYPE_descriptor_t *td, void *sptr)
 
     ASN_STRUCT_FREE_CONTENTS_ONLY(*td, sptr);
 }
+
+void ogs_asn_free_decoded(const asn_TYPE_descriptor_t *td, void *sptr)
+{
+#if OGS_USE_TALLOC == 1
+    ogs_asn_decode_arena_t *slot = NULL;
+#endif
+
+    ogs_assert(td);
+    ogs_assert(sptr);
+
+#if OGS_USE_TALLOC == 1
+    slot = decode_arena_find(sptr);
+    if (slot) {
+        decode_arena_release(slot);
+        return;
+    }
+#endif
+
+    /* Decoded without an arena, e.g. all of them were in use */
+    ASN_STRUCT_FREE_CONTENTS_ONLY(*td, sptr);
+}
+
+void ogs_asn_pkbuf_to_OCTET_STRING(ogs_asn_adopted_t *adopted,
+        ogs_pkbuf_t *pkbuf, OCTET_STRING_t *octet_string)
+{
+    ogs_assert(adopted);
+    ogs_assert(pkbuf);
+    ogs_assert(octet_string);
+
+    if (adopted->num < OGS_ASN_MAX_ADOPTED_PKBUF) {
+        adopted->item[adopted->num].octet_string = octet_string;
+        adopted->item[adopted->num].pkbuf = pkbuf;
+        adopted->num++;
+
+        octet_string->buf = pkbuf->data;
+        octet_string->size = pkbuf->len;
+        return;
+    }
+
+    /* No room left : copy it */
+    octet_string->size = pkbuf->len;
+    octet_string->buf = CALLOC(octet_string->size, sizeof(uint8_t));
+    ogs_assert(octet_string->buf);
+    memcpy(octet_string->buf, pkbuf->data, octet_string->size);
+    ogs_pkbuf_free(pkbuf);
+}
+
+void ogs_asn_adopted_release(ogs_asn_adopted_t *adopted)
+{
+    int i;
+
+    ogs_assert(adopted);
+
+    for (i = 0; i < adopted->num; i++) {
+        /* Keep ASN_STRUCT_FREE() away from the pkbuf data */
+        adopted->item[i].octet_string->buf = NULL;
+        adopted->item[i].octet_string->size = 0;
+
+        ogs_pkbuf_free(adopted->item[i].pkbuf);
+    }
+
+    memset(adopted, 0, sizeof(*adopted));
+}
+
+/*
+ * Takes the ownership of 'pkbuf' : the PDU encoded with every field
+ * set to zero.
+ */
+int ogs_asn_template_init(ogs_asn_template_t *tmpl, ogs_pkbuf_t *pkbuf)
+{
+    ogs_assert(tmpl);
+
+    memset(tmpl, 0, sizeof(*tmpl));
+
+    if (!pkbuf) {
+        ogs_error("No template");
+        return OGS_ERROR;
+    }
+
+    tmpl->pkbuf = pkbuf;
+
+    return OGS_OK;
+}
+
+/*
+ * Takes the ownership of 'ones' : the PDU encoded with the next field set
+ * to all ones. Fails unless exactly 'num_of_bit' bits differ from
+ * the template, e.g. if the field changed the length of the PDU.
+ */
+int ogs_asn_template_add_field(
+        ogs_asn_template_t *tmpl, ogs_pkbuf_t *ones, int num_of_bit)
+{
+    int i, n = 0;
+    uint8_t diff;
+
+    ogs_assert(tmpl);
+    ogs_assert(tmpl->pkbuf);
+    ogs_assert(num_of_bit > 0 && num_of_bit <= OGS_ASN_MAX_TEMPLATE_FIELD_BITS);
+
+    if (!ones) {
+        ogs_error("No field");
+        return OGS_ERROR;
+    }
+
+    if (tmpl->num_of_field >= OGS_ASN_MAX_TEMPLATE_FIELD ||
+        ones->len != tmpl->pkbuf->len) {
+        ogs_error("Invalid field [%d:%d:%d]",
+                tmpl->num_of_field, ones->len, tmpl->pkbuf->len);
+        ogs_pkbuf_free(ones);
+        return OGS_ERROR;
+    }
+
+    for (i = 0; i < ones->len; i++) {
+        diff = ones->data[i] ^ tmpl->pkbuf->data[i];
+        while (diff) {
+            /* Most significant bit first */
+            int bit = 7 - (31 - __builtin_clz(diff));
+
+            if (n == num_of_bit) {
+                n++;
+                break;
+            }
+            tmpl->field[tmpl->num_of_field].bit[n++] = i * 8 + bit;
+            diff &= ~(0x80 >> bit);
+        }
+        if (n > num_of_bit)
+            break;
+    }
+
+    ogs_pkbuf_free(ones);
+
+    if (n != num_of_bit) {
+        ogs_error("Field is not patchable [%d:%d]", n, num_of_bit);
+        return OGS_ERROR;
+    }
+
+    tmpl->field[tmpl->num_of_field].num_of_bit = num_of_bit;
+    tmpl->num_of_field++;
+
+    return OGS_OK;
+}
+
+/* value[i] is written into the i-th field added to the template */
+ogs_pkbuf_t *ogs_asn_template_build(
+        ogs_asn_template_t *tmpl, const uint64_t *value)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+    int i, j;
+
+    ogs_assert(tmpl);
+    ogs_assert(tmpl->pkbuf);
+    ogs_assert(value);
+
+    pkbuf = ogs_pkbuf_alloc(NULL, tmpl->pkbuf->len);
+    if (!pkbuf) {
+        ogs_error("ogs_pkbuf_alloc() failed");
+        return NULL;
+    }
+    ogs_pkbuf_put_data(pkbuf, tmpl->pkbuf->data, tmpl->pkbuf->len);
+
+    for (i = 0; i < tmpl->num_of_field; i++) {
+        int num_of_bit = tmpl->field[i].num_of_bit;
+
+        for (j = 0; j < num_of_bit; j++) {
+            uint16_t bit = tmpl->field[i].bit[j];
+
+            if ((value[i] >> (num_of_bit - 1 - j)) & 1)
+                pkbuf->data[bit >> 3] |= 0x80 >> (bit & 7);
+        }
+    }
+
+    return pkbuf;
+}
+
+void ogs_asn_template_final(ogs_asn_template_t *tmpl)
+{
+    ogs_assert(tmpl);
+
+    if (tmpl->pkbuf)
+        ogs_pkbuf_free(tmpl->pkbuf);
+
+    memset(tmpl, 0, sizeof(*tmpl));
+}
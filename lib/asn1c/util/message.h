@@ -24,15 +24,80 @@
 
 #include "asn_internal.h"
 #include "constr_TYPE.h"
+#include "OCTET_STRING.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 ogs_pkbuf_t *ogs_asn_encode(const asn_TYPE_descriptor_t *td, void *sptr);
+void ogs_asn_free(const asn_TYPE_descriptor_t *td, void *sptr);
+
+/*
+ * A structure filled by ogs_asn_decode() must be released by
+ * ogs_asn_free_decoded(), not by ogs_asn_free().
+ */
 int ogs_asn_decode(const asn_TYPE_descriptor_t *td,
         void *struct_ptr, size_t struct_size, ogs_pkbuf_t *pkbuf);
-void ogs_asn_free(const asn_TYPE_descriptor_t *td, void *sptr);
+void ogs_asn_free_decoded(const asn_TYPE_descriptor_t *td, void *sptr);
+
+/*
+ * pkbufs whose data an OCTET_STRING of a PDU being built points to,
+ * e.g. the NAS PDUs of a downlink NGAP message, instead of a copy.
+ *
+ * The builder keeps the list next to the PDU and hands it to
+ * ogs_asn_encode_adopted(), which releases the pkbufs once the PDU is
+ * encoded. A builder that gives up before encoding calls
+ * ogs_asn_adopted_release() before ogs_asn_free().
+ */
+#define OGS_ASN_MAX_ADOPTED_PKBUF   16
+
+typedef struct ogs_asn_adopted_s {
+    int num;
+    struct {
+        OCTET_STRING_t *octet_string;
+        ogs_pkbuf_t *pkbuf;
+    } item[OGS_ASN_MAX_ADOPTED_PKBUF];
+} ogs_asn_adopted_t;
+
+/* Takes the ownership of 'pkbuf'. It is copied if 'adopted' is full. */
+void ogs_asn_pkbuf_to_OCTET_STRING(ogs_asn_adopted_t *adopted,
+        ogs_pkbuf_t *pkbuf, OCTET_STRING_t *octet_string);
+void ogs_asn_adopted_release(ogs_asn_adopted_t *adopted);
+
+ogs_pkbuf_t *ogs_asn_encode_adopted(const asn_TYPE_descriptor_t *td,
+        void *sptr, ogs_asn_adopted_t *adopted);
+
+/*
+ * APER template
+ *
+ * A PDU encoded once whose fixed-size fields (e.g. the UE identity of
+ * a Paging) are patched for every message instead of encoding it again.
+ *
+ * The template is encoded with every field set to zero. The bit positions
+ * of a field are found by comparing it with the PDU encoded with only
+ * that field set to all ones, so that they can be located even when
+ * the field is not octet-aligned.
+ */
+#define OGS_ASN_MAX_TEMPLATE_FIELD          4
+#define OGS_ASN_MAX_TEMPLATE_FIELD_BITS     64
+
+typedef struct ogs_asn_template_s {
+    ogs_pkbuf_t *pkbuf;
+
+    int num_of_field;
+    struct {
+        int num_of_bit;
+        uint16_t bit[OGS_ASN_MAX_TEMPLATE_FIELD_BITS]; /* MSB first */
+    } field[OGS_ASN_MAX_TEMPLATE_FIELD];
+} ogs_asn_template_t;
+
+int ogs_asn_template_init(ogs_asn_template_t *tmpl, ogs_pkbuf_t *pkbuf);
+int ogs_asn_template_add_field(
+        ogs_asn_template_t *tmpl, ogs_pkbuf_t *ones, int num_of_bit);
+ogs_pkbuf_t *ogs_asn_template_build(
+        ogs_asn_template_t *tmpl, const uint64_t *value);
+void ogs_asn_template_final(ogs_asn_template_t *tmpl);
 
 #ifdef __cplusplus
 }
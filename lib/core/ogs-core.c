@@ -38,11 +38,13 @@ static ogs_core_context_t self = {
 
 void ogs_core_initialize(void)
 {
+    ogs_pool_stat_init();
     ogs_mem_init();
     ogs_log_init();
     ogs_pkbuf_init();
     ogs_socket_init();
     ogs_tlv_init();
+    ogs_tlv_msg_init();
 
     ogs_log_install_domain(&__ogs_mem_domain, "mem", ogs_core()->log.level);
     ogs_log_install_domain(&__ogs_sock_domain, "sock", ogs_core()->log.level);
@@ -54,11 +56,13 @@ void ogs_core_initialize(void)
 
 void ogs_core_terminate(void)
 {
+    ogs_tlv_msg_final();
     ogs_tlv_final();
     ogs_socket_final();
     ogs_pkbuf_final();
     ogs_log_final();
     ogs_mem_final();
+    ogs_pool_stat_final();
 }
 
 ogs_core_context_t *ogs_core(void)
@@ -217,6 +217,9 @@ static int epoll_process(ogs_pollset_t *pollset, ogs_time_t timeout)
             pollset->capacity,
             timeout == OGS_INFINITE_TIME ? OGS_INFINITE_TIME :
                 ogs_time_to_msec(timeout));
+
+    /* The coarse clock is read again on demand */
+    ogs_time_invalidate();
     if (num_of_poll < 0) {
         ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno, "epoll failed");
         return OGS_ERROR;
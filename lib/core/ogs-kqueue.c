@@ -206,6 +206,9 @@ static int kqueue_process(ogs_pollset_t *pollset, ogs_time_t timeout)
             context->change_list, context->nchanges,
             context->event_list, context->nevents, tp);
 
+    /* The coarse clock is read again on demand */
+    ogs_time_invalidate();
+
     context->nchanges = 0;
 
     if (n < 0) {
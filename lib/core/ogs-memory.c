@@ -26,46 +26,368 @@
  * Memory Pool - Use talloc library
  *****************************************/
 
+/*
+ * talloc is not thread-safe, so every allocation used to be serialized
+ * on a single global mutex. Instead, each thread now allocates from its own
+ * arena : a talloc context under __ogs_talloc_core with a private mutex.
+ * The owner thread is the only one allocating from it, so the mutex is
+ * normally uncontended. It is still required because the memory can be
+ * freed by another thread (e.g. freeDiameter thread -> main loop).
+ *
+ * Every chunk is prefixed with a header remembering its arena,
+ * so that ogs_talloc_free()/ogs_talloc_realloc_size() know which mutex
+ * to hold without walking the talloc hierarchy. A chunk allocated under
+ * another chunk goes to the arena of its parent, whatever the calling thread,
+ * so that a hierarchy never spans two arenas.
+ *
+ * Note that ogs_pkbuf_alloc(NULL, ...) also allocates from the arena of
+ * the calling thread. A packet freed by another thread only costs
+ * the (uncontended) mutex of the owner arena.
+ *
+ * Arenas are never released while the process is running. When a thread
+ * exits, its arena becomes idle and is adopted by the next new thread.
+ * Everything is released in ogs_mem_final(), and talloc_report_full()
+ * on __ogs_talloc_core still shows the whole hierarchy.
+ *
+ * A pooled per-message arena is not freed by ogs_mem_arena_destroy() either.
+ * Its chunks are released, which rewinds the talloc_pool(), and the arena
+ * is kept on a free list of the calling thread for the next
+ * ogs_mem_arena_create_pool() of the same size. Only the owner thread
+ * touches this list, so neither the global mutex nor a malloc() is needed.
+ */
+
+#define OGS_MEM_MAX_FREE_POOL 16
+
+struct ogs_mem_arena_s {
+    ogs_lnode_t lnode;
+
+    ogs_thread_mutex_t mutex;
+    void *ctx;
+
+    bool thread;    /* Per-thread arena (false : per-message arena) */
+    bool idle;      /* Per-thread arena whose thread has exited */
+    bool pool;      /* Per-message arena carved from a talloc_pool() */
+    size_t pool_size;
+
+    /* Per-thread arena only : arena selected by ogs_mem_arena_switch() */
+    ogs_mem_arena_t *current;
+
+    /* Per-thread arena only : pooled arenas released by the owner thread */
+    ogs_list_t free_pool;
+    int num_of_free_pool;
+
+    /* Per-thread arena only : chunks and arenas allocated by the owner */
+    uint64_t num_of_alloc;
+};
+
+typedef union ogs_mem_header_u {
+    struct {
+        ogs_mem_arena_t *arena;
+        uintptr_t check;    /* arena ^ OGS_MEM_HEADER_MAGIC */
+    } h;
+    long double align;
+} ogs_mem_header_t;
+
+#define OGS_MEM_HEADER_SIZE sizeof(ogs_mem_header_t)
+#define OGS_MEM_HEADER_MAGIC ((uintptr_t)0x6f67736d656d6864ULL)
+
 void *__ogs_talloc_core;
 
-static ogs_thread_mutex_t mutex;
+/*
+ * Chunks allocated under a context that is not managed by an arena
+ * (e.g. talloc_pool() in UPF/SGW-U) are still protected by the global mutex.
+ * The global mutex also protects the children list of __ogs_talloc_core.
+ */
+static ogs_mem_arena_t global_arena;
+
+static OGS_LIST(arena_list);
+static pthread_key_t arena_key;
+
+static void arena_release(void *data)
+{
+    ogs_mem_arena_t *arena = data;
+    ogs_assert(arena);
+
+    ogs_thread_mutex_lock(&global_arena.mutex);
+    arena->current = NULL;
+    arena->idle = true;
+    ogs_thread_mutex_unlock(&global_arena.mutex);
+}
+
+static ogs_mem_arena_t *arena_new(const char *name, size_t pool_size)
+{
+    ogs_mem_arena_t *arena = NULL;
+
+    arena = calloc(1, sizeof *arena);
+    ogs_assert(arena);
+
+    ogs_thread_mutex_init(&arena->mutex);
+
+    if (pool_size) {
+        arena->ctx = talloc_pool(__ogs_talloc_core, pool_size);
+        ogs_assert(arena->ctx);
+        talloc_set_name_const(arena->ctx, name);
+        arena->pool = true;
+        arena->pool_size = pool_size;
+    } else {
+        /* Zero-sized context : does not change talloc_total_size() */
+        arena->ctx = talloc_named_const(__ogs_talloc_core, 0, name);
+        ogs_assert(arena->ctx);
+    }
+
+    return arena;
+}
+
+static ogs_mem_arena_t *thread_arena(void)
+{
+    ogs_mem_arena_t *arena = NULL;
+
+    arena = pthread_getspecific(arena_key);
+    if (ogs_likely(arena))
+        return arena;
+
+    ogs_thread_mutex_lock(&global_arena.mutex);
+
+    ogs_list_for_each(&arena_list, arena) {
+        if (arena->idle == true) {
+            arena->idle = false;
+            break;
+        }
+    }
+
+    if (!arena) {
+        arena = arena_new("thread", 0);
+        arena->thread = true;
+        ogs_list_add(&arena_list, arena);
+    }
+
+    ogs_thread_mutex_unlock(&global_arena.mutex);
+
+    ogs_assert(pthread_setspecific(arena_key, arena) == 0);
+
+    return arena;
+}
+
+/*
+ * A context passed to ogs_talloc_*() is either NULL/__ogs_talloc_core,
+ * a chunk returned by ogs_talloc_*() (prefixed with our header),
+ * or a raw talloc context such as talloc_pool(). The bytes preceding
+ * a raw talloc context belong to its talloc_chunk, so they can be read
+ * safely; the check word tells both cases apart.
+ */
+static ogs_mem_header_t *header_from_context(const void *ctx)
+{
+    ogs_mem_header_t *header = (ogs_mem_header_t *)ctx - 1;
+
+    if (header->h.arena &&
+        header->h.check == ((uintptr_t)header->h.arena ^ OGS_MEM_HEADER_MAGIC))
+        return header;
+
+    return NULL;
+}
+
+static ogs_mem_arena_t *arena_from_context(
+        const void *ctx, const void **parent)
+{
+    ogs_mem_arena_t *arena = NULL;
+    ogs_mem_header_t *header = NULL;
+
+    ogs_assert(parent);
+
+    if (ctx != NULL && ctx != __ogs_talloc_core) {
+        header = header_from_context(ctx);
+        if (header) {
+            /* The child lives in the arena owning its parent */
+            *parent = header;
+            return header->h.arena;
+        }
+
+        *parent = ctx;
+        return &global_arena;
+    }
+
+    arena = thread_arena();
+    if (arena->current)
+        arena = arena->current;
+
+    *parent = arena->ctx;
+    return arena;
+}
 
 void ogs_mem_init(void)
 {
-    ogs_thread_mutex_init(&mutex);
+    memset(&global_arena, 0, sizeof global_arena);
+    ogs_thread_mutex_init(&global_arena.mutex);
 
     talloc_enable_null_tracking();
 
 #define TALLOC_MEMSIZE 1
     __ogs_talloc_core = talloc_named_const(NULL, TALLOC_MEMSIZE, "core");
+
+    ogs_list_init(&arena_list);
+    ogs_assert(pthread_key_create(&arena_key, arena_release) == 0);
 }
 
 void ogs_mem_final(void)
 {
+    ogs_mem_arena_t *arena = NULL, *next_arena = NULL;
+    ogs_mem_arena_t *pool = NULL, *next_pool = NULL;
+
     if (talloc_total_size(__ogs_talloc_core) != TALLOC_MEMSIZE)
         talloc_report_full(__ogs_talloc_core, stderr);
 
+    /* All arena contexts are children of __ogs_talloc_core */
     talloc_free(__ogs_talloc_core);
 
-    ogs_thread_mutex_destroy(&mutex);
+    ogs_list_for_each_safe(&arena_list, next_arena, arena) {
+        ogs_list_for_each_safe(&arena->free_pool, next_pool, pool) {
+            ogs_list_remove(&arena->free_pool, pool);
+            ogs_thread_mutex_destroy(&pool->mutex);
+            free(pool);
+        }
+
+        ogs_list_remove(&arena_list, arena);
+        ogs_thread_mutex_destroy(&arena->mutex);
+        free(arena);
+    }
+
+    pthread_setspecific(arena_key, NULL);
+    pthread_key_delete(arena_key);
+
+    ogs_thread_mutex_destroy(&global_arena.mutex);
 }
 
 void *ogs_mem_get_mutex(void)
 {
-    return &mutex;
+    return &global_arena.mutex;
+}
+
+ogs_mem_arena_t *ogs_mem_arena_create(const char *name)
+{
+    ogs_mem_arena_t *arena = NULL;
+
+    ogs_assert(name);
+
+    ogs_thread_mutex_lock(&global_arena.mutex);
+    arena = arena_new(name, 0);
+    ogs_thread_mutex_unlock(&global_arena.mutex);
+
+    thread_arena()->num_of_alloc++;
+
+    return arena;
+}
+
+ogs_mem_arena_t *ogs_mem_arena_create_pool(const char *name, size_t size)
+{
+    ogs_mem_arena_t *self = NULL, *arena = NULL;
+
+    ogs_assert(name);
+    ogs_assert(size);
+
+    self = thread_arena();
+
+    ogs_list_for_each(&self->free_pool, arena) {
+        if (arena->pool_size == size) {
+            ogs_list_remove(&self->free_pool, arena);
+            self->num_of_free_pool--;
+
+            talloc_set_name_const(arena->ctx, name);
+            return arena;
+        }
+    }
+
+    ogs_thread_mutex_lock(&global_arena.mutex);
+    arena = arena_new(name, size);
+    ogs_thread_mutex_unlock(&global_arena.mutex);
+
+    self->num_of_alloc++;
+
+    return arena;
+}
+
+void ogs_mem_arena_destroy(ogs_mem_arena_t *arena)
+{
+    ogs_mem_arena_t *self = NULL;
+
+    ogs_assert(arena);
+    ogs_assert(arena->thread == false);
+
+    if (arena->pool == true) {
+        self = thread_arena();
+        if (self->num_of_free_pool < OGS_MEM_MAX_FREE_POOL) {
+            talloc_free_children(arena->ctx);
+
+            ogs_list_add(&self->free_pool, arena);
+            self->num_of_free_pool++;
+            return;
+        }
+    }
+
+    ogs_thread_mutex_lock(&global_arena.mutex);
+    talloc_free(arena->ctx);
+    ogs_thread_mutex_unlock(&global_arena.mutex);
+
+    ogs_thread_mutex_destroy(&arena->mutex);
+    free(arena);
+}
+
+ogs_mem_arena_t *ogs_mem_arena_switch(ogs_mem_arena_t *arena)
+{
+    ogs_mem_arena_t *self = NULL, *prev = NULL;
+
+    ogs_assert(!arena || arena->thread == false);
+
+    self = thread_arena();
+    prev = self->current;
+    self->current = arena;
+
+    return prev;
+}
+
+uint64_t ogs_mem_num_of_alloc(void)
+{
+    return thread_arena()->num_of_alloc;
+}
+
+static void *talloc_header_alloc(
+        const void *ctx, size_t size, const char *name, bool zero)
+{
+    ogs_mem_arena_t *arena = NULL;
+    ogs_mem_header_t *header = NULL;
+    const void *parent = NULL;
+
+    arena = arena_from_context(ctx, &parent);
+    ogs_assert(arena);
+    ogs_assert(parent);
+
+    ogs_thread_mutex_lock(&arena->mutex);
+
+    if (zero == true)
+        header = _talloc_zero(parent, OGS_MEM_HEADER_SIZE + size, name);
+    else
+        header = talloc_named_const(parent, OGS_MEM_HEADER_SIZE + size, name);
+
+    ogs_thread_mutex_unlock(&arena->mutex);
+
+    if (!header) {
+        ogs_error("talloc[size:%d] failed", (int)size);
+        return NULL;
+    }
+
+    header->h.arena = arena;
+    header->h.check = (uintptr_t)arena ^ OGS_MEM_HEADER_MAGIC;
+    thread_arena()->num_of_alloc++;
+
+    return header + 1;
 }
 
 void *ogs_talloc_size(const void *ctx, size_t size, const char *name)
 {
     void *ptr = NULL;
 
-    ogs_thread_mutex_lock(&mutex);
-
-    ptr = talloc_named_const(ctx, size, name);
+    ptr = talloc_header_alloc(ctx, size, name, false);
     ogs_expect(ptr);
 
-    ogs_thread_mutex_unlock(&mutex);
-
     return ptr;
 }
 
@@ -73,40 +395,62 @@ void *ogs_talloc_zero_size(const void *ctx, size_t size, const char *name)
 {
     void *ptr = NULL;
 
-    ogs_thread_mutex_lock(&mutex);
-
-    ptr = _talloc_zero(ctx, size, name);
+    ptr = talloc_header_alloc(ctx, size, name, true);
     ogs_expect(ptr);
 
-    ogs_thread_mutex_unlock(&mutex);
-
     return ptr;
 }
 
 void *ogs_talloc_realloc_size(
         const void *context, void *oldptr, size_t size, const char *name)
 {
-    void *ptr = NULL;
+    ogs_mem_arena_t *arena = NULL;
+    ogs_mem_header_t *header = NULL;
 
-    ogs_thread_mutex_lock(&mutex);
+    if (!oldptr)
+        return ogs_talloc_size(context, size, name);
 
-    ptr = _talloc_realloc(context, oldptr, size, name);
-    ogs_expect(ptr);
+    if (!size) {
+        ogs_talloc_free(oldptr, name);
+        return NULL;
+    }
 
-    ogs_thread_mutex_unlock(&mutex);
+    header = (ogs_mem_header_t *)oldptr - 1;
+    arena = header->h.arena;
+    ogs_assert(arena);
 
-    return ptr;
+    /* The chunk stays in the arena where it was allocated */
+    ogs_thread_mutex_lock(&arena->mutex);
+
+    header = _talloc_realloc(NULL, header, OGS_MEM_HEADER_SIZE + size, name);
+    ogs_expect(header);
+
+    ogs_thread_mutex_unlock(&arena->mutex);
+
+    if (!header)
+        return NULL;
+
+    return header + 1;
 }
 
 int ogs_talloc_free(void *ptr, const char *location)
 {
     int ret;
+    ogs_mem_arena_t *arena = NULL;
+    ogs_mem_header_t *header = NULL;
+
+    if (!ptr)
+        return -1;
+
+    header = (ogs_mem_header_t *)ptr - 1;
+    arena = header->h.arena;
+    ogs_assert(arena);
 
-    ogs_thread_mutex_lock(&mutex);
+    ogs_thread_mutex_lock(&arena->mutex);
 
-    ret = _talloc_free(ptr, location);
+    ret = _talloc_free(header, location);
 
-    ogs_thread_mutex_unlock(&mutex);
+    ogs_thread_mutex_unlock(&arena->mutex);
 
     return ret;
 }
@@ -51,6 +51,42 @@ void *ogs_talloc_realloc_size(
         const void *context, void *oldptr, size_t size, const char *name);
 int ogs_talloc_free(void *ptr, const char *location);
 
+/*
+ * Per-message arena
+ *
+ * ogs_mem_arena_switch(arena) makes ogs_malloc()/ogs_calloc()/ogs_strdup()
+ * of the calling thread allocate from the arena until
+ * ogs_mem_arena_switch() is called again with the returned arena.
+ * ogs_mem_arena_destroy() frees everything allocated from the arena at once.
+ *
+ *   arena = ogs_mem_arena_create("message");
+ *   prev = ogs_mem_arena_switch(arena);
+ *   item = cJSON_Parse(json);
+ *   ogs_mem_arena_switch(prev);
+ *   ...
+ *   ogs_mem_arena_destroy(arena);
+ *
+ * ogs_mem_arena_create_pool() preallocates 'size' bytes and carves
+ * the chunks out of it. talloc falls back to malloc() once the pool is
+ * exhausted. Such an arena is recycled by ogs_mem_arena_destroy(),
+ * so that a small message costs no malloc() at all.
+ */
+typedef struct ogs_mem_arena_s ogs_mem_arena_t;
+
+ogs_mem_arena_t *ogs_mem_arena_create(const char *name);
+ogs_mem_arena_t *ogs_mem_arena_create_pool(const char *name, size_t size);
+void ogs_mem_arena_destroy(ogs_mem_arena_t *arena);
+ogs_mem_arena_t *ogs_mem_arena_switch(ogs_mem_arena_t *arena);
+
+/*
+ * Number of chunks and arenas allocated so far by the calling thread,
+ * e.g. to measure allocations per request in a benchmark.
+ * Chunks carved from a pooled arena are counted as well,
+ * but not a pooled arena recycled by ogs_mem_arena_create_pool().
+ * Only counted when OGS_USE_TALLOC is enabled.
+ */
+uint64_t ogs_mem_num_of_alloc(void);
+
 void *ogs_malloc_debug(size_t size, const char *file_line);
 void *ogs_calloc_debug(
         size_t nmemb, size_t size, const char *file_line);
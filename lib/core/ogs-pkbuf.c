@@ -223,6 +223,10 @@ ogs_pkbuf_t *ogs_pkbuf_alloc_debug(
 #if OGS_USE_TALLOC == 1
     ogs_pkbuf_t *pkbuf = NULL;
 
+    /*
+     * With a NULL pool, the packet comes from the arena of the calling
+     * thread, and ogs_pkbuf_free() from another thread locks that arena.
+     */
     pkbuf = ogs_talloc_zero_size(pool, sizeof(*pkbuf) + size, file_line);
     if (!pkbuf) {
         ogs_error("ogs_pkbuf_alloc() failed [size=%d]", size);
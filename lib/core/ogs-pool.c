@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "core-config-private.h"
+
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "ogs-core.h"
+
+/*
+ * Arrays smaller than this are not worth a mapping of their own
+ * and are taken from calloc() as before.
+ */
+#define OGS_POOL_MMAP_THRESHOLD (64*1024)
+
+static OGS_LIST(stat_list);
+static ogs_thread_mutex_t stat_mutex;
+
+void ogs_pool_stat_init(void)
+{
+    ogs_list_init(&stat_list);
+    ogs_thread_mutex_init(&stat_mutex);
+}
+
+void ogs_pool_stat_final(void)
+{
+    ogs_thread_mutex_destroy(&stat_mutex);
+}
+
+void ogs_pool_stat_add(ogs_pool_stat_t *stat)
+{
+    ogs_assert(stat);
+
+    ogs_thread_mutex_lock(&stat_mutex);
+    ogs_list_add(&stat_list, stat);
+    ogs_thread_mutex_unlock(&stat_mutex);
+}
+
+void ogs_pool_stat_remove(ogs_pool_stat_t *stat)
+{
+    ogs_assert(stat);
+
+    ogs_thread_mutex_lock(&stat_mutex);
+    ogs_list_remove(&stat_list, stat);
+    ogs_thread_mutex_unlock(&stat_mutex);
+}
+
+void ogs_pool_stat_foreach(
+        void (*cb)(const ogs_pool_stat_t *stat, void *data), void *data)
+{
+    ogs_pool_stat_t *stat = NULL, snapshot;
+
+    ogs_assert(cb);
+
+    ogs_thread_mutex_lock(&stat_mutex);
+    ogs_list_for_each(&stat_list, stat) {
+        memset(&snapshot, 0, sizeof(snapshot));
+        snapshot.name = stat->name;
+        snapshot.size = stat->size;
+        snapshot.used = ogs_pool_stat_get(stat, used);
+        snapshot.high_water = ogs_pool_stat_get(stat, high_water);
+        snapshot.failed = ogs_pool_stat_get(stat, failed);
+
+        cb(&snapshot, data);
+    }
+    ogs_thread_mutex_unlock(&stat_mutex);
+}
+
+/*
+ * The arrays of a large pool are reserved with an anonymous mapping.
+ * Pages are committed by the kernel when a node is first touched,
+ * so a pool sized for the worst case costs only what is really used.
+ */
+void *ogs_pool_reserve(size_t size)
+{
+    void *ptr = NULL;
+
+#if HAVE_SYS_MMAN_H && defined(MAP_ANONYMOUS)
+    if (size >= OGS_POOL_MMAP_THRESHOLD) {
+        int flags = MAP_PRIVATE|MAP_ANONYMOUS;
+#if defined(MAP_NORESERVE)
+        flags |= MAP_NORESERVE;
+#endif
+        ptr = mmap(NULL, size, PROT_READ|PROT_WRITE, flags, -1, 0);
+        if (ptr == MAP_FAILED) {
+            ogs_log_message(OGS_LOG_ERROR, ogs_errno,
+                    "mmap() failed [%zu]", size);
+            return NULL;
+        }
+        return ptr;
+    }
+#endif
+
+    ptr = calloc(1, size);
+    if (!ptr)
+        ogs_error("calloc() failed [%zu]", size);
+
+    return ptr;
+}
+
+void ogs_pool_release(void *ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+#if HAVE_SYS_MMAN_H && defined(MAP_ANONYMOUS)
+    if (size >= OGS_POOL_MMAP_THRESHOLD) {
+        if (munmap(ptr, size) != 0)
+            ogs_log_message(OGS_LOG_ERROR, ogs_errno,
+                    "munmap() failed [%zu]", size);
+        return;
+    }
+#endif
+
+    free(ptr);
+}
@@ -34,39 +34,85 @@ extern "C" {
 
 typedef int32_t ogs_pool_id_t;
 
+/*
+ * Usage of a pool initialized with ogs_pool_init().
+ * They are listed so that they can be exported as metrics.
+ *
+ * The counters are updated by the thread owning the pool and read by
+ * the metrics thread, so they are stored with relaxed atomics, and
+ * ogs_pool_stat_foreach() hands a snapshot to the callback.
+ */
+typedef struct ogs_pool_stat_s {
+    ogs_lnode_t lnode;
+
+    const char *name;
+    int size;
+
+    int used;
+    int high_water; /* the most nodes in use at the same time */
+    int failed; /* allocations that found the pool empty */
+} ogs_pool_stat_t;
+
+#define ogs_pool_stat_set(stat, field, value) \
+    __atomic_store_n(&(stat)->field, (value), __ATOMIC_RELAXED)
+#define ogs_pool_stat_get(stat, field) \
+    __atomic_load_n(&(stat)->field, __ATOMIC_RELAXED)
+
+void ogs_pool_stat_init(void);
+void ogs_pool_stat_final(void);
+void ogs_pool_stat_add(ogs_pool_stat_t *stat);
+void ogs_pool_stat_remove(ogs_pool_stat_t *stat);
+void ogs_pool_stat_foreach(
+        void (*cb)(const ogs_pool_stat_t *stat, void *data), void *data);
+
+void *ogs_pool_reserve(size_t size);
+void ogs_pool_release(void *ptr, size_t size);
+
+/*
+ * Nodes that were never handed out are taken from array[] in order
+ * (fresh counts them), and only released nodes go through the free ring.
+ * This gives the same order as a ring filled with the whole array,
+ * but the pool does not touch a node's memory before it is used.
+ */
 #define OGS_POOL(pool, type) \
     struct { \
         const char *name; \
         int head, tail; \
         int size, avail; \
+        int fresh; \
         type **free, *array, **index; \
         \
         ogs_hash_t *id_hash; \
         ogs_pool_id_t id; \
+        \
+        ogs_pool_stat_t stat; \
     } pool
 
 /*
  * ogs_pool_init() shall be used in the initialization routine.
  * Otherwise, memory will be fragment since this function uses system malloc()
+ *
+ * Large arrays are only reserved here, see ogs_pool_reserve().
  */
 #define ogs_pool_init(pool, _size) do { \
-    int i; \
     (pool)->name = #pool; \
-    (pool)->free = malloc(sizeof(*(pool)->free) * _size); \
+    (pool)->free = ogs_pool_reserve(sizeof(*(pool)->free) * _size); \
     ogs_assert((pool)->free); \
-    (pool)->array = malloc(sizeof(*(pool)->array) * _size); \
+    (pool)->array = ogs_pool_reserve(sizeof(*(pool)->array) * _size); \
     ogs_assert((pool)->array); \
-    (pool)->index = malloc(sizeof(*(pool)->index) * _size); \
+    (pool)->index = ogs_pool_reserve(sizeof(*(pool)->index) * _size); \
     ogs_assert((pool)->index); \
     (pool)->size = (pool)->avail = _size; \
     (pool)->head = (pool)->tail = 0; \
-    for (i = 0; i < _size; i++) { \
-        (pool)->free[i] = &((pool)->array[i]); \
-        (pool)->index[i] = NULL; \
-    } \
+    (pool)->fresh = 0; \
     \
     (pool)->id_hash = ogs_hash_make(); \
     ogs_assert((pool)->id_hash); \
+    \
+    memset(&(pool)->stat, 0, sizeof((pool)->stat)); \
+    (pool)->stat.name = (pool)->name; \
+    (pool)->stat.size = (pool)->size; \
+    ogs_pool_stat_add(&(pool)->stat); \
 } while (0)
 
 /*
@@ -77,9 +123,14 @@ typedef int32_t ogs_pool_id_t;
     if (((pool)->size != (pool)->avail)) \
         ogs_error("%d in '%s[%d]' were not released.", \
                 (pool)->size - (pool)->avail, (pool)->name, (pool)->size); \
-    free((pool)->free); \
-    free((pool)->array); \
-    free((pool)->index); \
+    ogs_pool_stat_remove(&(pool)->stat); \
+    \
+    ogs_pool_release((pool)->free, \
+            sizeof(*(pool)->free) * (pool)->size); \
+    ogs_pool_release((pool)->array, \
+            sizeof(*(pool)->array) * (pool)->size); \
+    ogs_pool_release((pool)->index, \
+            sizeof(*(pool)->index) * (pool)->size); \
     \
     ogs_assert((pool)->id_hash); \
     ogs_hash_destroy((pool)->id_hash); \
@@ -92,23 +143,21 @@ typedef int32_t ogs_pool_id_t;
  * so this function should use ogs_malloc() instead of system malloc()
  */
 #define ogs_pool_create(pool, _size) do { \
-    int i; \
     (pool)->name = #pool; \
     (pool)->free = ogs_malloc(sizeof(*(pool)->free) * _size); \
     ogs_assert((pool)->free); \
     (pool)->array = ogs_malloc(sizeof(*(pool)->array) * _size); \
     ogs_assert((pool)->array); \
-    (pool)->index = ogs_malloc(sizeof(*(pool)->index) * _size); \
+    (pool)->index = ogs_calloc(_size, sizeof(*(pool)->index)); \
     ogs_assert((pool)->index); \
     (pool)->size = (pool)->avail = _size; \
     (pool)->head = (pool)->tail = 0; \
-    for (i = 0; i < _size; i++) { \
-        (pool)->free[i] = &((pool)->array[i]); \
-        (pool)->index[i] = NULL; \
-    } \
+    (pool)->fresh = 0; \
     \
     (pool)->id_hash = ogs_hash_make(); \
     ogs_assert((pool)->id_hash); \
+    \
+    memset(&(pool)->stat, 0, sizeof((pool)->stat)); \
 } while (0)
 
 /*
@@ -133,10 +182,22 @@ typedef int32_t ogs_pool_id_t;
     *(node) = NULL; \
     if ((pool)->avail > 0) { \
         (pool)->avail--; \
-        *(node) = (void*)(pool)->free[(pool)->head]; \
-        (pool)->free[(pool)->head] = NULL; \
-        (pool)->head = ((pool)->head + 1) % ((pool)->size); \
+        if ((pool)->fresh < (pool)->size) { \
+            *(node) = (void*)&((pool)->array[(pool)->fresh++]); \
+        } else { \
+            *(node) = (void*)(pool)->free[(pool)->head]; \
+            (pool)->free[(pool)->head] = NULL; \
+            (pool)->head = ((pool)->head + 1) % ((pool)->size); \
+        } \
         (pool)->index[ogs_pool_index(pool, *(node))-1] = *(node); \
+        ogs_pool_stat_set(&(pool)->stat, used, \
+                (pool)->size - (pool)->avail); \
+        if ((pool)->size - (pool)->avail > (pool)->stat.high_water) \
+            ogs_pool_stat_set(&(pool)->stat, high_water, \
+                    (pool)->size - (pool)->avail); \
+    } else { \
+        ogs_pool_stat_set(&(pool)->stat, failed, \
+                (pool)->stat.failed + 1); \
     } \
 } while (0)
 
@@ -146,9 +207,14 @@ typedef int32_t ogs_pool_id_t;
         (pool)->free[(pool)->tail] = (void*)(node); \
         (pool)->tail = ((pool)->tail + 1) % ((pool)->size); \
         (pool)->index[ogs_pool_index(pool, node)-1] = NULL; \
+        ogs_pool_stat_set(&(pool)->stat, used, \
+                (pool)->size - (pool)->avail); \
     } \
 } while (0)
 
+#define ogs_pool_high_water(pool) ((pool)->stat.high_water)
+#define ogs_pool_failed(pool) ((pool)->stat.failed)
+
 #define ogs_pool_index(pool, node) (((node) - (pool)->array)+1)
 #define ogs_pool_find(pool, _index) \
     (_index > 0 && _index <= (pool)->size) ? (pool)->index[_index-1] : NULL
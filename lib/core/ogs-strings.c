@@ -150,13 +150,17 @@ char *ogs_cpystrn(char *dst, const char *src, size_t dst_size)
 char *ogs_talloc_strdup(const void *t, const char *p)
 {
     char *ptr = NULL;
+    size_t len;
 
-    ogs_thread_mutex_lock(ogs_mem_get_mutex());
+    if (!p)
+        return NULL;
 
-    ptr = talloc_strdup(t, p);
-    ogs_expect(ptr);
+    len = strlen(p) + 1;
+    ptr = ogs_talloc_size(t, len, __location__);
+    if (!ptr)
+        return NULL;
 
-    ogs_thread_mutex_unlock(ogs_mem_get_mutex());
+    memcpy(ptr, p, len);
 
     return ptr;
 }
@@ -164,13 +168,18 @@ char *ogs_talloc_strdup(const void *t, const char *p)
 char *ogs_talloc_strndup(const void *t, const char *p, size_t n)
 {
     char *ptr = NULL;
+    size_t len;
 
-    ogs_thread_mutex_lock(ogs_mem_get_mutex());
+    if (!p)
+        return NULL;
 
-    ptr = talloc_strndup(t, p, n);
-    ogs_expect(ptr);
+    len = strnlen(p, n);
+    ptr = ogs_talloc_size(t, len + 1, __location__);
+    if (!ptr)
+        return NULL;
 
-    ogs_thread_mutex_unlock(ogs_mem_get_mutex());
+    memcpy(ptr, p, len);
+    ptr[len] = '\0';
 
     return ptr;
 }
@@ -179,50 +188,71 @@ void *ogs_talloc_memdup(const void *t, const void *p, size_t size)
 {
     void *ptr = NULL;
 
-    ogs_thread_mutex_lock(ogs_mem_get_mutex());
-
-    ptr = talloc_memdup(t, p, size);
-    ogs_expect(ptr);
+    ptr = ogs_talloc_size(t, size, __location__);
+    if (!ptr)
+        return NULL;
 
-    ogs_thread_mutex_unlock(ogs_mem_get_mutex());
+    memcpy(ptr, p, size);
 
     return ptr;
 }
 
 char *ogs_talloc_asprintf(const void *t, const char *fmt, ...)
 {
-    va_list ap;
-    char *ret;
-
-    ogs_thread_mutex_lock(ogs_mem_get_mutex());
+    va_list ap, ap2;
+    char *ret = NULL;
+    int len;
 
     va_start(ap, fmt);
-    ret = talloc_vasprintf(t, fmt, ap);
-    ogs_expect(ret);
+
+    va_copy(ap2, ap);
+    len = vsnprintf(NULL, 0, fmt, ap2);
+    va_end(ap2);
+
+    if (len >= 0) {
+        ret = ogs_talloc_size(t, len + 1, __location__);
+        if (ret)
+            vsnprintf(ret, len + 1, fmt, ap);
+    }
+
     va_end(ap);
 
-    ogs_thread_mutex_unlock(ogs_mem_get_mutex());
+    ogs_expect(ret);
 
     return ret;
 }
 
 char *ogs_talloc_asprintf_append(char *s, const char *fmt, ...)
 {
-    va_list ap;
-
-    ogs_thread_mutex_lock(ogs_mem_get_mutex());
+    va_list ap, ap2;
+    size_t slen;
+    int len;
 
     va_start(ap, fmt);
-    s = talloc_vasprintf_append(s, fmt, ap);
-    ogs_expect(s);
+
+    va_copy(ap2, ap);
+    len = vsnprintf(NULL, 0, fmt, ap2);
+    va_end(ap2);
+
+    if (len < 0) {
+        va_end(ap);
+        ogs_error("vsnprintf() failed");
+        return NULL;
+    }
+
+    slen = s ? strlen(s) : 0;
+    s = ogs_talloc_realloc_size(
+            __ogs_talloc_core, s, slen + len + 1, __location__);
+    if (s)
+        vsnprintf(s + slen, len + 1, fmt, ap);
+
     va_end(ap);
 
-    ogs_thread_mutex_unlock(ogs_mem_get_mutex());
+    ogs_expect(s);
 
     return s;
 }
 
-
 /*****************************************
  * Memory Pool - Use pkbuf library
  *****************************************/
@@ -272,6 +272,67 @@ ogs_time_t ogs_get_monotonic_time(void)
 #endif
 }
 
+#if defined(_MSC_VER)
+#define OGS_TIME_THREAD_LOCAL __declspec(thread)
+#else
+#define OGS_TIME_THREAD_LOCAL __thread
+#endif
+
+static OGS_TIME_THREAD_LOCAL ogs_time_t coarse_now;
+static OGS_TIME_THREAD_LOCAL ogs_time_t coarse_monotonic;
+static OGS_TIME_THREAD_LOCAL bool coarse_now_valid;
+static OGS_TIME_THREAD_LOCAL bool coarse_monotonic_valid;
+static OGS_TIME_THREAD_LOCAL bool coarse_driven;
+
+void ogs_time_update(void)
+{
+    coarse_driven = true;
+    coarse_now = ogs_time_now();
+    coarse_now_valid = true;
+    coarse_monotonic = ogs_get_monotonic_time();
+    coarse_monotonic_valid = true;
+}
+
+void ogs_time_invalidate(void)
+{
+    coarse_driven = true;
+    coarse_now_valid = false;
+    coarse_monotonic_valid = false;
+}
+
+/*
+ * The clock is read on the first call after ogs_time_invalidate(),
+ * so a thread that never asks for the coarse time never pays for it.
+ *
+ * Nothing would ever invalidate the cache of a thread without a pollset
+ * (e.g. a worker thread), so such a thread gets the precise clock.
+ */
+ogs_time_t ogs_time_now_coarse(void)
+{
+    if (ogs_unlikely(coarse_driven == false))
+        return ogs_time_now();
+
+    if (ogs_unlikely(coarse_now_valid == false)) {
+        coarse_now = ogs_time_now();
+        coarse_now_valid = true;
+    }
+
+    return coarse_now;
+}
+
+ogs_time_t ogs_monotonic_coarse(void)
+{
+    if (ogs_unlikely(coarse_driven == false))
+        return ogs_get_monotonic_time();
+
+    if (ogs_unlikely(coarse_monotonic_valid == false)) {
+        coarse_monotonic = ogs_get_monotonic_time();
+        coarse_monotonic_valid = true;
+    }
+
+    return coarse_monotonic;
+}
+
 void ogs_localtime(time_t s, struct tm *tm)
 {
     ogs_assert(tm);
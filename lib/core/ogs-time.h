@@ -109,6 +109,28 @@ uint32_t ogs_time_to_ntp32(ogs_time_t time);
 
 /** @return number of microseconds since an arbitrary point */
 ogs_time_t ogs_get_monotonic_time(void);
+
+/*
+ * Coarse clock
+ *
+ * The pollset calls ogs_time_invalidate() each time it wakes up.
+ * The first ogs_time_now_coarse()/ogs_monotonic_coarse() of a poll
+ * iteration reads the clock and caches it for the calling thread,
+ * so that per-packet code makes at most one clock call per iteration.
+ * ogs_time_update() refreshes both values immediately.
+ * Use the precise functions above when the resolution matters.
+ *
+ * Only the thread running the pollset, or one that calls
+ * ogs_time_update()/ogs_time_invalidate() itself, uses the cache.
+ * On any other thread, e.g. a worker, they return the precise clock.
+ */
+void ogs_time_update(void);
+void ogs_time_invalidate(void);
+/** @return cached ogs_time_now() of the current poll iteration */
+ogs_time_t ogs_time_now_coarse(void);
+/** @return cached ogs_get_monotonic_time() of the current poll iteration */
+ogs_time_t ogs_monotonic_coarse(void);
+
 /** @return the GMT offset in seconds */
 int ogs_timezone(void);
 
@@ -95,10 +95,225 @@ static uint8_t tlv_ctype2mode(ogs_tlv_type_e ctype, uint8_t msg_mode)
     }
 }
 
-static ogs_tlv_t *tlv_add_leaf(
-        ogs_tlv_t *parent_tlv, ogs_tlv_t *tlv, ogs_tlv_desc_t *desc, void *msg, uint8_t msg_mode)
+/*
+ * Per-descriptor type index
+ *
+ * Looking up the descriptor of each IE used to walk child_descs[] linearly.
+ * The index keeps the children sorted by <type,instance> together with
+ * their offset in the message structure, so that the lookup is done
+ * with a binary search. It is built on first use and kept until
+ * ogs_tlv_msg_final().
+ */
+typedef struct ogs_tlv_desc_index_s {
+    struct ogs_tlv_desc_index_s *next;
+    ogs_tlv_desc_t *desc;
+
+    int num_of_entry;
+    struct {
+        uint32_t key; /* type<<8 + instance */
+        uint8_t index; /* position in child_descs[] */
+        uint32_t offset; /* offset in the message structure */
+    } entry[OGS_TLV_MAX_CHILD_DESC];
+} ogs_tlv_desc_index_t;
+
+static ogs_thread_mutex_t index_mutex;
+static ogs_tlv_desc_index_t *index_list;
+
+#define TLV_INDEX_KEY(__tYPE, __iNSTANCE) \
+    ((((uint32_t)(__tYPE))<<8) | (__iNSTANCE))
+
+void ogs_tlv_msg_init(void)
+{
+    ogs_thread_mutex_init(&index_mutex);
+    index_list = NULL;
+}
+
+void ogs_tlv_msg_final(void)
+{
+    ogs_tlv_desc_index_t *index = NULL, *next = NULL;
+
+    for (index = index_list; index; index = next) {
+        next = index->next;
+        index->desc->index = NULL;
+        ogs_free(index);
+    }
+    index_list = NULL;
+
+    ogs_thread_mutex_destroy(&index_mutex);
+}
+
+static ogs_tlv_desc_index_t *tlv_desc_index_build(ogs_tlv_desc_t *parent_desc)
+{
+    ogs_tlv_desc_index_t *index = NULL;
+    ogs_tlv_desc_t *prev_desc = NULL, *desc = NULL;
+    uint32_t offset = 0;
+    int i, j;
+
+    index = ogs_calloc(1, sizeof(*index));
+    if (!index) {
+        ogs_error("ogs_calloc() failed");
+        return NULL;
+    }
+    index->desc = parent_desc;
+
+    for (i = 0, desc = parent_desc->child_descs[i]; desc != NULL;
+            i++, desc = parent_desc->child_descs[i]) {
+        uint32_t key = TLV_INDEX_KEY(desc->type, desc->instance);
+
+        /* Insertion sort : entries with the same key keep their order */
+        for (j = index->num_of_entry;
+                j > 0 && index->entry[j-1].key > key; j--)
+            index->entry[j] = index->entry[j-1];
+
+        index->entry[j].key = key;
+        index->entry[j].index = i;
+        index->entry[j].offset = offset;
+        index->num_of_entry++;
+
+        if (desc->ctype == OGS_TLV_MORE) {
+            ogs_assert(prev_desc && prev_desc->ctype != OGS_TLV_MORE);
+            offset += prev_desc->vsize * (desc->length - 1);
+        } else {
+            offset += desc->vsize;
+        }
+
+        prev_desc = desc;
+    }
+
+    return index;
+}
+
+static ogs_tlv_desc_index_t *tlv_desc_index(ogs_tlv_desc_t *parent_desc)
+{
+    ogs_tlv_desc_index_t *index = NULL;
+
+    index = __atomic_load_n(&parent_desc->index, __ATOMIC_ACQUIRE);
+    if (ogs_likely(index))
+        return index;
+
+    ogs_thread_mutex_lock(&index_mutex);
+
+    index = parent_desc->index;
+    if (!index) {
+        index = tlv_desc_index_build(parent_desc);
+        if (index) {
+            index->next = index_list;
+            index_list = index;
+            __atomic_store_n(&parent_desc->index, index, __ATOMIC_RELEASE);
+        }
+    }
+
+    ogs_thread_mutex_unlock(&index_mutex);
+
+    return index;
+}
+
+/*
+ * Find the match_type_pos-th descriptor of <match_type,match_instance>.
+ * On success, *group is the position of the first entry with this key,
+ * which is used to count the IEs of the same <type,instance>.
+ */
+static ogs_tlv_desc_t *tlv_find_desc_by_type_inst(
+        ogs_tlv_desc_index_t *index, ogs_tlv_desc_t *parent_desc,
+        uint8_t *desc_index, uint32_t *tlv_offset, int *group,
+        uint16_t match_type, uint8_t match_instance, unsigned match_type_pos)
+{
+    uint32_t key = TLV_INDEX_KEY(match_type, match_instance);
+    int low = 0, high, mid, i;
+
+    ogs_assert(index);
+    ogs_assert(parent_desc);
+
+    /* Lower bound */
+    high = index->num_of_entry;
+    while (low < high) {
+        mid = (low + high) / 2;
+        if (index->entry[mid].key < key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    i = low + match_type_pos;
+    if (i >= index->num_of_entry || index->entry[i].key != key)
+        return NULL;
+
+    *desc_index = index->entry[i].index;
+    *tlv_offset = index->entry[i].offset;
+    if (group)
+        *group = low;
+
+    return parent_desc->child_descs[index->entry[i].index];
+}
+
+/*
+ * Encoding
+ *
+ * The IEs are written directly into the pkbuf. The first pass (buf == NULL)
+ * only calculates the length, and the second one writes the IEs.
+ * The length of a grouped IE is filled in after its children are written.
+ */
+static uint32_t tlv_header_length(uint8_t mode)
+{
+    switch (mode) {
+    case OGS_TLV_MODE_T1_L1:
+        return 2;
+    case OGS_TLV_MODE_T1_L2:
+        return 3;
+    case OGS_TLV_MODE_T1_L2_I1:
+    case OGS_TLV_MODE_T2_L2:
+        return 4;
+    case OGS_TLV_MODE_T1:
+        return 1;
+    default:
+        ogs_assert_if_reached();
+        break;
+    }
+
+    return 0;
+}
+
+static void tlv_put_header(uint8_t *pos, uint8_t mode,
+        uint16_t type, uint32_t length, uint8_t instance)
+{
+    switch (mode) {
+    case OGS_TLV_MODE_T1_L1:
+        *(pos++) = type & 0xff;
+        *(pos++) = length & 0xff;
+        break;
+    case OGS_TLV_MODE_T1_L2:
+        *(pos++) = type & 0xff;
+        *(pos++) = (length >> 8) & 0xff;
+        *(pos++) = length & 0xff;
+        break;
+    case OGS_TLV_MODE_T1_L2_I1:
+        *(pos++) = type & 0xff;
+        *(pos++) = (length >> 8) & 0xff;
+        *(pos++) = length & 0xff;
+        *(pos++) = instance & 0xff;
+        break;
+    case OGS_TLV_MODE_T2_L2:
+        *(pos++) = (type >> 8) & 0xff;
+        *(pos++) = type & 0xff;
+        *(pos++) = (length >> 8) & 0xff;
+        *(pos++) = length & 0xff;
+        break;
+    case OGS_TLV_MODE_T1:
+        *(pos++) = type & 0xff;
+        break;
+    default:
+        ogs_assert_if_reached();
+        break;
+    }
+}
+
+static int tlv_encode_leaf(uint8_t *buf, uint32_t *length,
+        ogs_tlv_desc_t *desc, void *msg, uint8_t msg_mode)
 {
     uint8_t tlv_mode = tlv_ctype2mode(desc->ctype, msg_mode);
+    uint32_t hlen = tlv_header_length(tlv_mode);
+    uint32_t vlen = 0;
+    uint8_t *pos = buf ? buf + hlen : NULL;
 
     switch (desc->ctype) {
     case OGS_TLV_UINT8:
@@ -107,21 +322,10 @@ static ogs_tlv_t *tlv_add_leaf(
     case OGS_TV_INT8:
     {
         ogs_tlv_uint8_t *v = (ogs_tlv_uint8_t *)msg;
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 1, desc->instance, &v->u8);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 1, desc->instance, &v->u8);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+
+        vlen = 1;
+        if (pos)
+            pos[0] = v->u8;
         break;
     }
     case OGS_TLV_UINT16:
@@ -131,22 +335,10 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_uint16_t *v = (ogs_tlv_uint16_t *)msg;
 
-        v->u16 = htobe16(v->u16);
-
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 2, desc->instance, &v->u16);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 2, desc->instance, &v->u16);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
+        vlen = 2;
+        if (pos) {
+            pos[0] = (v->u16 >> 8) & 0xff;
+            pos[1] = v->u16 & 0xff;
         }
         break;
     }
@@ -157,23 +349,11 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_uint24_t *v = (ogs_tlv_uint24_t *)msg;
 
-        v->u24 = v->u24 << 8;
-        v->u24 = htobe32(v->u24);
-
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 3, desc->instance, &v->u24);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 3, desc->instance, &v->u24);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
+        vlen = 3;
+        if (pos) {
+            pos[0] = (v->u24 >> 16) & 0xff;
+            pos[1] = (v->u24 >> 8) & 0xff;
+            pos[2] = v->u24 & 0xff;
         }
         break;
     }
@@ -184,22 +364,12 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_uint32_t *v = (ogs_tlv_uint32_t *)msg;
 
-        v->u32 = htobe32(v->u32);
-
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 4, desc->instance, &v->u32);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 4, desc->instance, &v->u32);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
+        vlen = 4;
+        if (pos) {
+            pos[0] = (v->u32 >> 24) & 0xff;
+            pos[1] = (v->u32 >> 16) & 0xff;
+            pos[2] = (v->u32 >> 8) & 0xff;
+            pos[3] = v->u32 & 0xff;
         }
         break;
     }
@@ -208,21 +378,9 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_octet_t *v = (ogs_tlv_octet_t *)msg;
 
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, desc->length, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, desc->length, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+        vlen = desc->length;
+        if (pos && vlen)
+            memcpy(pos, v->data, vlen);
         break;
     }
     case OGS_TLV_VAR_STR:
@@ -232,74 +390,99 @@ static ogs_tlv_t *tlv_add_leaf(
         if (v->len == 0) {
             ogs_error("No TLV length - [%s] T:%d I:%d (vsz=%d)",
                     desc->name, desc->type, desc->instance, desc->vsize);
-            return NULL;
+            return OGS_ERROR;
         }
 
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, v->len, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, v->len, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
+        vlen = v->len;
+        if (pos)
+            memcpy(pos, v->data, vlen);
         break;
     }
     case OGS_TLV_NULL:
     case OGS_TV_NULL:
-    {
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 0, desc->instance, NULL);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 0, desc->instance, NULL);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
         break;
-    }
     default:
         ogs_error("Unknown type [%d]", desc->ctype);
-        return NULL;
+        return OGS_ERROR;
+    }
+
+    if (buf)
+        tlv_put_header(buf, tlv_mode, desc->type, vlen, desc->instance);
+
+    *length = hlen + vlen;
+
+    return OGS_OK;
+}
+
+static int tlv_encode_compound(uint8_t *buf, uint32_t *length,
+        uint32_t *count, ogs_tlv_desc_t *parent_desc, void *msg,
+        int depth, uint8_t mode);
+
+static int tlv_encode_element(uint8_t *buf, uint32_t *length,
+        uint32_t *count, ogs_tlv_desc_t *desc, void *msg,
+        int depth, uint8_t mode, int i, const char *indent)
+{
+    int rv;
+
+    if (desc->ctype == OGS_TLV_COMPOUND) {
+        uint8_t tlv_mode = tlv_ctype2mode(desc->ctype, mode);
+        uint32_t hlen = tlv_header_length(tlv_mode);
+        uint32_t vlen = 0, r = 0;
+
+        ogs_trace("BUILD %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
+                indent, i, desc->name, desc->type, desc->instance,
+                desc->vsize, msg);
+
+        rv = tlv_encode_compound(buf ? buf + hlen : NULL, &vlen, &r,
+                desc, (uint8_t *)msg + sizeof(ogs_tlv_presence_t),
+                depth + 1, mode);
+        if (rv != OGS_OK || r == 0) {
+            ogs_error("tlv_encode_compound() failed");
+            return OGS_ERROR;
+        }
+
+        if (buf)
+            tlv_put_header(buf, tlv_mode, desc->type, vlen, desc->instance);
+
+        *length = hlen + vlen;
+        *count += 1 + r;
+    } else {
+        ogs_trace("BUILD %sL#%d [%s] T:%d L:%d I:%d "
+                "(cls:%d vsz:%d) off:%p ",
+                indent, i, desc->name, desc->type, desc->length,
+                desc->instance, desc->ctype, desc->vsize, msg);
+
+        rv = tlv_encode_leaf(buf, length, desc, msg, mode);
+        if (rv != OGS_OK) {
+            ogs_error("tlv_encode_leaf() failed");
+            return OGS_ERROR;
+        }
+
+        *count += 1;
     }
 
-    return tlv;
+    return OGS_OK;
 }
 
-static uint32_t tlv_add_compound(ogs_tlv_t **root, ogs_tlv_t *parent_tlv,
-        ogs_tlv_desc_t *parent_desc, void *msg, int depth, uint8_t mode)
+static int tlv_encode_compound(uint8_t *buf, uint32_t *length,
+        uint32_t *count, ogs_tlv_desc_t *parent_desc, void *msg,
+        int depth, uint8_t mode)
 {
     ogs_tlv_presence_t *presence_p;
     ogs_tlv_desc_t *desc = NULL, *next_desc = NULL;
-    ogs_tlv_t *tlv = NULL, *emb_tlv = NULL;
     uint8_t *p = msg;
-    uint32_t offset = 0, count = 0;
-    int i, j, r;
+    uint32_t offset = 0, total = 0, elen;
+    int i, j, rv;
     char indent[17] = "                "; /* 16 spaces */
 
-    ogs_assert(root);
+    ogs_assert(length);
+    ogs_assert(count);
     ogs_assert(parent_desc);
     ogs_assert(msg);
 
     ogs_assert(depth <= 8);
     indent[depth*2] = 0;
 
-    *root = NULL;
-
     for (i = 0, desc = parent_desc->child_descs[i]; desc != NULL;
             i++, desc = parent_desc->child_descs[i]) {
         next_desc = parent_desc->child_descs[i+1];
@@ -311,46 +494,11 @@ static uint32_t tlv_add_compound(ogs_tlv_t **root, ogs_tlv_t *parent_tlv,
                 if (*presence_p == 0)
                     break;
 
-                if (desc->ctype == OGS_TLV_COMPOUND) {
-                    ogs_trace("BUILD %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->instance,
-                            desc->vsize, p + offset2);
-
-                    if (parent_tlv)
-                        tlv = ogs_tlv_embed(parent_tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-                    else
-                        tlv = ogs_tlv_add(tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-
-                    r = tlv_add_compound(&emb_tlv, tlv, desc,
-                            p + offset2 + sizeof(ogs_tlv_presence_t),
-                            depth + 1, mode);
-                    if (r <= 0 || !emb_tlv) {
-                        ogs_error("tlv_add_compound() failed");
-                        return 0;
-                    }
-                    count += 1 + r;
-                } else {
-                    ogs_trace("BUILD %sL#%d [%s] T:%d L:%d I:%d "
-                            "(cls:%d vsz:%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->length,
-                            desc->instance, desc->ctype, desc->vsize,
-                            p + offset2);
-
-                    tlv = tlv_add_leaf(parent_tlv, tlv, desc,
-                            p + offset2, mode);
-                    if (!tlv) {
-                        ogs_error("tlv_add_leaf() failed");
-                        return 0;
-                    }
-                    count++;
-                }
-
-                if (*root == NULL)
-                    *root = tlv;
+                rv = tlv_encode_element(buf ? buf + total : NULL, &elen,
+                        count, desc, p + offset2, depth, mode, i, indent);
+                if (rv != OGS_OK)
+                    return OGS_ERROR;
+                total += elen;
 
                 offset2 += desc->vsize;
             }
@@ -360,58 +508,26 @@ static uint32_t tlv_add_compound(ogs_tlv_t **root, ogs_tlv_t *parent_tlv,
             presence_p = (ogs_tlv_presence_t *)(p + offset);
 
             if (*presence_p) {
-                if (desc->ctype == OGS_TLV_COMPOUND) {
-                    ogs_trace("BUILD %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->instance,
-                            desc->vsize, p + offset);
-
-                    if (parent_tlv)
-                        tlv = ogs_tlv_embed(parent_tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-                    else
-                        tlv = ogs_tlv_add(tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-
-                    r = tlv_add_compound(&emb_tlv, tlv, desc,
-                            p + offset + sizeof(ogs_tlv_presence_t),
-                            depth + 1, mode);
-                    if (r <= 0 || !emb_tlv) {
-                        ogs_error("tlv_add_compound() failed");
-                        return 0;
-                    }
-                    count += 1 + r;
-                } else {
-                    ogs_trace("BUILD %sL#%d [%s] T:%d L:%d I:%d "
-                            "(cls:%d vsz:%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->length,
-                            desc->instance, desc->ctype, desc->vsize,
-                            p + offset);
-
-                    tlv = tlv_add_leaf(parent_tlv, tlv, desc, p + offset, mode);
-                    if (!tlv) {
-                        ogs_error("tlv_add_leaf() failed");
-                        return 0;
-                    }
-                    count++;
-                }
-
-                if (*root == NULL)
-                    *root = tlv;
+                rv = tlv_encode_element(buf ? buf + total : NULL, &elen,
+                        count, desc, p + offset, depth, mode, i, indent);
+                if (rv != OGS_OK)
+                    return OGS_ERROR;
+                total += elen;
             }
             offset += desc->vsize;
         }
     }
 
-    return count;
+    *length = total;
+
+    return OGS_OK;
 }
 
 ogs_pkbuf_t *ogs_tlv_build_msg(ogs_tlv_desc_t *desc, void *msg, int mode)
 {
-    ogs_tlv_t *root = NULL;
-    uint32_t r, length, rendlen;
+    uint32_t r = 0, length = 0, rendlen = 0;
     ogs_pkbuf_t *pkbuf = NULL;
+    int rv;
 
     ogs_assert(desc);
     ogs_assert(msg);
@@ -419,16 +535,13 @@ ogs_pkbuf_t *ogs_tlv_build_msg(ogs_tlv_desc_t *desc, void *msg, int mode)
     ogs_assert(desc->ctype == OGS_TLV_MESSAGE);
 
     if (desc->child_descs[0]) {
-        r = tlv_add_compound(&root, NULL, desc, msg, 0, mode);
-        if (r <= 0 || !root) {
-            ogs_error("tlv_add_compound() failed");
+        rv = tlv_encode_compound(NULL, &length, &r, desc, msg, 0, mode);
+        if (rv != OGS_OK || r == 0) {
+            ogs_error("tlv_encode_compound() failed");
             return NULL;
         }
-
-        length = ogs_tlv_calc_length(root);
-    } else {
-        length = 0;
     }
+
     pkbuf = ogs_pkbuf_alloc(NULL, OGS_TLV_MAX_HEADROOM+length);
     if (!pkbuf) {
         ogs_error("ogs_pkbuf_alloc() failed");
@@ -438,52 +551,25 @@ ogs_pkbuf_t *ogs_tlv_build_msg(ogs_tlv_desc_t *desc, void *msg, int mode)
     ogs_pkbuf_put(pkbuf, length);
 
     if (desc->child_descs[0]) {
-        rendlen = ogs_tlv_render(root, pkbuf->data, length);
-        if (rendlen != length) {
-            ogs_error("ogs_tlv_render[rendlen:%d != length:%d] failed",
+        r = 0;
+        rv = tlv_encode_compound(pkbuf->data, &rendlen, &r, desc, msg, 0, mode);
+        if (rv != OGS_OK || rendlen != length) {
+            ogs_error("tlv_encode_compound[rendlen:%d != length:%d] failed",
                     rendlen, length);
+            ogs_pkbuf_free(pkbuf);
             return NULL;
         }
-
-        ogs_tlv_free_all(root);
     }
 
     return pkbuf;
 }
 
-static ogs_tlv_desc_t* tlv_find_desc_by_type_inst(uint8_t *desc_index,
-        uint32_t *tlv_offset, ogs_tlv_desc_t *parent_desc, uint16_t match_type, uint8_t match_instance, uint8_t match_type_pos)
-{
-    ogs_tlv_desc_t *prev_desc = NULL, *desc = NULL;
-    int i, offset = 0;
-    unsigned match_i = 0;
-
-    ogs_assert(parent_desc);
-
-    for (i = 0, desc = parent_desc->child_descs[i]; desc != NULL;
-            i++, desc = parent_desc->child_descs[i]) {
-        if (desc->type == match_type && desc->instance == match_instance) {
-            if (match_i == match_type_pos) {
-                *desc_index = i;
-                *tlv_offset = offset;
-                break;
-            }
-            match_i++;
-        }
-
-        if (desc->ctype == OGS_TLV_MORE) {
-            ogs_assert(prev_desc && prev_desc->ctype != OGS_TLV_MORE);
-            offset += prev_desc->vsize * (desc->length - 1);
-        } else {
-            offset += desc->vsize;
-        }
-
-        prev_desc = desc;
-    }
-
-    return desc;
-}
-
+/*
+ * Decoding
+ *
+ * The IEs are parsed directly from the pkbuf into the message structure
+ * without building an intermediate ogs_tlv_t list.
+ */
 static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_t *tlv)
 {
     ogs_assert(msg);
@@ -594,179 +680,6 @@ static int tlv_parse_leaf(void *msg, ogs_tlv_desc_t *desc, ogs_tlv_t *tlv)
     return OGS_OK;
 }
 
-/* rbtree structure used to keep track count of TLVs with given <type,instance>
- * while parsing. This is used to link it to the matching nth field in a
- * ogs_tlv_desc_t struct */
-typedef struct tlv_count_node_s {
-    ogs_rbnode_t node;
-    uint32_t key; /* type<<8 + instance */
-    unsigned count;
-} tlv_count_node_t;
-
-static tlv_count_node_t *tlv_count_node_find(ogs_rbtree_t *tree, tlv_count_node_t *count_node_arr, unsigned count_node_arr_len,
-        unsigned *count_alloc_next, uint16_t type, uint8_t instance)
-{
-    ogs_rbnode_t **new = NULL;
-    ogs_rbnode_t *parent = NULL;
-    tlv_count_node_t *this;
-
-    uint64_t key = (((uint32_t)type)<<8) | instance;
-
-    new = &tree->root;
-    while (*new) {
-        this = ogs_rb_entry(*new, tlv_count_node_t, node);
-        parent = *new;
-        if (key < this->key) {
-            new = &(*new)->left;
-        } else if (key > this->key) {
-            new = &(*new)->right;
-        } else { /* found entry: */
-            return this;
-        }
-    }
-
-    /* No entry, need to add one: */
-    if (*count_alloc_next == count_node_arr_len) {
-        ogs_error("This TLV has to many entries, can't parse");
-        return NULL;
-    }
-    this = &count_node_arr[(*count_alloc_next)++];
-    this->key = key;
-    this->count = 0;
-    ogs_rbtree_link_node(&this->node, parent, new);
-    ogs_rbtree_insert_color(tree, &this->node);
-    return this;
-}
-
-static int tlv_parse_compound(void *msg, ogs_tlv_desc_t *parent_desc,
-        ogs_tlv_t *parent_tlv, int depth, int mode)
-{
-    int rv;
-    ogs_tlv_presence_t *presence_p = (ogs_tlv_presence_t *)msg;
-    ogs_tlv_desc_t *desc = NULL, *next_desc = NULL;
-    ogs_tlv_t *tlv = NULL, *emb_tlv = NULL;
-    uint8_t *p = msg;
-    uint32_t offset = 0;
-    uint8_t index = 0;
-    int i = 0, j;
-    OGS_RBTREE(tree);
-    tlv_count_node_t count_node[OGS_TLV_MAX_CHILD_DESC];
-    unsigned count_node_alloc_next = 0;
-    char indent[17] = "                "; /* 16 spaces */
-
-    ogs_assert(msg);
-    ogs_assert(parent_desc);
-    ogs_assert(parent_tlv);
-
-    ogs_assert(depth <= 8);
-    indent[depth*2] = 0;
-
-    tlv = parent_tlv;
-    while (tlv) {
-        tlv_count_node_t *curr_count = tlv_count_node_find(&tree, &count_node[0],
-                OGS_ARRAY_SIZE(count_node), &count_node_alloc_next, tlv->type, tlv->instance);
-        if (!curr_count)
-            return OGS_ERROR;
-        desc = tlv_find_desc_by_type_inst(&index, &offset, parent_desc, tlv->type, tlv->instance, curr_count->count);
-        if (desc == NULL) {
-            ogs_warn("Unknown TLV type [%d]", tlv->type);
-            tlv = tlv->next;
-            continue;
-        }
-
-        presence_p = (ogs_tlv_presence_t *)(p + offset);
-
-        /* Multiple of the same type TLV may be included */
-        next_desc = parent_desc->child_descs[index+1];
-        if (next_desc != NULL && next_desc->ctype == OGS_TLV_MORE) {
-            for (j = 0; j < next_desc->length; j++) {
-                presence_p =
-                    (ogs_tlv_presence_t *)(p + offset + desc->vsize * j);
-                if (*presence_p == 0) {
-                    offset += desc->vsize * j;
-                    break;
-                }
-            }
-            if (j == next_desc->length) {
-                ogs_fatal("Multiple of the same type TLV need more room");
-                tlv = tlv->next;
-                continue;
-            }
-        } else {
-            curr_count->count++;
-        }
-
-        if (desc->ctype == OGS_TLV_COMPOUND) {
-            emb_tlv = ogs_tlv_parse_embedded_block(tlv, mode);
-            if (emb_tlv == NULL) {
-                ogs_error("Error while parse TLV");
-                return OGS_ERROR;
-            }
-
-            ogs_trace("PARSE %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
-                    indent, i++, desc->name, desc->type, desc->instance,
-                    desc->vsize, p + offset);
-
-            offset += sizeof(ogs_tlv_presence_t);
-
-            rv = tlv_parse_compound(
-                    p + offset, desc, emb_tlv, depth + 1, mode);
-            if (rv != OGS_OK) {
-                ogs_error("Can't parse compound TLV");
-                return OGS_ERROR;
-            }
-
-            *presence_p = 1;
-        } else {
-            ogs_trace("PARSE %sL#%d [%s] T:%d L:%d I:%d "
-                    "(cls:%d vsz:%d) off:%p ",
-                    indent, i++, desc->name, desc->type, desc->length,
-                    desc->instance, desc->ctype, desc->vsize, p + offset);
-
-            rv = tlv_parse_leaf(p + offset, desc, tlv);
-            if (rv != OGS_OK) {
-                ogs_error("Can't parse leaf TLV");
-                return OGS_ERROR;
-            }
-
-            *presence_p = 1;
-        }
-
-        tlv = tlv->next;
-    }
-
-    return OGS_OK;
-}
-
-int ogs_tlv_parse_msg(void *msg, ogs_tlv_desc_t *desc, ogs_pkbuf_t *pkbuf,
-        int mode)
-{
-    int rv;
-    ogs_tlv_t *root;
-
-    ogs_assert(msg);
-    ogs_assert(desc);
-    ogs_assert(pkbuf);
-
-    ogs_assert(desc->ctype == OGS_TLV_MESSAGE);
-    if (!desc->child_descs[0]) {
-        ogs_fatal("No Child Descs in [%s]", desc->name);
-        ogs_assert_if_reached();
-    }
-
-    root = ogs_tlv_parse_block(pkbuf->len, pkbuf->data, mode);
-    if (root == NULL) {
-        ogs_error("Can't parse TLV message");
-        return OGS_ERROR;
-    }
-
-    rv = tlv_parse_compound(msg, desc, root, 0, mode);
-
-    ogs_tlv_free_all(root);
-
-    return rv;
-}
-
 static uint16_t parse_get_element_type(uint8_t *pos, uint8_t mode)
 {
     uint16_t type;
@@ -793,7 +706,8 @@ static uint16_t parse_get_element_type(uint8_t *pos, uint8_t mode)
 /* Get TLV element taking into account msg_mode (to know TLV tag length) +
  * specific TLV information from "desc" (to know whether the specific IE is TLV
  * or TV, and its expected length in the later case). */
-static uint8_t *tlv_get_element_desc(ogs_tlv_t *tlv, uint8_t *blk, uint8_t msg_mode, ogs_tlv_desc_t *desc)
+static uint8_t *tlv_get_element_desc(ogs_tlv_t *tlv, uint8_t *blk,
+        uint32_t remain, uint8_t msg_mode, ogs_tlv_desc_t *desc)
 {
     uint8_t instance;
     unsigned tlv_tag_pos;
@@ -801,86 +715,207 @@ static uint8_t *tlv_get_element_desc(ogs_tlv_t *tlv, uint8_t *blk, uint8_t msg_m
     uint32_t tlv_offset = 0;
     uint16_t tlv_tag;
     uint8_t tlv_mode;
-    static ogs_tlv_desc_t* tlv_desc;
+    ogs_tlv_desc_t *tlv_desc;
+    ogs_tlv_desc_index_t *index;
+
+    if (remain < tlv_header_length(msg_mode == OGS_TLV_MODE_T2_L2 ?
+                OGS_TLV_MODE_T2_L2 : OGS_TLV_MODE_T1))
+        return NULL;
+
+    index = tlv_desc_index(desc);
+    if (!index)
+        return NULL;
 
     tlv_tag = parse_get_element_type(blk, msg_mode);
     instance = 0;  /* TODO: support instance != 0 if ever really needed by looking it up in pos */
     tlv_tag_pos = 0; /* All tags with same instance should use the same tlv_desc, so take the first one */
-    tlv_desc = tlv_find_desc_by_type_inst(&desc_index, &tlv_offset, desc, tlv_tag, instance, tlv_tag_pos);
+    tlv_desc = tlv_find_desc_by_type_inst(index, desc, &desc_index,
+            &tlv_offset, NULL, tlv_tag, instance, tlv_tag_pos);
     if (!tlv_desc) {
         ogs_error("Can't parse find TLV description for type %u", tlv_tag);
         return NULL;
     }
     tlv_mode = tlv_ctype2mode(tlv_desc->ctype, msg_mode);
 
+    if (remain < tlv_header_length(tlv_mode))
+        return NULL;
+
     if (tlv_mode == OGS_TLV_MODE_T1)
         return tlv_get_element_fixed(tlv, blk, tlv_mode, tlv_desc->length);
     return tlv_get_element(tlv, blk, tlv_mode);
 }
 
-/* Similar to ogs_tlv_parse_block(), but taking into account each TLV format from "desc". */
-static ogs_tlv_t *ogs_tlv_parse_block_desc(uint32_t length, void *data, uint8_t msg_mode, ogs_tlv_desc_t *desc)
+static int tlv_parse_element(void *msg, ogs_tlv_desc_t *parent_desc,
+        ogs_tlv_desc_index_t *index, uint8_t *count, ogs_tlv_t *tlv,
+        int depth, int mode, int *i, const char *indent);
+
+/* Parse a block of IEs of parent_desc. If by_desc is true,
+ * the format of each IE is taken from its description (e.g. GTPv1-C) */
+static int tlv_parse_block(void *msg, ogs_tlv_desc_t *parent_desc,
+        uint8_t *blk, uint32_t length, int depth, uint8_t mode, bool by_desc)
 {
-    uint8_t *pos = data;
-    uint8_t *blk = data;
-
-    ogs_tlv_t *root = NULL;
-    ogs_tlv_t *prev = NULL;
-    ogs_tlv_t *curr = NULL;
-
-    root = curr = ogs_tlv_get();
-    if (!curr) {
-        ogs_error("ogs_tlv_parse_block() failed[LEN:%d,MODE:%d] - no tlv",
-                length, msg_mode);
-        ogs_log_hexdump(OGS_LOG_ERROR, data, ogs_min(length, 512));
-        return NULL;
+    ogs_tlv_desc_index_t *index = NULL;
+    uint8_t count[OGS_TLV_MAX_CHILD_DESC];
+    uint8_t *pos = blk, *next = NULL;
+    ogs_tlv_t tlv;
+    int i = 0;
+    char indent[17] = "                "; /* 16 spaces */
+
+    ogs_assert(msg);
+    ogs_assert(parent_desc);
+
+    ogs_assert(depth <= 8);
+    indent[depth*2] = 0;
+
+    index = tlv_desc_index(parent_desc);
+    if (!index) {
+        ogs_error("tlv_desc_index() failed");
+        return OGS_ERROR;
     }
 
-    pos = tlv_get_element_desc(curr, pos, msg_mode, desc);
-    if (!pos) {
-        ogs_error("ogs_tlv_parse_block() failed[LEN:%u,MODE:%u] - parse error",
-                length, msg_mode);
-        ogs_log_hexdump(OGS_LOG_ERROR, data, ogs_min(length, 512));
-        ogs_tlv_free_all(root);
-        return NULL;
+    memset(count, 0, sizeof(count));
+
+    /* An empty block was never accepted by ogs_tlv_parse_block() */
+    if (length == 0) {
+        ogs_error("tlv_parse_block() failed[LEN:%d,MODE:%d]", length, mode);
+        return OGS_ERROR;
     }
 
-    while(pos - blk < length) {
-        prev = curr;
+    while (pos - blk < length) {
+        uint32_t remain = length - (pos - blk);
 
-        curr = ogs_tlv_get();
-        if (!curr) {
-            ogs_error("ogs_tlv_parse_block() failed[LEN:%d,MODE:%d]",
-                    length, msg_mode);
-            ogs_log_hexdump(OGS_LOG_ERROR, data, ogs_min(length, 512));
+        memset(&tlv, 0, sizeof(tlv));
 
-            ogs_tlv_free_all(root);
-            return NULL;
+        if (by_desc == true) {
+            next = tlv_get_element_desc(&tlv, pos, remain, mode, parent_desc);
+        } else if (remain >= tlv_header_length(mode)) {
+            next = tlv_get_element(&tlv, pos, mode);
+        } else {
+            next = NULL;
         }
-        prev->next = curr;
 
-        pos = tlv_get_element_desc(curr, pos, msg_mode, desc);
-        if (!pos) {
-            ogs_error("ogs_tlv_parse_block() failed[LEN:%d,MODE:%d]",
-                    length, msg_mode);
-            ogs_log_hexdump(OGS_LOG_ERROR, data, ogs_min(length, 512));
+        if (!next || next - blk > length) {
+            ogs_error("tlv_parse_block() failed[LEN:%d,MODE:%d]",
+                    length, mode);
+            ogs_error("POS[%p] BLK[%p] POS-BLK[%d]",
+                    pos, blk, (int)(pos - blk));
+/*
+ * Limit hexdump size to avoid excessive logging when handling malformed
+ * or intentionally crafted messages. This prevents log flooding and
+ * secondary DoS effects while still providing enough data for debugging.
+ */
+            ogs_log_hexdump(OGS_LOG_ERROR, blk, ogs_min(length, 512));
+            return OGS_ERROR;
+        }
 
-            ogs_tlv_free_all(root);
-            return NULL;
+        if (tlv_parse_element(msg, parent_desc, index, count, &tlv,
+                    depth, mode, &i, indent) != OGS_OK)
+            return OGS_ERROR;
+
+        pos = next;
+    }
+
+    return OGS_OK;
+}
+
+static int tlv_parse_element(void *msg, ogs_tlv_desc_t *parent_desc,
+        ogs_tlv_desc_index_t *index, uint8_t *count, ogs_tlv_t *tlv,
+        int depth, int mode, int *i, const char *indent)
+{
+    int rv;
+    ogs_tlv_presence_t *presence_p = NULL;
+    ogs_tlv_desc_t *desc = NULL, *next_desc = NULL;
+    uint8_t *p = msg;
+    uint32_t offset = 0;
+    uint8_t desc_index = 0;
+    int group = 0, j;
+
+    desc = tlv_find_desc_by_type_inst(index, parent_desc, &desc_index,
+            &offset, &group, tlv->type, tlv->instance, 0);
+    if (desc) {
+        /* Use the next descriptor for each repeated <type,instance> */
+        desc = tlv_find_desc_by_type_inst(index, parent_desc, &desc_index,
+                &offset, &group, tlv->type, tlv->instance, count[group]);
+    }
+    if (desc == NULL) {
+        ogs_warn("Unknown TLV type [%d]", tlv->type);
+        return OGS_OK;
+    }
+
+    presence_p = (ogs_tlv_presence_t *)(p + offset);
+
+    /* Multiple of the same type TLV may be included */
+    next_desc = parent_desc->child_descs[desc_index+1];
+    if (next_desc != NULL && next_desc->ctype == OGS_TLV_MORE) {
+        for (j = 0; j < next_desc->length; j++) {
+            presence_p =
+                (ogs_tlv_presence_t *)(p + offset + desc->vsize * j);
+            if (*presence_p == 0) {
+                offset += desc->vsize * j;
+                break;
+            }
         }
+        if (j == next_desc->length) {
+            ogs_fatal("Multiple of the same type TLV need more room");
+            return OGS_OK;
+        }
+    } else {
+        count[group]++;
     }
 
-    if (length != (pos - blk)) {
-        ogs_error("ogs_tlv_parse_block() failed[LEN:%d,MODE:%d]",
-                length, msg_mode);
-        ogs_error("POS[%p] BLK[%p] POS-BLK[%d]", pos, blk, (int)(pos - blk));
-        ogs_log_hexdump(OGS_LOG_ERROR, data, ogs_min(length, 512));
+    if (desc->ctype == OGS_TLV_COMPOUND) {
+        ogs_trace("PARSE %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
+                indent, (*i)++, desc->name, desc->type, desc->instance,
+                desc->vsize, p + offset);
 
-        ogs_tlv_free_all(root);
-        return NULL;
+        offset += sizeof(ogs_tlv_presence_t);
+
+        rv = tlv_parse_block(p + offset, desc,
+                tlv->value, tlv->length, depth + 1, mode, false);
+        if (rv != OGS_OK) {
+            ogs_error("Can't parse compound TLV");
+            return OGS_ERROR;
+        }
+
+        *presence_p = 1;
+    } else {
+        ogs_trace("PARSE %sL#%d [%s] T:%d L:%d I:%d "
+                "(cls:%d vsz:%d) off:%p ",
+                indent, (*i)++, desc->name, desc->type, desc->length,
+                desc->instance, desc->ctype, desc->vsize, p + offset);
+
+        rv = tlv_parse_leaf(p + offset, desc, tlv);
+        if (rv != OGS_OK) {
+            ogs_error("Can't parse leaf TLV");
+            return OGS_ERROR;
+        }
+
+        *presence_p = 1;
+    }
+
+    return OGS_OK;
+}
+
+int ogs_tlv_parse_msg(void *msg, ogs_tlv_desc_t *desc, ogs_pkbuf_t *pkbuf,
+        int mode)
+{
+    int rv;
+
+    ogs_assert(msg);
+    ogs_assert(desc);
+    ogs_assert(pkbuf);
+
+    ogs_assert(desc->ctype == OGS_TLV_MESSAGE);
+    if (!desc->child_descs[0]) {
+        ogs_fatal("No Child Descs in [%s]", desc->name);
+        ogs_assert_if_reached();
     }
 
-    return root;
+    rv = tlv_parse_block(msg, desc, pkbuf->data, pkbuf->len, 0, mode, false);
+    if (rv != OGS_OK)
+        ogs_error("Can't parse TLV message");
+
+    return rv;
 }
 
 /* Similar to ogs_tlv_parse_msg(), but takes each TLV type from the desc
@@ -890,7 +925,6 @@ int ogs_tlv_parse_msg_desc(
         void *msg, ogs_tlv_desc_t *desc, ogs_pkbuf_t *pkbuf, int msg_mode)
 {
     int rv;
-    ogs_tlv_t *root;
 
     ogs_assert(msg);
     ogs_assert(desc);
@@ -899,15 +933,10 @@ int ogs_tlv_parse_msg_desc(
     ogs_assert(desc->ctype == OGS_TLV_MESSAGE);
     ogs_assert(desc->child_descs[0]);
 
-    root = ogs_tlv_parse_block_desc(pkbuf->len, pkbuf->data, msg_mode, desc);
-    if (root == NULL) {
+    rv = tlv_parse_block(msg, desc,
+            pkbuf->data, pkbuf->len, 0, msg_mode, true);
+    if (rv != OGS_OK)
         ogs_error("Can't parse TLV message");
-        return OGS_ERROR;
-    }
-
-    rv = tlv_parse_compound(msg, desc, root, 0, msg_mode);
-
-    ogs_tlv_free_all(root);
 
     return rv;
 }
@@ -73,6 +73,9 @@ typedef struct ogs_tlv_desc_s {
     uint8_t  instance;
     uint16_t vsize;
     void *child_descs[OGS_TLV_MAX_CHILD_DESC];
+
+    /* Built on first use by the codec. Leave it out of the initializers */
+    struct ogs_tlv_desc_index_s *index;
 } ogs_tlv_desc_t;
 
 extern ogs_tlv_desc_t ogs_tlv_desc_more1;
@@ -176,6 +179,9 @@ typedef struct ogs_tlv_null_s {
     ogs_tlv_presence_t presence;
 } ogs_tlv_null_t;
 
+void ogs_tlv_msg_init(void);
+void ogs_tlv_msg_final(void);
+
 ogs_pkbuf_t *ogs_tlv_build_msg(ogs_tlv_desc_t *desc, void *msg, int mode);
 int ogs_tlv_parse_msg(
         void *msg, ogs_tlv_desc_t *desc, ogs_pkbuf_t *pkbuf, int mode);
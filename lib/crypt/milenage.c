@@ -27,15 +27,10 @@ static void ShiftBits(uint8_t r, uint8_t rijndaelInput[16],
 static uint8_t *bits_shift(uint32_t bit_valid, uint8_t *dst,
                             uint8_t *src, uint32_t numBits);
 
-static int aes_128_encrypt_block(const uint8_t *key,
+static int aes_128_encrypt_block(const ogs_aes_key_t *key,
     const uint8_t *in, uint8_t *out)
 {
-    const int key_bits = 128;
-    unsigned int rk[OGS_AES_RKLENGTH(128)];
-    int nrounds;
-
-    nrounds = ogs_aes_setup_enc(rk, key, key_bits);
-    ogs_aes_encrypt(rk, nrounds, in, out);
+    ogs_aes_encrypt(key->rk, key->nrounds, in, out);
 
     return 0;
 }
@@ -60,10 +55,14 @@ int milenage_f1(const uint8_t *opc, const uint8_t *k,
 #if 1 /* R1-R5 issues1153 */
     uint8_t r1 = 64;
 #endif
+    ogs_aes_key_t aes_key;
+
+    /* Both E_K() below use the same expanded key */
+    ogs_aes_set_encrypt_key(&aes_key, k, 128);
 
 	for (i = 0; i < 16; i++)
 		tmp1[i] = _rand[i] ^ opc[i];
-	if (aes_128_encrypt_block(k, tmp1, tmp1))
+	if (aes_128_encrypt_block(&aes_key, tmp1, tmp1))
 		return -1;
 
 	/* tmp2 = IN1 = SQN || AMF || SQN || AMF */
@@ -86,7 +85,7 @@ int milenage_f1(const uint8_t *opc, const uint8_t *k,
 	/* XOR with c1 (= ..00, i.e., NOP) */
 
 	/* f1 || f1* = E_K(tmp3) XOR OP_c */
-	if (aes_128_encrypt_block(k, tmp3, tmp1))
+	if (aes_128_encrypt_block(&aes_key, tmp3, tmp1))
 		return -1;
 	for (i = 0; i < 16; i++)
 		tmp1[i] ^= opc[i];
@@ -123,11 +122,15 @@ int milenage_f2345(const uint8_t *opc, const uint8_t *k,
     uint8_t r4 = 64;
     uint8_t r5 = 96;
 #endif
+    ogs_aes_key_t aes_key;
+
+    /* Up to five E_K() below use the same expanded key */
+    ogs_aes_set_encrypt_key(&aes_key, k, 128);
 
 	/* tmp2 = TEMP = E_K(RAND XOR OP_C) */
 	for (i = 0; i < 16; i++)
 		tmp1[i] = _rand[i] ^ opc[i];
-	if (aes_128_encrypt_block(k, tmp1, tmp2))
+	if (aes_128_encrypt_block(&aes_key, tmp1, tmp2))
 		return -1;
 
 	/* OUT2 = E_K(rot(TEMP XOR OP_C, r2) XOR c2) XOR OP_C */
@@ -145,7 +148,7 @@ int milenage_f2345(const uint8_t *opc, const uint8_t *k,
 #endif
 	tmp1[15] ^= 1; /* XOR c2 (= ..01) */
 	/* f5 || f2 = E_K(tmp1) XOR OP_c */
-	if (aes_128_encrypt_block(k, tmp1, tmp3))
+	if (aes_128_encrypt_block(&aes_key, tmp1, tmp3))
 		return -1;
 	for (i = 0; i < 16; i++)
 		tmp3[i] ^= opc[i];
@@ -164,7 +167,7 @@ int milenage_f2345(const uint8_t *opc, const uint8_t *k,
         ShiftBits(r3, tmp1, tmp2, opc);
 #endif
 		tmp1[15] ^= 2; /* XOR c3 (= ..02) */
-		if (aes_128_encrypt_block(k, tmp1, ck))
+		if (aes_128_encrypt_block(&aes_key, tmp1, ck))
 			return -1;
 		for (i = 0; i < 16; i++)
 			ck[i] ^= opc[i];
@@ -180,7 +183,7 @@ int milenage_f2345(const uint8_t *opc, const uint8_t *k,
         ShiftBits(r4, tmp1, tmp2, opc);
 #endif
 		tmp1[15] ^= 4; /* XOR c4 (= ..04) */
-		if (aes_128_encrypt_block(k, tmp1, ik))
+		if (aes_128_encrypt_block(&aes_key, tmp1, ik))
 			return -1;
 		for (i = 0; i < 16; i++)
 			ik[i] ^= opc[i];
@@ -196,7 +199,7 @@ int milenage_f2345(const uint8_t *opc, const uint8_t *k,
         ShiftBits(r5, tmp1, tmp2, opc);
 #endif
 		tmp1[15] ^= 8; /* XOR c5 (= ..08) */
-		if (aes_128_encrypt_block(k, tmp1, tmp1))
+		if (aes_128_encrypt_block(&aes_key, tmp1, tmp1))
 			return -1;
 		for (i = 0; i < 6; i++)
 			akstar[i] = tmp1[i] ^ opc[i];
@@ -387,8 +390,11 @@ int milenage_check(const uint8_t *opc, const uint8_t *k,
 void milenage_opc(const uint8_t *k, const uint8_t *op,  uint8_t *opc)
 {
     int i;
+    ogs_aes_key_t aes_key;
+
+    ogs_aes_set_encrypt_key(&aes_key, k, 128);
 
-    aes_128_encrypt_block(k,  op, opc);
+    aes_128_encrypt_block(&aes_key,  op, opc);
 
     for (i = 0; i < 16; i++)
     {
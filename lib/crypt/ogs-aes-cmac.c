@@ -58,7 +58,7 @@
     +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
 
 static int _generate_subkey(uint8_t *k1, uint8_t *k2,
-        const uint8_t *key)
+        const ogs_aes_key_t *aes_key)
 {
     uint8_t zero[16] = {
         0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
@@ -69,13 +69,10 @@ static int _generate_subkey(uint8_t *k1, uint8_t *k2,
         0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x87
     };
     uint8_t L[16];
-
-    uint32_t rk[OGS_AES_RKLENGTH(OGS_AES_MAX_KEY_BITS)];
-    int i, nrounds;
+    int i;
 
     /* Step 1.  L := AES-128(K, const_Zero) */
-    nrounds = ogs_aes_setup_enc(rk, key, 128);
-    ogs_aes_encrypt(rk, nrounds, zero, L);
+    ogs_aes_encrypt(aes_key->rk, aes_key->nrounds, zero, L);
 
     /* Step 2.  if MSB(L) is equal to 0 */
     if ((L[0] & 0x80) == 0)
@@ -161,25 +158,52 @@ static int _generate_subkey(uint8_t *k1, uint8_t *k2,
     +   Step 7.  return T;                                              +
     +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
 
+void ogs_aes_cmac_set_key(ogs_aes_cmac_key_t *cmac_key, const uint8_t *key)
+{
+    ogs_assert(cmac_key);
+    ogs_assert(key);
+
+    ogs_aes_set_encrypt_key(&cmac_key->aes, key, 128);
+
+    /* Step 1.  (K1,K2) := Generate_Subkey(K); */
+    _generate_subkey(cmac_key->k1, cmac_key->k2, &cmac_key->aes);
+}
+
 int ogs_aes_cmac_calculate(uint8_t *cmac, const uint8_t *key,
         const uint8_t *msg, const uint32_t len)
+{
+    ogs_aes_cmac_key_t cmac_key;
+
+    ogs_assert(key);
+
+    ogs_aes_cmac_set_key(&cmac_key, key);
+    return ogs_aes_cmac_calculate_with_key(cmac, &cmac_key, msg, len);
+}
+
+int ogs_aes_cmac_calculate_with_key(uint8_t *cmac,
+        const ogs_aes_cmac_key_t *cmac_key,
+        const uint8_t *msg, const uint32_t len)
 {
     uint8_t x[16] = {
         0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
         0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
     };
     uint8_t y[16], m_last[16];
-    uint8_t k1[16], k2[16];
+    const uint8_t *k1, *k2;
     int i, j, n, bs, flag;
-    uint32_t rk[OGS_AES_RKLENGTH(OGS_AES_MAX_KEY_BITS)];
+    const uint32_t *rk;
     int nrounds;
 
     ogs_assert(cmac);
-    ogs_assert(key);
+    ogs_assert(cmac_key);
     ogs_assert(msg);
 
-    /* Step 1.  (K1,K2) := Generate_Subkey(K); */
-    _generate_subkey(k1, k2, key);
+    /* Step 1.  (K1,K2) := Generate_Subkey(K) was done by
+                ogs_aes_cmac_set_key() */
+    k1 = cmac_key->k1;
+    k2 = cmac_key->k2;
+    rk = cmac_key->aes.rk;
+    nrounds = cmac_key->aes.nrounds;
 
     /* Step 2.  n := ceil(len/const_Bsize); */
     n = (len + 15) / OGS_AES_BLOCK_SIZE;
@@ -239,8 +263,6 @@ int ogs_aes_cmac_calculate(uint8_t *cmac, const uint8_t *key,
                 T := AES-128(K,Y);
      */
 
-    nrounds = ogs_aes_setup_enc(rk, key, 128);
-
     for (i = 0; i <= n - 2; i++)
     {
         bs = i * OGS_AES_BLOCK_SIZE;
@@ -257,6 +279,75 @@ int ogs_aes_cmac_calculate(uint8_t *cmac, const uint8_t *key,
     return OGS_OK;
 }
 
+/*
+ * Copies the 'size' octets at 'offset' of 'prefix' || 'msg' into 'block'
+ */
+static void _gather(uint8_t *block, uint32_t offset, int size,
+        const uint8_t *prefix, uint32_t prefix_len, const uint8_t *msg)
+{
+    int i;
+
+    for (i = 0; i < size; i++, offset++)
+        block[i] = offset < prefix_len ?
+            prefix[offset] : msg[offset - prefix_len];
+}
+
+int ogs_aes_cmac_calculate_with_prefix(uint8_t *cmac,
+        const ogs_aes_cmac_key_t *cmac_key,
+        const uint8_t *prefix, const uint32_t prefix_len,
+        const uint8_t *msg, const uint32_t len)
+{
+    uint8_t x[16] = {
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00
+    };
+    uint8_t y[16], block[16];
+    const uint8_t *m;
+    uint32_t total, offset;
+    int i, last;
+
+    ogs_assert(cmac);
+    ogs_assert(cmac_key);
+    ogs_assert(prefix || prefix_len == 0);
+    ogs_assert(msg || len == 0);
+
+    total = prefix_len + len;
+
+    /* Every block but the last one, as in Step 6. */
+    for (offset = 0; total - offset > OGS_AES_BLOCK_SIZE;
+            offset += OGS_AES_BLOCK_SIZE) {
+        if (offset >= prefix_len) {
+            m = msg + (offset - prefix_len);
+        } else {
+            _gather(block, offset, OGS_AES_BLOCK_SIZE, prefix, prefix_len, msg);
+            m = block;
+        }
+
+        for (i = 0; i < 16; i++)
+            y[i] = x[i] ^ m[i];
+        ogs_aes_encrypt(cmac_key->aes.rk, cmac_key->aes.nrounds, y, x);
+    }
+
+    /* M_last of Step 4. */
+    last = total - offset;
+    _gather(block, offset, last, prefix, prefix_len, msg);
+
+    if (last == OGS_AES_BLOCK_SIZE) {
+        for (i = 0; i < 16; i++)
+            y[i] = block[i] ^ cmac_key->k1[i] ^ x[i];
+    } else {
+        block[last] = 0x80;
+        for (i = last + 1; i < OGS_AES_BLOCK_SIZE; i++)
+            block[i] = 0x00;
+
+        for (i = 0; i < 16; i++)
+            y[i] = block[i] ^ cmac_key->k2[i] ^ x[i];
+    }
+    ogs_aes_encrypt(cmac_key->aes.rk, cmac_key->aes.nrounds, y, cmac);
+
+    return OGS_OK;
+}
+
 /*  From RFC 4493
 
     +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -36,6 +36,24 @@
 extern "C" {
 #endif
 
+/*
+ * Expanded key and the K1/K2 subkeys of RFC 4493, which depend
+ * only on the key and so can be kept for the lifetime of the key.
+ */
+typedef struct ogs_aes_cmac_key_s {
+    ogs_aes_key_t aes;
+    uint8_t k1[OGS_AES_BLOCK_SIZE];
+    uint8_t k2[OGS_AES_BLOCK_SIZE];
+} ogs_aes_cmac_key_t;
+
+/**
+ * Expand the 128-bit key and generate the subkeys
+ *
+ * @param cmac_key
+ * @param key
+ */
+void ogs_aes_cmac_set_key(ogs_aes_cmac_key_t *cmac_key, const uint8_t *key);
+
 /**
  * Caculate CMAC value
  *
@@ -49,6 +67,28 @@ extern "C" {
  */
 int ogs_aes_cmac_calculate(uint8_t *cmac, const uint8_t *key,
         const uint8_t *msg, const uint32_t len);
+int ogs_aes_cmac_calculate_with_key(uint8_t *cmac,
+        const ogs_aes_cmac_key_t *cmac_key,
+        const uint8_t *msg, const uint32_t len);
+
+/**
+ * Caculate CMAC value of 'prefix' followed by 'msg'
+ * without copying them into a single buffer
+ *
+ * @param cmac
+ * @param cmac_key
+ * @param prefix
+ * @param prefix_len
+ * @param msg
+ * @param len
+ *
+ * @return OGS_OK
+ *         OGS_ERROR
+ */
+int ogs_aes_cmac_calculate_with_prefix(uint8_t *cmac,
+        const ogs_aes_cmac_key_t *cmac_key,
+        const uint8_t *prefix, const uint32_t prefix_len,
+        const uint8_t *msg, const uint32_t len);
 
 /**
  * Verify CMAC value
@@ -1416,14 +1416,35 @@ static void ctr128_inc_aligned(uint8_t *counter)
     } while (n);
 }
 
+void ogs_aes_set_encrypt_key(ogs_aes_key_t *aes_key,
+        const uint8_t *key, int keybits)
+{
+    ogs_assert(aes_key);
+    ogs_assert(key);
+
+    aes_key->nrounds = ogs_aes_setup_enc(aes_key->rk, key, keybits);
+}
+
 int ogs_aes_ctr128_encrypt(const uint8_t *key,
         uint8_t *ivec, const uint8_t *in, const uint32_t inlen,
         uint8_t *out)
+{
+    ogs_aes_key_t aes_key;
+
+    ogs_assert(key);
+
+    ogs_aes_set_encrypt_key(&aes_key, key, 128);
+    return ogs_aes_ctr128_encrypt_with_key(&aes_key, ivec, in, inlen, out);
+}
+
+int ogs_aes_ctr128_encrypt_with_key(const ogs_aes_key_t *key,
+        uint8_t *ivec, const uint8_t *in, const uint32_t inlen,
+        uint8_t *out)
 {
     uint8_t ecount_buf[16];
     uint32_t len = inlen;
 
-    uint32_t rk[OGS_AES_RKLENGTH(OGS_AES_MAX_KEY_BITS)];
+    const uint32_t *rk;
     int nrounds;
 
     uint32_t n = 0;
@@ -1436,7 +1457,8 @@ int ogs_aes_ctr128_encrypt(const uint8_t *key,
     ogs_assert(out);
 
     memset(ecount_buf, 0, 16);
-    nrounds = ogs_aes_setup_enc(rk, key, 128);
+    rk = key->rk;
+    nrounds = key->nrounds;
 
     while (n && len) 
     {
@@ -43,6 +43,16 @@ extern "C" {
 #define OGS_AES_RKLENGTH(keybits)  ((keybits)/8+28)
 #define OGS_AES_NROUNDS(keybits)   ((keybits)/32+6)
 
+/*
+ * Expanded encryption key. Callers that use one key for many blocks
+ * (e.g. K_NASint/K_NASenc of a NAS security context) keep it around
+ * instead of running the key schedule for every message.
+ */
+typedef struct ogs_aes_key_s {
+    uint32_t rk[OGS_AES_RKLENGTH(OGS_AES_MAX_KEY_BITS)];
+    int nrounds;
+} ogs_aes_key_t;
+
 int ogs_aes_setup_enc(uint32_t *rk, const uint8_t *key, int keybits);
 int ogs_aes_setup_dec(uint32_t *rk, const uint8_t *key, int keybits);
 
@@ -63,6 +73,12 @@ int ogs_aes_cbc_decrypt(const uint8_t *key,
 int ogs_aes_ctr128_encrypt(const uint8_t *key,
         uint8_t *ivec, const uint8_t *in, const uint32_t inlen,
         uint8_t *out);
+int ogs_aes_ctr128_encrypt_with_key(const ogs_aes_key_t *key,
+        uint8_t *ivec, const uint8_t *in, const uint32_t inlen,
+        uint8_t *out);
+
+void ogs_aes_set_encrypt_key(ogs_aes_key_t *aes_key,
+        const uint8_t *key, int keybits);
 
 #ifdef __cplusplus
 }
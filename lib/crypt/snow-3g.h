@@ -15,6 +15,17 @@ typedef uint8_t u8;
 typedef uint32_t u32;
 typedef uint64_t u64;
 
+/*
+ * SNOW 3G state. The functions below work on a caller-provided state,
+ * so that f8/f9 can run concurrently for different UEs.
+ */
+typedef struct snow_3g_state_s {
+	u32 LFSR_S[16];
+	u32 FSM_R1;
+	u32 FSM_R2;
+	u32 FSM_R3;
+} snow_3g_state_t;
+
 /* Initialization.
 * Input k[4]: Four 32-bit words making up 128-bit key.
 * Input IV[4]: Four 32-bit words making 128-bit initialization variable.
@@ -22,16 +33,24 @@ typedef uint64_t u64;
 * See Section 4.1.
 */
 
-void snow_3g_initialize(u32 k[4], u32 IV[4]);
+void snow_3g_state_init(snow_3g_state_t *state,
+        const u32 k[4], const u32 IV[4]);
 
 /* Generation of Keystream.
+* Output: the next 32-bit word of keystream.
+* See section 4.2.
+*/
+
+u32 snow_3g_state_next(snow_3g_state_t *state);
+
+/* Same as above on a single internal state.
+* Kept for compatibility only : not reentrant.
 * input n: number of 32-bit words of keystream.
 * input z: space for the generated keystream, assumes
 * memory is allocated already.
-* output: generated keystream which is filled in z
-* See section 4.2.
 */
 
+void snow_3g_initialize(u32 k[4], u32 IV[4]);
 void snow_3g_generate_key_stream(u32 n, u32 *z);
 
 /* f8.
@@ -21,12 +21,34 @@ extern "C" {
 typedef uint8_t u8;
 typedef uint32_t u32;
 
+/*
+ * ZUC state. All the functions below work on a caller-provided state,
+ * so that EEA3/EIA3 can run concurrently for different UEs.
+ */
+typedef struct zuc_state_s {
+	u32 LFSR_S[16];	/* the state registers of LFSR */
+	u32 F_R1;	/* the registers of F */
+	u32 F_R2;
+	u32 BRC_X[4];	/* the outputs of BitReorganization */
+} zuc_state_t;
+
 /*
  * ZUC keystream generator
  * k: secret key (input, 16 bytes)
  * iv: initialization vector (input, 16 bytes)
+ *
+ * zuc_state_init() runs the initialisation mode and the first clock of
+ * the working mode, after which every zuc_state_next() returns
+ * the next 32-bit word of keystream.
+*/
+void zuc_state_init(zuc_state_t *state, const u8 *k, const u8 *iv);
+u32 zuc_state_next(zuc_state_t *state);
+
+/*
+ * ZUC keystream generator on a single internal state.
+ * Kept for compatibility only : not reentrant.
  * Keystream: produced keystream (output, variable length)
- * KeystreamLen: length in bits requested for the keystream (input)
+ * KeystreamLen: length in 32-bit words requested for the keystream (input)
 */
 void zuc_initialize(u8* k, u8* iv);
 void zuc_generate_key_stream(u32* pKeystream, u32 KeystreamLen);
@@ -23,6 +23,7 @@ int ogs_dbi_msisdn_data(
         char *imsi_or_msisdn_bcd, ogs_msisdn_data_t *msisdn_data)
 {
     int rv = OGS_OK;
+    ogs_mongoc_client_t client;
     mongoc_cursor_t *cursor = NULL;
     bson_t *query = NULL;
     bson_error_t error;
@@ -37,6 +38,10 @@ int ogs_dbi_msisdn_data(
 
     memset(msisdn_data, 0, sizeof(*msisdn_data));
 
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
+        goto out;
+
     query = BCON_NEW("$or",
             "[",
                 "{", "imsi", BCON_UTF8(imsi_or_msisdn_bcd), "}",
@@ -44,9 +49,9 @@ int ogs_dbi_msisdn_data(
             "]");
 #if MONGOC_CHECK_VERSION(1, 5, 0)
     cursor = mongoc_collection_find_with_opts(
-            ogs_mongoc()->collection.subscriber, query, NULL, NULL);
+            client.subscriber, query, NULL, NULL);
 #else
-    cursor = mongoc_collection_find(ogs_mongoc()->collection.subscriber,
+    cursor = mongoc_collection_find(client.subscriber,
             MONGOC_QUERY_NONE, 0, 0, 0, query, NULL, NULL);
 #endif
 
@@ -108,6 +113,7 @@ int ogs_dbi_msisdn_data(
 out:
     if (query) bson_destroy(query);
     if (cursor) mongoc_cursor_destroy(cursor);
+    ogs_mongoc_client_push(&client);
 
     return rv;
 }
@@ -115,6 +121,7 @@ out:
 int ogs_dbi_ims_data(char *supi, ogs_ims_data_t *ims_data)
 {
     int rv = OGS_OK;
+    ogs_mongoc_client_t client;
     mongoc_cursor_t *cursor = NULL;
     bson_t *query = NULL;
     bson_error_t error;
@@ -138,12 +145,16 @@ int ogs_dbi_ims_data(char *supi, ogs_ims_data_t *ims_data)
     supi_id = ogs_id_get_value(supi);
     ogs_assert(supi_id);
 
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
+        goto out;
+
     query = BCON_NEW(supi_type, BCON_UTF8(supi_id));
 #if MONGOC_CHECK_VERSION(1, 5, 0)
     cursor = mongoc_collection_find_with_opts(
-            ogs_mongoc()->collection.subscriber, query, NULL, NULL);
+            client.subscriber, query, NULL, NULL);
 #else
-    cursor = mongoc_collection_find(ogs_mongoc()->collection.subscriber,
+    cursor = mongoc_collection_find(client.subscriber,
             MONGOC_QUERY_NONE, 0, 0, 0, query, NULL, NULL);
 #endif
 
@@ -413,6 +424,7 @@ int ogs_dbi_ims_data(char *supi, ogs_ims_data_t *ims_data)
 out:
     if (query) bson_destroy(query);
     if (cursor) mongoc_cursor_destroy(cursor);
+    ogs_mongoc_client_push(&client);
 
     ogs_free(supi_type);
     ogs_free(supi_id);
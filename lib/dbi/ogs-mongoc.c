@@ -83,8 +83,6 @@ int ogs_mongoc_init(const char *db_uri)
     bson_error_t error;
     bson_iter_t iter;
 
-    const mongoc_uri_t *uri;
-
     if (!db_uri) {
         ogs_error("No DB_URI");
         return OGS_ERROR;
@@ -98,21 +96,24 @@ int ogs_mongoc_init(const char *db_uri)
 
     self.initialized = true;
 
-    self.client = mongoc_client_new(db_uri);
-    if (!self.client) {
+    self.uri = mongoc_uri_new(db_uri);
+    if (!self.uri) {
         ogs_error("Failed to parse DB URI [%s]", self.masked_db_uri);
         return OGS_ERROR;
     }
 
+    self.name = mongoc_uri_get_database(self.uri);
+    ogs_assert(self.name);
+
+    self.pool = mongoc_client_pool_new(self.uri);
+    ogs_assert(self.pool);
+
 #if MONGOC_CHECK_VERSION(1, 4, 0)
-    mongoc_client_set_error_api(self.client, 2);
+    mongoc_client_pool_set_error_api(self.pool, 2);
 #endif
 
-    uri = mongoc_client_get_uri(self.client);
-    ogs_assert(uri);
-
-    self.name = mongoc_uri_get_database(uri);
-    ogs_assert(self.name);
+    self.client = mongoc_client_pool_pop(self.pool);
+    ogs_assert(self.client);
 
     self.database = mongoc_client_get_database(self.client, self.name);
     ogs_assert(self.database);
@@ -139,9 +140,17 @@ void ogs_mongoc_final(void)
         self.database = NULL;
     }
     if (self.client) {
-        mongoc_client_destroy(self.client);
+        mongoc_client_pool_push(self.pool, self.client);
         self.client = NULL;
     }
+    if (self.pool) {
+        mongoc_client_pool_destroy(self.pool);
+        self.pool = NULL;
+    }
+    if (self.uri) {
+        mongoc_uri_destroy(self.uri);
+        self.uri = NULL;
+    }
     if (self.masked_db_uri) {
         ogs_free(self.masked_db_uri);
         self.masked_db_uri = NULL;
@@ -158,6 +167,42 @@ ogs_mongoc_t *ogs_mongoc(void)
     return &self;
 }
 
+int ogs_mongoc_client_pop(ogs_mongoc_client_t *client)
+{
+    ogs_assert(client);
+
+    memset(client, 0, sizeof(*client));
+
+    if (!self.pool || !self.name) {
+        ogs_error("MongoDB is not initialized");
+        return OGS_ERROR;
+    }
+
+    /* Waits for a client if all of them are in use */
+    client->client = mongoc_client_pool_pop(self.pool);
+    ogs_assert(client->client);
+
+    client->subscriber = mongoc_client_get_collection(
+            client->client, self.name, "subscribers");
+    ogs_assert(client->subscriber);
+
+    return OGS_OK;
+}
+
+void ogs_mongoc_client_push(ogs_mongoc_client_t *client)
+{
+    ogs_assert(client);
+
+    if (client->subscriber) {
+        mongoc_collection_destroy(client->subscriber);
+        client->subscriber = NULL;
+    }
+    if (client->client) {
+        mongoc_client_pool_push(self.pool, client->client);
+        client->client = NULL;
+    }
+}
+
 int ogs_dbi_init(const char *db_uri)
 {
     int rv;
@@ -167,6 +212,7 @@ int ogs_dbi_init(const char *db_uri)
     rv = ogs_mongoc_init(db_uri);
     if (rv != OGS_OK) return rv;
 
+    /* Only for the change stream : queries use ogs_mongoc_client_pop() */
     if (ogs_mongoc()->client && ogs_mongoc()->name) {
         self.collection.subscriber = mongoc_client_get_collection(
             ogs_mongoc()->client, ogs_mongoc()->name, "subscribers");
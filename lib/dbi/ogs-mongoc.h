@@ -34,7 +34,8 @@ typedef struct ogs_mongoc_s {
     bool initialized;
     const char *name;
     void *uri;
-    void *client;
+    void *pool;
+    void *client;       /* Held by the owner of the change stream */
     void *database;
 
 #if MONGOC_CHECK_VERSION(1, 9, 0)
@@ -52,6 +53,19 @@ int ogs_mongoc_init(const char *db_uri);
 void ogs_mongoc_final(void);
 ogs_mongoc_t *ogs_mongoc(void);
 
+/*
+ * A mongoc_client_t must not be used by two threads at the same time.
+ * Each ogs_dbi_*() query pops a client from the pool and pushes it back
+ * when done, so the Diameter threads of the HSS/PCRF query in parallel.
+ */
+typedef struct ogs_mongoc_client_s {
+    mongoc_client_t *client;
+    mongoc_collection_t *subscriber;
+} ogs_mongoc_client_t;
+
+int ogs_mongoc_client_pop(ogs_mongoc_client_t *client);
+void ogs_mongoc_client_push(ogs_mongoc_client_t *client);
+
 int ogs_dbi_init(const char *db_uri);
 void ogs_dbi_final(void);
 
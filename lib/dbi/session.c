@@ -24,6 +24,7 @@ int ogs_dbi_session_data(
         ogs_session_data_t *session_data)
 {
     int rv = OGS_OK;
+    ogs_mongoc_client_t client;
     mongoc_cursor_t *cursor = NULL;
     bson_t *query = NULL;
     bson_t *opts = NULL;
@@ -50,12 +51,16 @@ int ogs_dbi_session_data(
     supi_id = ogs_id_get_value(supi);
     ogs_assert(supi_id);
 
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
+        goto out;
+
     query = BCON_NEW(supi_type, BCON_UTF8(supi_id));
 #if MONGOC_CHECK_VERSION(1, 5, 0)
     cursor = mongoc_collection_find_with_opts(
-            ogs_mongoc()->collection.subscriber, query, NULL, NULL);
+            client.subscriber, query, NULL, NULL);
 #else
-    cursor = mongoc_collection_find(ogs_mongoc()->collection.subscriber,
+    cursor = mongoc_collection_find(client.subscriber,
             MONGOC_QUERY_NONE, 0, 0, 0, query, NULL, NULL);
 #endif
 
@@ -503,6 +508,7 @@ out:
     if (query) bson_destroy(query);
     if (opts) bson_destroy(opts);
     if (cursor) mongoc_cursor_destroy(cursor);
+    ogs_mongoc_client_push(&client);
 
     ogs_free(supi_type);
     ogs_free(supi_id);
@@ -22,6 +22,7 @@
 int ogs_dbi_auth_info(char *supi, ogs_dbi_auth_info_t *auth_info)
 {
     int rv = OGS_OK;
+    ogs_mongoc_client_t client;
     mongoc_cursor_t *cursor = NULL;
     bson_t *query = NULL;
     bson_error_t error;
@@ -50,12 +51,16 @@ int ogs_dbi_auth_info(char *supi, ogs_dbi_auth_info_t *auth_info)
         return OGS_ERROR;
     }
 
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
+        goto out;
+
     query = BCON_NEW(supi_type, BCON_UTF8(supi_id));
 #if MONGOC_CHECK_VERSION(1, 5, 0)
     cursor = mongoc_collection_find_with_opts(
-            ogs_mongoc()->collection.subscriber, query, NULL, NULL);
+            client.subscriber, query, NULL, NULL);
 #else
-    cursor = mongoc_collection_find(ogs_mongoc()->collection.subscriber,
+    cursor = mongoc_collection_find(client.subscriber,
             MONGOC_QUERY_NONE, 0, 0, 0, query, NULL, NULL);
 #endif
 
@@ -112,13 +117,14 @@ int ogs_dbi_auth_info(char *supi, ogs_dbi_auth_info_t *auth_info)
             memcpy(auth_info->rand, buf, OGS_RAND_LEN);
         } else if (!strcmp(key, OGS_SQN_STRING) &&
                 BSON_ITER_HOLDS_INT64(&inner_iter)) {
-            auth_info->sqn = bson_iter_int64(&inner_iter);
+            auth_info->sqn = bson_iter_int64(&inner_iter) & OGS_MAX_SQN;
         }
     }
 
 out:
     if (query) bson_destroy(query);
     if (cursor) mongoc_cursor_destroy(cursor);
+    ogs_mongoc_client_push(&client);
 
     ogs_free(supi_type);
     ogs_free(supi_id);
@@ -129,6 +135,7 @@ out:
 int ogs_dbi_update_sqn(char *supi, uint64_t sqn)
 {
     int rv = OGS_OK;
+    ogs_mongoc_client_t client;
     bson_t *query = NULL;
     bson_t *update = NULL;
     bson_error_t error;
@@ -149,13 +156,20 @@ int ogs_dbi_update_sqn(char *supi, uint64_t sqn)
                 OGS_SECURITY_STRING "." OGS_SQN_STRING, BCON_INT64(sqn),
             "}");
 
-    if (!mongoc_collection_update(ogs_mongoc()->collection.subscriber,
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
+        goto out;
+
+    if (!mongoc_collection_update(client.subscriber,
             MONGOC_UPDATE_NONE, query, update, NULL, &error)) {
         ogs_error("mongoc_collection_update() failure: %s", error.message);
 
         rv = OGS_ERROR;
     }
 
+    ogs_mongoc_client_push(&client);
+
+out:
     if (query) bson_destroy(query);
     if (update) bson_destroy(update);
 
@@ -168,6 +182,7 @@ int ogs_dbi_update_sqn(char *supi, uint64_t sqn)
 int ogs_dbi_update_imeisv(char *supi, char *imeisv)
 {
     int rv = OGS_OK;
+    ogs_mongoc_client_t client;
     bson_t *query = NULL;
     bson_t *update = NULL;
     bson_error_t error;
@@ -190,13 +205,21 @@ int ogs_dbi_update_imeisv(char *supi, char *imeisv)
             "{",
                 OGS_IMEISV_STRING, BCON_UTF8(imeisv),
             "}");
-    if (!mongoc_collection_update(ogs_mongoc()->collection.subscriber,
+
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
+        goto out;
+
+    if (!mongoc_collection_update(client.subscriber,
             MONGOC_UPDATE_UPSERT, query, update, NULL, &error)) {
         ogs_error("mongoc_collection_update() failure: %s", error.message);
 
         rv = OGS_ERROR;
     }
 
+    ogs_mongoc_client_push(&client);
+
+out:
     if (query) bson_destroy(query);
     if (update) bson_destroy(update);
 
@@ -210,6 +233,7 @@ int ogs_dbi_update_mme(char *supi, char *mme_host, char *mme_realm,
     bool purge_flag)
 {
     int rv = OGS_OK;
+    ogs_mongoc_client_t client;
     bson_t *query = NULL;
     bson_t *update = NULL;
     bson_error_t error;
@@ -235,13 +259,21 @@ int ogs_dbi_update_mme(char *supi, char *mme_host, char *mme_realm,
                 OGS_MME_TIMESTAMP_STRING, BCON_INT64(ogs_time_now()),
                 OGS_PURGE_FLAG_STRING, BCON_BOOL(purge_flag),
             "}");
-    if (!mongoc_collection_update(ogs_mongoc()->collection.subscriber,
+
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
+        goto out;
+
+    if (!mongoc_collection_update(client.subscriber,
             MONGOC_UPDATE_UPSERT, query, update, NULL, &error)) {
         ogs_error("mongoc_collection_update() failure: %s", error.message);
 
         rv = OGS_ERROR;
     }
 
+    ogs_mongoc_client_push(&client);
+
+out:
     if (query) bson_destroy(query);
     if (update) bson_destroy(update);
 
@@ -257,7 +289,7 @@ int ogs_dbi_increment_sqn(char *supi)
     bson_t *query = NULL;
     bson_t *update = NULL;
     bson_error_t error;
-    uint64_t max_sqn = OGS_MAX_SQN;
+    ogs_mongoc_client_t client;
 
     char *supi_type = NULL;
     char *supi_id = NULL;
@@ -270,31 +302,45 @@ int ogs_dbi_increment_sqn(char *supi)
     ogs_assert(supi_id);
 
     query = BCON_NEW(supi_type, BCON_UTF8(supi_id));
-    update = BCON_NEW("$inc",
+    /*
+     * A single update is atomic, so concurrent increments need no lock.
+     * The pipeline keeps the stored SQN within 48 bits:
+     *   [ { $set: { security.sqn:
+     *           { $mod: [ { $add: [ "$security.sqn", 32 ] }, 2^48 ] } } } ]
+     */
+    update = BCON_NEW("0",
             "{",
-                OGS_SECURITY_STRING "." OGS_SQN_STRING, BCON_INT64(32),
+                "$set", "{",
+                    OGS_SECURITY_STRING "." OGS_SQN_STRING, "{",
+                        "$mod", "[",
+                            "{",
+                                "$add", "[",
+                                    BCON_UTF8("$" OGS_SECURITY_STRING "."
+                                        OGS_SQN_STRING),
+                                    BCON_INT64(32),
+                                "]",
+                            "}",
+                            BCON_INT64(OGS_MAX_SQN + 1),
+                        "]",
+                    "}",
+                "}",
             "}");
-    if (!mongoc_collection_update(ogs_mongoc()->collection.subscriber,
-            MONGOC_UPDATE_NONE, query, update, NULL, &error)) {
-        ogs_error("mongoc_collection_update() failure: %s", error.message);
 
-        rv = OGS_ERROR;
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
         goto out;
-    }
-    bson_destroy(update);
 
-    update = BCON_NEW("$bit",
-            "{",
-                OGS_SECURITY_STRING "." OGS_SQN_STRING,
-                "{", "and", BCON_INT64(max_sqn), "}",
-            "}");
-    if (!mongoc_collection_update(ogs_mongoc()->collection.subscriber,
-            MONGOC_UPDATE_NONE, query, update, NULL, &error)) {
-        ogs_error("mongoc_collection_update() failure: %s", error.message);
+    /* An update pipeline needs update_one() */
+    if (!mongoc_collection_update_one(client.subscriber,
+            query, update, NULL, NULL, &error)) {
+        ogs_error("mongoc_collection_update_one() failure: %s",
+                error.message);
 
         rv = OGS_ERROR;
     }
 
+    ogs_mongoc_client_push(&client);
+
 out:
     if (query) bson_destroy(query);
     if (update) bson_destroy(update);
@@ -309,6 +355,7 @@ int ogs_dbi_subscription_data(char *supi,
         ogs_subscription_data_t *subscription_data)
 {
     int rv = OGS_OK;
+    ogs_mongoc_client_t client;
     mongoc_cursor_t *cursor = NULL;
     bson_t *query = NULL;
     bson_error_t error;
@@ -332,12 +379,16 @@ int ogs_dbi_subscription_data(char *supi,
     supi_id = ogs_id_get_value(supi);
     ogs_assert(supi_id);
 
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
+        goto out;
+
     query = BCON_NEW(supi_type, BCON_UTF8(supi_id));
 #if MONGOC_CHECK_VERSION(1, 5, 0)
     cursor = mongoc_collection_find_with_opts(
-            ogs_mongoc()->collection.subscriber, query, NULL, NULL);
+            client.subscriber, query, NULL, NULL);
 #else
-    cursor = mongoc_collection_find(ogs_mongoc()->collection.subscriber,
+    cursor = mongoc_collection_find(client.subscriber,
             MONGOC_QUERY_NONE, 0, 0, 0, query, NULL, NULL);
 #endif
 
@@ -830,6 +881,7 @@ int ogs_dbi_subscription_data(char *supi,
 out:
     if (query) bson_destroy(query);
     if (cursor) mongoc_cursor_destroy(cursor);
+    ogs_mongoc_client_push(&client);
 
     ogs_free(supi_type);
     ogs_free(supi_id);
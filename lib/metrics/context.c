@@ -42,6 +42,7 @@ void ogs_metrics_context_init(void)
     ogs_metrics_server_init(ogs_metrics_self());
 
     ogs_list_init(&self.custom_eps);
+    ogs_list_init(&self.collectors);
 
     context_initialized = 1;
 }
@@ -53,6 +54,7 @@ void ogs_metrics_context_open(ogs_metrics_context_t *ctx)
 void ogs_metrics_context_close(ogs_metrics_context_t *ctx)
 {
     ogs_metrics_custom_ep_t *node = NULL, *node_next = NULL;
+    ogs_metrics_collector_t *collector = NULL, *collector_next = NULL;
 
     ogs_metrics_server_close(ctx);
 
@@ -61,6 +63,11 @@ void ogs_metrics_context_close(ogs_metrics_context_t *ctx)
         ogs_list_remove(&self.custom_eps, node);
         ogs_free(node);
     }
+
+    ogs_list_for_each_safe(&self.collectors, collector_next, collector) {
+        ogs_list_remove(&self.collectors, collector);
+        ogs_free(collector);
+    }
 }
 
 void ogs_metrics_context_final(void)
@@ -291,3 +298,25 @@ void ogs_metrics_register_custom_ep(ogs_metrics_custom_ep_hdlr_t handler,
 
     ogs_list_add(&self.custom_eps, ep);
 }
+
+void ogs_metrics_register_collector(ogs_metrics_collector_f collect)
+{
+    ogs_metrics_collector_t *collector;
+
+    ogs_assert(collect);
+
+    collector = ogs_calloc(1, sizeof(*collector));
+    ogs_assert(collector);
+
+    collector->collect = collect;
+
+    ogs_list_add(&self.collectors, collector);
+}
+
+void ogs_metrics_collect(void)
+{
+    ogs_metrics_collector_t *collector = NULL;
+
+    ogs_list_for_each(&self.collectors, collector)
+        collector->collect();
+}
@@ -44,6 +44,9 @@ typedef struct ogs_metrics_context_s {
 
     /* custom endpoints */
     ogs_list_t custom_eps;
+
+    /* called before each scrape */
+    ogs_list_t collectors;
 } ogs_metrics_context_t;
 
 typedef enum ogs_metrics_histogram_bucket_type_s  {
@@ -130,6 +133,23 @@ typedef struct ogs_metrics_custom_ep_s {
 void ogs_metrics_register_custom_ep(ogs_metrics_custom_ep_hdlr_t handler,
         const char *endpoint);
 
+/*
+ * A collector refreshes metrics whose source is not updated
+ * through ogs_metrics_inst_*() (e.g. counters kept by a library).
+ * It runs on each scrape. The metrics server is polled from
+ * ogs_app()->pollset, so this is the thread of the NF main loop.
+ */
+typedef void (*ogs_metrics_collector_f)(void);
+
+typedef struct ogs_metrics_collector_s {
+    ogs_lnode_t lnode;
+
+    ogs_metrics_collector_f collect;
+} ogs_metrics_collector_t;
+
+void ogs_metrics_register_collector(ogs_metrics_collector_f collect);
+void ogs_metrics_collect(void);
+
 #ifdef __cplusplus
 }
 #endif
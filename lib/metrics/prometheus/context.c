@@ -22,7 +22,8 @@
  /*
  * Prometheus HTTP server (MicroHTTPD) with optional JSON endpoints:
  *   - /                (provide health check)
- *   - /metrics         (provide prometheus metrics metrics according to the relevant NF)
+ *   - /metrics         (provide prometheus metrics metrics according to the relevant NF,
+ *                       and the usage of the memory pools)
  *   - /pdu-info        (provided by NF registering ogs_metrics_pdu_info_dumper)
  *   - /gnb-info        (provided by NF registering ogs_metrics_gnb_info_dumper)
  *   - /enb-info        (provided by NF registering ogs_metrics_enb_info_dumper)
@@ -73,6 +74,21 @@ typedef struct ogs_metrics_inst_s {
 static OGS_POOL(metrics_spec_pool, ogs_metrics_spec_t);
 static OGS_POOL(metrics_server_pool, ogs_metrics_server_t);
 
+/* Usage of the memory pools, refreshed on each scrape */
+static struct {
+    prom_metric_t *size;
+    prom_metric_t *used;
+    prom_metric_t *high_water;
+    prom_metric_t *failed;
+
+    ogs_hash_t *failed_published; /* Pool name : failures already added */
+} pool_metrics;
+
+typedef struct pool_usage_s {
+    const char *name;
+    int size, used, high_water, failed;
+} pool_usage_t;
+
 /* Forward decls */
 static int ogs_metrics_context_server_start(ogs_metrics_server_t *server);
 static int ogs_metrics_context_server_stop(ogs_metrics_server_t *server);
@@ -192,6 +208,109 @@ typedef enum MHD_Result _MHD_Result;
 typedef int _MHD_Result;
 #endif
 
+static void pool_metrics_init(void)
+{
+    const char *labels[] = { "pool" };
+
+    pool_metrics.size = prom_gauge_new("ogs_pool_size",
+            "Number of nodes in the pool", 1, labels);
+    ogs_assert(pool_metrics.size);
+    prom_collector_registry_must_register_metric(pool_metrics.size);
+
+    pool_metrics.used = prom_gauge_new("ogs_pool_used",
+            "Number of nodes in use", 1, labels);
+    ogs_assert(pool_metrics.used);
+    prom_collector_registry_must_register_metric(pool_metrics.used);
+
+    pool_metrics.high_water = prom_gauge_new("ogs_pool_high_water",
+            "Most nodes in use at the same time", 1, labels);
+    ogs_assert(pool_metrics.high_water);
+    prom_collector_registry_must_register_metric(pool_metrics.high_water);
+
+    pool_metrics.failed = prom_counter_new("ogs_pool_alloc_failures",
+            "Allocations that found the pool empty", 1, labels);
+    ogs_assert(pool_metrics.failed);
+    prom_collector_registry_must_register_metric(pool_metrics.failed);
+
+    pool_metrics.failed_published = ogs_hash_make();
+    ogs_assert(pool_metrics.failed_published);
+}
+
+static void pool_metrics_final(void)
+{
+    ogs_hash_index_t *hi = NULL;
+
+    for (hi = ogs_hash_first(pool_metrics.failed_published);
+            hi; hi = ogs_hash_next(hi))
+        ogs_free(ogs_hash_this_val(hi));
+    ogs_hash_destroy(pool_metrics.failed_published);
+    pool_metrics.failed_published = NULL;
+}
+
+/* Pools with the same name (e.g. one per timer manager) are added up */
+static void pool_usage_collect(const ogs_pool_stat_t *stat, void *data)
+{
+    ogs_hash_t *hash = data;
+    pool_usage_t *usage = NULL;
+    const char *name = stat->name;
+
+    ogs_assert(name);
+    if (name[0] == '&')
+        name++;
+
+    usage = ogs_hash_get(hash, name, OGS_HASH_KEY_STRING);
+    if (!usage) {
+        usage = ogs_calloc(1, sizeof(*usage));
+        ogs_assert(usage);
+        usage->name = name;
+        ogs_hash_set(hash, usage->name, OGS_HASH_KEY_STRING, usage);
+    }
+
+    usage->size += stat->size;
+    usage->used += stat->used;
+    usage->high_water += stat->high_water;
+    usage->failed += stat->failed;
+}
+
+static void pool_metrics_update(void)
+{
+    ogs_hash_t *hash = NULL;
+    ogs_hash_index_t *hi = NULL;
+
+    hash = ogs_hash_make();
+    ogs_assert(hash);
+
+    ogs_pool_stat_foreach(pool_usage_collect, hash);
+
+    for (hi = ogs_hash_first(hash); hi; hi = ogs_hash_next(hi)) {
+        pool_usage_t *usage = ogs_hash_this_val(hi);
+        const char *label_values[] = { usage->name };
+        int *published = NULL;
+
+        prom_gauge_set(pool_metrics.size, usage->size, label_values);
+        prom_gauge_set(pool_metrics.used, usage->used, label_values);
+        prom_gauge_set(pool_metrics.high_water,
+                usage->high_water, label_values);
+
+        /* The counter only goes up : add the failures since last scrape */
+        published = ogs_hash_get(pool_metrics.failed_published,
+                usage->name, OGS_HASH_KEY_STRING);
+        if (!published) {
+            published = ogs_calloc(1, sizeof(*published));
+            ogs_assert(published);
+            ogs_hash_set(pool_metrics.failed_published,
+                    usage->name, OGS_HASH_KEY_STRING, published);
+        }
+        prom_counter_add(pool_metrics.failed,
+                ogs_max(usage->failed - *published, 0), label_values);
+        *published = ogs_max(usage->failed, *published);
+
+        ogs_free(usage);
+    }
+
+    ogs_hash_destroy(hash);
+}
+
 /* Small helper to serve JSON from a registered dumper */
 static _MHD_Result serve_json_from_dumper(struct MHD_Connection *connection,
                                           ogs_metrics_custom_ep_hdlr_t handler,
@@ -290,6 +409,8 @@ mhd_server_access_handler(void *cls, struct MHD_Connection *connection,
 
     /* Prometheus metrics plain-text */
     if (strcmp(url, "/metrics") == 0) {
+        pool_metrics_update();
+        ogs_metrics_collect();
         buf = prom_collector_registry_bridge(PROM_COLLECTOR_REGISTRY_DEFAULT);
         rsp = MHD_create_response_from_buffer(strlen(buf), (void *)buf, MHD_RESPMEM_MUST_COPY);
         MHD_add_response_header(rsp, "Content-Type", "text/plain; version=0.0.4; charset=utf-8");
@@ -415,6 +536,7 @@ void ogs_metrics_spec_init(ogs_metrics_context_t *ctx)
     ogs_list_init(&ctx->spec_list);
     ogs_pool_init(&metrics_spec_pool, ogs_app()->metrics.max_specs);
     prom_collector_registry_default_init();
+    pool_metrics_init();
 }
 
 void ogs_metrics_spec_final(ogs_metrics_context_t *ctx)
@@ -424,6 +546,7 @@ void ogs_metrics_spec_final(ogs_metrics_context_t *ctx)
     ogs_list_for_each_entry_safe(&ctx->spec_list, next, spec, entry)
         ogs_metrics_spec_free(spec);
 
+    pool_metrics_final();
     prom_collector_registry_destroy(PROM_COLLECTOR_REGISTRY_DEFAULT);
     ogs_pool_final(&metrics_spec_pool);
 }
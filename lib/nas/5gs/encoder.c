@@ -3561,7 +3561,7 @@ ogs_pkbuf_t *ogs_nas_5gmm_encode(ogs_nas_5gs_message_t *message)
     ogs_assert(message);
 
     /* The Packet Buffer(ogs_pkbuf_t) for NAS message MUST make a HEADROOM.
-     * When calculating AES_CMAC, we need to use the headroom of the packet. */
+     * The security header is pushed into the headroom of the packet. */
     pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
     if (!pkbuf) {
         ogs_error("ogs_pkbuf_alloc() failed");
@@ -3731,7 +3731,7 @@ ogs_pkbuf_t *ogs_nas_5gsm_encode(ogs_nas_5gs_message_t *message)
     ogs_assert(message);
 
     /* The Packet Buffer(ogs_pkbuf_t) for NAS message MUST make a HEADROOM.
-     * When calculating AES_CMAC, we need to use the headroom of the packet. */
+     * The security header is pushed into the headroom of the packet. */
     pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
     if (!pkbuf) {
         ogs_error("ogs_pkbuf_alloc() failed");
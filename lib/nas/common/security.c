@@ -19,13 +19,67 @@
 
 #include "ogs-nas-common.h"
 
+void ogs_nas_security_cache_clear(ogs_nas_security_cache_t *cache)
+{
+    ogs_assert(cache);
+
+    /* Do not leave the expanded keys behind */
+    memset(cache, 0, sizeof(*cache));
+}
+
+static const ogs_aes_cmac_key_t *int_key(ogs_nas_security_cache_t *cache,
+        const uint8_t *knas_int, ogs_aes_cmac_key_t *local)
+{
+    if (!cache) {
+        ogs_aes_cmac_set_key(local, knas_int);
+        return local;
+    }
+
+    if (!cache->int_ready ||
+        memcmp(cache->knas_int, knas_int, OGS_KEY_LEN) != 0) {
+        memcpy(cache->knas_int, knas_int, OGS_KEY_LEN);
+        ogs_aes_cmac_set_key(&cache->int_key, knas_int);
+        cache->int_ready = true;
+    }
+
+    return &cache->int_key;
+}
+
+static const ogs_aes_key_t *enc_key(ogs_nas_security_cache_t *cache,
+        const uint8_t *knas_enc, ogs_aes_key_t *local)
+{
+    if (!cache) {
+        ogs_aes_set_encrypt_key(local, knas_enc, 128);
+        return local;
+    }
+
+    if (!cache->enc_ready ||
+        memcmp(cache->knas_enc, knas_enc, OGS_KEY_LEN) != 0) {
+        memcpy(cache->knas_enc, knas_enc, OGS_KEY_LEN);
+        ogs_aes_set_encrypt_key(&cache->enc_key, knas_enc, 128);
+        cache->enc_ready = true;
+    }
+
+    return &cache->enc_key;
+}
+
 void ogs_nas_mac_calculate(uint8_t algorithm_identity,
         uint8_t *knas_int, uint32_t count, uint8_t bearer, 
         uint8_t direction, ogs_pkbuf_t *pkbuf, uint8_t *mac)
 {
-    uint8_t *ivec = NULL;;
+    ogs_nas_mac_calculate_with_cache(NULL, algorithm_identity,
+            knas_int, count, bearer, direction, pkbuf, mac);
+}
+
+void ogs_nas_mac_calculate_with_cache(ogs_nas_security_cache_t *cache,
+        uint8_t algorithm_identity,
+        uint8_t *knas_int, uint32_t count, uint8_t bearer,
+        uint8_t direction, ogs_pkbuf_t *pkbuf, uint8_t *mac)
+{
+    uint8_t ivec[8];
     uint8_t cmac[16];
     uint32_t mac32;
+    ogs_aes_cmac_key_t local;
 
     ogs_assert(knas_int);
     ogs_assert(bearer <= 0x1f);
@@ -43,18 +97,16 @@ void ogs_nas_mac_calculate(uint8_t algorithm_identity,
     case OGS_NAS_SECURITY_ALGORITHMS_128_EIA2:
         count = htonl(count);
 
-        ogs_pkbuf_push(pkbuf, 8);
-
-        ivec = pkbuf->data;
-        memset(ivec, 0, 8);
+        /* The IV is not pushed into the packet which is left untouched */
+        memset(ivec, 0, sizeof(ivec));
         memcpy(ivec + 0, &count, sizeof(count));
         ivec[4] = (bearer << 3) | (direction << 2);
 
-        ogs_aes_cmac_calculate(cmac, knas_int, pkbuf->data, pkbuf->len);
+        ogs_aes_cmac_calculate_with_prefix(cmac,
+                int_key(cache, knas_int, &local), ivec, sizeof(ivec),
+                pkbuf->data, pkbuf->len);
         memcpy(mac, cmac, 4);
 
-        ogs_pkbuf_pull(pkbuf, 8);
-
         break;
     case OGS_NAS_SECURITY_ALGORITHMS_128_EIA3:
         zuc_eia3(knas_int, count, bearer, direction, 
@@ -74,9 +126,18 @@ void ogs_nas_mac_calculate(uint8_t algorithm_identity,
 void ogs_nas_encrypt(uint8_t algorithm_identity,
         uint8_t *knas_enc, uint32_t count, uint8_t bearer, 
         uint8_t direction, ogs_pkbuf_t *pkbuf)
+{
+    ogs_nas_encrypt_with_cache(NULL, algorithm_identity,
+            knas_enc, count, bearer, direction, pkbuf);
+}
+
+void ogs_nas_encrypt_with_cache(ogs_nas_security_cache_t *cache,
+        uint8_t algorithm_identity,
+        uint8_t *knas_enc, uint32_t count, uint8_t bearer,
+        uint8_t direction, ogs_pkbuf_t *pkbuf)
 {
     uint8_t ivec[16];
-    SNOW_CTX ctx;
+    ogs_aes_key_t local;
 
     ogs_assert(knas_enc);
     ogs_assert(bearer <= 0x1f);
@@ -87,13 +148,8 @@ void ogs_nas_encrypt(uint8_t algorithm_identity,
 
     switch (algorithm_identity) {
     case OGS_NAS_SECURITY_ALGORITHMS_128_EEA1:
-#if 0 /* Issue #2581 : snow_3g_f8 have memory problem */
         snow_3g_f8(knas_enc, count, bearer, direction, 
                 pkbuf->data, (pkbuf->len << 3));
-#else
-        SNOW_init(count, bearer, direction, (const char *)knas_enc, &ctx);
-        SNOW(pkbuf->len, pkbuf->data, pkbuf->data, &ctx);
-#endif
         break;
     case OGS_NAS_SECURITY_ALGORITHMS_128_EEA2:
         count = htonl(count);
@@ -101,8 +157,8 @@ void ogs_nas_encrypt(uint8_t algorithm_identity,
         memset(ivec, 0, 16);
         memcpy(ivec + 0, &count, sizeof(count));
         ivec[4] = (bearer << 3) | (direction << 2);
-        ogs_aes_ctr128_encrypt(knas_enc, ivec, 
-                pkbuf->data, pkbuf->len, pkbuf->data);
+        ogs_aes_ctr128_encrypt_with_key(enc_key(cache, knas_enc, &local),
+                ivec, pkbuf->data, pkbuf->len, pkbuf->data);
         break;
     case OGS_NAS_SECURITY_ALGORITHMS_128_EEA3:
         zuc_eea3(knas_enc, count, bearer, direction, 
@@ -31,6 +31,24 @@ extern "C" {
 #define OGS_NAS_SECURITY_DOWNLINK_DIRECTION 1
 #define OGS_NAS_SECURITY_UPLINK_DIRECTION 0
 
+/*
+ * Expanded K_NASint/K_NASenc kept in the UE security context.
+ * The AES key schedule (and the CMAC subkeys) is recomputed only
+ * when the key differs from the one it was built from, so that
+ * 128-EIA2/128-EEA2 do not run it for every NAS message.
+ */
+typedef struct ogs_nas_security_cache_s {
+    bool int_ready;
+    uint8_t knas_int[OGS_KEY_LEN];
+    ogs_aes_cmac_key_t int_key;
+
+    bool enc_ready;
+    uint8_t knas_enc[OGS_KEY_LEN];
+    ogs_aes_key_t enc_key;
+} ogs_nas_security_cache_t;
+
+void ogs_nas_security_cache_clear(ogs_nas_security_cache_t *cache);
+
 void ogs_nas_mac_calculate(uint8_t algorithm_identity,
     uint8_t *knas_int, uint32_t count, uint8_t bearer, 
     uint8_t direction, ogs_pkbuf_t *pkbuf, uint8_t *mac);
@@ -39,6 +57,17 @@ void ogs_nas_encrypt(uint8_t algorithm_identity,
     uint8_t *knas_enc, uint32_t count, uint8_t bearer, 
     uint8_t direction, ogs_pkbuf_t *pkbuf);
 
+/* Same as above, using (and refreshing) the cached key schedule */
+void ogs_nas_mac_calculate_with_cache(ogs_nas_security_cache_t *cache,
+    uint8_t algorithm_identity,
+    uint8_t *knas_int, uint32_t count, uint8_t bearer,
+    uint8_t direction, ogs_pkbuf_t *pkbuf, uint8_t *mac);
+
+void ogs_nas_encrypt_with_cache(ogs_nas_security_cache_t *cache,
+    uint8_t algorithm_identity,
+    uint8_t *knas_enc, uint32_t count, uint8_t bearer,
+    uint8_t direction, ogs_pkbuf_t *pkbuf);
+
 #ifdef __cplusplus
 }
 #endif
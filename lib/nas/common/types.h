@@ -31,7 +31,7 @@ extern "C" {
 #endif
 
 /* The Packet Buffer(ogs_pkbuf_t) for NAS message MUST make a HEADROOM.
- * When calculating AES_CMAC, we need to use the headroom of the packet. */
+ * The security header is pushed into the headroom of the packet. */
 #define OGS_NAS_HEADROOM 16
 
 #define OGS_NAS_SECURITY_HEADER_PLAIN_NAS_MESSAGE 0
@@ -30,8 +30,14 @@ extern "C" {
 
 typedef struct NGAP_NGAP_PDU ogs_ngap_message_t;
 
-int ogs_ngap_decode(ogs_ngap_message_t *message, ogs_pkbuf_t *pkbuf);
 ogs_pkbuf_t *ogs_ngap_encode(ogs_ngap_message_t *message);
+
+/* Releases the pkbufs in 'adopted' : see ogs_asn_encode_adopted() */
+ogs_pkbuf_t *ogs_ngap_encode_adopted(
+        ogs_ngap_message_t *message, ogs_asn_adopted_t *adopted);
+
+/* Only for a message from ogs_ngap_decode() : see ogs_asn_free_decoded() */
+int ogs_ngap_decode(ogs_ngap_message_t *message, ogs_pkbuf_t *pkbuf);
 void ogs_ngap_free(ogs_ngap_message_t *message);
 
 #ifdef __cplusplus
@@ -22,6 +22,12 @@
 int __ogs_s1ap_domain;
 
 ogs_pkbuf_t *ogs_s1ap_encode(ogs_s1ap_message_t *message)
+{
+    return ogs_s1ap_encode_adopted(message, NULL);
+}
+
+ogs_pkbuf_t *ogs_s1ap_encode_adopted(
+        ogs_s1ap_message_t *message, ogs_asn_adopted_t *adopted)
 {
     ogs_pkbuf_t *pkbuf = NULL;
 
@@ -30,9 +36,9 @@ ogs_pkbuf_t *ogs_s1ap_encode(ogs_s1ap_message_t *message)
     if (ogs_log_get_domain_level(OGS_LOG_DOMAIN) >= OGS_LOG_TRACE)
         asn_fprint(stdout, &asn_DEF_S1AP_S1AP_PDU, message);
 
-    pkbuf = ogs_asn_encode(&asn_DEF_S1AP_S1AP_PDU, message);
+    pkbuf = ogs_asn_encode_adopted(&asn_DEF_S1AP_S1AP_PDU, message, adopted);
     if (!pkbuf) {
-        ogs_error("ogs_asn_encode() failed");
+        ogs_error("ogs_asn_encode_adopted() failed");
         return NULL;
     }
 
@@ -63,5 +69,5 @@ int ogs_s1ap_decode(ogs_s1ap_message_t *message, ogs_pkbuf_t *pkbuf)
 void ogs_s1ap_free(ogs_s1ap_message_t *message)
 {
     ogs_assert(message);
-    ogs_asn_free(&asn_DEF_S1AP_S1AP_PDU, message);
+    ogs_asn_free_decoded(&asn_DEF_S1AP_S1AP_PDU, message);
 }
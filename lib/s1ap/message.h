@@ -30,8 +30,14 @@ extern "C" {
 
 typedef struct S1AP_S1AP_PDU ogs_s1ap_message_t;
 
-int ogs_s1ap_decode(ogs_s1ap_message_t *message, ogs_pkbuf_t *pkbuf);
 ogs_pkbuf_t *ogs_s1ap_encode(ogs_s1ap_message_t *message);
+
+/* Releases the pkbufs in 'adopted' : see ogs_asn_encode_adopted() */
+ogs_pkbuf_t *ogs_s1ap_encode_adopted(
+        ogs_s1ap_message_t *message, ogs_asn_adopted_t *adopted);
+
+/* Only for a message from ogs_s1ap_decode() : see ogs_asn_free_decoded() */
+int ogs_s1ap_decode(ogs_s1ap_message_t *message, ogs_pkbuf_t *pkbuf);
 void ogs_s1ap_free(ogs_s1ap_message_t *message);
 
 #ifdef __cplusplus
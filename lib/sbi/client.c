@@ -18,6 +18,7 @@
  */
 
 #include "ogs-sbi.h"
+#include "nghttp2-common.h"
 
 #include "curl/curl.h"
 
@@ -47,6 +48,7 @@ typedef struct connection_s {
 
     char *memory;
     size_t size;
+    size_t memory_size; /* allocated for memory */
     bool memory_overflow;
 
     char *location;
@@ -88,7 +90,6 @@ void ogs_sbi_client_init(int num_of_sockinfo_pool, int num_of_connection_pool)
 
     ogs_pool_init(&sockinfo_pool, num_of_sockinfo_pool);
     ogs_pool_init(&connection_pool, num_of_connection_pool);
-
 }
 void ogs_sbi_client_final(void)
 {
@@ -98,6 +99,8 @@ void ogs_sbi_client_final(void)
     ogs_pool_final(&sockinfo_pool);
     ogs_pool_final(&connection_pool);
 
+    ogs_nghttp2_client_final();
+
     curl_global_cleanup();
 }
 
@@ -206,6 +209,7 @@ void ogs_sbi_client_remove(ogs_sbi_client_t *client)
     ogs_list_remove(&ogs_sbi_self()->client_list, client);
 
     connection_remove_all(client);
+    ogs_nghttp2_client_close(client);
 
     ogs_assert(client->t_curl);
     ogs_timer_delete(client->t_curl);
@@ -234,6 +238,8 @@ void ogs_sbi_client_remove(ogs_sbi_client_t *client)
         ogs_freeaddrinfo(client->addr);
     if (client->addr6)
         ogs_freeaddrinfo(client->addr6);
+    if (client->h2_addr)
+        ogs_freeaddrinfo(client->h2_addr);
 
     ogs_pool_free(&client_pool, client);
 }
@@ -301,6 +307,8 @@ void ogs_sbi_client_stop(ogs_sbi_client_t *client)
         ogs_assert(conn->client_cb);
         conn->client_cb(OGS_DONE, NULL, conn->data);
     }
+
+    ogs_nghttp2_client_stop(client);
 }
 
 void ogs_sbi_client_stop_all(void)
@@ -311,6 +319,36 @@ void ogs_sbi_client_stop_all(void)
         ogs_sbi_client_stop(client);
 }
 
+/*
+ * Open the HTTP/2 connections to the peer before the first request,
+ * if sbi.client.connection.warm_up is set.
+ *
+ * libcurl connects on demand, so this only applies to the nghttp2 engine.
+ */
+void ogs_sbi_client_warm_up(ogs_sbi_client_t *client)
+{
+    ogs_assert(client);
+
+    if (ogs_sbi_self()->client_connection.warm_up == false)
+        return;
+
+    if (ogs_sbi_self()->client_engine == OGS_SBI_CLIENT_ENGINE_NGHTTP2)
+        ogs_nghttp2_client_warm_up(client);
+}
+
+/*
+ * Fill in the statistics of each HTTP/2 connection to the peer.
+ * Returns the number of connections, 0 for the curl engine.
+ */
+int ogs_sbi_client_connection_stat(ogs_sbi_client_t *client,
+        ogs_sbi_client_connection_stat_t *stat, int max)
+{
+    ogs_assert(client);
+    ogs_assert(stat);
+
+    return ogs_nghttp2_client_connection_stat(client, stat, max);
+}
+
 #define mycase(code) \
   case code: s = OGS_STRINGIFY(code)
 
@@ -557,6 +595,7 @@ static connection_t *connection_add(
 #endif
 
     ogs_list_add(&client->connection_list, conn);
+    client->outstanding++;
 
     curl_easy_setopt(conn->easy, CURLOPT_URL, request->h.uri);
 
@@ -592,6 +631,8 @@ static void connection_remove(connection_t *conn)
     ogs_assert(client);
 
     ogs_list_remove(&client->connection_list, conn);
+    ogs_assert(client->outstanding);
+    client->outstanding--;
 
     ogs_assert(client->multi);
     curl_multi_remove_handle(client->multi, conn->easy);
@@ -745,11 +786,13 @@ static void check_multi_info(ogs_sbi_client_t *client)
                         response->status, response->h.method, response->h.uri);
 
                 if (conn->memory) {
-                    response->http.content =
-                        ogs_memdup(conn->memory, conn->size + 1);
-                    ogs_assert(response->http.content);
+                    /* The response takes the received body as it is */
+                    response->http.content = conn->memory;
                     response->http.content_length = conn->size;
                     ogs_assert(response->http.content_length);
+
+                    conn->memory = NULL;
+                    conn->size = conn->memory_size = 0;
                 }
 
                 ogs_log_message(level, 0, "RECEIVED[%d]",
@@ -796,6 +839,10 @@ bool ogs_sbi_client_send_request(
     }
     ogs_debug("[%s] %s", request->h.method, request->h.uri);
 
+    if (ogs_sbi_self()->client_engine == OGS_SBI_CLIENT_ENGINE_NGHTTP2)
+        return ogs_nghttp2_client_send_request(
+                client, client_cb, request, data);
+
     conn = connection_add(client, client_cb, request, data);
     if (!conn) {
         ogs_error("connection_add() failed");
@@ -862,18 +909,26 @@ static size_t write_cb(void *contents, size_t size, size_t nmemb, void *data)
     ogs_assert(conn);
 
     realsize = size * nmemb;
-    ptr = ogs_realloc(conn->memory, conn->size + realsize + 1);
-    if(!ptr) {
-        conn->memory_overflow = true;
+    if (conn->size + realsize + 1 > conn->memory_size) {
+        /* Grow geometrically so that a large body is not copied per chunk */
+        size_t memory_size = ogs_max(
+                conn->memory_size * 2, conn->size + realsize + 1);
 
-        ogs_error("Overflow : conn->size[%d], realsize[%d]",
-                    (int)conn->size, (int)realsize);
-        ogs_log_hexdump(OGS_LOG_ERROR, contents, realsize);
+        ptr = ogs_realloc(conn->memory, memory_size);
+        if(!ptr) {
+            conn->memory_overflow = true;
+
+            ogs_error("Overflow : conn->size[%d], realsize[%d]",
+                        (int)conn->size, (int)realsize);
+            ogs_log_hexdump(OGS_LOG_ERROR, contents, realsize);
+
+            return 0;
+        }
 
-        return 0;
+        conn->memory = ptr;
+        conn->memory_size = memory_size;
     }
 
-    conn->memory = ptr;
     memcpy(&(conn->memory[conn->size]), contents, realsize);
     conn->size += realsize;
     conn->memory[conn->size] = 0;
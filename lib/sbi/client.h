@@ -72,9 +72,19 @@ extern "C" {
         } \
     } while(0)
 
+/* Upper bound of sbi.client.connection.num */
+#define OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION 16
+
 typedef int (*ogs_sbi_client_cb_f)(
         int status, ogs_sbi_response_t *response, void *data);
 
+typedef struct ogs_sbi_client_connection_stat_s {
+    bool established;
+    int streams;            /* streams in flight */
+    ogs_time_t rtt;         /* last PING round-trip time (0 if unknown) */
+    uint64_t goaway;        /* GOAWAY frames received */
+} ogs_sbi_client_connection_stat_t;
+
 typedef struct ogs_sbi_client_s {
     ogs_lnode_t lnode;
 
@@ -89,6 +99,8 @@ typedef struct ogs_sbi_client_s {
     ogs_sockaddr_t  *addr6;
 
     char *resolve;
+    ogs_sockaddr_t  *h2_addr;   /* FQDN resolved for the nghttp2 engine */
+    void            *h2_resolve;    /* Lookup in progress */
 
     ogs_timer_t     *t_curl;            /* timer for CURL */
     ogs_list_t      connection_list;    /* CURL connection list */
@@ -96,6 +108,11 @@ typedef struct ogs_sbi_client_s {
     void            *multi;             /* CURL multi handle */
     int             still_running;      /* number of running CURL handle */
 
+    /* HTTP/2 connections if sbi.client.engine is nghttp2 */
+    struct ogs_nghttp2_connection_s *h2[OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION];
+
+    unsigned int    outstanding;        /* requests waiting for a response */
+
     unsigned int    reference_count;    /* reference count for memory free */
 } ogs_sbi_client_t;
 
@@ -118,6 +135,10 @@ ogs_sbi_client_t *ogs_sbi_client_find(
 void ogs_sbi_client_stop(ogs_sbi_client_t *client);
 void ogs_sbi_client_stop_all(void);
 
+void ogs_sbi_client_warm_up(ogs_sbi_client_t *client);
+int ogs_sbi_client_connection_stat(ogs_sbi_client_t *client,
+        ogs_sbi_client_connection_stat_t *stat, int max);
+
 bool ogs_sbi_client_send_request(
         ogs_sbi_client_t *client, ogs_sbi_client_cb_f client_cb,
         ogs_sbi_request_t *request, void *data);
@@ -18,6 +18,7 @@
  */
 
 #include "ogs-sbi.h"
+#include "nghttp2-common.h"
 
 int __ogs_sbi_domain;
 static ogs_sbi_context_t self;
@@ -33,6 +34,7 @@ static OGS_POOL(nf_info_pool, ogs_sbi_nf_info_t);
 void ogs_sbi_context_init(OpenAPI_nf_type_e nf_type)
 {
     char nf_instance_id[OGS_UUID_FORMATTED_LENGTH + 1];
+    int i;
 
     ogs_assert(nf_type);
 
@@ -48,6 +50,10 @@ void ogs_sbi_context_init(OpenAPI_nf_type_e nf_type)
     ogs_sbi_client_init(ogs_app()->pool.event, ogs_app()->pool.event);
 
     ogs_list_init(&self.nf_instance_list);
+    self.nf_instance_id_hash = ogs_hash_make();
+    ogs_assert(self.nf_instance_id_hash);
+    for (i = 0; i < OGS_SBI_MAX_NUM_OF_NF_TYPE; i++)
+        ogs_list_init(&self.nf_type_list[i]);
     ogs_pool_init(&nf_instance_pool, ogs_app()->pool.nf);
     ogs_pool_init(&nf_service_pool, ogs_app()->pool.nf_service);
 
@@ -61,6 +67,8 @@ void ogs_sbi_context_init(OpenAPI_nf_type_e nf_type)
 
     ogs_pool_init(&nf_info_pool, ogs_app()->pool.nf * OGS_MAX_NUM_OF_NF_INFO);
 
+    ogs_sbi_discovery_cache_init(ogs_app()->pool.nf);
+
     /* Add SELF NF-Instance */
     self.nf_instance = ogs_sbi_nf_instance_add();
     ogs_assert(self.nf_instance);
@@ -99,8 +107,13 @@ void ogs_sbi_context_final(void)
 
     ogs_pool_final(&xact_pool);
 
+    ogs_sbi_discovery_cache_final();
+
     ogs_sbi_nf_instance_remove_all();
 
+    ogs_assert(self.nf_instance_id_hash);
+    ogs_hash_destroy(self.nf_instance_id_hash);
+
     ogs_pool_final(&nf_instance_pool);
     ogs_pool_final(&nf_service_pool);
     ogs_pool_final(&nf_info_pool);
@@ -131,6 +144,11 @@ static int ogs_sbi_context_prepare(void)
     self.client_delegated_config.nrf.disc = OGS_SBI_CLIENT_DELEGATED_AUTO;
     self.client_delegated_config.scp.next = OGS_SBI_CLIENT_DELEGATED_AUTO;
 
+    self.client_engine = OGS_SBI_CLIENT_ENGINE_CURL;
+    self.client_selection = OGS_SBI_CLIENT_SELECTION_FIRST;
+    self.client_connection.num = 1;
+    self.client_connection.stream = ogs_app()->pool.stream;
+
     return OGS_OK;
 }
 
@@ -610,6 +628,92 @@ int ogs_sbi_context_parse_config(
                                                 "key `%s`", del_key);
                                         }
                                     }
+                                } else if (!strcmp(client_key, "engine")) {
+                                    const char *v =
+                                        ogs_yaml_iter_value(&client_iter);
+                                    if (v) {
+                                        if (!ogs_strcasecmp(v, "curl"))
+                                            self.client_engine =
+                                            OGS_SBI_CLIENT_ENGINE_CURL;
+                                        else if (!ogs_strcasecmp(
+                                                    v, "nghttp2"))
+                                            self.client_engine =
+                                            OGS_SBI_CLIENT_ENGINE_NGHTTP2;
+                                        else
+                                            ogs_warn("unknown engine `%s`",
+                                                    v);
+                                    }
+                                } else if (!strcmp(client_key, "selection")) {
+                                    const char *v =
+                                        ogs_yaml_iter_value(&client_iter);
+                                    if (v) {
+                                        if (!ogs_strcasecmp(v, "first"))
+                                            self.client_selection =
+                                            OGS_SBI_CLIENT_SELECTION_FIRST;
+                                        else if (!ogs_strcasecmp(
+                                                    v, "weighted"))
+                                            self.client_selection =
+                                            OGS_SBI_CLIENT_SELECTION_WEIGHTED;
+                                        else if (!ogs_strcasecmp(
+                                                    v, "least_outstanding"))
+                                            self.client_selection =
+                                    OGS_SBI_CLIENT_SELECTION_LEAST_OUTSTANDING;
+                                        else if (!ogs_strcasecmp(
+                                                    v, "consistent_hash"))
+                                            self.client_selection =
+                                    OGS_SBI_CLIENT_SELECTION_CONSISTENT_HASH;
+                                        else
+                                            ogs_warn("unknown selection `%s`",
+                                                    v);
+                                    }
+                                } else if (!strcmp(client_key,
+                                            "connection")) {
+                                    ogs_yaml_iter_t connection_iter;
+                                    ogs_yaml_iter_recurse(&client_iter,
+                                            &connection_iter);
+
+                                    while (ogs_yaml_iter_next(
+                                                &connection_iter)) {
+                                        const char *connection_key =
+                                            ogs_yaml_iter_key(
+                                                    &connection_iter);
+                                        ogs_assert(connection_key);
+                                        if (!strcmp(connection_key, "num")) {
+                                            const char *v = ogs_yaml_iter_value(
+                                                    &connection_iter);
+                                            if (v)
+                                                self.client_connection.num =
+                                                    atoi(v);
+                                        } else if (!strcmp(connection_key,
+                                                    "warm_up")) {
+                                            self.client_connection.warm_up =
+                                                ogs_yaml_iter_bool(
+                                                        &connection_iter);
+                                        } else if (!strcmp(connection_key,
+                                                    "stream")) {
+                                            const char *v = ogs_yaml_iter_value(
+                                                    &connection_iter);
+                                            if (v && atoi(v) > 0)
+                                                self.client_connection.stream =
+                                                    atoi(v);
+                                        } else
+                                            ogs_warn("unknown connection "
+                                                    "key `%s`",
+                                                    connection_key);
+                                    }
+
+                                    if (self.client_connection.num < 1 ||
+                                        self.client_connection.num >
+                                        OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION) {
+                                        ogs_warn("connection.num %d is out of "
+                                                "range [1..%d]",
+                                                self.client_connection.num,
+                                        OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION);
+                                        self.client_connection.num =
+                                            ogs_max(1, ogs_min(
+                                                self.client_connection.num,
+                                        OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION));
+                                    }
                                 }
                             }
                         } else
@@ -645,6 +749,9 @@ int ogs_sbi_context_parse_config(
     rv = ogs_sbi_context_validation(local, nrf, scp);
     if (rv != OGS_OK) return rv;
 
+    if (self.client_engine == OGS_SBI_CLIENT_ENGINE_NGHTTP2)
+        ogs_nghttp2_client_init();
+
     return OGS_OK;
 }
 
@@ -1243,6 +1350,8 @@ ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_add(void)
     nf_instance->capacity = OGS_SBI_DEFAULT_CAPACITY;
     nf_instance->load = OGS_SBI_DEFAULT_LOAD;
 
+    nf_instance->type_node.nf_instance = nf_instance;
+
     ogs_list_add(&ogs_sbi_self()->nf_instance_list, nf_instance);
 
     ogs_debug("[%s] NFInstance added with Ref [%s]",
@@ -1253,13 +1362,49 @@ ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_add(void)
     return nf_instance;
 }
 
+static void nf_instance_id_hash_remove(ogs_sbi_nf_instance_t *nf_instance)
+{
+    ogs_sbi_nf_instance_t *other = NULL;
+
+    ogs_assert(nf_instance);
+    ogs_assert(nf_instance->id);
+
+    if (ogs_hash_get(self.nf_instance_id_hash,
+                nf_instance->id, OGS_HASH_KEY_STRING) != nf_instance)
+        return;
+
+    ogs_hash_set(self.nf_instance_id_hash,
+            nf_instance->id, OGS_HASH_KEY_STRING, NULL);
+
+    /* Another NF Instance with the same ID takes over the hash entry */
+    ogs_list_for_each(&self.nf_instance_list, other) {
+        if (other != nf_instance &&
+            other->id && strcmp(other->id, nf_instance->id) == 0) {
+            ogs_hash_set(self.nf_instance_id_hash,
+                    other->id, OGS_HASH_KEY_STRING, other);
+            break;
+        }
+    }
+}
+
 void ogs_sbi_nf_instance_set_id(ogs_sbi_nf_instance_t *nf_instance, char *id)
 {
     ogs_assert(nf_instance);
     ogs_assert(id);
 
+    if (nf_instance->id) {
+        nf_instance_id_hash_remove(nf_instance);
+        ogs_free(nf_instance->id);
+    }
+
     nf_instance->id = ogs_strdup(id);
     ogs_assert(nf_instance->id);
+
+    /* The first NF Instance with this ID is found as before */
+    if (!ogs_hash_get(self.nf_instance_id_hash,
+                nf_instance->id, OGS_HASH_KEY_STRING))
+        ogs_hash_set(self.nf_instance_id_hash,
+                nf_instance->id, OGS_HASH_KEY_STRING, nf_instance);
 }
 
 void ogs_sbi_nf_instance_set_type(
@@ -1267,8 +1412,18 @@ void ogs_sbi_nf_instance_set_type(
 {
     ogs_assert(nf_instance);
     ogs_assert(nf_type);
+    ogs_assert(nf_type < OGS_SBI_MAX_NUM_OF_NF_TYPE);
+
+    if (nf_instance->nf_type == nf_type)
+        return;
+
+    if (nf_instance->nf_type)
+        ogs_list_remove(&self.nf_type_list[nf_instance->nf_type],
+                &nf_instance->type_node);
 
     nf_instance->nf_type = nf_type;
+
+    ogs_list_add(&self.nf_type_list[nf_type], &nf_instance->type_node);
 }
 
 void ogs_sbi_nf_instance_set_status(
@@ -1352,6 +1507,13 @@ void ogs_sbi_nf_instance_remove(ogs_sbi_nf_instance_t *nf_instance)
 
     ogs_list_remove(&ogs_sbi_self()->nf_instance_list, nf_instance);
 
+    if (nf_instance->nf_type)
+        ogs_list_remove(&self.nf_type_list[nf_instance->nf_type],
+                &nf_instance->type_node);
+
+    if (nf_instance->id)
+        nf_instance_id_hash_remove(nf_instance);
+
     ogs_sbi_nf_info_remove_all(&nf_instance->nf_info_list);
 
     ogs_sbi_nf_service_remove_all(nf_instance);
@@ -1399,34 +1561,212 @@ ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find(char *id)
      */
     if (!id) return NULL;
 
-    ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
-        if (nf_instance->id && strcmp(nf_instance->id, id) == 0)
-            break;
-    }
+    nf_instance = ogs_hash_get(
+            self.nf_instance_id_hash, id, OGS_HASH_KEY_STRING);
 
     return nf_instance;
 }
 
+ogs_list_t *ogs_sbi_nf_instance_type_list(OpenAPI_nf_type_e nf_type)
+{
+    ogs_assert(nf_type < OGS_SBI_MAX_NUM_OF_NF_TYPE);
+
+    return &self.nf_type_list[nf_type];
+}
+
 ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find_by_discovery_param(
         OpenAPI_nf_type_e target_nf_type,
         OpenAPI_nf_type_e requester_nf_type,
         ogs_sbi_discovery_option_t *discovery_option)
 {
     ogs_sbi_nf_instance_t *nf_instance = NULL;
+    ogs_sbi_nf_type_node_t *node = NULL;
+
+    ogs_sbi_nf_instance_t *candidates[OGS_SBI_MAX_NUM_OF_NF_CANDIDATE];
+    int num_of_candidates = 0;
 
     ogs_assert(target_nf_type);
     ogs_assert(requester_nf_type);
 
-    ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
+    /* A specific NF Instance is requested : no need to look at others */
+    if (discovery_option && discovery_option->target_nf_instance_id) {
+        nf_instance = ogs_sbi_nf_instance_find(
+                discovery_option->target_nf_instance_id);
+        if (nf_instance &&
+            ogs_sbi_discovery_param_is_matched(
+                nf_instance, target_nf_type, requester_nf_type,
+                discovery_option) == true)
+            return nf_instance;
+
+        return NULL;
+    }
+
+    /* Only NF Instances of the target NF type are candidates */
+    ogs_list_for_each(ogs_sbi_nf_instance_type_list(target_nf_type), node) {
+        nf_instance = node->nf_instance;
+        ogs_assert(nf_instance);
+
         if (ogs_sbi_discovery_param_is_matched(
                     nf_instance, target_nf_type, requester_nf_type,
                     discovery_option) == false)
             continue;
 
-        return nf_instance;
+        if (self.client_selection == OGS_SBI_CLIENT_SELECTION_FIRST)
+            return nf_instance;
+
+        if (num_of_candidates == OGS_SBI_MAX_NUM_OF_NF_CANDIDATE)
+            break;
+        candidates[num_of_candidates++] = nf_instance;
     }
 
-    return NULL;
+    return ogs_sbi_nf_instance_select(
+            candidates, num_of_candidates, discovery_option);
+}
+
+/*
+ * The weight follows the capacity of the NF instance,
+ * reduced by the load it reports (0..100 percent).
+ */
+static int nf_instance_weight(ogs_sbi_nf_instance_t *nf_instance)
+{
+    int load, weight;
+
+    ogs_assert(nf_instance);
+
+    load = ogs_max(0, ogs_min(nf_instance->load, 100));
+    weight = nf_instance->capacity * (100 - load) / 100;
+
+    return ogs_max(weight, 1);
+}
+
+/* FNV-1a, continued from `hash` */
+static uint64_t hash_string(uint64_t hash, const char *s)
+{
+    ogs_assert(s);
+
+    while (*s) {
+        hash ^= (uint8_t)*s++;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+/* splitmix64 finalizer : spreads close FNV values over 64 bits */
+static uint64_t hash_mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+
+    return x;
+}
+
+/*
+ * Select one of the NF instances that matched a discovery.
+ *
+ * Only the candidates with the best priority (the lowest value,
+ * TS29.510 6.1.6.2.2) are considered; the others are standby.
+ * Among them, sbi.client.selection chooses:
+ *
+ * o first : the first candidate, as before
+ * o weighted : smooth weighted round-robin on capacity and load
+ * o least_outstanding : the fewest requests in flight per weight
+ * o consistent_hash : rendezvous hashing of the affinity key
+ *   (weighted if no affinity key is given)
+ */
+ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_select(
+        ogs_sbi_nf_instance_t **candidates, int num_of_candidates,
+        ogs_sbi_discovery_option_t *discovery_option)
+{
+    ogs_sbi_client_selection_e selection = self.client_selection;
+    ogs_sbi_nf_instance_t *nf_instance = NULL, *selected = NULL;
+    int i, priority, total = 0;
+
+    ogs_assert(candidates);
+
+    if (num_of_candidates == 0)
+        return NULL;
+    if (num_of_candidates == 1 ||
+        selection == OGS_SBI_CLIENT_SELECTION_FIRST)
+        return candidates[0];
+
+    priority = candidates[0]->priority;
+    for (i = 1; i < num_of_candidates; i++)
+        priority = ogs_min(priority, candidates[i]->priority);
+
+    if (selection == OGS_SBI_CLIENT_SELECTION_CONSISTENT_HASH) {
+        if (discovery_option && discovery_option->affinity_key) {
+            uint64_t key, score, best = 0;
+
+            key = hash_string(
+                    0xcbf29ce484222325ULL, discovery_option->affinity_key);
+
+            for (i = 0; i < num_of_candidates; i++) {
+                nf_instance = candidates[i];
+                if (nf_instance->priority != priority)
+                    continue;
+
+                ogs_assert(nf_instance->id);
+                score = hash_mix(hash_string(key, nf_instance->id));
+                if (!selected || score > best) {
+                    selected = nf_instance;
+                    best = score;
+                }
+            }
+
+            return selected;
+        }
+
+        selection = OGS_SBI_CLIENT_SELECTION_WEIGHTED;
+    }
+
+    if (selection == OGS_SBI_CLIENT_SELECTION_LEAST_OUTSTANDING) {
+        uint64_t outstanding, best = 0;
+        int weight, best_weight = 0;
+
+        for (i = 0; i < num_of_candidates; i++) {
+            ogs_sbi_client_t *client = NULL;
+
+            nf_instance = candidates[i];
+            if (nf_instance->priority != priority)
+                continue;
+
+            client = NF_INSTANCE_CLIENT(nf_instance);
+            outstanding = client ? client->outstanding : 0;
+            weight = nf_instance_weight(nf_instance);
+
+            /* outstanding/weight < best/best_weight */
+            if (!selected ||
+                outstanding * best_weight < best * weight) {
+                selected = nf_instance;
+                best = outstanding;
+                best_weight = weight;
+            }
+        }
+
+        return selected;
+    }
+
+    for (i = 0; i < num_of_candidates; i++) {
+        nf_instance = candidates[i];
+        if (nf_instance->priority != priority)
+            continue;
+
+        nf_instance->current_weight += nf_instance_weight(nf_instance);
+        total += nf_instance_weight(nf_instance);
+
+        if (!selected ||
+            nf_instance->current_weight > selected->current_weight)
+            selected = nf_instance;
+    }
+
+    ogs_assert(selected);
+    selected->current_weight -= total;
+
+    return selected;
 }
 
 ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find_by_service_type(
@@ -2109,6 +2449,7 @@ static void nf_service_associate_client(ogs_sbi_nf_service_t *nf_service)
         ogs_info("[%s] NFService associated [%s]",
                 nf_service->name, nf_service->id);
         OGS_SBI_SETUP_CLIENT(nf_service, client);
+        ogs_sbi_client_warm_up(client);
     }
 }
 
@@ -2444,6 +2785,7 @@ void ogs_sbi_client_associate(ogs_sbi_nf_instance_t *nf_instance)
                 nf_instance->id);
 
         OGS_SBI_SETUP_CLIENT(nf_instance, client);
+        ogs_sbi_client_warm_up(client);
     }
 
     nf_service_associate_client_all(nf_instance);
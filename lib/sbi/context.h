@@ -30,6 +30,7 @@ extern "C" {
 
 #define OGS_MAX_NUM_OF_NF_INFO 8
 #define OGS_MAX_NUM_OF_SCP_DOMAIN 8
+#define OGS_SBI_MAX_NUM_OF_NF_TYPE 128
 
 typedef struct ogs_sbi_client_s ogs_sbi_client_t;
 typedef struct ogs_sbi_smf_info_s ogs_sbi_smf_info_t;
@@ -52,10 +53,35 @@ typedef struct ogs_sbi_client_delegated_config_s {
     } scp;
 } ogs_sbi_client_delegated_config_t;
 
+typedef enum {
+    OGS_SBI_CLIENT_ENGINE_CURL = 0,
+    OGS_SBI_CLIENT_ENGINE_NGHTTP2,
+} ogs_sbi_client_engine_e;
+
+typedef enum {
+    OGS_SBI_CLIENT_SELECTION_FIRST = 0,
+    OGS_SBI_CLIENT_SELECTION_WEIGHTED,
+    OGS_SBI_CLIENT_SELECTION_LEAST_OUTSTANDING,
+    OGS_SBI_CLIENT_SELECTION_CONSISTENT_HASH,
+} ogs_sbi_client_selection_e;
+
 typedef struct ogs_sbi_context_s {
     /* For sbi.client.delegated */
     ogs_sbi_client_delegated_config_t client_delegated_config;
 
+    /* For sbi.client.engine */
+    ogs_sbi_client_engine_e client_engine;
+
+    /* For sbi.client.selection */
+    ogs_sbi_client_selection_e client_selection;
+
+    /* For sbi.client.connection */
+    struct {
+        int num;        /* HTTP/2 connections per peer (nghttp2 engine) */
+        bool warm_up;   /* Open them when the peer is associated */
+        int stream;     /* Streams in flight to all peers (nghttp2 engine) */
+    } client_connection;
+
 #define OGS_HOME_NETWORK_PKI_VALUE_MIN 1
 #define OGS_HOME_NETWORK_PKI_VALUE_MAX 254
 
@@ -96,6 +122,9 @@ typedef struct ogs_sbi_context_s {
     ogs_uuid_t uuid;
 
     ogs_list_t nf_instance_list;
+    ogs_hash_t *nf_instance_id_hash;    /* hash table for NF Instance ID */
+    ogs_list_t nf_type_list[OGS_SBI_MAX_NUM_OF_NF_TYPE]; /* by NF Type */
+
     ogs_list_t subscription_spec_list;
     ogs_list_t subscription_data_list;
 
@@ -110,8 +139,15 @@ typedef struct ogs_sbi_context_s {
     const char *service_name[OGS_SBI_MAX_NUM_OF_SERVICE_TYPE];
 } ogs_sbi_context_t;
 
+/* Entry of ogs_sbi_self()->nf_type_list[] */
+typedef struct ogs_sbi_nf_type_node_s {
+    ogs_lnode_t lnode;
+    ogs_sbi_nf_instance_t *nf_instance;
+} ogs_sbi_nf_type_node_t;
+
 typedef struct ogs_sbi_nf_instance_s {
     ogs_lnode_t lnode;
+    ogs_sbi_nf_type_node_t type_node;
 
     ogs_fsm_t sm;                           /* A state machine */
     ogs_timer_t *t_registration_interval;   /* timer to retry
@@ -170,7 +206,6 @@ typedef struct ogs_sbi_nf_instance_s {
     ogs_sockaddr_t *ipv6[OGS_SBI_MAX_NUM_OF_IP_ADDRESS];
 
     int num_of_allowed_nf_type;
-#define OGS_SBI_MAX_NUM_OF_NF_TYPE 128
     OpenAPI_nf_type_e allowed_nf_type[OGS_SBI_MAX_NUM_OF_NF_TYPE];
 
 #define OGS_SBI_DEFAULT_PRIORITY 0
@@ -180,6 +215,9 @@ typedef struct ogs_sbi_nf_instance_s {
     int capacity;
     int load;
 
+    /* Smooth weighted round-robin : see ogs_sbi_nf_instance_select() */
+    int current_weight;
+
     ogs_list_t nf_service_list;
     ogs_list_t nf_info_list;
 
@@ -478,10 +516,15 @@ void ogs_sbi_nf_instance_clear(ogs_sbi_nf_instance_t *nf_instance);
 void ogs_sbi_nf_instance_remove(ogs_sbi_nf_instance_t *nf_instance);
 void ogs_sbi_nf_instance_remove_all(void);
 ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find(char *id);
+ogs_list_t *ogs_sbi_nf_instance_type_list(OpenAPI_nf_type_e nf_type);
 ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find_by_discovery_param(
         OpenAPI_nf_type_e nf_type,
         OpenAPI_nf_type_e requester_nf_type,
         ogs_sbi_discovery_option_t *discovery_option);
+#define OGS_SBI_MAX_NUM_OF_NF_CANDIDATE 64
+ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_select(
+        ogs_sbi_nf_instance_t **candidates, int num_of_candidates,
+        ogs_sbi_discovery_option_t *discovery_option);
 ogs_sbi_nf_instance_t *ogs_sbi_nf_instance_find_by_service_type(
         ogs_sbi_service_type_e service_type,
         OpenAPI_nf_type_e requester_nf_type);
@@ -20,6 +20,9 @@
 #include "ogs-sbi.h"
 #include "yuarel.h"
 
+#include <openssl/evp.h>
+#include <openssl/ec.h>
+
 static int parse_scheme_output(
         char *_protection_scheme_id, char *_scheme_output,
         ogs_datum_t *ecckey, ogs_datum_t *cipher_text, uint8_t *mactag)
@@ -79,6 +82,91 @@ static int parse_scheme_output(
     return OGS_OK;
 }
 
+/*
+ * ECDH for SUCI de-concealment.
+ *
+ * libcrypto is already linked for TLS and its X25519/P-256 are much
+ * faster than curve25519-donna and the portable ecc.c, so they are tried
+ * first. On any failure we fall back to the built-in implementation.
+ */
+static int x25519_shared_secret(
+        const uint8_t *pub, const uint8_t *key, uint8_t *z)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    EVP_PKEY *priv_key = NULL, *peer_key = NULL;
+    EVP_PKEY_CTX *ctx = NULL;
+    size_t len = OGS_ECCKEY_LEN;
+    int rv = OGS_ERROR;
+
+    priv_key = EVP_PKEY_new_raw_private_key(
+            EVP_PKEY_X25519, NULL, key, OGS_ECCKEY_LEN);
+    peer_key = EVP_PKEY_new_raw_public_key(
+            EVP_PKEY_X25519, NULL, pub, OGS_ECCKEY_LEN);
+    if (priv_key && peer_key)
+        ctx = EVP_PKEY_CTX_new(priv_key, NULL);
+
+    if (ctx &&
+        EVP_PKEY_derive_init(ctx) == 1 &&
+        EVP_PKEY_derive_set_peer(ctx, peer_key) == 1 &&
+        EVP_PKEY_derive(ctx, z, &len) == 1 && len == OGS_ECCKEY_LEN)
+        rv = OGS_OK;
+
+    EVP_PKEY_CTX_free(ctx);
+    EVP_PKEY_free(peer_key);
+    EVP_PKEY_free(priv_key);
+
+    if (rv == OGS_OK)
+        return OGS_OK;
+#endif
+
+    curve25519_donna(z, key, pub);
+    return OGS_OK;
+}
+
+static int p256_shared_secret(
+        const uint8_t *pub, const uint8_t *key, uint8_t *z)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    EC_GROUP *group = NULL;
+    EC_POINT *peer = NULL, *shared = NULL;
+    BIGNUM *priv = NULL, *x = NULL;
+    BN_CTX *bn_ctx = NULL;
+    int rv = OGS_ERROR;
+
+    group = EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1);
+    bn_ctx = BN_CTX_new();
+    if (group && bn_ctx) {
+        peer = EC_POINT_new(group);
+        shared = EC_POINT_new(group);
+        priv = BN_bin2bn(key, OGS_ECCKEY_LEN, NULL);
+        x = BN_new();
+    }
+
+    /* The UE public key is a compressed point */
+    if (peer && shared && priv && x &&
+        EC_POINT_oct2point(group, peer, pub, OGS_ECCKEY_LEN+1, bn_ctx) == 1 &&
+        EC_POINT_mul(group, shared, NULL, peer, priv, bn_ctx) == 1 &&
+        EC_POINT_get_affine_coordinates(group, shared, x, NULL, bn_ctx) == 1 &&
+        BN_bn2binpad(x, z, OGS_ECCKEY_LEN) == OGS_ECCKEY_LEN)
+        rv = OGS_OK;
+
+    BN_clear_free(priv);
+    BN_free(x);
+    EC_POINT_free(shared);
+    EC_POINT_free(peer);
+    BN_CTX_free(bn_ctx);
+    EC_GROUP_free(group);
+
+    if (rv == OGS_OK)
+        return OGS_OK;
+#endif
+
+    if (ecdh_shared_secret(pub, key, z) != 1)
+        return OGS_ERROR;
+
+    return OGS_OK;
+}
+
 char *ogs_supi_from_suci(char *suci)
 {
 #define MAX_SUCI_TOKEN 16
@@ -165,17 +253,17 @@ char *ogs_supi_from_suci(char *suci)
 
                     if (protection_scheme_id ==
                             OGS_PROTECTION_SCHEME_PROFILE_A) {
-                        curve25519_donna(z,
+                        x25519_shared_secret(pubkey.data,
                             ogs_sbi_self()->hnet[home_network_pki_value].key,
-                            pubkey.data);
+                            z);
                     } else if (protection_scheme_id ==
                             OGS_PROTECTION_SCHEME_PROFILE_B) {
-                        if (ecdh_shared_secret(
+                        if (p256_shared_secret(
                                 pubkey.data,
                                 ogs_sbi_self()->
                                     hnet[home_network_pki_value].key,
-                                z) != 1) {
-                            ogs_error("ecdh_shared_secret() failed");
+                                z) != OGS_OK) {
+                            ogs_error("p256_shared_secret() failed");
                             ogs_log_hexdump(OGS_LOG_ERROR,
                                     pubkey.data, OGS_ECCKEY_LEN);
                             ogs_log_hexdump(OGS_LOG_ERROR,
@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-sbi.h"
+
+typedef struct discovery_cache_entry_s {
+    ogs_lnode_t lnode; /* oldest first */
+
+    char *key;
+    OpenAPI_nf_type_e target_nf_type;
+    ogs_time_t expires; /* monotonic */
+
+    int num_of_nf_instance_id;
+    char *nf_instance_id[OGS_SBI_DISCOVERY_CACHE_MAX_NF_INSTANCE];
+} discovery_cache_entry_t;
+
+static OGS_POOL(entry_pool, discovery_cache_entry_t);
+static OGS_LIST(entry_list);
+static ogs_hash_t *entry_hash;
+
+static ogs_sbi_discovery_cache_stat_t cache_stat;
+
+void ogs_sbi_discovery_cache_init(int num_of_entry)
+{
+    ogs_list_init(&entry_list);
+    ogs_pool_init(&entry_pool, num_of_entry);
+
+    entry_hash = ogs_hash_make();
+    ogs_assert(entry_hash);
+
+    memset(&cache_stat, 0, sizeof(cache_stat));
+}
+
+void ogs_sbi_discovery_cache_final(void)
+{
+    ogs_sbi_discovery_cache_remove_all();
+
+    ogs_assert(entry_hash);
+    ogs_hash_destroy(entry_hash);
+
+    ogs_pool_final(&entry_pool);
+}
+
+static int strptr_compare(const void *a, const void *b)
+{
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static int snssai_compare(const void *a, const void *b)
+{
+    const ogs_s_nssai_t *x = a, *y = b;
+
+    if (x->sst != y->sst)
+        return x->sst < y->sst ? -1 : 1;
+    if (x->sd.v != y->sd.v)
+        return x->sd.v < y->sd.v ? -1 : 1;
+    return 0;
+}
+
+static int plmn_id_compare(const void *a, const void *b)
+{
+    return memcmp(a, b, sizeof(ogs_plmn_id_t));
+}
+
+/*
+ * The key does not depend on the order in which service names,
+ * S-NSSAIs or PLMNs were added to the discovery option.
+ */
+static char *build_key(char *buf, size_t size,
+        OpenAPI_nf_type_e target_nf_type,
+        OpenAPI_nf_type_e requester_nf_type,
+        ogs_sbi_discovery_option_t *discovery_option)
+{
+    char *p = buf, *last = buf + size;
+    int i;
+
+    p = ogs_slprintf(p, last, "%d/%d", target_nf_type, requester_nf_type);
+
+    if (!discovery_option)
+        return buf;
+
+    if (discovery_option->target_nf_instance_id)
+        p = ogs_slprintf(p, last, "/tid=%s",
+                discovery_option->target_nf_instance_id);
+    if (discovery_option->requester_nf_instance_id)
+        p = ogs_slprintf(p, last, "/rid=%s",
+                discovery_option->requester_nf_instance_id);
+
+    if (discovery_option->num_of_service_names) {
+        char *service_names[OGS_SBI_MAX_NUM_OF_SERVICE_TYPE];
+
+        memcpy(service_names, discovery_option->service_names,
+                sizeof(char *) * discovery_option->num_of_service_names);
+        qsort(service_names, discovery_option->num_of_service_names,
+                sizeof(char *), strptr_compare);
+
+        p = ogs_slprintf(p, last, "/svc=");
+        for (i = 0; i < discovery_option->num_of_service_names; i++)
+            p = ogs_slprintf(p, last, "%s,", service_names[i]);
+    }
+
+    if (discovery_option->num_of_snssais) {
+        ogs_s_nssai_t snssais[OGS_MAX_NUM_OF_SLICE];
+
+        memcpy(snssais, discovery_option->snssais,
+                sizeof(ogs_s_nssai_t) * discovery_option->num_of_snssais);
+        qsort(snssais, discovery_option->num_of_snssais,
+                sizeof(ogs_s_nssai_t), snssai_compare);
+
+        p = ogs_slprintf(p, last, "/snssai=");
+        for (i = 0; i < discovery_option->num_of_snssais; i++)
+            p = ogs_slprintf(p, last, "%d-%06x,",
+                    snssais[i].sst, snssais[i].sd.v);
+    }
+
+    if (discovery_option->dnn)
+        p = ogs_slprintf(p, last, "/dnn=%s", discovery_option->dnn);
+
+    if (discovery_option->tai_presence)
+        p = ogs_slprintf(p, last, "/tai=%06x-%06x",
+                ogs_plmn_id_hexdump(&discovery_option->tai.plmn_id),
+                discovery_option->tai.tac.v);
+
+    if (discovery_option->guami_presence)
+        p = ogs_slprintf(p, last, "/guami=%06x-%06x",
+                ogs_plmn_id_hexdump(&discovery_option->guami.plmn_id),
+                ogs_amf_id_hexdump(&discovery_option->guami.amf_id));
+
+    if (discovery_option->num_of_target_plmn_list) {
+        ogs_plmn_id_t plmn_list[OGS_MAX_NUM_OF_PLMN];
+
+        memcpy(plmn_list, discovery_option->target_plmn_list,
+                sizeof(ogs_plmn_id_t) *
+                discovery_option->num_of_target_plmn_list);
+        qsort(plmn_list, discovery_option->num_of_target_plmn_list,
+                sizeof(ogs_plmn_id_t), plmn_id_compare);
+
+        p = ogs_slprintf(p, last, "/tplmn=");
+        for (i = 0; i < discovery_option->num_of_target_plmn_list; i++)
+            p = ogs_slprintf(p, last, "%06x,",
+                    ogs_plmn_id_hexdump(&plmn_list[i]));
+    }
+
+    if (discovery_option->num_of_requester_plmn_list) {
+        ogs_plmn_id_t plmn_list[OGS_MAX_NUM_OF_PLMN];
+
+        memcpy(plmn_list, discovery_option->requester_plmn_list,
+                sizeof(ogs_plmn_id_t) *
+                discovery_option->num_of_requester_plmn_list);
+        qsort(plmn_list, discovery_option->num_of_requester_plmn_list,
+                sizeof(ogs_plmn_id_t), plmn_id_compare);
+
+        p = ogs_slprintf(p, last, "/rplmn=");
+        for (i = 0; i < discovery_option->num_of_requester_plmn_list; i++)
+            p = ogs_slprintf(p, last, "%06x,",
+                    ogs_plmn_id_hexdump(&plmn_list[i]));
+    }
+
+    if (discovery_option->hnrf_uri)
+        p = ogs_slprintf(p, last, "/hnrf=%s", discovery_option->hnrf_uri);
+
+    if (discovery_option->requester_features)
+        p = ogs_slprintf(p, last, "/features=%llx",
+                (long long)discovery_option->requester_features);
+
+    return buf;
+}
+
+static void entry_remove(discovery_cache_entry_t *entry)
+{
+    int i;
+
+    ogs_assert(entry);
+
+    ogs_list_remove(&entry_list, entry);
+    ogs_hash_set(entry_hash, entry->key, OGS_HASH_KEY_STRING, NULL);
+
+    for (i = 0; i < entry->num_of_nf_instance_id; i++)
+        ogs_free(entry->nf_instance_id[i]);
+    ogs_free(entry->key);
+
+    ogs_pool_free(&entry_pool, entry);
+
+    cache_stat.entries--;
+}
+
+void ogs_sbi_discovery_cache_remove_all(void)
+{
+    discovery_cache_entry_t *entry = NULL, *next_entry = NULL;
+
+    ogs_list_for_each_safe(&entry_list, next_entry, entry)
+        entry_remove(entry);
+}
+
+void ogs_sbi_discovery_cache_add(
+        OpenAPI_nf_type_e target_nf_type,
+        OpenAPI_nf_type_e requester_nf_type,
+        ogs_sbi_discovery_option_t *discovery_option,
+        OpenAPI_search_result_t *SearchResult)
+{
+    char key[OGS_HUGE_LEN];
+    discovery_cache_entry_t *entry = NULL;
+    OpenAPI_lnode_t *node = NULL;
+
+    ogs_assert(target_nf_type);
+    ogs_assert(requester_nf_type);
+    ogs_assert(SearchResult);
+
+    /* Without validityPeriod, the NRF gives no hint how long to keep it */
+    if (!SearchResult->is_validity_period || !SearchResult->validity_period)
+        return;
+
+    build_key(key, sizeof(key),
+            target_nf_type, requester_nf_type, discovery_option);
+
+    entry = ogs_hash_get(entry_hash, key, OGS_HASH_KEY_STRING);
+    if (entry)
+        entry_remove(entry);
+
+    if (entry_pool.avail <= 0) {
+        /* Make room by dropping the oldest result */
+        entry = ogs_list_first(&entry_list);
+        ogs_assert(entry);
+        entry_remove(entry);
+    }
+
+    ogs_pool_alloc(&entry_pool, &entry);
+    ogs_assert(entry);
+    memset(entry, 0, sizeof(*entry));
+
+    OpenAPI_list_for_each(SearchResult->nf_instances, node) {
+        OpenAPI_nf_profile_t *NFProfile = node->data;
+
+        if (entry->num_of_nf_instance_id >=
+                OGS_SBI_DISCOVERY_CACHE_MAX_NF_INSTANCE)
+            break;
+
+        if (!NFProfile || !NFProfile->nf_instance_id)
+            continue;
+        if (NFProfile->nf_type != target_nf_type)
+            continue;
+        if (NF_INSTANCE_ID_IS_SELF(NFProfile->nf_instance_id))
+            continue;
+
+        entry->nf_instance_id[entry->num_of_nf_instance_id] =
+            ogs_strdup(NFProfile->nf_instance_id);
+        ogs_assert(entry->nf_instance_id[entry->num_of_nf_instance_id]);
+        entry->num_of_nf_instance_id++;
+    }
+
+    if (!entry->num_of_nf_instance_id) {
+        ogs_pool_free(&entry_pool, entry);
+        return;
+    }
+
+    entry->key = ogs_strdup(key);
+    ogs_assert(entry->key);
+    entry->target_nf_type = target_nf_type;
+    entry->expires = ogs_monotonic_coarse() +
+        ogs_time_from_sec(SearchResult->validity_period);
+
+    ogs_list_add(&entry_list, entry);
+    ogs_hash_set(entry_hash, entry->key, OGS_HASH_KEY_STRING, entry);
+
+    cache_stat.entries++;
+
+    ogs_debug("[%s] Discovery cached [%d NF Instance(s), validity:%ds]",
+            key, entry->num_of_nf_instance_id, SearchResult->validity_period);
+}
+
+ogs_sbi_nf_instance_t *ogs_sbi_discovery_cache_find(
+        OpenAPI_nf_type_e target_nf_type,
+        OpenAPI_nf_type_e requester_nf_type,
+        ogs_sbi_discovery_option_t *discovery_option)
+{
+    char key[OGS_HUGE_LEN];
+    discovery_cache_entry_t *entry = NULL;
+    ogs_sbi_nf_instance_t *nf_instance = NULL;
+    ogs_sbi_nf_instance_t *candidates[OGS_SBI_DISCOVERY_CACHE_MAX_NF_INSTANCE];
+    int i, num_of_candidates = 0;
+
+    ogs_assert(target_nf_type);
+    ogs_assert(requester_nf_type);
+
+    build_key(key, sizeof(key),
+            target_nf_type, requester_nf_type, discovery_option);
+
+    entry = ogs_hash_get(entry_hash, key, OGS_HASH_KEY_STRING);
+    if (!entry) {
+        cache_stat.miss++;
+        return NULL;
+    }
+
+    if (ogs_monotonic_coarse() >= entry->expires) {
+        ogs_debug("[%s] Discovery cache expired", key);
+        entry_remove(entry);
+        cache_stat.expired++;
+        cache_stat.miss++;
+        return NULL;
+    }
+
+    /* NF Instances may have gone since the NRF answered */
+    for (i = 0; i < entry->num_of_nf_instance_id; i++) {
+        nf_instance = ogs_sbi_nf_instance_find(entry->nf_instance_id[i]);
+        if (nf_instance &&
+            nf_instance->nf_type == target_nf_type &&
+            OGS_FSM_CHECK(&nf_instance->sm, ogs_sbi_nf_state_registered))
+            candidates[num_of_candidates++] = nf_instance;
+    }
+
+    if (!num_of_candidates) {
+        entry_remove(entry);
+        cache_stat.miss++;
+        return NULL;
+    }
+
+    cache_stat.hit++;
+
+    return ogs_sbi_nf_instance_select(
+            candidates, num_of_candidates, discovery_option);
+}
+
+void ogs_sbi_discovery_cache_invalidate(OpenAPI_nf_type_e target_nf_type)
+{
+    discovery_cache_entry_t *entry = NULL, *next_entry = NULL;
+
+    ogs_list_for_each_safe(&entry_list, next_entry, entry) {
+        if (entry->target_nf_type != target_nf_type)
+            continue;
+
+        entry_remove(entry);
+        cache_stat.invalidated++;
+    }
+}
+
+void ogs_sbi_discovery_cache_stat(ogs_sbi_discovery_cache_stat_t *stat)
+{
+    ogs_assert(stat);
+
+    memcpy(stat, &cache_stat, sizeof(*stat));
+}
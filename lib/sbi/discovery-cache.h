@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined(OGS_SBI_INSIDE) && !defined(OGS_SBI_COMPILATION)
+#error "This header cannot be included directly."
+#endif
+
+#ifndef OGS_SBI_DISCOVERY_CACHE_H
+#define OGS_SBI_DISCOVERY_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Results of NFDiscover are remembered per (target NF type,
+ * requester NF type, discovery option) until the validityPeriod
+ * of the SearchResult expires or the NRF notifies a change
+ * for the target NF type.
+ */
+#define OGS_SBI_DISCOVERY_CACHE_MAX_NF_INSTANCE 8
+
+typedef struct ogs_sbi_discovery_cache_stat_s {
+    uint64_t hit;
+    uint64_t miss;
+    uint64_t expired;
+    uint64_t invalidated;
+    int entries;
+} ogs_sbi_discovery_cache_stat_t;
+
+void ogs_sbi_discovery_cache_init(int num_of_entry);
+void ogs_sbi_discovery_cache_final(void);
+
+void ogs_sbi_discovery_cache_add(
+        OpenAPI_nf_type_e target_nf_type,
+        OpenAPI_nf_type_e requester_nf_type,
+        ogs_sbi_discovery_option_t *discovery_option,
+        OpenAPI_search_result_t *SearchResult);
+ogs_sbi_nf_instance_t *ogs_sbi_discovery_cache_find(
+        OpenAPI_nf_type_e target_nf_type,
+        OpenAPI_nf_type_e requester_nf_type,
+        ogs_sbi_discovery_option_t *discovery_option);
+void ogs_sbi_discovery_cache_invalidate(OpenAPI_nf_type_e target_nf_type);
+void ogs_sbi_discovery_cache_remove_all(void);
+
+/* Safe to call from any thread : fills a snapshot of the counters */
+void ogs_sbi_discovery_cache_stat(ogs_sbi_discovery_cache_stat_t *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OGS_SBI_DISCOVERY_CACHE_H */
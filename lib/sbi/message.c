@@ -1434,13 +1434,65 @@ void ogs_sbi_http_hash_free(ogs_hash_t *hash)
     ogs_hash_destroy(hash);
 }
 
+/*
+ * Initial size of the print buffer, estimated from the tree.
+ *
+ * cJSON_PrintUnformatted() would start with 256 bytes. The estimate
+ * does not need to be exact : cJSON still grows the buffer if the
+ * document turns out to be larger, e.g. with escaped strings.
+ */
+#define OGS_SBI_JSON_MIN_PREBUFFER 256
+
+static size_t json_estimate_length(const cJSON *item)
+{
+    size_t length = 0;
+
+    for (; item; item = item->next) {
+        if (item->string)
+            length += strlen(item->string) + 3; /* "name": */
+
+        if (cJSON_IsArray(item) || cJSON_IsObject(item))
+            length += json_estimate_length(item->child) + 2;
+        else if (cJSON_IsString(item) || cJSON_IsRaw(item))
+            length += (item->valuestring ? strlen(item->valuestring) : 0) + 2;
+        else if (cJSON_IsNumber(item))
+            length += 24;
+        else
+            length += 5; /* true, false, null */
+
+        if (item->next)
+            length++; /* , */
+    }
+
+    return length;
+}
+
+static int json_prebuffer(const cJSON *item)
+{
+    size_t length = json_estimate_length(item) + 1;
+
+    length = ogs_min(length, (size_t)OGS_MAX_SDU_LEN);
+    return ogs_max((int)length, OGS_SBI_JSON_MIN_PREBUFFER);
+}
+
 static char *build_json(ogs_sbi_message_t *message)
 {
     char *content = NULL;
     cJSON *item = NULL;
+    ogs_mem_arena_t *arena = NULL, *prev = NULL;
 
     ogs_assert(message);
 
+    /*
+     * The cJSON tree only lives until it is printed.
+     * Build it in a per-message arena and release it at once
+     * instead of cJSON_Delete().
+     */
+    arena = ogs_mem_arena_create("json");
+    ogs_assert(arena);
+
+    prev = ogs_mem_arena_switch(arena);
+
     if (message->ProblemDetails) {
         item = OpenAPI_problem_details_convertToJSON(message->ProblemDetails);
         ogs_assert(item);
@@ -1726,13 +1778,16 @@ static char *build_json(ogs_sbi_message_t *message)
         ogs_assert(item);
     }
 
+    ogs_mem_arena_switch(prev);
+
     if (item) {
-        content = cJSON_PrintUnformatted(item);
+        content = cJSON_PrintBuffered(item, json_prebuffer(item), false);
         ogs_assert(content);
         ogs_log_print(OGS_LOG_TRACE, "%s", content);
-        cJSON_Delete(item);
     }
 
+    ogs_mem_arena_destroy(arena);
+
     return content;
 }
 
@@ -1741,6 +1796,7 @@ static int parse_json(ogs_sbi_message_t *message,
 {
     int rv = OGS_OK;
     cJSON *item = NULL;
+    ogs_mem_arena_t *arena = NULL, *prev = NULL;
 
     ogs_assert(message);
 
@@ -1753,9 +1809,22 @@ static int parse_json(ogs_sbi_message_t *message,
     }
 
     ogs_log_print(OGS_LOG_TRACE, "%s", json);
+
+    /*
+     * The cJSON tree is only needed while the OpenAPI structures
+     * are being built. Allocate it from a per-message arena
+     * and release it at once instead of cJSON_Delete().
+     */
+    arena = ogs_mem_arena_create("json");
+    ogs_assert(arena);
+
+    prev = ogs_mem_arena_switch(arena);
     item = cJSON_Parse(json);
+    ogs_mem_arena_switch(prev);
+
     if (!item) {
         ogs_error("JSON parse error [%s]", json);
+        ogs_mem_arena_destroy(arena);
         return OGS_ERROR;
     }
 
@@ -3077,7 +3146,7 @@ static int parse_json(ogs_sbi_message_t *message,
 
 cleanup:
 
-    cJSON_Delete(item);
+    ogs_mem_arena_destroy(arena);
     return rv;
 }
 
@@ -3578,6 +3647,9 @@ void ogs_sbi_discovery_option_free(
     if (discovery_option->hnrf_uri)
         ogs_free(discovery_option->hnrf_uri);
 
+    if (discovery_option->affinity_key)
+        ogs_free(discovery_option->affinity_key);
+
     ogs_free(discovery_option);
 }
 
@@ -3615,6 +3687,17 @@ void ogs_sbi_discovery_option_set_dnn(
     ogs_assert(discovery_option->dnn);
 }
 
+void ogs_sbi_discovery_option_set_affinity_key(
+        ogs_sbi_discovery_option_t *discovery_option, char *affinity_key)
+{
+    ogs_assert(discovery_option);
+    ogs_assert(affinity_key);
+
+    ogs_assert(!discovery_option->affinity_key);
+    discovery_option->affinity_key = ogs_strdup(affinity_key);
+    ogs_assert(discovery_option->affinity_key);
+}
+
 void ogs_sbi_discovery_option_add_service_names(
         ogs_sbi_discovery_option_t *discovery_option,
         char *service_name)
@@ -477,6 +477,13 @@ typedef struct ogs_sbi_discovery_option_s {
     char *hnrf_uri;
 
     uint64_t requester_features;
+
+    /*
+     * Not sent to the NRF. With sbi.client.selection: consistent_hash,
+     * the same key (e.g. SUPI) selects the same NF instance
+     * as long as the candidates do not change.
+     */
+    char *affinity_key;
 } ogs_sbi_discovery_option_t;
 
 typedef struct ogs_sbi_message_s {
@@ -694,6 +701,8 @@ void ogs_sbi_discovery_option_set_requester_nf_instance_id(
         char *requester_nf_instance_id);
 void ogs_sbi_discovery_option_set_dnn(
         ogs_sbi_discovery_option_t *discovery_option, char *dnn);
+void ogs_sbi_discovery_option_set_affinity_key(
+        ogs_sbi_discovery_option_t *discovery_option, char *affinity_key);
 
 void ogs_sbi_discovery_option_add_service_names(
         ogs_sbi_discovery_option_t *discovery_option,
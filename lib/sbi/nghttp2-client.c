@@ -0,0 +1,1991 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Native HTTP/2 client.
+ *
+ * Every ogs_sbi_client_t owns up to sbi.client.connection.num connections
+ * to its peer which are kept open and shared by all requests as HTTP/2
+ * streams. A new request goes to the connection with the fewest streams
+ * in flight, so that one congested connection does not hold up the others.
+ * Requests made before a connection is up are queued on it and
+ * submitted once the (TLS) connection is established.
+ */
+
+#include "ogs-sbi.h"
+#include "nghttp2-common.h"
+
+#include <netinet/tcp.h>
+#include <nghttp2/nghttp2.h>
+
+#define MAX_HTTP_CONTENT_LEN (256 * 1024 * 1024) /* 256MB */
+#define MAX_HTTP_CONTENT_HINT (1024 * 1024) /* Do not trust a larger one */
+
+/* PING is sent at most this often to measure the round-trip time */
+#define PING_INTERVAL ogs_time_from_sec(1)
+
+typedef enum {
+    CONNECTION_CLOSED = 0,
+    CONNECTION_RESOLVING,       /* Waiting for the resolver thread */
+    CONNECTION_CONNECTING,      /* TCP connect() in progress */
+    CONNECTION_HANDSHAKING,     /* TLS handshake in progress */
+    CONNECTION_ESTABLISHED,
+} connection_state_e;
+
+typedef struct ogs_nghttp2_connection_s {
+    ogs_sbi_client_t        *client;
+    int                     index;  /* in client->h2[] */
+    connection_state_e      state;
+
+    ogs_sock_t              *sock;
+    struct {
+        ogs_poll_t          *read;
+        ogs_poll_t          *write;
+    } poll;
+
+    SSL_CTX                 *ssl_ctx;
+    SSL                     *ssl;
+
+    nghttp2_session         *session;
+    ogs_sbi_write_queue_t   write_queue;
+
+    ogs_list_t              stream_list;
+    int                     num_of_stream;
+
+    bool                    goaway;         /* draining : no new streams */
+    uint64_t                num_of_goaway;
+
+    ogs_time_t              ping_sent;      /* 0 if no PING in flight */
+    ogs_time_t              ping_last;
+    ogs_time_t              rtt;
+
+    /*
+     * :scheme and :authority are the same for every request
+     * on this connection, so they are built only once.
+     */
+    char                    *authority;
+    nghttp2_nv              nv[2];
+} ogs_nghttp2_connection_t;
+
+typedef struct stream_s {
+    ogs_lnode_t             lnode;
+
+    ogs_pool_id_t           id;
+
+    int32_t                 stream_id; /* 0 until submitted */
+    bool                    closed;
+    uint32_t                error_code;
+
+    ogs_nghttp2_connection_t *conn;
+
+    ogs_sbi_client_cb_f     client_cb;
+    void                    *data;
+
+    ogs_timer_t             *timer;
+
+    char                    *method;
+    char                    *uri;
+    char                    *path;
+
+    nghttp2_nv              *nva;
+    size_t                  nvlen;
+    char                    **names; /* lower-cased header names */
+
+    char                    *content;
+    size_t                  content_length;
+    size_t                  content_offset;
+
+    int                     status;
+    char                    *content_type;
+    char                    *location;
+    char                    *producer_id;
+
+    char                    *memory;
+    size_t                  size;
+    size_t                  memory_size;
+    size_t                  content_length_hint;
+    bool                    memory_overflow;
+} stream_t;
+
+static OGS_POOL(connection_pool, ogs_nghttp2_connection_t);
+static OGS_POOL(stream_pool, stream_t);
+
+/*
+ * getaddrinfo() may block for seconds, so the peer FQDN is looked up
+ * on a resolver thread. The result is handed back to the pollset thread
+ * through a socket pair and the connections waiting for it are opened.
+ */
+typedef struct resolve_s {
+    ogs_sbi_client_t        *client;    /* NULL once the client is gone */
+    char                    *fqdn;
+    uint16_t                port;
+    ogs_sockaddr_t          *addr;      /* NULL if the lookup failed */
+} resolve_t;
+
+static struct {
+    bool                    initialized;
+
+    ogs_thread_t            *thread;
+    ogs_queue_t             *request;
+    ogs_queue_t             *done;
+
+    ogs_socket_t            fd[2];
+    ogs_poll_t              *poll;
+} resolver;
+
+static void resolver_main(void *data);
+static void resolver_handler(short when, ogs_socket_t fd, void *data);
+
+static int connection_open(ogs_nghttp2_connection_t *conn);
+static void connection_close(ogs_nghttp2_connection_t *conn);
+static void connection_dispatch(ogs_nghttp2_connection_t *conn);
+
+static int connection_send(ogs_nghttp2_connection_t *conn);
+static void connection_write_flush(ogs_nghttp2_connection_t *conn);
+
+static void connect_handler(short when, ogs_socket_t fd, void *data);
+static void handshake_handler(short when, ogs_socket_t fd, void *data);
+static void recv_handler(short when, ogs_socket_t fd, void *data);
+
+static int stream_submit(stream_t *stream);
+static void stream_remove(stream_t *stream);
+static void stream_timer_expired(void *data);
+
+/*
+ * Streams in flight are bounded by sbi.client.connection.stream
+ * (global.max.ue * 16 by default), not by the event pool.
+ */
+void ogs_nghttp2_client_init(void)
+{
+    int rv;
+
+    if (resolver.initialized == true)
+        return;
+
+    ogs_pool_init(&connection_pool,
+            ogs_app()->pool.nf * OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION);
+    ogs_pool_init(&stream_pool, ogs_sbi_self()->client_connection.stream);
+
+    /* At most one lookup is in progress per client */
+    resolver.request = ogs_queue_create(ogs_app()->pool.nf);
+    ogs_assert(resolver.request);
+    resolver.done = ogs_queue_create(ogs_app()->pool.nf);
+    ogs_assert(resolver.done);
+
+    rv = ogs_socketpair(AF_SOCKPAIR, SOCK_STREAM, 0, resolver.fd);
+    ogs_assert(rv == OGS_OK);
+    rv = ogs_nonblocking(resolver.fd[0]);
+    ogs_assert(rv == OGS_OK);
+
+    resolver.poll = ogs_pollset_add(ogs_app()->pollset,
+            OGS_POLLIN, resolver.fd[0], resolver_handler, NULL);
+    ogs_assert(resolver.poll);
+
+    resolver.thread = ogs_thread_create(resolver_main, NULL);
+    ogs_assert(resolver.thread);
+
+    resolver.initialized = true;
+}
+
+void ogs_nghttp2_client_final(void)
+{
+    resolve_t *req = NULL;
+
+    if (resolver.initialized == false)
+        return;
+
+    ogs_queue_term(resolver.request);
+    ogs_thread_destroy(resolver.thread);
+
+    while (ogs_queue_trypop(resolver.request, (void **)&req) == OGS_OK) {
+        ogs_free(req->fqdn);
+        ogs_free(req);
+    }
+    while (ogs_queue_trypop(resolver.done, (void **)&req) == OGS_OK) {
+        if (req->addr)
+            ogs_freeaddrinfo(req->addr);
+        ogs_free(req->fqdn);
+        ogs_free(req);
+    }
+
+    ogs_queue_destroy(resolver.request);
+    ogs_queue_destroy(resolver.done);
+
+    ogs_pollset_remove(resolver.poll);
+    ogs_closesocket(resolver.fd[0]);
+    ogs_closesocket(resolver.fd[1]);
+
+    ogs_pool_final(&stream_pool);
+    ogs_pool_final(&connection_pool);
+
+    resolver.initialized = false;
+}
+
+/*
+ * Same as curl_easy_escape() : everything except the unreserved
+ * characters of RFC 3986 is percent-encoded.
+ */
+static char *uri_escape(const char *str)
+{
+    char *buf = NULL, *p = NULL;
+
+    ogs_assert(str);
+
+    buf = ogs_malloc(strlen(str) * 3 + 1);
+    if (!buf) {
+        ogs_error("ogs_malloc() failed");
+        return NULL;
+    }
+
+    for (p = buf; *str; str++) {
+        unsigned char c = *str;
+
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') ||
+            c == '-' || c == '.' || c == '_' || c == '~') {
+            *p++ = c;
+        } else {
+            *p++ = '%';
+            *p++ = ogs_to_hex(c >> 4);
+            *p++ = ogs_to_hex(c & 15);
+        }
+    }
+    *p = '\0';
+
+    return buf;
+}
+
+static char *build_path(const char *uri, ogs_hash_t *params)
+{
+    ogs_hash_index_t *hi;
+    const char *p = NULL;
+    char *path = NULL;
+    bool has_params;
+
+    ogs_assert(uri);
+
+    /* http://127.0.0.10:7777/nnrf-disc/v1/nf-instances -> /nnrf-disc/... */
+    p = strstr(uri, "://");
+    if (p)
+        p = strchr(p + 3, '/');
+    else
+        p = uri;
+
+    path = ogs_strdup(p ? p : "/");
+    if (!path) {
+        ogs_error("ogs_strdup() failed");
+        return NULL;
+    }
+
+    if (!params || !ogs_hash_count(params))
+        return path;
+
+    has_params = (strchr(path, '?') != NULL);
+
+    for (hi = ogs_hash_first(params); hi; hi = ogs_hash_next(hi)) {
+        char *key_esc = NULL, *val_esc = NULL;
+
+        ogs_assert(ogs_hash_this_key(hi));
+        ogs_assert(ogs_hash_this_val(hi));
+
+        key_esc = uri_escape(ogs_hash_this_key(hi));
+        val_esc = uri_escape(ogs_hash_this_val(hi));
+        if (!key_esc || !val_esc) {
+            if (key_esc)
+                ogs_free(key_esc);
+            if (val_esc)
+                ogs_free(val_esc);
+            ogs_free(path);
+            return NULL;
+        }
+
+        path = ogs_mstrcatf(path, "%s%s=%s",
+                has_params ? "&" : "?", key_esc, val_esc);
+        has_params = true;
+
+        ogs_free(key_esc);
+        ogs_free(val_esc);
+
+        if (!path) {
+            ogs_error("ogs_mstrcatf() failed");
+            return NULL;
+        }
+    }
+
+    return path;
+}
+
+static void set_nv(nghttp2_nv *nv, const char *name, const char *value,
+        uint8_t flags)
+{
+    nv->name = (uint8_t *)name;
+    nv->namelen = strlen(name);
+    nv->value = (uint8_t *)value;
+    nv->valuelen = strlen(value);
+    nv->flags = flags;
+}
+
+/*
+ * Methods are taken from the static strings so that nghttp2 need not
+ * copy them, and they match the HPACK static table.
+ */
+static const char *static_method(const char *method)
+{
+    static const char *methods[] = {
+        OGS_SBI_HTTP_METHOD_GET,
+        OGS_SBI_HTTP_METHOD_POST,
+        OGS_SBI_HTTP_METHOD_PUT,
+        OGS_SBI_HTTP_METHOD_PATCH,
+        OGS_SBI_HTTP_METHOD_DELETE,
+        OGS_SBI_HTTP_METHOD_OPTIONS,
+    };
+    int i;
+
+    for (i = 0; i < OGS_ARRAY_SIZE(methods); i++)
+        if (strcmp(method, methods[i]) == 0)
+            return methods[i];
+
+    return NULL;
+}
+
+static void stream_free(stream_t *stream)
+{
+    size_t i;
+
+    ogs_assert(stream);
+
+    if (stream->timer)
+        ogs_timer_delete(stream->timer);
+
+    if (stream->names) {
+        for (i = 0; i < stream->nvlen; i++)
+            if (stream->names[i])
+                ogs_free(stream->names[i]);
+        ogs_free(stream->names);
+    }
+    if (stream->nva)
+        ogs_free(stream->nva);
+
+    if (stream->method)
+        ogs_free(stream->method);
+    if (stream->uri)
+        ogs_free(stream->uri);
+    if (stream->path)
+        ogs_free(stream->path);
+    if (stream->content)
+        ogs_free(stream->content);
+
+    if (stream->content_type)
+        ogs_free(stream->content_type);
+    if (stream->location)
+        ogs_free(stream->location);
+    if (stream->producer_id)
+        ogs_free(stream->producer_id);
+    if (stream->memory)
+        ogs_free(stream->memory);
+
+    ogs_pool_id_free(&stream_pool, stream);
+}
+
+static stream_t *stream_add(ogs_nghttp2_connection_t *conn,
+        ogs_sbi_client_cb_f client_cb, ogs_sbi_request_t *request, void *data)
+{
+    stream_t *stream = NULL;
+    ogs_hash_index_t *hi;
+    const char *method = NULL;
+    size_t i;
+
+    ogs_assert(conn);
+    ogs_assert(client_cb);
+    ogs_assert(request);
+    ogs_assert(request->h.method);
+    ogs_assert(request->h.uri);
+
+    ogs_pool_id_calloc(&stream_pool, &stream);
+    if (!stream) {
+        ogs_error("ogs_pool_id_calloc() failed");
+        return NULL;
+    }
+
+    stream->conn = conn;
+    stream->client_cb = client_cb;
+    stream->data = data;
+
+    stream->method = ogs_strdup(request->h.method);
+    stream->uri = ogs_strdup(request->h.uri);
+    stream->path = build_path(request->h.uri, request->http.params);
+    if (!stream->method || !stream->uri || !stream->path) {
+        ogs_error("No memory for request line");
+        stream_free(stream);
+        return NULL;
+    }
+
+    /* :method, :scheme, :authority, :path and the request headers */
+    stream->nva = ogs_calloc(
+            4 + ogs_hash_count(request->http.headers), sizeof(nghttp2_nv));
+    stream->names = ogs_calloc(
+            4 + ogs_hash_count(request->http.headers), sizeof(char *));
+    if (!stream->nva || !stream->names) {
+        ogs_error("No memory for headers");
+        stream_free(stream);
+        return NULL;
+    }
+
+    method = static_method(stream->method);
+    set_nv(&stream->nva[stream->nvlen++], ":method",
+            method ? method : stream->method,
+            NGHTTP2_NV_FLAG_NO_COPY_NAME|
+            (method ? NGHTTP2_NV_FLAG_NO_COPY_VALUE : 0));
+    stream->nva[stream->nvlen++] = conn->nv[0];
+    stream->nva[stream->nvlen++] = conn->nv[1];
+    set_nv(&stream->nva[stream->nvlen++], ":path", stream->path,
+            NGHTTP2_NV_FLAG_NO_COPY_NAME);
+
+    for (hi = ogs_hash_first(request->http.headers);
+            hi; hi = ogs_hash_next(hi)) {
+        const char *key = ogs_hash_this_key(hi);
+        const char *val = ogs_hash_this_val(hi);
+        char *name = NULL;
+
+        ogs_assert(key);
+        ogs_assert(val);
+
+        /* Header field names must be lower-case in HTTP/2 */
+        name = ogs_strdup(key);
+        if (!name) {
+            ogs_error("ogs_strdup() failed");
+            stream_free(stream);
+            return NULL;
+        }
+        for (i = 0; name[i]; i++)
+            name[i] = tolower((unsigned char)name[i]);
+
+        stream->names[stream->nvlen] = name;
+        set_nv(&stream->nva[stream->nvlen++], name, val, NGHTTP2_NV_FLAG_NONE);
+    }
+
+    if (request->http.content && request->http.content_length) {
+        stream->content = ogs_memdup(
+                request->http.content, request->http.content_length);
+        if (!stream->content) {
+            ogs_error("ogs_memdup() failed");
+            stream_free(stream);
+            return NULL;
+        }
+        stream->content_length = request->http.content_length;
+
+        ogs_debug("SENDING...[%d]", (int)stream->content_length);
+        ogs_debug("%s", request->http.content);
+    }
+
+    stream->timer = ogs_timer_add(ogs_app()->timer_mgr,
+            stream_timer_expired, OGS_UINT_TO_POINTER(stream->id));
+    if (!stream->timer) {
+        ogs_error("ogs_timer_add() failed");
+        stream_free(stream);
+        return NULL;
+    }
+
+    /* If http response is not received within deadline,
+     * Open5GS will discard this request. */
+    ogs_timer_start(stream->timer,
+            ogs_local_conf()->time.message.sbi.connection_deadline);
+
+    ogs_list_add(&conn->stream_list, stream);
+    conn->num_of_stream++;
+    conn->client->outstanding++;
+
+    return stream;
+}
+
+static void stream_remove(stream_t *stream)
+{
+    ogs_nghttp2_connection_t *conn = NULL;
+
+    ogs_assert(stream);
+    conn = stream->conn;
+    ogs_assert(conn);
+
+    ogs_list_remove(&conn->stream_list, stream);
+    ogs_assert(conn->num_of_stream);
+    conn->num_of_stream--;
+    ogs_assert(conn->client->outstanding);
+    conn->client->outstanding--;
+
+    if (conn->session && stream->stream_id && !stream->closed)
+        nghttp2_session_set_stream_user_data(
+                conn->session, stream->stream_id, NULL);
+
+    stream_free(stream);
+}
+
+static void stream_remove_all(ogs_nghttp2_connection_t *conn)
+{
+    stream_t *stream = NULL, *next_stream = NULL;
+
+    ogs_assert(conn);
+
+    ogs_list_for_each_safe(&conn->stream_list, next_stream, stream)
+        stream_remove(stream);
+}
+
+static void stream_timer_expired(void *data)
+{
+    ogs_pool_id_t stream_id = OGS_POINTER_TO_UINT(data);
+    stream_t *stream = NULL;
+    ogs_nghttp2_connection_t *conn = NULL;
+    ogs_sbi_client_t *client = NULL;
+
+    if (stream_id >= OGS_MIN_POOL_ID && stream_id <= OGS_MAX_POOL_ID)
+        stream = ogs_pool_find_by_id(&stream_pool, stream_id);
+    else
+        ogs_error("Invalid Stream ID [%d]", stream_id);
+
+    if (!stream) {
+        ogs_error("No Stream");
+        return;
+    }
+
+    conn = stream->conn;
+    ogs_assert(conn);
+    client = conn->client;
+    ogs_assert(client);
+
+    ogs_error("Connection timer expired [METHOD:%s]", stream->method);
+    ogs_error("Effective URL: %s", stream->uri);
+
+    /* The callback may drop the last reference to the client */
+    OGS_OBJECT_REF(client);
+
+    ogs_assert(stream->client_cb);
+    stream->client_cb(OGS_TIMEUP, NULL, stream->data);
+
+    if (conn->session && stream->stream_id && !stream->closed) {
+        nghttp2_submit_rst_stream(conn->session, NGHTTP2_FLAG_NONE,
+                stream->stream_id, NGHTTP2_CANCEL);
+        stream_remove(stream);
+        connection_send(conn);
+    } else {
+        stream_remove(stream);
+    }
+
+    ogs_sbi_client_remove(client);
+}
+
+static ssize_t request_read_callback(nghttp2_session *session,
+        int32_t stream_id, uint8_t *buf, size_t length, uint32_t *data_flags,
+        nghttp2_data_source *source, void *user_data)
+{
+    stream_t *stream = NULL;
+    size_t len;
+
+    ogs_assert(session);
+
+    stream = nghttp2_session_get_stream_user_data(session, stream_id);
+    if (!stream) {
+        ogs_error("no stream [%d]", stream_id);
+        return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+    }
+
+    ogs_assert(stream->content_offset <= stream->content_length);
+    len = ogs_min(length, stream->content_length - stream->content_offset);
+
+    if (len) {
+        memcpy(buf, stream->content + stream->content_offset, len);
+        stream->content_offset += len;
+    }
+
+    if (stream->content_offset == stream->content_length)
+        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+
+    return len;
+}
+
+static int stream_submit(stream_t *stream)
+{
+    ogs_nghttp2_connection_t *conn = NULL;
+    nghttp2_data_provider data_prd;
+    int32_t stream_id;
+
+    ogs_assert(stream);
+    conn = stream->conn;
+    ogs_assert(conn);
+    ogs_assert(conn->session);
+    ogs_assert(stream->stream_id == 0);
+
+    memset(&data_prd, 0, sizeof(data_prd));
+    data_prd.read_callback = request_read_callback;
+
+    stream_id = nghttp2_submit_request(conn->session, NULL,
+            stream->nva, stream->nvlen,
+            stream->content ? &data_prd : NULL, stream);
+    if (stream_id < 0) {
+        ogs_error("nghttp2_submit_request() failed (%d:%s)",
+                    stream_id, nghttp2_strerror(stream_id));
+        return OGS_ERROR;
+    }
+
+    stream->stream_id = stream_id;
+
+    ogs_debug("[%d] %s %s", stream_id, stream->method, stream->uri);
+
+    return OGS_OK;
+}
+
+/*
+ * Call back the application for the streams that nghttp2 has closed.
+ * This is not done from within nghttp2 callbacks because
+ * the application may send new requests or remove the client.
+ */
+static void connection_dispatch(ogs_nghttp2_connection_t *conn)
+{
+    stream_t *stream = NULL, *next_stream = NULL;
+    ogs_sbi_response_t *response = NULL;
+
+    ogs_assert(conn);
+
+    ogs_list_for_each_safe(&conn->stream_list, next_stream, stream) {
+        ogs_log_level_e level = OGS_LOG_DEBUG;
+
+        if (stream->closed == false)
+            continue;
+
+        if (stream->error_code != NGHTTP2_NO_ERROR || !stream->status) {
+            ogs_warn("[%s] %s failed (stream:%d error:%d:%s)",
+                    stream->method, stream->uri, stream->stream_id,
+                    stream->error_code,
+                    nghttp2_http2_strerror(stream->error_code));
+
+            ogs_assert(stream->client_cb);
+            stream->client_cb(OGS_ERROR, NULL, stream->data);
+
+            stream_remove(stream);
+            continue;
+        }
+
+        response = ogs_sbi_response_new();
+        ogs_assert(response);
+
+        response->status = stream->status;
+
+        response->h.method = ogs_strdup(stream->method);
+        ogs_assert(response->h.method);
+        response->h.uri = ogs_strdup(stream->uri);
+        ogs_assert(response->h.uri);
+
+        if (stream->content_type)
+            ogs_sbi_header_set(response->http.headers,
+                    OGS_SBI_CONTENT_TYPE, stream->content_type);
+        if (stream->location)
+            ogs_sbi_header_set(response->http.headers,
+                    OGS_SBI_LOCATION, stream->location);
+        if (stream->producer_id)
+            ogs_sbi_header_set(response->http.headers,
+                    OGS_SBI_CUSTOM_PRODUCER_ID, stream->producer_id);
+
+        if (stream->memory_overflow == true)
+            level = OGS_LOG_ERROR;
+
+        ogs_log_message(level, 0, "[%d:%s] %s",
+                response->status, response->h.method, response->h.uri);
+
+        if (stream->memory) {
+            /* The response takes the received body as it is */
+            response->http.content = stream->memory;
+            response->http.content_length = stream->size;
+
+            stream->memory = NULL;
+            stream->size = stream->memory_size = 0;
+        }
+
+        ogs_log_message(level, 0, "RECEIVED[%d]",
+                (int)response->http.content_length);
+        if (response->http.content_length && response->http.content)
+            ogs_log_message(level, 0, "%s", response->http.content);
+
+        ogs_assert(stream->client_cb);
+        if (stream->memory_overflow == true) {
+            ogs_sbi_response_free(response);
+            stream->client_cb(OGS_ERROR, NULL, stream->data);
+        } else {
+            stream->client_cb(OGS_OK, response, stream->data);
+        }
+
+        stream_remove(stream);
+    }
+}
+
+static int on_header(nghttp2_session *session, const nghttp2_frame *frame,
+        nghttp2_rcbuf *name, nghttp2_rcbuf *value, uint8_t flags,
+        void *user_data)
+{
+    stream_t *stream = NULL;
+    nghttp2_vec namebuf, valuebuf;
+    const char *namestr = NULL;
+    char *valuestr = NULL;
+
+    ogs_assert(session);
+    ogs_assert(frame);
+
+    if (frame->hd.type != NGHTTP2_HEADERS ||
+        frame->headers.cat != NGHTTP2_HCAT_RESPONSE)
+        return 0;
+
+    stream = nghttp2_session_get_stream_user_data(session, frame->hd.stream_id);
+    if (!stream)
+        return 0;
+
+    namebuf = nghttp2_rcbuf_get_buf(name);
+    valuebuf = nghttp2_rcbuf_get_buf(value);
+
+    if (!namebuf.len || !valuebuf.len)
+        return 0;
+
+    namestr = (const char *)namebuf.base;
+
+    valuestr = ogs_strndup((const char *)valuebuf.base, valuebuf.len);
+    ogs_assert(valuestr);
+
+    if (namebuf.len == sizeof(":status") - 1 &&
+        memcmp(namestr, ":status", namebuf.len) == 0) {
+        stream->status = atoi(valuestr);
+        ogs_free(valuestr);
+    } else if (!ogs_strncasecmp(namestr, "content-length", namebuf.len) &&
+            namebuf.len == sizeof("content-length") - 1) {
+        stream->content_length_hint = strtoul(valuestr, NULL, 10);
+        ogs_free(valuestr);
+    } else if (!ogs_strncasecmp(namestr, OGS_SBI_CONTENT_TYPE, namebuf.len) &&
+            namebuf.len == strlen(OGS_SBI_CONTENT_TYPE)) {
+        if (stream->content_type)
+            ogs_free(stream->content_type);
+        stream->content_type = valuestr;
+    } else if (!ogs_strncasecmp(namestr, OGS_SBI_LOCATION, namebuf.len) &&
+            namebuf.len == strlen(OGS_SBI_LOCATION)) {
+        if (stream->location)
+            ogs_free(stream->location);
+        stream->location = valuestr;
+    } else if (!ogs_strncasecmp(namestr,
+                OGS_SBI_CUSTOM_PRODUCER_ID, namebuf.len) &&
+            namebuf.len == strlen(OGS_SBI_CUSTOM_PRODUCER_ID)) {
+        if (stream->producer_id)
+            ogs_free(stream->producer_id);
+        stream->producer_id = valuestr;
+    } else {
+        ogs_free(valuestr);
+    }
+
+    return 0;
+}
+
+static int on_data_chunk_recv(nghttp2_session *session, uint8_t flags,
+        int32_t stream_id, const uint8_t *data, size_t len, void *user_data)
+{
+    stream_t *stream = NULL;
+    char *ptr = NULL;
+
+    ogs_assert(session);
+
+    stream = nghttp2_session_get_stream_user_data(session, stream_id);
+    if (!stream)
+        return 0;
+
+    ogs_assert(data);
+    ogs_assert(len);
+
+    if (stream->size + len > MAX_HTTP_CONTENT_LEN) {
+        stream->memory_overflow = true;
+
+        ogs_error("Payload too large : size[%d], len[%d]",
+                    (int)stream->size, (int)len);
+
+        return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+    }
+
+    if (stream->size + len + 1 > stream->memory_size) {
+        size_t memory_size;
+
+        if (!stream->memory)
+            memory_size = ogs_min(
+                    ogs_max(stream->content_length_hint, len),
+                    ogs_max(MAX_HTTP_CONTENT_HINT, len)) + 1;
+        else
+            /* Grow geometrically so that a large body is not copied
+             * per chunk */
+            memory_size = ogs_max(
+                    stream->memory_size * 2, stream->size + len + 1);
+
+        ptr = ogs_realloc(stream->memory, memory_size);
+        if (!ptr) {
+            stream->memory_overflow = true;
+
+            ogs_error("Overflow : size[%d], len[%d]",
+                        (int)stream->size, (int)len);
+            ogs_log_hexdump(OGS_LOG_ERROR, data, len);
+
+            return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+        }
+
+        stream->memory = ptr;
+        stream->memory_size = memory_size;
+    }
+
+    memcpy(stream->memory + stream->size, data, len);
+    stream->size += len;
+    stream->memory[stream->size] = 0;
+
+    return 0;
+}
+
+static int on_stream_close(nghttp2_session *session, int32_t stream_id,
+        uint32_t error_code, void *user_data)
+{
+    stream_t *stream = NULL;
+
+    ogs_assert(session);
+
+    stream = nghttp2_session_get_stream_user_data(session, stream_id);
+    if (!stream)
+        return 0;
+
+    stream->closed = true;
+    stream->error_code = error_code;
+
+    return 0;
+}
+
+static int on_frame_recv(nghttp2_session *session,
+        const nghttp2_frame *frame, void *user_data)
+{
+    ogs_nghttp2_connection_t *conn = user_data;
+
+    ogs_assert(conn);
+    ogs_assert(frame);
+
+    switch (frame->hd.type) {
+    case NGHTTP2_GOAWAY:
+        ogs_warn("GOAWAY received [%s:%d] last_stream_id:%d error:%d:%s",
+                conn->authority, conn->index, frame->goaway.last_stream_id,
+                frame->goaway.error_code,
+                nghttp2_http2_strerror(frame->goaway.error_code));
+
+        /* New requests go to the other connections until this one closes */
+        conn->goaway = true;
+        conn->num_of_goaway++;
+        break;
+    case NGHTTP2_PING:
+        if ((frame->hd.flags & NGHTTP2_FLAG_ACK) && conn->ping_sent) {
+            conn->rtt = ogs_get_monotonic_time() - conn->ping_sent;
+            conn->ping_sent = 0;
+
+            ogs_debug("[%s:%d] RTT %lld usec", conn->authority, conn->index,
+                    (long long)conn->rtt);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+static int error_callback(nghttp2_session *session,
+        const char *msg, size_t len, void *user_data)
+{
+    ogs_nghttp2_connection_t *conn = user_data;
+
+    ogs_assert(conn);
+    ogs_assert(msg);
+
+    ogs_error("http2 error [%s]: %.*s", conn->authority, (int)len, msg);
+
+    return 0;
+}
+
+static int connection_set_callbacks(ogs_nghttp2_connection_t *conn)
+{
+    int rv;
+    nghttp2_session_callbacks *callbacks = NULL;
+
+    ogs_assert(conn);
+
+    rv = nghttp2_session_callbacks_new(&callbacks);
+    if (rv != 0) {
+        ogs_error("nghttp2_session_callbacks_new() failed (%d:%s)",
+                    rv, nghttp2_strerror(rv));
+        return OGS_ERROR;
+    }
+
+    nghttp2_session_callbacks_set_on_frame_recv_callback(
+            callbacks, on_frame_recv);
+
+    nghttp2_session_callbacks_set_on_stream_close_callback(
+            callbacks, on_stream_close);
+
+    nghttp2_session_callbacks_set_on_header_callback2(callbacks, on_header);
+
+    nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
+            callbacks, on_data_chunk_recv);
+
+    nghttp2_session_callbacks_set_error_callback(callbacks, error_callback);
+
+    rv = nghttp2_session_client_new(&conn->session, callbacks, conn);
+    nghttp2_session_callbacks_del(callbacks);
+    if (rv != 0) {
+        ogs_error("nghttp2_session_client_new() failed (%d:%s)",
+                    rv, nghttp2_strerror(rv));
+        return OGS_ERROR;
+    }
+
+    return OGS_OK;
+}
+
+/* Measure the round-trip time if it has not been done for a while */
+static void connection_ping(ogs_nghttp2_connection_t *conn)
+{
+    ogs_time_t now;
+    int rv;
+
+    ogs_assert(conn);
+    ogs_assert(conn->session);
+
+    if (conn->ping_sent)
+        return;
+
+    now = ogs_get_monotonic_time();
+    if (conn->ping_last && now - conn->ping_last < PING_INTERVAL)
+        return;
+
+    rv = nghttp2_submit_ping(conn->session, NGHTTP2_FLAG_NONE, NULL);
+    if (rv != 0) {
+        ogs_error("nghttp2_submit_ping() failed (%d:%s)",
+                    rv, nghttp2_strerror(rv));
+        return;
+    }
+
+    conn->ping_sent = conn->ping_last = now;
+}
+
+static int connection_send(ogs_nghttp2_connection_t *conn)
+{
+    ogs_assert(conn);
+    ogs_assert(conn->session);
+
+    for (;;) {
+        const uint8_t *data = NULL;
+        ssize_t data_len;
+
+        data_len = nghttp2_session_mem_send(conn->session, &data);
+        if (data_len < 0) {
+            ogs_error("nghttp2_session_mem_send() failed (%d:%s)",
+                        (int)data_len, nghttp2_strerror((int)data_len));
+            return OGS_ERROR;
+        }
+
+        if (data_len == 0)
+            break;
+
+        ogs_sbi_write_queue_add(&conn->write_queue, data, data_len);
+    }
+
+    connection_write_flush(conn);
+
+    return OGS_OK;
+}
+
+static void connection_write_callback(short when, ogs_socket_t fd, void *data)
+{
+    ogs_nghttp2_connection_t *conn = data;
+    ogs_sbi_client_t *client = NULL;
+
+    ogs_assert(conn);
+    client = conn->client;
+    ogs_assert(client);
+
+    connection_write_flush(conn);
+
+    OGS_OBJECT_REF(client);
+    connection_dispatch(conn);
+    ogs_sbi_client_remove(client);
+}
+
+static void connection_write_flush(ogs_nghttp2_connection_t *conn)
+{
+    ogs_socket_t fd = INVALID_SOCKET;
+    int rv;
+
+    ogs_assert(conn);
+    ogs_assert(conn->sock);
+    fd = conn->sock->fd;
+    ogs_assert(fd != INVALID_SOCKET);
+
+    rv = ogs_sbi_write_queue_write(&conn->write_queue, fd, conn->ssl);
+    if (rv == OGS_ERROR) {
+        /*
+         * The connection itself is not closed here since this can be called
+         * from the application. recv_handler() will see the broken
+         * connection and close it.
+         */
+        ogs_sbi_write_queue_discard(&conn->write_queue);
+    }
+
+    if (rv == OGS_RETRY) {
+        if (!conn->poll.write) {
+            conn->poll.write = ogs_pollset_add(ogs_app()->pollset,
+                OGS_POLLOUT, fd, connection_write_callback, conn);
+            ogs_assert(conn->poll.write);
+        }
+    } else {
+        if (conn->poll.write) {
+            ogs_pollset_remove(conn->poll.write);
+            conn->poll.write = NULL;
+        }
+    }
+}
+
+static void connection_poll_remove(ogs_nghttp2_connection_t *conn)
+{
+    ogs_assert(conn);
+
+    if (conn->poll.read) {
+        ogs_pollset_remove(conn->poll.read);
+        conn->poll.read = NULL;
+    }
+    if (conn->poll.write) {
+        ogs_pollset_remove(conn->poll.write);
+        conn->poll.write = NULL;
+    }
+}
+
+/*
+ * Tear down the socket and the HTTP/2 session, and fail every request
+ * that was waiting on them. The connection object stays with the client
+ * and is opened again by the next request.
+ */
+static void connection_close(ogs_nghttp2_connection_t *conn)
+{
+    ogs_list_t stream_list;
+    stream_t *stream = NULL, *next_stream = NULL;
+
+    ogs_assert(conn);
+
+    connection_poll_remove(conn);
+
+    if (conn->session) {
+        nghttp2_session_del(conn->session);
+        conn->session = NULL;
+    }
+    if (conn->ssl) {
+        SSL_free(conn->ssl);
+        conn->ssl = NULL;
+    }
+    if (conn->sock) {
+        ogs_sock_destroy(conn->sock);
+        conn->sock = NULL;
+    }
+
+    ogs_sbi_write_queue_discard(&conn->write_queue);
+
+    conn->state = CONNECTION_CLOSED;
+    conn->goaway = false;
+    conn->ping_sent = 0;
+
+    /* New requests made from the callbacks go to a fresh connection */
+    memcpy(&stream_list, &conn->stream_list, sizeof(stream_list));
+    ogs_list_init(&conn->stream_list);
+
+    ogs_list_for_each_safe(&stream_list, next_stream, stream) {
+        ogs_list_remove(&stream_list, stream);
+        ogs_list_add(&conn->stream_list, stream);
+
+        stream->closed = true;
+
+        ogs_assert(stream->client_cb);
+        stream->client_cb(OGS_ERROR, NULL, stream->data);
+
+        stream_remove(stream);
+    }
+}
+
+static int connection_established(ogs_nghttp2_connection_t *conn)
+{
+    nghttp2_settings_entry iv[2] = {
+        { NGHTTP2_SETTINGS_ENABLE_PUSH, 0 },
+        { NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS,
+            ogs_sbi_self()->client_connection.stream },
+    };
+    stream_t *stream = NULL, *next_stream = NULL;
+    int rv;
+
+    ogs_assert(conn);
+    ogs_assert(conn->sock);
+
+    connection_poll_remove(conn);
+
+    if (connection_set_callbacks(conn) != OGS_OK) {
+        ogs_error("connection_set_callbacks() failed");
+        return OGS_ERROR;
+    }
+
+    rv = nghttp2_submit_settings(
+            conn->session, NGHTTP2_FLAG_NONE, iv, OGS_ARRAY_SIZE(iv));
+    if (rv != 0) {
+        ogs_error("nghttp2_submit_settings() failed (%d:%s)",
+                    rv, nghttp2_strerror(rv));
+        return OGS_ERROR;
+    }
+
+    conn->state = CONNECTION_ESTABLISHED;
+
+    conn->poll.read = ogs_pollset_add(ogs_app()->pollset,
+            OGS_POLLIN, conn->sock->fd, recv_handler, conn);
+    ogs_assert(conn->poll.read);
+
+    ogs_debug("HTTP/2 connection established [%s:%d]",
+            conn->authority, conn->index);
+
+    connection_ping(conn);
+
+    ogs_list_for_each_safe(&conn->stream_list, next_stream, stream) {
+        if (stream->stream_id == 0 && stream_submit(stream) != OGS_OK) {
+            stream->closed = true;
+            stream->error_code = NGHTTP2_INTERNAL_ERROR;
+        }
+    }
+
+    return connection_send(conn);
+}
+
+static int connection_handshake(ogs_nghttp2_connection_t *conn)
+{
+    const unsigned char *alpn = NULL;
+    unsigned int alpnlen = 0;
+    short when = 0;
+    int rv, err;
+
+    ogs_assert(conn);
+    ogs_assert(conn->ssl);
+    ogs_assert(conn->sock);
+
+    rv = SSL_do_handshake(conn->ssl);
+    if (rv <= 0) {
+        err = SSL_get_error(conn->ssl, rv);
+        if (err == SSL_ERROR_WANT_READ)
+            when = OGS_POLLIN;
+        else if (err == SSL_ERROR_WANT_WRITE)
+            when = OGS_POLLOUT;
+        else {
+            ogs_error("SSL_do_handshake() failed [%s] [%d:%s]",
+                    conn->authority, err,
+                    ERR_error_string(ERR_get_error(), NULL));
+            return OGS_ERROR;
+        }
+
+        connection_poll_remove(conn);
+        if (when == OGS_POLLIN) {
+            conn->poll.read = ogs_pollset_add(ogs_app()->pollset,
+                    when, conn->sock->fd, handshake_handler, conn);
+            ogs_assert(conn->poll.read);
+        } else {
+            conn->poll.write = ogs_pollset_add(ogs_app()->pollset,
+                    when, conn->sock->fd, handshake_handler, conn);
+            ogs_assert(conn->poll.write);
+        }
+
+        return OGS_OK;
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+    SSL_get0_alpn_selected(conn->ssl, &alpn, &alpnlen);
+#endif
+    if (alpnlen != NGHTTP2_PROTO_VERSION_ID_LEN ||
+        memcmp(alpn, NGHTTP2_PROTO_VERSION_ID, alpnlen) != 0) {
+        ogs_warn("[%s] did not negotiate h2 with ALPN", conn->authority);
+    }
+
+    return connection_established(conn);
+}
+
+static void handshake_handler(short when, ogs_socket_t fd, void *data)
+{
+    ogs_nghttp2_connection_t *conn = data;
+    ogs_sbi_client_t *client = NULL;
+
+    ogs_assert(conn);
+    client = conn->client;
+    ogs_assert(client);
+
+    OGS_OBJECT_REF(client);
+    if (connection_handshake(conn) != OGS_OK)
+        connection_close(conn);
+    else
+        connection_dispatch(conn);
+    ogs_sbi_client_remove(client);
+}
+
+static SSL_CTX *create_ssl_ctx(ogs_sbi_client_t *client)
+{
+    static const unsigned char alpn[] = "\x02h2";
+    SSL_CTX *ssl_ctx = NULL;
+
+    ogs_assert(client);
+
+    ssl_ctx = SSL_CTX_new(TLS_client_method());
+    if (!ssl_ctx) {
+        ogs_error("Could not create SSL/TLS context: %s",
+                ERR_error_string(ERR_get_error(), NULL));
+        return NULL;
+    }
+
+    SSL_CTX_set_options(ssl_ctx,
+            SSL_OP_ALL|SSL_OP_NO_SSLv2|SSL_OP_NO_SSLv3|SSL_OP_NO_COMPRESSION);
+    SSL_CTX_set_mode(ssl_ctx, SSL_MODE_AUTO_RETRY);
+    SSL_CTX_set_mode(ssl_ctx, SSL_MODE_RELEASE_BUFFERS);
+
+    if (client->insecure_skip_verify) {
+        SSL_CTX_set_verify(ssl_ctx, SSL_VERIFY_NONE, NULL);
+    } else {
+        SSL_CTX_set_verify(ssl_ctx, SSL_VERIFY_PEER, NULL);
+        if (client->cacert) {
+            if (SSL_CTX_load_verify_locations(
+                        ssl_ctx, client->cacert, NULL) != 1) {
+                ogs_error("Could not load CA certificate - cacert=%s",
+                        client->cacert);
+                SSL_CTX_free(ssl_ctx);
+                return NULL;
+            }
+        } else if (SSL_CTX_set_default_verify_paths(ssl_ctx) != 1) {
+            ogs_warn("Could not load system trusted ca certificates: %s",
+                    ERR_error_string(ERR_get_error(), NULL));
+        }
+    }
+
+    if (client->private_key && client->cert) {
+        if (SSL_CTX_use_PrivateKey_file(ssl_ctx,
+                    client->private_key, SSL_FILETYPE_PEM) != 1) {
+            ogs_error("Could not read private key file - key_file=%s",
+                    client->private_key);
+            SSL_CTX_free(ssl_ctx);
+            return NULL;
+        }
+        if (SSL_CTX_use_certificate_chain_file(ssl_ctx, client->cert) != 1) {
+            ogs_error("Could not read certificate file - cert_file=%s",
+                    client->cert);
+            SSL_CTX_free(ssl_ctx);
+            return NULL;
+        }
+    }
+
+    if (client->sslkeylog) {
+        /* Ensure app data is set for SSL objects */
+        SSL_CTX_set_app_data(ssl_ctx, client->sslkeylog);
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+        /* Set the SSL Key Log callback */
+        SSL_CTX_set_keylog_callback(ssl_ctx, ogs_sbi_keylog_callback);
+#endif
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+    SSL_CTX_set_alpn_protos(ssl_ctx, alpn, sizeof(alpn) - 1);
+#endif
+
+    return ssl_ctx;
+}
+
+static int connection_connected(ogs_nghttp2_connection_t *conn)
+{
+    ogs_sbi_client_t *client = NULL;
+
+    ogs_assert(conn);
+    client = conn->client;
+    ogs_assert(client);
+
+    if (client->scheme != OpenAPI_uri_scheme_https)
+        return connection_established(conn);
+
+    if (!conn->ssl_ctx) {
+        conn->ssl_ctx = create_ssl_ctx(client);
+        if (!conn->ssl_ctx) {
+            ogs_error("create_ssl_ctx() failed");
+            return OGS_ERROR;
+        }
+    }
+
+    conn->ssl = SSL_new(conn->ssl_ctx);
+    if (!conn->ssl) {
+        ogs_error("SSL_new() failed");
+        return OGS_ERROR;
+    }
+
+    if (client->fqdn) {
+        SSL_set_tlsext_host_name(conn->ssl, client->fqdn);
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+        if (!client->insecure_skip_verify)
+            SSL_set1_host(conn->ssl, client->fqdn);
+#endif
+    }
+
+    SSL_set_fd(conn->ssl, conn->sock->fd);
+    SSL_set_connect_state(conn->ssl);
+
+    conn->state = CONNECTION_HANDSHAKING;
+
+    return connection_handshake(conn);
+}
+
+static void connect_handler(short when, ogs_socket_t fd, void *data)
+{
+    ogs_nghttp2_connection_t *conn = data;
+    ogs_sbi_client_t *client = NULL;
+    int err = 0;
+    socklen_t len = sizeof(err);
+
+    ogs_assert(conn);
+    client = conn->client;
+    ogs_assert(client);
+
+    OGS_OBJECT_REF(client);
+
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+        ogs_error("connect() failed [%s] (%d:%s)",
+                conn->authority, err, strerror(err));
+        connection_close(conn);
+    } else if (connection_connected(conn) != OGS_OK) {
+        connection_close(conn);
+    } else {
+        /* Queued requests that nghttp2 refused to submit */
+        connection_dispatch(conn);
+    }
+
+    ogs_sbi_client_remove(client);
+}
+
+static void resolver_main(void *data)
+{
+    resolve_t *req = NULL;
+    char buf[1] = { 0 };
+    int rv;
+
+    for ( ;; ) {
+        rv = ogs_queue_pop(resolver.request, (void **)&req);
+        if (rv == OGS_DONE)
+            break;
+        if (rv == OGS_RETRY)
+            continue;
+        ogs_assert(rv == OGS_OK);
+
+        rv = ogs_getaddrinfo(&req->addr, AF_UNSPEC, req->fqdn, req->port, 0);
+        if (rv != OGS_OK)
+            req->addr = NULL;
+
+        rv = ogs_queue_push(resolver.done, req);
+        if (rv != OGS_OK) {
+            /* Terminated while looking up */
+            if (req->addr)
+                ogs_freeaddrinfo(req->addr);
+            ogs_free(req->fqdn);
+            ogs_free(req);
+            break;
+        }
+
+        if (send(resolver.fd[1], buf, 1, 0) < 0)
+            ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                    "send() failed");
+    }
+}
+
+static void resolve_done(resolve_t *req)
+{
+    ogs_sbi_client_t *client = NULL;
+    ogs_nghttp2_connection_t *conn = NULL;
+    int i;
+
+    ogs_assert(req);
+
+    client = req->client;
+    if (client) {
+        ogs_assert(client->h2_resolve == req);
+        client->h2_resolve = NULL;
+
+        if (req->addr) {
+            ogs_assert(!client->h2_addr);
+            client->h2_addr = req->addr;
+            req->addr = NULL;
+        } else {
+            ogs_error("ogs_getaddrinfo() failed [%s]", req->fqdn);
+        }
+
+        /* The callbacks may drop the last reference to the client */
+        OGS_OBJECT_REF(client);
+
+        for (i = 0; i < OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION; i++) {
+            conn = client->h2[i];
+            if (!conn || conn->state != CONNECTION_RESOLVING)
+                continue;
+
+            conn->state = CONNECTION_CLOSED;
+            if (connection_open(conn) != OGS_OK) {
+                ogs_error("connection_open() failed [%s:%d]",
+                        conn->authority, conn->index);
+                connection_close(conn);
+            }
+        }
+
+        ogs_sbi_client_remove(client);
+    }
+
+    if (req->addr)
+        ogs_freeaddrinfo(req->addr);
+    ogs_free(req->fqdn);
+    ogs_free(req);
+}
+
+static void resolver_handler(short when, ogs_socket_t fd, void *data)
+{
+    resolve_t *req = NULL;
+    unsigned char buf[64];
+
+    ogs_assert(when == OGS_POLLIN);
+
+    while (recv(fd, (char *)buf, sizeof(buf), 0) > 0)
+        /* drain */;
+
+    while (ogs_queue_trypop(resolver.done, (void **)&req) == OGS_OK)
+        resolve_done(req);
+}
+
+/* Returns false if the lookup cannot be started */
+static bool resolve_start(ogs_sbi_client_t *client)
+{
+    resolve_t *req = NULL;
+
+    ogs_assert(client);
+    ogs_assert(client->fqdn);
+
+    if (client->h2_resolve)
+        return true;
+
+    req = ogs_calloc(1, sizeof(*req));
+    if (!req) {
+        ogs_error("ogs_calloc() failed");
+        return false;
+    }
+
+    req->client = client;
+    req->fqdn = ogs_strdup(client->fqdn);
+    ogs_assert(req->fqdn);
+    req->port = client->fqdn_port;
+    if (!req->port)
+        req->port = client->scheme == OpenAPI_uri_scheme_https ?
+            OGS_SBI_HTTPS_PORT : OGS_SBI_HTTP_PORT;
+
+    if (ogs_queue_trypush(resolver.request, req) != OGS_OK) {
+        ogs_error("ogs_queue_trypush() failed [%s]", req->fqdn);
+        ogs_free(req->fqdn);
+        ogs_free(req);
+        return false;
+    }
+
+    client->h2_resolve = req;
+
+    return true;
+}
+
+static ogs_sockaddr_t *connection_resolve(ogs_nghttp2_connection_t *conn)
+{
+    ogs_sbi_client_t *client = NULL;
+    ogs_sockaddr_t *addr = NULL, *sa = NULL;
+    int rv;
+
+    ogs_assert(conn);
+    client = conn->client;
+    ogs_assert(client);
+
+    if (client->fqdn && client->resolve) {
+        /*
+         * "fqdn:port:address[,address]..." : only the first is used.
+         * The address is numeric, so this does not query DNS.
+         */
+        const char *p = strchr(client->resolve, ':');
+        char *host = NULL;
+        uint16_t port = client->fqdn_port;
+
+        if (!port)
+            port = client->scheme == OpenAPI_uri_scheme_https ?
+                OGS_SBI_HTTPS_PORT : OGS_SBI_HTTP_PORT;
+
+        if (p)
+            p = strchr(p + 1, ':');
+        if (p) {
+            host = ogs_strndup(p + 1, strcspn(p + 1, ","));
+            ogs_assert(host);
+
+            rv = ogs_getaddrinfo(&addr, AF_UNSPEC, host, port,
+                    AI_NUMERICHOST);
+            if (rv != OGS_OK)
+                ogs_error("ogs_getaddrinfo() failed [%s]", host);
+
+            ogs_free(host);
+            return addr;
+        }
+    }
+
+    /*
+     * The address of the NF profile is used as is. Otherwise the FQDN
+     * is looked up once per client; until then NULL is returned
+     * and client->h2_resolve is set.
+     */
+    if (client->addr6 || client->addr) {
+        sa = client->addr6 ? client->addr6 : client->addr;
+    } else if (client->fqdn) {
+        if (!client->h2_addr) {
+            resolve_start(client);
+            return NULL;
+        }
+        sa = client->h2_addr;
+    }
+
+    if (!sa)
+        return NULL;
+
+    rv = ogs_copyaddrinfo(&addr, sa);
+    ogs_assert(rv == OGS_OK);
+
+    return addr;
+}
+
+static int connection_open(ogs_nghttp2_connection_t *conn)
+{
+    char buf[OGS_ADDRSTRLEN];
+    ogs_sbi_client_t *client = NULL;
+    ogs_sockaddr_t *addr = NULL;
+    ogs_sock_t *sock = NULL;
+    int rv;
+
+    ogs_assert(conn);
+    ogs_assert(conn->state == CONNECTION_CLOSED);
+    client = conn->client;
+    ogs_assert(client);
+
+    addr = connection_resolve(conn);
+    if (!addr) {
+        if (client->h2_resolve) {
+            /* Opened again by resolve_done() */
+            conn->state = CONNECTION_RESOLVING;
+            return OGS_OK;
+        }
+        ogs_error("Cannot resolve [%s]", conn->authority);
+        return OGS_ERROR;
+    }
+
+    sock = ogs_sock_socket(addr->ogs_sa_family, SOCK_STREAM, IPPROTO_TCP);
+    if (!sock) {
+        ogs_freeaddrinfo(addr);
+        return OGS_ERROR;
+    }
+
+    rv = ogs_nonblocking(sock->fd);
+    ogs_assert(rv == OGS_OK);
+    rv = ogs_closeonexec(sock->fd);
+    ogs_assert(rv == OGS_OK);
+    ogs_tcp_nodelay(sock->fd, true);
+
+    if (client->local_if)
+        ogs_bind_to_device(sock->fd, client->local_if);
+
+    memcpy(&sock->remote_addr, addr, sizeof(sock->remote_addr));
+
+    rv = connect(sock->fd, &addr->sa, ogs_sockaddr_len(addr));
+    if (rv != 0 && errno != EINPROGRESS) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "connect() failed [%s]:%d",
+                OGS_ADDR(addr, buf), OGS_PORT(addr));
+        ogs_sock_destroy(sock);
+        ogs_freeaddrinfo(addr);
+        return OGS_ERROR;
+    }
+
+    ogs_debug("HTTP/2 connecting [%s] to [%s]:%d", conn->authority,
+            OGS_ADDR(addr, buf), OGS_PORT(addr));
+    ogs_freeaddrinfo(addr);
+
+    conn->sock = sock;
+
+    if (rv == 0)
+        return connection_connected(conn);
+
+    conn->state = CONNECTION_CONNECTING;
+
+    conn->poll.write = ogs_pollset_add(ogs_app()->pollset,
+            OGS_POLLOUT, sock->fd, connect_handler, conn);
+    ogs_assert(conn->poll.write);
+
+    return OGS_OK;
+}
+
+/*
+ * The read side shares one buffer across connections since all of them
+ * are served from the pollset thread and nghttp2 consumes it entirely.
+ */
+static uint8_t recv_buffer[OGS_MAX_SDU_LEN];
+
+static void recv_handler(short when, ogs_socket_t fd, void *data)
+{
+    ogs_nghttp2_connection_t *conn = data;
+    ogs_sbi_client_t *client = NULL;
+    ssize_t readlen;
+    int i, n;
+    bool broken = false;
+
+    ogs_assert(conn);
+    ogs_assert(fd != INVALID_SOCKET);
+    client = conn->client;
+    ogs_assert(client);
+
+    /* The callbacks may drop the last reference to the client */
+    OGS_OBJECT_REF(client);
+
+    for (i = 0; i < OGS_SBI_MAX_READ_PER_EVENT; i++) {
+        if (conn->ssl) {
+            n = SSL_read(conn->ssl, recv_buffer, sizeof(recv_buffer));
+            if (n <= 0) {
+                int err = SSL_get_error(conn->ssl, n);
+                if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE)
+                    break;
+                if (err == SSL_ERROR_ZERO_RETURN)
+                    n = 0;
+                else if (n == 0)
+                    n = -1;
+            }
+        } else {
+            n = ogs_recv(fd, recv_buffer, sizeof(recv_buffer), 0);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+        }
+
+        if (n <= 0) {
+            if (n < 0 && errno != OGS_ECONNRESET)
+                ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                        "lost connection [%s]", conn->authority);
+            else
+                ogs_debug("connection closed [%s]", conn->authority);
+
+            broken = true;
+            break;
+        }
+
+        ogs_assert(conn->session);
+        readlen = nghttp2_session_mem_recv(conn->session, recv_buffer, n);
+        if (readlen < 0) {
+            ogs_error("nghttp2_session_mem_recv() failed (%d:%s)",
+                        (int)readlen, nghttp2_strerror((int)readlen));
+            broken = true;
+            break;
+        }
+
+        /* Nothing more for now */
+        if ((size_t)n < sizeof(recv_buffer) &&
+            (!conn->ssl || SSL_pending(conn->ssl) == 0))
+            break;
+    }
+
+    if (broken == false) {
+        /* SETTINGS ACK, WINDOW_UPDATE and the like */
+        if (nghttp2_session_want_write(conn->session))
+            connection_send(conn);
+
+        connection_dispatch(conn);
+
+        /* GOAWAY has been exchanged and all the streams are done */
+        if (conn->session &&
+            !nghttp2_session_want_read(conn->session) &&
+            !nghttp2_session_want_write(conn->session))
+            broken = true;
+    }
+
+    if (broken == true && conn->state == CONNECTION_ESTABLISHED) {
+        /* Responses completed before the connection broke */
+        connection_dispatch(conn);
+        connection_close(conn);
+    }
+
+    ogs_sbi_client_remove(client);
+}
+
+static ogs_nghttp2_connection_t *connection_add(
+        ogs_sbi_client_t *client, int index)
+{
+    ogs_nghttp2_connection_t *conn = NULL;
+    char *apiroot = NULL, *p = NULL;
+
+    ogs_assert(client);
+    ogs_assert(index >= 0 && index < OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION);
+    ogs_assert(client->h2[index] == NULL);
+
+    ogs_pool_alloc(&connection_pool, &conn);
+    if (!conn) {
+        ogs_error("ogs_pool_alloc() failed");
+        return NULL;
+    }
+    memset(conn, 0, sizeof(*conn));
+
+    conn->client = client;
+    conn->index = index;
+
+    /* http://127.0.0.10:7777 -> 127.0.0.10:7777 */
+    apiroot = ogs_sbi_client_apiroot(client);
+    ogs_assert(apiroot);
+    p = strstr(apiroot, "://");
+    conn->authority = ogs_strdup(p ? p + 3 : apiroot);
+    ogs_assert(conn->authority);
+    ogs_free(apiroot);
+
+    set_nv(&conn->nv[0], ":scheme",
+            client->scheme == OpenAPI_uri_scheme_https ? "https" : "http",
+            NGHTTP2_NV_FLAG_NO_COPY_NAME|NGHTTP2_NV_FLAG_NO_COPY_VALUE);
+    set_nv(&conn->nv[1], ":authority", conn->authority,
+            NGHTTP2_NV_FLAG_NO_COPY_NAME|NGHTTP2_NV_FLAG_NO_COPY_VALUE);
+
+    ogs_list_init(&conn->stream_list);
+
+    client->h2[index] = conn;
+
+    return conn;
+}
+
+static void connection_free(ogs_nghttp2_connection_t *conn)
+{
+    ogs_sbi_client_t *client = NULL;
+
+    ogs_assert(conn);
+    client = conn->client;
+    ogs_assert(client);
+
+    stream_remove_all(conn);
+
+    connection_poll_remove(conn);
+
+    if (conn->session)
+        nghttp2_session_del(conn->session);
+    if (conn->ssl)
+        SSL_free(conn->ssl);
+    if (conn->ssl_ctx)
+        SSL_CTX_free(conn->ssl_ctx);
+    if (conn->sock)
+        ogs_sock_destroy(conn->sock);
+
+    ogs_sbi_write_queue_discard(&conn->write_queue);
+
+    ogs_free(conn->authority);
+
+    client->h2[conn->index] = NULL;
+
+    ogs_pool_free(&connection_pool, conn);
+}
+
+static int num_of_connection(void)
+{
+    return ogs_max(1, ogs_min(ogs_sbi_self()->client_connection.num,
+                OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION));
+}
+
+/*
+ * Pick the connection with the fewest streams in flight.
+ *
+ * Connections are added lazily : a new one is opened only when
+ * all the existing ones are busy. A connection that received GOAWAY
+ * is used only if there is nothing else.
+ */
+static ogs_nghttp2_connection_t *connection_select(ogs_sbi_client_t *client)
+{
+    ogs_nghttp2_connection_t *conn = NULL, *best = NULL, *draining = NULL;
+    int i, empty = -1;
+
+    ogs_assert(client);
+
+    for (i = 0; i < num_of_connection(); i++) {
+        conn = client->h2[i];
+        if (!conn) {
+            if (empty < 0)
+                empty = i;
+            continue;
+        }
+
+        if (conn->goaway) {
+            if (!draining || conn->num_of_stream < draining->num_of_stream)
+                draining = conn;
+            continue;
+        }
+
+        if (!best || conn->num_of_stream < best->num_of_stream ||
+            (conn->num_of_stream == best->num_of_stream &&
+             conn->state == CONNECTION_ESTABLISHED &&
+             best->state != CONNECTION_ESTABLISHED))
+            best = conn;
+    }
+
+    if (best && best->num_of_stream == 0)
+        return best;
+
+    if (empty >= 0)
+        return connection_add(client, empty);
+
+    return best ? best : draining;
+}
+
+bool ogs_nghttp2_client_send_request(
+        ogs_sbi_client_t *client, ogs_sbi_client_cb_f client_cb,
+        ogs_sbi_request_t *request, void *data)
+{
+    ogs_nghttp2_connection_t *conn = NULL;
+    stream_t *stream = NULL;
+
+    ogs_assert(client);
+    ogs_assert(request);
+
+    conn = connection_select(client);
+    if (!conn) {
+        ogs_error("connection_select() failed");
+        return false;
+    }
+
+    stream = stream_add(conn, client_cb, request, data);
+    if (!stream) {
+        ogs_error("stream_add() failed");
+        return false;
+    }
+
+    switch (conn->state) {
+    case CONNECTION_CLOSED:
+        if (connection_open(conn) != OGS_OK) {
+            ogs_error("connection_open() failed [%s:%d]",
+                    conn->authority, conn->index);
+
+            /* The caller handles the failure of this request */
+            stream_remove(stream);
+            connection_close(conn);
+            return false;
+        }
+        if (stream->closed == true) {
+            /* Connected at once, but nghttp2 refused the request */
+            stream_remove(stream);
+            return false;
+        }
+        break;
+    case CONNECTION_ESTABLISHED:
+        if (stream_submit(stream) != OGS_OK) {
+            stream_remove(stream);
+            return false;
+        }
+        connection_ping(conn);
+        connection_send(conn);
+        break;
+    default:
+        /* Submitted once the connection is established */
+        break;
+    }
+
+    return true;
+}
+
+void ogs_nghttp2_client_stop(ogs_sbi_client_t *client)
+{
+    ogs_nghttp2_connection_t *conn = NULL;
+    stream_t *stream = NULL;
+    int i;
+
+    ogs_assert(client);
+
+    for (i = 0; i < OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION; i++) {
+        conn = client->h2[i];
+        if (!conn)
+            continue;
+
+        ogs_list_for_each(&conn->stream_list, stream) {
+            ogs_assert(stream->client_cb);
+            stream->client_cb(OGS_DONE, NULL, stream->data);
+        }
+    }
+}
+
+void ogs_nghttp2_client_close(ogs_sbi_client_t *client)
+{
+    int i;
+
+    ogs_assert(client);
+
+    if (client->h2_resolve) {
+        /* The result is dropped by resolve_done() */
+        ((resolve_t *)client->h2_resolve)->client = NULL;
+        client->h2_resolve = NULL;
+    }
+
+    for (i = 0; i < OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION; i++)
+        if (client->h2[i])
+            connection_free(client->h2[i]);
+}
+
+void ogs_nghttp2_client_warm_up(ogs_sbi_client_t *client)
+{
+    ogs_nghttp2_connection_t *conn = NULL;
+    int i;
+
+    ogs_assert(client);
+
+    for (i = 0; i < num_of_connection(); i++) {
+        conn = client->h2[i];
+        if (!conn) {
+            conn = connection_add(client, i);
+            if (!conn) {
+                ogs_error("connection_add() failed");
+                return;
+            }
+        }
+
+        if (conn->state == CONNECTION_CLOSED &&
+            connection_open(conn) != OGS_OK) {
+            ogs_error("connection_open() failed [%s:%d]",
+                    conn->authority, conn->index);
+            connection_close(conn);
+        }
+    }
+}
+
+int ogs_nghttp2_client_connection_stat(ogs_sbi_client_t *client,
+        ogs_sbi_client_connection_stat_t *stat, int max)
+{
+    ogs_nghttp2_connection_t *conn = NULL;
+    int i, n = 0;
+
+    ogs_assert(client);
+    ogs_assert(stat);
+
+    for (i = 0; i < OGS_SBI_MAX_NUM_OF_CLIENT_CONNECTION && n < max; i++) {
+        conn = client->h2[i];
+        if (!conn)
+            continue;
+
+        stat[n].established = conn->state == CONNECTION_ESTABLISHED;
+        stat[n].streams = conn->num_of_stream;
+        stat[n].rtt = conn->rtt;
+        stat[n].goaway = conn->num_of_goaway;
+        n++;
+    }
+
+    return n;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "nghttp2-common.h"
+
+#include <sys/uio.h>
+
+static size_t write_chunk_size(ogs_pkbuf_t *last, size_t len)
+{
+    size_t size = OGS_SBI_WRITE_CHUNK_MIN;
+
+    /* A small response takes a small chunk; a burst grows them */
+    if (last)
+        size = 2 * (last->end - last->head);
+
+    return ogs_min(ogs_max(size, len), OGS_SBI_WRITE_CHUNK_SIZE);
+}
+
+void ogs_sbi_write_queue_add(
+        ogs_sbi_write_queue_t *queue, const void *data, size_t len)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+    const uint8_t *pos = data;
+    size_t n;
+
+    ogs_assert(queue);
+    ogs_assert(data);
+
+    while (len) {
+        pkbuf = ogs_list_last(&queue->list);
+        if (!pkbuf || ogs_pkbuf_tailroom(pkbuf) == 0) {
+            pkbuf = ogs_pkbuf_alloc(NULL, write_chunk_size(pkbuf, len));
+            ogs_assert(pkbuf);
+            ogs_list_add(&queue->list, pkbuf);
+        }
+
+        n = ogs_min(len, ogs_pkbuf_tailroom(pkbuf));
+        ogs_pkbuf_put_data(pkbuf, pos, n);
+
+        pos += n;
+        len -= n;
+        queue->queued += n;
+    }
+}
+
+static void write_queue_consume(ogs_sbi_write_queue_t *queue, size_t len)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    ogs_assert(queue);
+    ogs_assert(len <= queue->queued);
+
+    queue->queued -= len;
+
+    while (len) {
+        pkbuf = ogs_list_first(&queue->list);
+        ogs_assert(pkbuf);
+
+        ogs_log_hexdump(OGS_LOG_DEBUG, pkbuf->data, ogs_min(len, pkbuf->len));
+
+        if (len < pkbuf->len) {
+            /* Partial write : keep the rest for the next time */
+            ogs_pkbuf_pull(pkbuf, len);
+            break;
+        }
+
+        len -= pkbuf->len;
+        ogs_list_remove(&queue->list, pkbuf);
+        ogs_pkbuf_free(pkbuf);
+    }
+}
+
+void ogs_sbi_write_queue_discard(ogs_sbi_write_queue_t *queue)
+{
+    ogs_pkbuf_t *pkbuf = NULL, *next_pkbuf = NULL;
+
+    ogs_assert(queue);
+
+    ogs_list_for_each_safe(&queue->list, next_pkbuf, pkbuf) {
+        ogs_list_remove(&queue->list, pkbuf);
+        ogs_pkbuf_free(pkbuf);
+    }
+    queue->queued = 0;
+}
+
+/*
+ * Write as much of the queue as the socket accepts.
+ *
+ * Returns OGS_OK if the queue is empty, OGS_RETRY if the socket
+ * would block, and OGS_ERROR if the connection is broken.
+ */
+int ogs_sbi_write_queue_write(
+        ogs_sbi_write_queue_t *queue, ogs_socket_t fd, SSL *ssl)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+    ssize_t sent;
+
+    ogs_assert(queue);
+    ogs_assert(fd != INVALID_SOCKET);
+
+    while (ogs_list_empty(&queue->list) == false) {
+        if (ssl) {
+            int err;
+
+            pkbuf = ogs_list_first(&queue->list);
+            ogs_assert(pkbuf);
+
+            sent = SSL_write(ssl, pkbuf->data, pkbuf->len);
+            if (sent <= 0) {
+                err = SSL_get_error(ssl, sent);
+                if (err == SSL_ERROR_WANT_WRITE || err == SSL_ERROR_WANT_READ)
+                    return OGS_RETRY;
+
+                ogs_error("SSL_write() failed [%d:%s]", err,
+                        ERR_error_string(ERR_get_error(), NULL));
+                return OGS_ERROR;
+            }
+        } else {
+            struct iovec iov[OGS_SBI_MAX_WRITE_IOV];
+            int iovcnt = 0;
+
+            ogs_list_for_each(&queue->list, pkbuf) {
+                if (iovcnt == OGS_SBI_MAX_WRITE_IOV)
+                    break;
+                iov[iovcnt].iov_base = pkbuf->data;
+                iov[iovcnt].iov_len = pkbuf->len;
+                iovcnt++;
+            }
+
+            sent = writev(fd, iov, iovcnt);
+            if (sent < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    return OGS_RETRY;
+
+                if (errno != OGS_ECONNRESET && errno != EPIPE)
+                    ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                            "writev() failed");
+                return OGS_ERROR;
+            }
+        }
+
+        write_queue_consume(queue, sent);
+    }
+
+    return OGS_OK;
+}
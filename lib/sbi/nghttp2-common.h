@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Internal to libogssbi : not part of the public API.
+ */
+
+#ifndef OGS_SBI_NGHTTP2_COMMON_H
+#define OGS_SBI_NGHTTP2_COMMON_H
+
+#include "ogs-sbi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Output of nghttp2 is appended to chunks of the write queue
+ * so that many small frames go out with a single writev()/SSL_write().
+ * The first chunk of a burst is OGS_SBI_WRITE_CHUNK_MIN, or the size of
+ * the frame data if larger, and each next one doubles up to
+ * OGS_SBI_WRITE_CHUNK_SIZE. 16KB is the largest TLS record.
+ */
+#define OGS_SBI_WRITE_CHUNK_MIN         1024
+#define OGS_SBI_WRITE_CHUNK_SIZE        16384
+#define OGS_SBI_MAX_WRITE_IOV           64
+
+/*
+ * The receive handlers read until the socket would block, but no more than
+ * this many times, so that one busy peer does not starve the others.
+ */
+#define OGS_SBI_MAX_READ_PER_EVENT      16
+
+typedef struct ogs_sbi_write_queue_s {
+    ogs_list_t              list;
+    size_t                  queued; /* bytes in list */
+} ogs_sbi_write_queue_t;
+
+void ogs_sbi_write_queue_add(
+        ogs_sbi_write_queue_t *queue, const void *data, size_t len);
+int ogs_sbi_write_queue_write(
+        ogs_sbi_write_queue_t *queue, ogs_socket_t fd, SSL *ssl);
+void ogs_sbi_write_queue_discard(ogs_sbi_write_queue_t *queue);
+
+/*
+ * Native HTTP/2 client used when sbi.client.engine is nghttp2.
+ * ogs_sbi_context_parse_config() initializes it for that engine only.
+ */
+void ogs_nghttp2_client_init(void);
+void ogs_nghttp2_client_final(void);
+
+bool ogs_nghttp2_client_send_request(
+        ogs_sbi_client_t *client, ogs_sbi_client_cb_f client_cb,
+        ogs_sbi_request_t *request, void *data);
+void ogs_nghttp2_client_stop(ogs_sbi_client_t *client);
+void ogs_nghttp2_client_close(ogs_sbi_client_t *client);
+void ogs_nghttp2_client_warm_up(ogs_sbi_client_t *client);
+int ogs_nghttp2_client_connection_stat(ogs_sbi_client_t *client,
+        ogs_sbi_client_connection_stat_t *stat, int max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OGS_SBI_NGHTTP2_COMMON_H */
@@ -19,12 +19,21 @@
 
 #include "ogs-sbi.h"
 #include "yuarel.h"
+#include "nghttp2-common.h"
 
 #include <netinet/tcp.h>
 #include <nghttp2/nghttp2.h>
 
 #define USE_SEND_DATA_WITH_NO_COPY 1
 
+/*
+ * Backpressure : once more than HIGH_WATER bytes are waiting for the peer,
+ * the session stops reading new requests until the queue drains
+ * below LOW_WATER.
+ */
+#define OGS_SBI_WRITE_HIGH_WATER        (1024*1024)
+#define OGS_SBI_WRITE_LOW_WATER         (256*1024)
+
 static void server_init(int num_of_session_pool, int num_of_stream_pool);
 static void server_final(void);
 
@@ -76,7 +85,7 @@ typedef struct ogs_sbi_session_s {
     } poll;
 
     nghttp2_session         *session;
-    ogs_list_t              write_queue;
+    ogs_sbi_write_queue_t   write_queue;
 
     ogs_sbi_server_t        *server;
     ogs_list_t              stream_list;
@@ -95,6 +104,9 @@ typedef struct ogs_sbi_stream_s {
     ogs_sbi_request_t       *request;
     bool                    memory_overflow;
 
+    size_t                  content_length_hint; /* content-length header */
+    size_t                  content_size; /* allocated for request content */
+
     ogs_sbi_session_t       *session;
 } ogs_sbi_stream_t;
 
@@ -109,8 +121,7 @@ static void recv_handler(short when, ogs_socket_t fd, void *data);
 static int session_set_callbacks(ogs_sbi_session_t *sbi_sess);
 static int session_send_preface(ogs_sbi_session_t *sbi_sess);
 static int session_send(ogs_sbi_session_t *sbi_sess);
-static void session_write_to_buffer(
-        ogs_sbi_session_t *sbi_sess, ogs_pkbuf_t *pkbuf);
+static void session_write_flush(ogs_sbi_session_t *sbi_sess);
 
 static OGS_POOL(session_pool, ogs_sbi_session_t);
 static OGS_POOL(stream_pool, ogs_sbi_stream_t);
@@ -881,7 +892,6 @@ static ogs_sbi_session_t *session_add(
 static void session_remove(ogs_sbi_session_t *sbi_sess)
 {
     ogs_sbi_server_t *server = NULL;
-    ogs_pkbuf_t *pkbuf = NULL, *next_pkbuf = NULL;
 
     ogs_assert(sbi_sess);
     server = sbi_sess->server;
@@ -901,10 +911,7 @@ static void session_remove(ogs_sbi_session_t *sbi_sess)
     if (sbi_sess->poll.write)
         ogs_pollset_remove(sbi_sess->poll.write);
 
-    ogs_list_for_each_safe(&sbi_sess->write_queue, next_pkbuf, pkbuf) {
-        ogs_list_remove(&sbi_sess->write_queue, pkbuf);
-        ogs_pkbuf_free(pkbuf);
-    }
+    ogs_sbi_write_queue_discard(&sbi_sess->write_queue);
 
     ogs_assert(sbi_sess->addr);
     ogs_free(sbi_sess->addr);
@@ -980,81 +987,104 @@ static void accept_handler(short when, ogs_socket_t fd, void *data)
     }
 }
 
+/*
+ * All sessions are served from the pollset thread and nghttp2 consumes
+ * the whole buffer before nghttp2_session_mem_recv() returns,
+ * so a single receive buffer is shared by every session.
+ */
+static uint8_t recv_buffer[OGS_MAX_SDU_LEN];
+
 static void recv_handler(short when, ogs_socket_t fd, void *data)
 {
     char buf[OGS_ADDRSTRLEN];
     ogs_sockaddr_t *addr = NULL;
 
     ogs_sbi_session_t *sbi_sess = data;
-    ogs_pkbuf_t *pkbuf = NULL;
     ssize_t readlen;
-    int n;
+    int i, n;
 
     ogs_assert(sbi_sess);
     ogs_assert(fd != INVALID_SOCKET);
     addr = sbi_sess->addr;
     ogs_assert(addr);
 
-    pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
-    ogs_assert(pkbuf);
+    for (i = 0; i < OGS_SBI_MAX_READ_PER_EVENT; i++) {
+        if (sbi_sess->ssl) {
+            n = SSL_read(sbi_sess->ssl, recv_buffer, sizeof(recv_buffer));
+            if (n <= 0) {
+                int err = SSL_get_error(sbi_sess->ssl, n);
+                if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE)
+                    break;
+                if (err == SSL_ERROR_ZERO_RETURN)
+                    n = 0;
+                else if (n == 0)
+                    n = -1;
+            }
+        } else {
+            n = ogs_recv(fd, recv_buffer, sizeof(recv_buffer), 0);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+        }
 
-    if (sbi_sess->ssl)
-        n = SSL_read(sbi_sess->ssl, pkbuf->data, OGS_MAX_SDU_LEN);
-    else
-        n = ogs_recv(fd, pkbuf->data, OGS_MAX_SDU_LEN, 0);
+        if (n <= 0) {
+            if (n < 0) {
+                if (errno != OGS_ECONNRESET)
+                    ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                                    "lost connection [%s]:%d",
+                                    OGS_ADDR(addr, buf), OGS_PORT(addr));
+            } else if (n == 0) {
+                ogs_debug("connection closed [%s]:%d",
+                            OGS_ADDR(addr, buf), OGS_PORT(addr));
+            }
 
-    if (n > 0) {
-        ogs_pkbuf_put(pkbuf, n);
+            session_remove(sbi_sess);
+            return;
+        }
 
         ogs_assert(sbi_sess->session);
-        readlen = nghttp2_session_mem_recv(
-                sbi_sess->session, pkbuf->data, pkbuf->len);
+        readlen = nghttp2_session_mem_recv(sbi_sess->session, recv_buffer, n);
         if (readlen < 0) {
             ogs_error("nghttp2_session_mem_recv() failed (%d:%s)",
                         (int)readlen, nghttp2_strerror((int)readlen));
             session_remove(sbi_sess);
-        } else {
-            /*
-             * Issues #2385
-             *
-             * Nokia AMF is sending GOAWAY because it didn't get
-             * ACK SETTINGS packet for the SETTINGS it set,
-             * this is according to http2 RFC, all settings must be
-             * ACK or connection will be dropped.
-             *
-             * Open5GS is not ACKing pure settings packets,
-             * looks like it is waiting for a header
-             * like POST/GET first to trigger
-             * sending settings ACK and then headers reply.
-             */
-
-            /*
-             * [SOLVED]
-             *
-             * Whether or not to send a Setting ACK is determined
-             * by the nghttp2 library. Therefore, when nghttp2 informs us
-             * that it want to send an SETTING frame with ACK
-             * by nghttp2_session_want_write(), we need to call session_send()
-             * directly to send it.
-             */
-            if (nghttp2_session_want_write(sbi_sess->session))
-                session_send(sbi_sess);
-        }
-    } else {
-        if (n < 0) {
-            if (errno != OGS_ECONNRESET)
-                ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
-                                "lost connection [%s]:%d",
-                                OGS_ADDR(addr, buf), OGS_PORT(addr));
-        } else if (n == 0) {
-            ogs_debug("connection closed [%s]:%d",
-                        OGS_ADDR(addr, buf), OGS_PORT(addr));
+            return;
         }
 
-        session_remove(sbi_sess);
+        /* Stopped reading due to backpressure */
+        if (!sbi_sess->poll.read)
+            break;
+
+        /* Nothing more for now */
+        if ((size_t)n < sizeof(recv_buffer) &&
+            (!sbi_sess->ssl || SSL_pending(sbi_sess->ssl) == 0))
+            break;
     }
 
-    ogs_pkbuf_free(pkbuf);
+    /*
+     * Issues #2385
+     *
+     * Nokia AMF is sending GOAWAY because it didn't get
+     * ACK SETTINGS packet for the SETTINGS it set,
+     * this is according to http2 RFC, all settings must be
+     * ACK or connection will be dropped.
+     *
+     * Open5GS is not ACKing pure settings packets,
+     * looks like it is waiting for a header
+     * like POST/GET first to trigger
+     * sending settings ACK and then headers reply.
+     */
+
+    /*
+     * [SOLVED]
+     *
+     * Whether or not to send a Setting ACK is determined
+     * by the nghttp2 library. Therefore, when nghttp2 informs us
+     * that it want to send an SETTING frame with ACK
+     * by nghttp2_session_want_write(), we need to call session_send()
+     * directly to send it.
+     */
+    if (nghttp2_session_want_write(sbi_sess->session))
+        session_send(sbi_sess);
 }
 
 static int on_frame_recv(nghttp2_session *session,
@@ -1338,6 +1368,7 @@ static int on_header(nghttp2_session *session, const nghttp2_frame *frame,
 
     const char PATH[] = ":path";
     const char METHOD[] = ":method";
+    const char CONTENT_LENGTH[] = "content-length";
 
     nghttp2_vec namebuf, valuebuf;
     char *namestr = NULL, *valuestr = NULL;
@@ -1432,6 +1463,11 @@ static int on_header(nghttp2_session *session, const nghttp2_frame *frame,
 
     } else {
 
+        /* Used to allocate the request content only once */
+        if (namebuf.len == sizeof(CONTENT_LENGTH) - 1 &&
+                memcmp(CONTENT_LENGTH, namebuf.base, namebuf.len) == 0)
+            stream->content_length_hint = strtoul(valuestr, NULL, 10);
+
         ogs_sbi_header_set(request->http.headers, namestr, valuestr);
 
     }
@@ -1467,6 +1503,7 @@ static int on_data_chunk_recv(nghttp2_session *session, uint8_t flags,
     ogs_assert(len);
 
 #define MAX_HTTP_CONTENT_LEN (256 * 1024 * 1024) /* 256MB */
+#define MAX_HTTP_CONTENT_HINT (1024 * 1024) /* Do not trust a larger one */
     if (request->http.content_length + len > MAX_HTTP_CONTENT_LEN) {
         stream->memory_overflow = true;
 
@@ -1484,12 +1521,21 @@ static int on_data_chunk_recv(nghttp2_session *session, uint8_t flags,
         ogs_assert(request->http.content_length == 0);
         ogs_assert(offset == 0);
 
-        content = (char*)ogs_malloc(len + 1);
-    } else {
+        stream->content_size = ogs_min(
+                ogs_max(stream->content_length_hint, len),
+                ogs_max(MAX_HTTP_CONTENT_HINT, len)) + 1;
+        content = (char*)ogs_malloc(stream->content_size);
+    } else if (request->http.content_length + len + 1 > stream->content_size) {
         ogs_assert(request->http.content_length != 0);
 
+        stream->content_size = ogs_min(
+                ogs_max(stream->content_size * 2,
+                    request->http.content_length + len + 1),
+                MAX_HTTP_CONTENT_LEN + 1);
         content = (char*)ogs_realloc(
-                request->http.content, request->http.content_length + len + 1);
+                request->http.content, stream->content_size);
+    } else {
+        content = request->http.content;
     }
 
     if (!content) {
@@ -1664,7 +1710,6 @@ static int on_send_data(nghttp2_session *session, nghttp2_frame *frame,
 
     ogs_sbi_response_t *response = NULL;
     ogs_sbi_stream_t *stream = NULL;
-    ogs_pkbuf_t *pkbuf = NULL;
     size_t padlen = 0;
 
     ogs_assert(session);
@@ -1688,26 +1733,23 @@ static int on_send_data(nghttp2_session *session, nghttp2_frame *frame,
     ogs_assert(framehd);
     ogs_assert(length);
 
-    pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
-    ogs_assert(pkbuf);
-    ogs_pkbuf_put_data(pkbuf, framehd, 9);
+    ogs_sbi_write_queue_add(&sbi_sess->write_queue, framehd, 9);
 
     padlen = frame->data.padlen;
 
     if (padlen > 0) {
-        ogs_pkbuf_put_u8(pkbuf, padlen-1);
+        uint8_t padlen_field = padlen-1;
+        ogs_sbi_write_queue_add(&sbi_sess->write_queue, &padlen_field, 1);
     }
 
-    ogs_pkbuf_put_data(pkbuf,
+    ogs_sbi_write_queue_add(&sbi_sess->write_queue,
             response->http.content, response->http.content_length);
 
     if (padlen > 0) {
-        memset(pkbuf->tail, 0, padlen-1);
-        ogs_pkbuf_put(pkbuf, padlen-1);
+        static const uint8_t padding[256];
+        ogs_sbi_write_queue_add(&sbi_sess->write_queue, padding, padlen-1);
     }
 
-    session_write_to_buffer(sbi_sess, pkbuf);
-
     return 0;
 }
 #else
@@ -1715,25 +1757,13 @@ static ssize_t send_callback(nghttp2_session *session, const uint8_t *data,
                              size_t length, int flags, void *user_data)
 {
     ogs_sbi_session_t *sbi_sess = user_data;
-    ogs_sock_t *sock = NULL;
-    ogs_socket_t fd = INVALID_SOCKET;
-
-    ogs_pkbuf_t *pkbuf = NULL;
 
     ogs_assert(sbi_sess);
-    sock = sbi_sess->sock;
-    ogs_assert(sock);
-    fd = sock->fd;
-    ogs_assert(fd != INVALID_SOCKET);
 
     ogs_assert(data);
     ogs_assert(length);
 
-    pkbuf = ogs_pkbuf_alloc(NULL, length);
-    ogs_assert(pkbuf);
-    ogs_pkbuf_put_data(pkbuf, data, length);
-
-    session_write_to_buffer(sbi_sess, pkbuf);
+    ogs_sbi_write_queue_add(&sbi_sess->write_queue, data, length);
 
     return length;
 }
@@ -1741,9 +1771,7 @@ static ssize_t send_callback(nghttp2_session *session, const uint8_t *data,
 
 static int session_send(ogs_sbi_session_t *sbi_sess)
 {
-#if USE_SEND_DATA_WITH_NO_COPY
-    ogs_pkbuf_t *pkbuf = NULL;
-#else
+#if !USE_SEND_DATA_WITH_NO_COPY
     int rv;
 #endif
 
@@ -1766,11 +1794,7 @@ static int session_send(ogs_sbi_session_t *sbi_sess)
             break;
         }
 
-        pkbuf = ogs_pkbuf_alloc(NULL, data_len);
-        ogs_assert(pkbuf);
-        ogs_pkbuf_put_data(pkbuf, data, data_len);
-
-        session_write_to_buffer(sbi_sess, pkbuf);
+        ogs_sbi_write_queue_add(&sbi_sess->write_queue, data, data_len);
     }
 #else
     rv = nghttp2_session_send(sbi_sess->session);
@@ -1781,59 +1805,66 @@ static int session_send(ogs_sbi_session_t *sbi_sess)
     }
 #endif
 
+    session_write_flush(sbi_sess);
+
     return OGS_OK;
 }
 
 static void session_write_callback(short when, ogs_socket_t fd, void *data)
 {
     ogs_sbi_session_t *sbi_sess = data;
-    ogs_pkbuf_t *pkbuf = NULL;
 
     ogs_assert(sbi_sess);
 
-    if (ogs_list_empty(&sbi_sess->write_queue) == true) {
-        if (sbi_sess->poll.write) {
-            ogs_pollset_remove(sbi_sess->poll.write);
-            sbi_sess->poll.write = NULL;
-        } else
-            ogs_warn("poll.write has already been removed");
-
-        return;
-    }
-
-    pkbuf = ogs_list_first(&sbi_sess->write_queue);
-    ogs_assert(pkbuf);
-    ogs_list_remove(&sbi_sess->write_queue, pkbuf);
-
-    if (sbi_sess->ssl)
-        SSL_write(sbi_sess->ssl, pkbuf->data, pkbuf->len);
-    else
-        ogs_send(fd, pkbuf->data, pkbuf->len, 0);
-
-    ogs_log_hexdump(OGS_LOG_DEBUG, pkbuf->data, pkbuf->len);
-
-    ogs_pkbuf_free(pkbuf);
+    session_write_flush(sbi_sess);
 }
 
-static void session_write_to_buffer(
-        ogs_sbi_session_t *sbi_sess, ogs_pkbuf_t *pkbuf)
+static void session_write_flush(ogs_sbi_session_t *sbi_sess)
 {
-    ogs_sock_t *sock = NULL;
     ogs_socket_t fd = INVALID_SOCKET;
-
-    ogs_assert(pkbuf);
+    int rv;
 
     ogs_assert(sbi_sess);
-    sock = sbi_sess->sock;
-    ogs_assert(sock);
-    fd = sock->fd;
+    ogs_assert(sbi_sess->sock);
+    fd = sbi_sess->sock->fd;
     ogs_assert(fd != INVALID_SOCKET);
 
-    ogs_list_add(&sbi_sess->write_queue, pkbuf);
+    rv = ogs_sbi_write_queue_write(&sbi_sess->write_queue, fd, sbi_sess->ssl);
+    if (rv == OGS_ERROR) {
+        /*
+         * The session itself is not removed here since this can be called
+         * from nghttp2 callbacks. recv_handler() will see the broken
+         * connection and remove it.
+         */
+        ogs_sbi_write_queue_discard(&sbi_sess->write_queue);
+    }
+
+    if (rv == OGS_RETRY) {
+        if (!sbi_sess->poll.write) {
+            sbi_sess->poll.write = ogs_pollset_add(ogs_app()->pollset,
+                OGS_POLLOUT, fd, session_write_callback, sbi_sess);
+            ogs_assert(sbi_sess->poll.write);
+        }
+    } else {
+        if (sbi_sess->poll.write) {
+            ogs_pollset_remove(sbi_sess->poll.write);
+            sbi_sess->poll.write = NULL;
+        }
+    }
 
-    if (!sbi_sess->poll.write) {
-        sbi_sess->poll.write = ogs_pollset_add(ogs_app()->pollset,
-            OGS_POLLOUT, fd, session_write_callback, sbi_sess);
-        ogs_assert(sbi_sess->poll.write);
+    /* Backpressure */
+    if (sbi_sess->write_queue.queued > OGS_SBI_WRITE_HIGH_WATER) {
+        if (sbi_sess->poll.read) {
+            ogs_warn("Peer is slow : %d bytes pending, stop reading",
+                    (int)sbi_sess->write_queue.queued);
+            ogs_pollset_remove(sbi_sess->poll.read);
+            sbi_sess->poll.read = NULL;
+        }
+    } else if (sbi_sess->write_queue.queued < OGS_SBI_WRITE_LOW_WATER) {
+        if (!sbi_sess->poll.read) {
+            sbi_sess->poll.read = ogs_pollset_add(ogs_app()->pollset,
+                OGS_POLLIN, fd, recv_handler, sbi_sess);
+            ogs_assert(sbi_sess->poll.read);
+        }
     }
 }
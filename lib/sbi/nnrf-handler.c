@@ -86,7 +86,7 @@ void ogs_nnrf_nfm_handle_nf_profile(
 
     ogs_sbi_nf_instance_clear(nf_instance);
 
-    nf_instance->nf_type = NFProfile->nf_type;
+    ogs_sbi_nf_instance_set_type(nf_instance, NFProfile->nf_type);
     nf_instance->nf_status = NFProfile->nf_status;
     if (NFProfile->is_heart_beat_timer == true)
         nf_instance->time.heartbeat_interval = NFProfile->heart_beat_timer;
@@ -1170,6 +1170,9 @@ bool ogs_nnrf_nfm_handle_nf_status_notify(
 
         ogs_nnrf_nfm_handle_nf_profile(nf_instance, NFProfile);
 
+        /* Earlier results for this NF type may no longer be the best */
+        ogs_sbi_discovery_cache_invalidate(nf_instance->nf_type);
+
         ogs_info("[%s] (NRF-notify) NF Profile updated [type:%s]",
                     nf_instance->id,
                     OpenAPI_nf_type_ToString(nf_instance->nf_type));
@@ -1191,6 +1194,7 @@ bool ogs_nnrf_nfm_handle_nf_status_notify(
             ogs_info("[%s] (NRF-notify) NF_DEREGISTERED event [type:%s]",
                     nf_instance->id,
                     OpenAPI_nf_type_ToString(nf_instance->nf_type));
+            ogs_sbi_discovery_cache_invalidate(nf_instance->nf_type);
             ogs_sbi_nf_fsm_fini(nf_instance);
             ogs_sbi_nf_instance_remove(nf_instance);
         } else {
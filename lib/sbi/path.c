@@ -297,6 +297,16 @@ int ogs_sbi_discover_and_send(ogs_sbi_xact_t *xact)
             sbi_object->service_type_array[service_type]);
     ogs_debug("OGS_SBI_GET_NF_INSTANCE [nf_instance:%p,service_name:%s]",
             nf_instance, ogs_sbi_service_type_to_name(service_type));
+    if (!nf_instance) {
+        nf_instance = ogs_sbi_discovery_cache_find(
+                        target_nf_type, requester_nf_type, discovery_option);
+        ogs_debug("ogs_sbi_discovery_cache_find() "
+                "[nf_instance:%p,service_name:%s]",
+                nf_instance, ogs_sbi_service_type_to_name(service_type));
+        if (nf_instance)
+            OGS_SBI_SETUP_NF_INSTANCE(
+                    sbi_object->service_type_array[service_type], nf_instance);
+    }
     if (!nf_instance) {
         nf_instance = ogs_sbi_nf_instance_find_by_discovery_param(
                         target_nf_type, requester_nf_type, discovery_option);
@@ -468,23 +468,137 @@ int ogs_sctp_sendmsg(ogs_sock_t *sock, const void *msg, size_t len,
             0); /* context */
 }
 
-int ogs_sctp_recvmsg(ogs_sock_t *sock, void *msg, size_t len,
-        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags)
+#if HAVE_SENDMMSG
+/* RFC 6458 SCTP_SNDINFO if the headers have it, else SCTP_SNDRCV */
+#ifdef SCTP_SNDINFO
+typedef struct sctp_sndinfo sctp_send_cmsg_t;
+#define SCTP_SEND_CMSG_TYPE SCTP_SNDINFO
+#define SCTP_SEND_CMSG_SET(__iNFO, __sTREAM, __pPID) do { \
+    (__iNFO)->snd_sid = (__sTREAM); \
+    (__iNFO)->snd_ppid = htobe32(__pPID); \
+} while (0)
+#else
+typedef struct sctp_sndrcvinfo sctp_send_cmsg_t;
+#define SCTP_SEND_CMSG_TYPE SCTP_SNDRCV
+#define SCTP_SEND_CMSG_SET(__iNFO, __sTREAM, __pPID) do { \
+    (__iNFO)->sinfo_stream = (__sTREAM); \
+    (__iNFO)->sinfo_ppid = htobe32(__pPID); \
+} while (0)
+#endif
+#endif
+
+/*
+ * Sends up to 'num' messages in order, each with the PPID and stream
+ * of its pkbuf, using a single sendmmsg(2) where it is available.
+ *
+ * Returns the number of messages sent, OGS_RETRY if the socket would block
+ * before the first one, or OGS_ERROR if the first one failed.
+ */
+int ogs_sctp_sendpkbufs(ogs_sock_t *sock,
+        ogs_pkbuf_t **pkbuf, int num, ogs_sockaddr_t *to)
+{
+#if HAVE_SENDMMSG
+    struct mmsghdr msg[OGS_SCTP_MAX_SEND_BATCH];
+    struct iovec iov[OGS_SCTP_MAX_SEND_BATCH];
+    union {
+        char buf[CMSG_SPACE(sizeof(sctp_send_cmsg_t))];
+        struct cmsghdr align;
+    } control[OGS_SCTP_MAX_SEND_BATCH];
+    struct cmsghdr *cmsg = NULL;
+    sctp_send_cmsg_t *info = NULL;
+    int i, sent;
+
+    ogs_assert(sock);
+    ogs_assert(pkbuf);
+    ogs_assert(num > 0 && num <= OGS_SCTP_MAX_SEND_BATCH);
+
+    memset(msg, 0, sizeof(msg[0]) * num);
+    memset(control, 0, sizeof(control[0]) * num);
+
+    for (i = 0; i < num; i++) {
+        ogs_assert(pkbuf[i]);
+
+        iov[i].iov_base = pkbuf[i]->data;
+        iov[i].iov_len = pkbuf[i]->len;
+
+        if (to) {
+            msg[i].msg_hdr.msg_name = &to->sa;
+            msg[i].msg_hdr.msg_namelen = ogs_sockaddr_len(to);
+        }
+        msg[i].msg_hdr.msg_iov = &iov[i];
+        msg[i].msg_hdr.msg_iovlen = 1;
+        msg[i].msg_hdr.msg_control = control[i].buf;
+        msg[i].msg_hdr.msg_controllen = sizeof(control[i].buf);
+
+        cmsg = CMSG_FIRSTHDR(&msg[i].msg_hdr);
+        cmsg->cmsg_level = IPPROTO_SCTP;
+        cmsg->cmsg_type = SCTP_SEND_CMSG_TYPE;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(sctp_send_cmsg_t));
+
+        info = (sctp_send_cmsg_t *)CMSG_DATA(cmsg);
+        SCTP_SEND_CMSG_SET(info, ogs_sctp_stream_no_in_pkbuf(pkbuf[i]),
+                ogs_sctp_ppid_in_pkbuf(pkbuf[i]));
+    }
+
+    sent = sendmmsg(sock->fd, msg, num, 0);
+    if (sent < 0) {
+        if (ogs_socket_errno == OGS_EAGAIN)
+            return OGS_RETRY;
+        return OGS_ERROR;
+    }
+
+    return sent;
+#else
+    int i, sent;
+
+    ogs_assert(sock);
+    ogs_assert(pkbuf);
+    ogs_assert(num > 0);
+
+    for (i = 0; i < num; i++) {
+        ogs_assert(pkbuf[i]);
+
+        sent = ogs_sctp_sendmsg(sock, pkbuf[i]->data, pkbuf[i]->len, to,
+                ogs_sctp_ppid_in_pkbuf(pkbuf[i]),
+                ogs_sctp_stream_no_in_pkbuf(pkbuf[i]));
+        if (sent < 0 || sent != pkbuf[i]->len) {
+            if (i)
+                break;
+            if (sent < 0 && ogs_socket_errno == OGS_EAGAIN)
+                return OGS_RETRY;
+            return OGS_ERROR;
+        }
+    }
+
+    return i;
+#endif
+}
+
+static int sctp_recvmsg_with_flags(ogs_sock_t *sock, void *msg, size_t len,
+        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags,
+        int flags)
 {
     int size;
     socklen_t addrlen = sizeof(struct sockaddr_storage);
     ogs_sockaddr_t addr;
+    int nowait;
 
-    int flags = 0;
     struct sctp_sndrcvinfo sndrcvinfo;
 
     ogs_assert(sock);
 
+    nowait = flags & MSG_DONTWAIT;
+
     memset(&sndrcvinfo, 0, sizeof sndrcvinfo);
     memset(&addr, 0, sizeof addr);
+
+    /* 'flags' is passed to recvmsg(2) and then holds the output flags */
     size = sctp_recvmsg(sock->fd, msg, len, &addr.sa, &addrlen,
                 &sndrcvinfo, &flags);
     if (size < 0) {
+        if (nowait && ogs_socket_errno == OGS_EAGAIN)
+            return OGS_RETRY;
+
         ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
                 "sctp_recvmsg(%d) failed", size);
         return size;
@@ -506,6 +620,19 @@ int ogs_sctp_recvmsg(ogs_sock_t *sock, void *msg, size_t len,
     return size;
 }
 
+int ogs_sctp_recvmsg(ogs_sock_t *sock, void *msg, size_t len,
+        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags)
+{
+    return sctp_recvmsg_with_flags(sock, msg, len, from, sinfo, msg_flags, 0);
+}
+
+int ogs_sctp_recvmsg_nowait(ogs_sock_t *sock, void *msg, size_t len,
+        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags)
+{
+    return sctp_recvmsg_with_flags(
+            sock, msg, len, from, sinfo, msg_flags, MSG_DONTWAIT);
+}
+
 /* is any of the bytes from offset .. u8_size in 'u8' non-zero? return offset
  * or -1 if all zero */
 static int byte_nonzero(
@@ -22,6 +22,19 @@
 
 int __ogs_sctp_domain;
 
+#if defined(_MSC_VER)
+#define OGS_SCTP_THREAD_LOCAL __declspec(thread)
+#else
+#define OGS_SCTP_THREAD_LOCAL __thread
+#endif
+
+/*
+ * Messages are received here and then copied into a pkbuf of their own
+ * size. With usrsctp, the receive upcall runs in the usrsctp threads,
+ * so every thread has its own buffer.
+ */
+static OGS_SCTP_THREAD_LOCAL uint8_t recv_buffer[OGS_MAX_SDU_LEN];
+
 static void sctp_write_callback(short when, ogs_socket_t fd, void *data);
 
 int ogs_sctp_recvdata(ogs_sock_t *sock, void *msg, size_t len,
@@ -53,6 +66,42 @@ int ogs_sctp_recvdata(ogs_sock_t *sock, void *msg, size_t len,
     return size;
 }
 
+/*
+ * Receives one message without blocking.
+ *
+ * Returns the size of the message in a newly allocated pkbuf,
+ * or OGS_RETRY if nothing is pending.
+ */
+int ogs_sctp_recvpkbuf(ogs_sock_t *sock, ogs_pkbuf_t **pkbuf,
+        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags)
+{
+    int size;
+
+    ogs_assert(sock);
+    ogs_assert(pkbuf);
+
+    *pkbuf = NULL;
+
+    size = ogs_sctp_recvmsg_nowait(sock,
+            recv_buffer, sizeof(recv_buffer), from, sinfo, msg_flags);
+    if (size == OGS_RETRY)
+        return size;
+    if (size < 0 || size >= OGS_MAX_SDU_LEN) {
+        ogs_error("ogs_sctp_recvmsg_nowait(%d) failed(%d:%s)",
+                size, errno, strerror(errno));
+        return OGS_ERROR;
+    }
+
+    *pkbuf = ogs_pkbuf_alloc(NULL, size);
+    if (!*pkbuf) {
+        ogs_error("ogs_pkbuf_alloc() failed");
+        return OGS_ERROR;
+    }
+    ogs_pkbuf_put_data(*pkbuf, recv_buffer, size);
+
+    return size;
+}
+
 int ogs_sctp_senddata(ogs_sock_t *sock,
         ogs_pkbuf_t *pkbuf, ogs_sockaddr_t *addr)
 {
@@ -75,12 +124,34 @@ int ogs_sctp_senddata(ogs_sock_t *sock,
     return OGS_OK;
 }
 
-void ogs_sctp_write_to_buffer(ogs_sctp_sock_t *sctp, ogs_pkbuf_t *pkbuf)
+/*
+ * Queues the message for the association and returns immediately.
+ *
+ * Everything written in one loop iteration is sent together once the
+ * socket is writable, so a burst costs one system call per
+ * OGS_SCTP_MAX_SEND_BATCH messages. If the peer does not keep up,
+ * the messages stay queued until the socket is writable again.
+ *
+ * Past OGS_SCTP_MAX_WRITE_QUEUE the message is dropped and OGS_NOTFOUND
+ * is returned : a stalled peer must not bring the daemon down.
+ */
+int ogs_sctp_write_to_buffer(ogs_sctp_sock_t *sctp, ogs_pkbuf_t *pkbuf)
 {
     ogs_assert(sctp);
     ogs_assert(pkbuf);
 
+    if (sctp->write_queue_depth >= OGS_SCTP_MAX_WRITE_QUEUE) {
+        ogs_error("SCTP write queue is full [%d] (len:%d,ssn:%d)",
+                sctp->write_queue_depth,
+                pkbuf->len, (int)ogs_sctp_stream_no_in_pkbuf(pkbuf));
+        ogs_pkbuf_free(pkbuf);
+        return OGS_NOTFOUND;
+    }
+
     ogs_list_add(&sctp->write_queue, pkbuf);
+    sctp->write_queue_depth++;
+    if (sctp->write_queue_depth > sctp->write_queue_peak)
+        sctp->write_queue_peak = sctp->write_queue_depth;
 
     if (!sctp->poll.write) {
         ogs_assert(sctp->sock);
@@ -88,27 +159,68 @@ void ogs_sctp_write_to_buffer(ogs_sctp_sock_t *sctp, ogs_pkbuf_t *pkbuf)
             OGS_POLLOUT, sctp->sock->fd, sctp_write_callback, sctp);
         ogs_assert(sctp->poll.write);
     }
+
+    return OGS_OK;
 }
 
 static void sctp_write_callback(short when, ogs_socket_t fd, void *data)
 {
     ogs_sctp_sock_t *sctp = data;
-    ogs_pkbuf_t *pkbuf = NULL;
+    ogs_pkbuf_t *pkbuf[OGS_SCTP_MAX_SEND_BATCH];
+    ogs_pkbuf_t *node = NULL, *next = NULL;
+    int i, num, sent, err;
 
     ogs_assert(sctp);
-    if (ogs_list_empty(&sctp->write_queue) == true) {
-        ogs_assert(sctp->poll.write);
-        ogs_pollset_remove(sctp->poll.write);
-        sctp->poll.write = NULL;
-        return;
-    }
+    ogs_assert(sctp->sock);
 
-    pkbuf = ogs_list_first(&sctp->write_queue);
-    ogs_assert(pkbuf);
-    ogs_list_remove(&sctp->write_queue, pkbuf);
+    while (ogs_list_empty(&sctp->write_queue) == false) {
+        num = 0;
+        ogs_list_for_each(&sctp->write_queue, node) {
+            pkbuf[num++] = node;
+            if (num == OGS_SCTP_MAX_SEND_BATCH)
+                break;
+        }
 
-    ogs_assert(sctp->sock);
-    ogs_sctp_senddata(sctp->sock, pkbuf, NULL);
+        sent = ogs_sctp_sendpkbufs(sctp->sock, pkbuf, num, NULL);
+        if (sent == OGS_RETRY) {
+            /* Send buffer is full : wait for the next POLLOUT */
+            return;
+        }
+        if (sent < 0) {
+            err = ogs_socket_errno;
+            if (err == EPIPE || err == OGS_ECONNRESET) {
+                /* The association is gone : none of them can be sent */
+                ogs_log_message(OGS_LOG_ERROR, err,
+                        "ogs_sctp_sendpkbufs() : drop %d messages",
+                        sctp->write_queue_depth);
+                ogs_list_for_each_safe(&sctp->write_queue, next, node) {
+                    ogs_list_remove(&sctp->write_queue, node);
+                    ogs_pkbuf_free(node);
+                }
+                sctp->write_queue_depth = 0;
+                break;
+            }
+
+            ogs_log_message(OGS_LOG_ERROR, err,
+                    "ogs_sctp_sendpkbufs(len:%d,ssn:%d)",
+                    pkbuf[0]->len, (int)ogs_sctp_stream_no_in_pkbuf(pkbuf[0]));
+            /* Drop the message that failed and go on with the others */
+            sent = 1;
+        }
+
+        for (i = 0; i < sent; i++) {
+            ogs_list_remove(&sctp->write_queue, pkbuf[i]);
+            ogs_pkbuf_free(pkbuf[i]);
+        }
+        sctp->write_queue_depth -= sent;
+
+        if (sent < num)
+            return;
+    }
+
+    ogs_assert(sctp->poll.write);
+    ogs_pollset_remove(sctp->poll.write);
+    sctp->poll.write = NULL;
 }
 
 void ogs_sctp_flush_and_destroy(ogs_sctp_sock_t *sctp)
@@ -133,5 +245,6 @@ void ogs_sctp_flush_and_destroy(ogs_sctp_sock_t *sctp)
             ogs_list_remove(&sctp->write_queue, pkbuf);
             ogs_pkbuf_free(pkbuf);
         }
+        sctp->write_queue_depth = 0;
     }
 }
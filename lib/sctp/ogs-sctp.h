@@ -48,6 +48,22 @@ extern int __ogs_sctp_domain;
 #define OGS_SCTP_SGSAP_PPID             0
 #define OGS_SCTP_NGAP_PPID              60
 
+/*
+ * The NGAP/S1AP receive handlers drain an association until it would block,
+ * but read no more than this many messages per event so that one busy
+ * peer does not starve the others.
+ */
+#define OGS_SCTP_MAX_RECV_PER_EVENT     16
+
+/*
+ * Messages written to a one-to-one association are queued and sent
+ * when the socket becomes writable, up to OGS_SCTP_MAX_SEND_BATCH with
+ * a single system call. A peer that does not drain its association
+ * stops at OGS_SCTP_MAX_WRITE_QUEUE messages; later ones are dropped.
+ */
+#define OGS_SCTP_MAX_SEND_BATCH         64
+#define OGS_SCTP_MAX_WRITE_QUEUE        4096
+
 #define ogs_sctp_ppid_in_pkbuf(__pkBUF)         (__pkBUF)->param[0]
 #define ogs_sctp_stream_no_in_pkbuf(__pkBUF)    (__pkBUF)->param[1]
 
@@ -92,6 +108,8 @@ typedef struct ogs_sctp_sock_s {
     } poll;
 
     ogs_list_t      write_queue;    /* Write Queue for Sending S1AP message */
+    int             write_queue_depth;  /* Messages in write_queue */
+    int             write_queue_peak;   /* Highest write_queue_depth */
 } ogs_sctp_sock_t;
 
 typedef struct ogs_sctp_info_s {
@@ -125,14 +143,20 @@ int ogs_sctp_so_linger(ogs_sock_t *sock, int l_linger);
 
 int ogs_sctp_sendmsg(ogs_sock_t *sock, const void *msg, size_t len,
         ogs_sockaddr_t *to, uint32_t ppid, uint16_t stream_no);
+int ogs_sctp_sendpkbufs(ogs_sock_t *sock,
+        ogs_pkbuf_t **pkbuf, int num, ogs_sockaddr_t *to);
 int ogs_sctp_recvmsg(ogs_sock_t *sock, void *msg, size_t len,
         ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags);
+int ogs_sctp_recvmsg_nowait(ogs_sock_t *sock, void *msg, size_t len,
+        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags);
 int ogs_sctp_recvdata(ogs_sock_t *sock, void *msg, size_t len,
         ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo);
+int ogs_sctp_recvpkbuf(ogs_sock_t *sock, ogs_pkbuf_t **pkbuf,
+        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags);
 
 int ogs_sctp_senddata(ogs_sock_t *sock,
         ogs_pkbuf_t *pkbuf, ogs_sockaddr_t *addr);
-void ogs_sctp_write_to_buffer(ogs_sctp_sock_t *sctp, ogs_pkbuf_t *pkbuf);
+int ogs_sctp_write_to_buffer(ogs_sctp_sock_t *sctp, ogs_pkbuf_t *pkbuf);
 void ogs_sctp_flush_and_destroy(ogs_sctp_sock_t *sctp);
 
 #ifdef __cplusplus
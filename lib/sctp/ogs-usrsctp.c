@@ -316,13 +316,47 @@ int ogs_sctp_sendmsg(ogs_sock_t *sock, const void *msg, size_t len,
             SCTP_SENDV_SNDINFO, 0);
 }
 
-int ogs_sctp_recvmsg(ogs_sock_t *sock, void *msg, size_t len,
-        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags)
+/*
+ * usrsctp has no batched send : the messages are sent one by one.
+ *
+ * Returns the number of messages sent, OGS_RETRY if the socket would block
+ * before the first one, or OGS_ERROR if the first one failed.
+ */
+int ogs_sctp_sendpkbufs(ogs_sock_t *sock,
+        ogs_pkbuf_t **pkbuf, int num, ogs_sockaddr_t *to)
+{
+    int i, sent;
+
+    ogs_assert(sock);
+    ogs_assert(pkbuf);
+    ogs_assert(num > 0);
+
+    for (i = 0; i < num; i++) {
+        ogs_assert(pkbuf[i]);
+
+        sent = ogs_sctp_sendmsg(sock, pkbuf[i]->data, pkbuf[i]->len, to,
+                ogs_sctp_ppid_in_pkbuf(pkbuf[i]),
+                ogs_sctp_stream_no_in_pkbuf(pkbuf[i]));
+        if (sent < 0 || sent != pkbuf[i]->len) {
+            if (i)
+                break;
+            if (sent < 0 && errno == EAGAIN)
+                return OGS_RETRY;
+            return OGS_ERROR;
+        }
+    }
+
+    return i;
+}
+
+static int sctp_recvmsg_with_flags(ogs_sock_t *sock, void *msg, size_t len,
+        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags,
+        int flags)
 {
     struct socket *socket = (struct socket *)sock;
     ogs_sockaddr_t addr;
     ssize_t n = 0;
-    int flags = 0;
+    int nowait;
     socklen_t addrlen = sizeof(struct sockaddr_storage);
     socklen_t infolen;
     struct sctp_rcvinfo rcv_info;
@@ -330,6 +364,8 @@ int ogs_sctp_recvmsg(ogs_sock_t *sock, void *msg, size_t len,
 
     ogs_assert(socket);
 
+    nowait = flags & MSG_DONTWAIT;
+
     memset(&rcv_info, 0, sizeof rcv_info);
     memset(&addr, 0, sizeof addr);
     n = usrsctp_recvv(socket, msg, len,
@@ -338,6 +374,9 @@ int ogs_sctp_recvmsg(ogs_sock_t *sock, void *msg, size_t len,
             &infolen, &infotype, &flags);
 
     if (n < 0) {
+        if (nowait && errno == EAGAIN)
+            return OGS_RETRY;
+
         ogs_error("sctp_recvmsg(%d) failed", (int)n);
         return OGS_ERROR;
     }
@@ -358,6 +397,19 @@ int ogs_sctp_recvmsg(ogs_sock_t *sock, void *msg, size_t len,
     return n;
 }
 
+int ogs_sctp_recvmsg(ogs_sock_t *sock, void *msg, size_t len,
+        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags)
+{
+    return sctp_recvmsg_with_flags(sock, msg, len, from, sinfo, msg_flags, 0);
+}
+
+int ogs_sctp_recvmsg_nowait(ogs_sock_t *sock, void *msg, size_t len,
+        ogs_sockaddr_t *from, ogs_sctp_info_t *sinfo, int *msg_flags)
+{
+    return sctp_recvmsg_with_flags(
+            sock, msg, len, from, sinfo, msg_flags, MSG_DONTWAIT);
+}
+
 ogs_sockaddr_t *ogs_usrsctp_remote_addr(union sctp_sockstore *store)
 {
     ogs_sockaddr_t *addr = NULL;
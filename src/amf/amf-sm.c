@@ -1029,28 +1029,43 @@ void amf_state_operational(ogs_fsm_t *s, amf_event_t *e)
         pkbuf = e->pkbuf;
         ogs_assert(pkbuf);
 
-        gnb = amf_gnb_find_by_addr(addr);
-        ogs_free(addr);
+        /* The messages received in a row are chained through pkbuf->lnode */
+        do {
+            ogs_pkbuf_t *next_pkbuf = ogs_list_next(pkbuf);
 
-        ogs_assert(gnb);
-        ogs_assert(OGS_FSM_STATE(&gnb->sm));
+            /* The previous message may have removed the gNB */
+            gnb = amf_gnb_find_by_addr(addr);
+            if (!gnb) {
+                ogs_error("gNB has already been removed");
+                ogs_pkbuf_free(pkbuf);
+                pkbuf = next_pkbuf;
+                continue;
+            }
+            ogs_assert(OGS_FSM_STATE(&gnb->sm));
 
-        rc = ogs_ngap_decode(&ngap_message, pkbuf);
-        if (rc == OGS_OK) {
-            e->gnb_id = gnb->id;
-            e->ngap.message = &ngap_message;
-            ogs_fsm_dispatch(&gnb->sm, e);
-        } else {
-            ogs_error("Cannot decode NGAP message");
-            r = ngap_send_error_indication(
-                    gnb, NULL, NULL, NGAP_Cause_PR_protocol, 
-                    NGAP_CauseProtocol_abstract_syntax_error_falsely_constructed_message);
-            ogs_expect(r == OGS_OK);
-            ogs_assert(r != OGS_ERROR);
-        }
+            e->pkbuf = pkbuf;
 
-        ogs_ngap_free(&ngap_message);
-        ogs_pkbuf_free(pkbuf);
+            rc = ogs_ngap_decode(&ngap_message, pkbuf);
+            if (rc == OGS_OK) {
+                e->gnb_id = gnb->id;
+                e->ngap.message = &ngap_message;
+                ogs_fsm_dispatch(&gnb->sm, e);
+            } else {
+                ogs_error("Cannot decode NGAP message");
+                r = ngap_send_error_indication(
+                        gnb, NULL, NULL, NGAP_Cause_PR_protocol, 
+                        NGAP_CauseProtocol_abstract_syntax_error_falsely_constructed_message);
+                ogs_expect(r == OGS_OK);
+                ogs_assert(r != OGS_ERROR);
+            }
+
+            ogs_ngap_free(&ngap_message);
+            ogs_pkbuf_free(pkbuf);
+
+            pkbuf = next_pkbuf;
+        } while (pkbuf);
+
+        ogs_free(addr);
         break;
 
     case AMF_EVENT_NGAP_TIMER:
@@ -42,6 +42,8 @@ static void stats_add_amf_session(void);
 static void stats_remove_amf_session(void);
 static bool amf_namf_comm_parse_guti(ogs_nas_5gs_guti_t *guti, char *ue_context_id);
 
+static void gnb_remove_ta(amf_gnb_t *gnb);
+
 void amf_context_init(void)
 {
     ogs_assert(context_initialized == 0);
@@ -83,6 +85,8 @@ void amf_context_init(void)
     ogs_assert(self.suci_hash);
     self.supi_hash = ogs_hash_make();
     ogs_assert(self.supi_hash);
+    self.ta_hash = ogs_hash_make();
+    ogs_assert(self.ta_hash);
 
     context_initialized = 1;
 }
@@ -105,6 +109,8 @@ void amf_context_final(void)
     ogs_hash_destroy(self.suci_hash);
     ogs_assert(self.supi_hash);
     ogs_hash_destroy(self.supi_hash);
+    ogs_assert(self.ta_hash);
+    ogs_hash_destroy(self.ta_hash);
 
     ogs_pool_final(&m_tmsi_pool);
     ogs_pool_final(&amf_sess_pool);
@@ -1263,6 +1269,7 @@ amf_gnb_t *amf_gnb_add(ogs_sock_t *sock, ogs_sockaddr_t *addr)
     gnb->ostream_id = 0;
 
     ogs_list_init(&gnb->ran_ue_list);
+    ogs_list_init(&gnb->ta_gnb_list);
 
     ogs_hash_set(self.gnb_addr_hash,
             gnb->sctp.addr, sizeof(ogs_sockaddr_t), gnb);
@@ -1298,6 +1305,8 @@ void amf_gnb_remove(amf_gnb_t *gnb)
     if (gnb->gnb_id_presence == true)
         ogs_hash_set(self.gnb_id_hash, &gnb->gnb_id, sizeof(gnb->gnb_id), NULL);
 
+    gnb_remove_ta(gnb);
+
     ogs_sctp_flush_and_destroy(&gnb->sctp);
 
     ogs_pool_id_free(&amf_gnb_pool, gnb);
@@ -1363,6 +1372,109 @@ amf_gnb_t *amf_gnb_find_by_id(ogs_pool_id_t id)
     return ogs_pool_find_by_id(&amf_gnb_pool, id);
 }
 
+static void ta_remove(amf_ta_t *ta)
+{
+    ogs_assert(ta);
+    ogs_assert(ogs_list_empty(&ta->gnb_list));
+
+    ogs_hash_set(self.ta_hash, &ta->tai, sizeof(ta->tai), NULL);
+
+    if (ta->paging.built)
+        ogs_asn_template_final(&ta->paging.tmpl);
+
+    ogs_free(ta);
+}
+
+static void gnb_remove_ta(amf_gnb_t *gnb)
+{
+    amf_ta_gnb_t *ta_gnb = NULL, *next_ta_gnb = NULL;
+    amf_ta_t *ta = NULL;
+
+    ogs_assert(gnb);
+
+    ogs_list_for_each_entry_safe(
+            &gnb->ta_gnb_list, next_ta_gnb, ta_gnb, gnb_lnode) {
+        ta = ta_gnb->ta;
+        ogs_assert(ta);
+
+        ogs_list_remove(&gnb->ta_gnb_list, &ta_gnb->gnb_lnode);
+        ogs_list_remove(&ta->gnb_list, ta_gnb);
+        ogs_free(ta_gnb);
+
+        if (ogs_list_empty(&ta->gnb_list))
+            ta_remove(ta);
+    }
+}
+
+/*
+ * Rebuilds the TAI index of the gNB from its Supported TAs.
+ * Must be called whenever gnb->supported_ta_list is changed.
+ */
+void amf_gnb_update_ta(amf_gnb_t *gnb)
+{
+    amf_ta_gnb_t *ta_gnb = NULL;
+    amf_ta_t *ta = NULL;
+    ogs_5gs_tai_t tai;
+    int i, j;
+
+    ogs_assert(gnb);
+
+    gnb_remove_ta(gnb);
+
+    for (i = 0; i < gnb->num_of_supported_ta_list; i++) {
+        for (j = 0; j < gnb->supported_ta_list[i].num_of_bplmn_list; j++) {
+            memset(&tai, 0, sizeof(tai));
+            memcpy(&tai.plmn_id,
+                    &gnb->supported_ta_list[i].bplmn_list[j].plmn_id,
+                    OGS_PLMN_ID_LEN);
+            tai.tac.v = gnb->supported_ta_list[i].tac.v;
+
+            ta = amf_ta_find(&tai);
+            if (!ta) {
+                ta = ogs_calloc(1, sizeof(*ta));
+                ogs_assert(ta);
+                memcpy(&ta->tai, &tai, sizeof(ta->tai));
+                ogs_list_init(&ta->gnb_list);
+                ogs_hash_set(self.ta_hash, &ta->tai, sizeof(ta->tai), ta);
+            } else {
+                /* Skip the TAI listed twice by the gNB */
+                bool found = false;
+
+                ogs_list_for_each(&ta->gnb_list, ta_gnb) {
+                    if (ta_gnb->gnb == gnb) {
+                        found = true;
+                        break;
+                    }
+                }
+                if (found)
+                    continue;
+            }
+
+            ta_gnb = ogs_calloc(1, sizeof(*ta_gnb));
+            ogs_assert(ta_gnb);
+            ta_gnb->ta = ta;
+            ta_gnb->gnb = gnb;
+
+            ogs_list_add(&ta->gnb_list, ta_gnb);
+            ogs_list_add(&gnb->ta_gnb_list, &ta_gnb->gnb_lnode);
+        }
+    }
+}
+
+amf_ta_t *amf_ta_find(const ogs_5gs_tai_t *tai)
+{
+    ogs_5gs_tai_t key;
+
+    ogs_assert(tai);
+
+    /* TAC is a bit-field : compare only the value */
+    memset(&key, 0, sizeof(key));
+    memcpy(&key.plmn_id, &tai->plmn_id, OGS_PLMN_ID_LEN);
+    key.tac.v = tai->tac.v;
+
+    return (amf_ta_t *)ogs_hash_get(self.ta_hash, &key, sizeof(key));
+}
+
 /** ran_ue_context handling function */
 ran_ue_t *ran_ue_add(amf_gnb_t *gnb, uint64_t ran_ue_ngap_id)
 {
@@ -1781,6 +1893,8 @@ void amf_ue_remove(amf_ue_t *amf_ue)
 
     amf_ue->ran_ue_id = OGS_INVALID_POOL_ID;
 
+    ogs_nas_security_cache_clear(&amf_ue->nas_security_cache);
+
     ogs_pool_id_free(&amf_ue_pool, amf_ue);
 
     ogs_info("[Removed] Number of AMF-UEs is now %d",
@@ -118,6 +118,7 @@ typedef struct amf_context_s {
     ogs_hash_t      *guti_ue_hash;  /* hash table (GUTI : AMF_UE) */
     ogs_hash_t      *suci_hash;     /* hash table (SUCI) */
     ogs_hash_t      *supi_hash;     /* hash table (SUPI) */
+    ogs_hash_t      *ta_hash;       /* hash table (TAI : AMF_TA) */
 
     uint16_t        ngap_port;      /* Default NGAP Port */
 
@@ -168,8 +169,36 @@ typedef struct amf_gnb_s {
 
     ogs_list_t      ran_ue_list;
 
+    ogs_list_t      ta_gnb_list;    /* list of amf_ta_gnb_t */
+
 } amf_gnb_t;
 
+/*
+ * Tracking Area served by one or more gNBs
+ *
+ * gNBs are indexed by the TAIs (TAC and each broadcast PLMN) of their
+ * Supported TAs so that a Paging is sent without scanning every gNB.
+ * The Paging of the TA is encoded once and only the 5G-S-TMSI is
+ * patched for every UE.
+ */
+typedef struct amf_ta_s {
+    ogs_5gs_tai_t   tai;
+    ogs_list_t      gnb_list;   /* list of amf_ta_gnb_t */
+
+    struct {
+        bool        built;      /* Template has been encoded */
+        ogs_asn_template_t tmpl;/* tmpl.pkbuf is NULL if it cannot be used */
+    } paging;
+} amf_ta_t;
+
+typedef struct amf_ta_gnb_s {
+    ogs_lnode_t     lnode;      /* listed in amf_ta_t->gnb_list */
+    ogs_lnode_t     gnb_lnode;  /* listed in amf_gnb_t->ta_gnb_list */
+
+    amf_ta_t        *ta;
+    amf_gnb_t       *gnb;
+} amf_ta_gnb_t;
+
 struct ran_ue_s {
     ogs_lnode_t     lnode;
     uint32_t        index;
@@ -482,6 +511,7 @@ struct amf_ue_s {
     /* Integrity and ciphering keys */
     uint8_t         knas_int[OGS_SHA256_DIGEST_SIZE/2];
     uint8_t         knas_enc[OGS_SHA256_DIGEST_SIZE/2];
+    ogs_nas_security_cache_t nas_security_cache;
     /* Downlink counter */
     uint32_t        dl_count;
     /* Uplink counter (24-bit stored in uint32_t) */
@@ -968,6 +998,9 @@ int amf_gnb_set_gnb_id(amf_gnb_t *gnb, uint32_t gnb_id);
 int amf_gnb_sock_type(ogs_sock_t *sock);
 amf_gnb_t *amf_gnb_find_by_id(ogs_pool_id_t id);
 
+void amf_gnb_update_ta(amf_gnb_t *gnb);
+amf_ta_t *amf_ta_find(const ogs_5gs_tai_t *tai);
+
 ran_ue_t *ran_ue_add(amf_gnb_t *gnb, uint64_t ran_ue_ngap_id);
 void ran_ue_remove(ran_ue_t *ran_ue);
 void ran_ue_switch_to_gnb(ran_ue_t *ran_ue, amf_gnb_t *new_gnb);
@@ -104,8 +104,12 @@ void amf_sctp_event_push(int id,
     if (rv != OGS_OK) {
         ogs_error("ogs_queue_push() failed:%d", (int)rv);
         ogs_free(e->ngap.addr);
-        if (e->pkbuf)
+        while (e->pkbuf) {
+            /* NGAP messages may be chained through pkbuf->lnode */
+            ogs_pkbuf_t *next_pkbuf = ogs_list_next(e->pkbuf);
             ogs_pkbuf_free(e->pkbuf);
+            e->pkbuf = next_pkbuf;
+        }
         ogs_event_free(e);
     }
 #if HAVE_USRSCTP
@@ -37,7 +37,9 @@
  *         "sctp": {
  *           "peer": "[192.168.168.100]:60110",
  *           "max_out_streams": 2,
- *           "next_ostream_id": 1
+ *           "next_ostream_id": 1,
+ *           "write_queue": 0,
+ *           "write_queue_peak": 3
  *         },
  *         "setup_success": true
  *       },
@@ -185,6 +187,8 @@ size_t amf_dump_gnb_info_paged(char *buf, size_t buflen, size_t page, size_t pag
             if (!cJSON_AddStringToObject(sctp, "peer", safe_sa_str(gnb->sctp.addr))) { cJSON_Delete(sctp); cJSON_Delete(ng); cJSON_Delete(g); oom = true; break; }
             if (!cJSON_AddNumberToObject(sctp, "max_out_streams", (double)gnb->max_num_of_ostreams)) { cJSON_Delete(sctp); cJSON_Delete(ng); cJSON_Delete(g); oom = true; break; }
             if (!cJSON_AddNumberToObject(sctp, "next_ostream_id", (double)(unsigned)gnb->ostream_id)) { cJSON_Delete(sctp); cJSON_Delete(ng); cJSON_Delete(g); oom = true; break; }
+            if (!cJSON_AddNumberToObject(sctp, "write_queue", (double)gnb->sctp.write_queue_depth)) { cJSON_Delete(sctp); cJSON_Delete(ng); cJSON_Delete(g); oom = true; break; }
+            if (!cJSON_AddNumberToObject(sctp, "write_queue_peak", (double)gnb->sctp.write_queue_peak)) { cJSON_Delete(sctp); cJSON_Delete(ng); cJSON_Delete(g); oom = true; break; }
 
             cJSON_AddItemToObjectCS(ng, "sctp", sctp);
 
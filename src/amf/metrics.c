@@ -67,6 +67,16 @@ amf_metrics_spec_def_t amf_metrics_spec_def_global[_AMF_METR_GLOB_MAX] = {
     .name = "gnb",
     .description = "gNodeBs",
 },
+[AMF_METR_GLOB_GAUGE_NGAP_WRITE_QUEUE] = {
+    .type = OGS_METRICS_METRIC_TYPE_GAUGE,
+    .name = "ngap_write_queue",
+    .description = "NGAP messages waiting for the gNB SCTP associations",
+},
+[AMF_METR_GLOB_GAUGE_NGAP_WRITE_QUEUE_MAX] = {
+    .type = OGS_METRICS_METRIC_TYPE_GAUGE,
+    .name = "ngap_write_queue_max",
+    .description = "NGAP messages waiting for the most backlogged gNB",
+},
 /* Global Counters: */
 [AMF_METR_GLOB_CTR_RM_REG_INIT_REQ] = {
     .type = OGS_METRICS_METRIC_TYPE_COUNTER,
@@ -138,6 +148,16 @@ amf_metrics_spec_def_t amf_metrics_spec_def_global[_AMF_METR_GLOB_MAX] = {
     .name = "fivegs_amffunction_mm_confupdatesucc",
     .description = "Number of UE Configuration Update complete messages received by the AMF",
 },
+[AMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_HIT] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "sbi_discovery_cache_hit",
+    .description = "NF discoveries answered from the discovery cache",
+},
+[AMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_MISS] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "sbi_discovery_cache_miss",
+    .description = "NF discoveries not found in the discovery cache",
+},
 /* Global Histograms: */
 [AMF_METR_GLOB_HIST_REG_TIME] = {
     .type = OGS_METRICS_METRIC_TYPE_HISTOGRAM,
@@ -348,6 +368,39 @@ int amf_metrics_free_inst_by_cause(ogs_metrics_inst_t **inst)
     return amf_metrics_free_inst(inst, _AMF_METR_BY_CAUSE_MAX);
 }
 
+/* Counters of the SBI library, refreshed on each scrape */
+static void amf_metrics_collect_sbi(void)
+{
+    static uint64_t hit, miss; /* Published so far */
+    ogs_sbi_discovery_cache_stat_t stat;
+
+    ogs_sbi_discovery_cache_stat(&stat);
+
+    amf_metrics_inst_global_add(
+            AMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_HIT, stat.hit - hit);
+    amf_metrics_inst_global_add(
+            AMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_MISS, stat.miss - miss);
+
+    hit = stat.hit;
+    miss = stat.miss;
+}
+
+/* Write queues of the gNB associations, refreshed on each scrape */
+static void amf_metrics_collect_ngap(void)
+{
+    amf_gnb_t *gnb = NULL;
+    int total = 0, max = 0;
+
+    ogs_list_for_each(&amf_self()->gnb_list, gnb) {
+        total += gnb->sctp.write_queue_depth;
+        if (gnb->sctp.write_queue_depth > max)
+            max = gnb->sctp.write_queue_depth;
+    }
+
+    amf_metrics_inst_global_set(AMF_METR_GLOB_GAUGE_NGAP_WRITE_QUEUE, total);
+    amf_metrics_inst_global_set(AMF_METR_GLOB_GAUGE_NGAP_WRITE_QUEUE_MAX, max);
+}
+
 void amf_metrics_init(void)
 {
     ogs_metrics_context_t *ctx = ogs_metrics_self();
@@ -362,6 +415,8 @@ void amf_metrics_init(void)
             amf_metrics_spec_def_by_cause, _AMF_METR_BY_CAUSE_MAX);
 
     amf_metrics_init_inst_global();
+    ogs_metrics_register_collector(amf_metrics_collect_sbi);
+    ogs_metrics_register_collector(amf_metrics_collect_ngap);
 
     amf_metrics_init_by_slice();
     amf_metrics_init_by_cause();
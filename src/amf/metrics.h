@@ -11,6 +11,8 @@ typedef enum amf_metric_type_global_s {
     AMF_METR_GLOB_GAUGE_RAN_UE,
     AMF_METR_GLOB_GAUGE_AMF_SESS,
     AMF_METR_GLOB_GAUGE_GNB,
+    AMF_METR_GLOB_GAUGE_NGAP_WRITE_QUEUE,
+    AMF_METR_GLOB_GAUGE_NGAP_WRITE_QUEUE_MAX,
     AMF_METR_GLOB_CTR_RM_REG_INIT_REQ,
     AMF_METR_GLOB_CTR_RM_REG_INIT_SUCC,
     AMF_METR_GLOB_CTR_RM_REG_MOB_REQ,
@@ -25,6 +27,8 @@ typedef enum amf_metric_type_global_s {
     AMF_METR_GLOB_CTR_AMF_AUTH_REJECT,
     AMF_METR_GLOB_CTR_MM_CONF_UPDATE,
     AMF_METR_GLOB_CTR_MM_CONF_UPDATE_SUCC,
+    AMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_HIT,
+    AMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_MISS,
     AMF_METR_GLOB_HIST_REG_TIME,
     _AMF_METR_GLOB_MAX,
 } amf_metric_type_global_t;
@@ -74,6 +74,10 @@ ogs_pkbuf_t *nas_5gs_security_encode(
         message->h.extended_protocol_discriminator;
     h.sequence_number = (amf_ue->dl_count & 0xff);
 
+    /*
+     * The message is ciphered and protected in place. The security header
+     * is pushed into the headroom reserved by the encoder.
+     */
     new = ogs_nas_5gs_plain_encode(message);
     if (!new) {
         ogs_error("ogs_nas_5gs_plain_encode() failed");
@@ -82,7 +86,8 @@ ogs_pkbuf_t *nas_5gs_security_encode(
 
     if (ciphered) {
         /* encrypt NAS message */
-        ogs_nas_encrypt(amf_ue->selected_enc_algorithm,
+        ogs_nas_encrypt_with_cache(&amf_ue->nas_security_cache,
+            amf_ue->selected_enc_algorithm,
             amf_ue->knas_enc, amf_ue->dl_count,
             amf_ue->nas.access_type,
             OGS_NAS_SECURITY_DOWNLINK_DIRECTION, new);
@@ -96,7 +101,8 @@ ogs_pkbuf_t *nas_5gs_security_encode(
         uint8_t mac[NAS_SECURITY_MAC_SIZE];
 
         /* calculate NAS MAC(message authentication code) */
-        ogs_nas_mac_calculate(amf_ue->selected_int_algorithm,
+        ogs_nas_mac_calculate_with_cache(&amf_ue->nas_security_cache,
+            amf_ue->selected_int_algorithm,
             amf_ue->knas_int, amf_ue->dl_count,
             amf_ue->nas.access_type,
             OGS_NAS_SECURITY_DOWNLINK_DIRECTION, new, mac);
@@ -156,14 +162,13 @@ int nas_5gs_security_decode(amf_ue_t *amf_ue,
         if (security_header_type.integrity_protected) {
             uint8_t mac[NAS_SECURITY_MAC_SIZE];
             uint32_t mac32;
-            uint32_t original_mac = h->message_authentication_code;
 
             /* calculate NAS MAC(message authentication code) */
-            ogs_nas_mac_calculate(amf_ue->selected_int_algorithm,
+            ogs_nas_mac_calculate_with_cache(&amf_ue->nas_security_cache,
+                amf_ue->selected_int_algorithm,
                 amf_ue->knas_int, amf_ue->ul_count.i32,
                 amf_ue->nas.access_type,
                 OGS_NAS_SECURITY_UPLINK_DIRECTION, pkbuf, mac);
-            h->message_authentication_code = original_mac;
 
             memcpy(&mac32, mac, NAS_SECURITY_MAC_SIZE);
             if (h->message_authentication_code != mac32) {
@@ -182,7 +187,8 @@ int nas_5gs_security_decode(amf_ue_t *amf_ue,
                 ogs_error("Cannot decrypt Malformed NAS Message");
                 return OGS_ERROR;
             }
-            ogs_nas_encrypt(amf_ue->selected_enc_algorithm,
+            ogs_nas_encrypt_with_cache(&amf_ue->nas_security_cache,
+                amf_ue->selected_enc_algorithm,
                 amf_ue->knas_enc, amf_ue->ul_count.i32,
                 amf_ue->nas.access_type,
                 OGS_NAS_SECURITY_UPLINK_DIRECTION, pkbuf);
@@ -368,6 +368,7 @@ ogs_pkbuf_t *ngap_build_downlink_nas_transport(
     ogs_pkbuf_t *gmmbuf, bool ue_ambr, bool allowed_nssai)
 {
     NGAP_NGAP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     NGAP_InitiatingMessage_t *initiatingMessage = NULL;
     NGAP_DownlinkNASTransport_t *DownlinkNASTransport = NULL;
 
@@ -385,6 +386,7 @@ ogs_pkbuf_t *ngap_build_downlink_nas_transport(
     ogs_debug("DownlinkNASTransport");
 
     memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
 
@@ -432,10 +434,7 @@ ogs_pkbuf_t *ngap_build_downlink_nas_transport(
     asn_uint642INTEGER(AMF_UE_NGAP_ID, ran_ue->amf_ue_ngap_id);
     *RAN_UE_NGAP_ID = ran_ue->ran_ue_ngap_id;
 
-    NAS_PDU->size = gmmbuf->len;
-    NAS_PDU->buf = CALLOC(NAS_PDU->size, sizeof(uint8_t));
-    memcpy(NAS_PDU->buf, gmmbuf->data, NAS_PDU->size);
-    ogs_pkbuf_free(gmmbuf);
+    ogs_asn_pkbuf_to_OCTET_STRING(&adopted, gmmbuf, NAS_PDU);
 
     /*
      * TS 38.413
@@ -506,7 +505,7 @@ ogs_pkbuf_t *ngap_build_downlink_nas_transport(
         }
     }
 
-    return ogs_ngap_encode(&pdu);
+    return ogs_ngap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *ngap_ue_build_initial_context_setup_request(
@@ -518,6 +517,7 @@ ogs_pkbuf_t *ngap_ue_build_initial_context_setup_request(
     amf_sess_t *sess = NULL;
 
     NGAP_NGAP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     NGAP_InitiatingMessage_t *initiatingMessage = NULL;
     NGAP_InitialContextSetupRequest_t *InitialContextSetupRequest = NULL;
 
@@ -541,6 +541,7 @@ ogs_pkbuf_t *ngap_ue_build_initial_context_setup_request(
     ogs_debug("InitialContextSetupRequest(UE)");
 
     memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
 
@@ -820,13 +821,10 @@ ogs_pkbuf_t *ngap_ue_build_initial_context_setup_request(
 
         NAS_PDU = &ie->value.choice.NAS_PDU;
 
-        NAS_PDU->size = gmmbuf->len;
-        NAS_PDU->buf = CALLOC(NAS_PDU->size, sizeof(uint8_t));
-        memcpy(NAS_PDU->buf, gmmbuf->data, NAS_PDU->size);
-        ogs_pkbuf_free(gmmbuf);
+        ogs_asn_pkbuf_to_OCTET_STRING(&adopted, gmmbuf, NAS_PDU);
     }
 
-    return ogs_ngap_encode(&pdu);
+    return ogs_ngap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *ngap_build_ue_context_modification_request(amf_ue_t *amf_ue)
@@ -982,6 +980,7 @@ ogs_pkbuf_t *ngap_sess_build_initial_context_setup_request(
     amf_ue_t *amf_ue = NULL;
 
     NGAP_NGAP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     NGAP_InitiatingMessage_t *initiatingMessage = NULL;
     NGAP_InitialContextSetupRequest_t *InitialContextSetupRequest = NULL;
 
@@ -1005,6 +1004,7 @@ ogs_pkbuf_t *ngap_sess_build_initial_context_setup_request(
     ogs_debug("InitialContextSetupRequest(Session)");
 
     memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
 
@@ -1105,10 +1105,7 @@ ogs_pkbuf_t *ngap_sess_build_initial_context_setup_request(
             PDUSessionItem->nAS_PDU = nAS_PDU = CALLOC(1, sizeof(*nAS_PDU));
             ogs_assert(nAS_PDU);
 
-            nAS_PDU->size = gmmbuf->len;
-            nAS_PDU->buf = CALLOC(nAS_PDU->size, sizeof(uint8_t));
-            memcpy(nAS_PDU->buf, gmmbuf->data, nAS_PDU->size);
-            ogs_pkbuf_free(gmmbuf);
+            ogs_asn_pkbuf_to_OCTET_STRING(&adopted, gmmbuf, nAS_PDU);
         }
 
         PDUSessionItem->pDUSessionID = sess->psi;
@@ -1273,7 +1270,7 @@ ogs_pkbuf_t *ngap_sess_build_initial_context_setup_request(
         memcpy(MaskedIMEISV->buf, amf_ue->masked_imeisv, MaskedIMEISV->size);
     }
 
-    return ogs_ngap_encode(&pdu);
+    return ogs_ngap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *ngap_build_ue_context_release_command(
@@ -1350,6 +1347,7 @@ ogs_pkbuf_t *ngap_ue_build_pdu_session_resource_setup_request(
     amf_sess_t *sess = NULL;
 
     NGAP_NGAP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     NGAP_InitiatingMessage_t *initiatingMessage = NULL;
     NGAP_PDUSessionResourceSetupRequest_t *PDUSessionResourceSetupRequest;
 
@@ -1369,6 +1367,7 @@ ogs_pkbuf_t *ngap_ue_build_pdu_session_resource_setup_request(
     ogs_debug("PDUSessionResourceSetupRequest(UE)");
 
     memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
 
@@ -1420,10 +1419,7 @@ ogs_pkbuf_t *ngap_ue_build_pdu_session_resource_setup_request(
 
         NAS_PDU = &ie->value.choice.NAS_PDU;
 
-        NAS_PDU->size = gmmbuf->len;
-        NAS_PDU->buf = CALLOC(NAS_PDU->size, sizeof(uint8_t));
-        memcpy(NAS_PDU->buf, gmmbuf->data, NAS_PDU->size);
-        ogs_pkbuf_free(gmmbuf);
+        ogs_asn_pkbuf_to_OCTET_STRING(&adopted, gmmbuf, NAS_PDU);
     }
 
     ogs_list_for_each(&amf_ue->sess_list, sess) {
@@ -1500,7 +1496,7 @@ ogs_pkbuf_t *ngap_ue_build_pdu_session_resource_setup_request(
         ran_ue->ue_ambr_sent = true;
     }
 
-    return ogs_ngap_encode(&pdu);
+    return ogs_ngap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *ngap_sess_build_pdu_session_resource_setup_request(
@@ -1510,6 +1506,7 @@ ogs_pkbuf_t *ngap_sess_build_pdu_session_resource_setup_request(
     amf_ue_t *amf_ue = NULL;
 
     NGAP_NGAP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     NGAP_InitiatingMessage_t *initiatingMessage = NULL;
     NGAP_PDUSessionResourceSetupRequest_t *PDUSessionResourceSetupRequest;
 
@@ -1536,6 +1533,7 @@ ogs_pkbuf_t *ngap_sess_build_pdu_session_resource_setup_request(
     ogs_debug("PDUSessionResourceSetupRequest(Session)");
 
     memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
 
@@ -1594,11 +1592,7 @@ ogs_pkbuf_t *ngap_sess_build_pdu_session_resource_setup_request(
     if (gmmbuf) {
         PDUSessionItem->pDUSessionNAS_PDU =
             pDUSessionNAS_PDU = CALLOC(1, sizeof(NGAP_NAS_PDU_t));
-        pDUSessionNAS_PDU->size = gmmbuf->len;
-        pDUSessionNAS_PDU->buf =
-            CALLOC(pDUSessionNAS_PDU->size, sizeof(uint8_t));
-        memcpy(pDUSessionNAS_PDU->buf, gmmbuf->data, pDUSessionNAS_PDU->size);
-        ogs_pkbuf_free(gmmbuf);
+        ogs_asn_pkbuf_to_OCTET_STRING(&adopted, gmmbuf, pDUSessionNAS_PDU);
     }
 
     s_NSSAI = &PDUSessionItem->s_NSSAI;
@@ -1645,7 +1639,7 @@ ogs_pkbuf_t *ngap_sess_build_pdu_session_resource_setup_request(
         ran_ue->ue_ambr_sent = true;
     }
 
-    return ogs_ngap_encode(&pdu);
+    return ogs_ngap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *ngap_build_pdu_session_resource_modify_request(
@@ -1655,6 +1649,7 @@ ogs_pkbuf_t *ngap_build_pdu_session_resource_modify_request(
     ran_ue_t *ran_ue = NULL;
 
     NGAP_NGAP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     NGAP_InitiatingMessage_t *initiatingMessage = NULL;
     NGAP_PDUSessionResourceModifyRequest_t *PDUSessionResourceModifyRequest;
 
@@ -1679,6 +1674,7 @@ ogs_pkbuf_t *ngap_build_pdu_session_resource_modify_request(
     ogs_debug("PDUSessionResourceModifyRequest");
 
     memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
 
@@ -1735,10 +1731,7 @@ ogs_pkbuf_t *ngap_build_pdu_session_resource_modify_request(
     PDUSessionItem->pDUSessionID = sess->psi;
 
     PDUSessionItem->nAS_PDU = nAS_PDU = CALLOC(1, sizeof(NGAP_NAS_PDU_t));
-    nAS_PDU->size = gmmbuf->len;
-    nAS_PDU->buf = CALLOC(nAS_PDU->size, sizeof(uint8_t));
-    memcpy(nAS_PDU->buf, gmmbuf->data, nAS_PDU->size);
-    ogs_pkbuf_free(gmmbuf);
+    ogs_asn_pkbuf_to_OCTET_STRING(&adopted, gmmbuf, nAS_PDU);
 
     transfer = &PDUSessionItem->pDUSessionResourceModifyRequestTransfer;
     transfer->size = n2smbuf->len;
@@ -1746,7 +1739,7 @@ ogs_pkbuf_t *ngap_build_pdu_session_resource_modify_request(
     memcpy(transfer->buf, n2smbuf->data, transfer->size);
     ogs_pkbuf_free(n2smbuf);
 
-    return ogs_ngap_encode(&pdu);
+    return ogs_ngap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *ngap_build_pdu_session_resource_release_command(
@@ -1756,6 +1749,7 @@ ogs_pkbuf_t *ngap_build_pdu_session_resource_release_command(
     ran_ue_t *ran_ue = NULL;
 
     NGAP_NGAP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     NGAP_InitiatingMessage_t *initiatingMessage = NULL;
     NGAP_PDUSessionResourceReleaseCommand_t *PDUSessionResourceReleaseCommand;
 
@@ -1779,6 +1773,7 @@ ogs_pkbuf_t *ngap_build_pdu_session_resource_release_command(
     ogs_debug("PDUSessionResourceReleaseCommand");
 
     memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
 
@@ -1830,10 +1825,7 @@ ogs_pkbuf_t *ngap_build_pdu_session_resource_release_command(
 
         NAS_PDU = &ie->value.choice.NAS_PDU;
 
-        NAS_PDU->size = gmmbuf->len;
-        NAS_PDU->buf = CALLOC(NAS_PDU->size, sizeof(uint8_t));
-        memcpy(NAS_PDU->buf, gmmbuf->data, NAS_PDU->size);
-        ogs_pkbuf_free(gmmbuf);
+        ogs_asn_pkbuf_to_OCTET_STRING(&adopted, gmmbuf, NAS_PDU);
     }
 
     ie = CALLOC(1, sizeof(NGAP_PDUSessionResourceReleaseCommandIEs_t));
@@ -1857,10 +1849,11 @@ ogs_pkbuf_t *ngap_build_pdu_session_resource_release_command(
     memcpy(transfer->buf, n2smbuf->data, transfer->size);
     ogs_pkbuf_free(n2smbuf);
 
-    return ogs_ngap_encode(&pdu);
+    return ogs_ngap_encode_adopted(&pdu, &adopted);
 }
 
-ogs_pkbuf_t *ngap_build_paging(amf_ue_t *amf_ue)
+static ogs_pkbuf_t *build_paging(ogs_5gs_tai_t *nr_tai,
+        uint16_t amf_set_id, uint8_t amf_pointer, uint32_t m_tmsi)
 {
     NGAP_NGAP_PDU_t pdu;
     NGAP_InitiatingMessage_t *initiatingMessage = NULL;
@@ -1877,8 +1870,7 @@ ogs_pkbuf_t *ngap_build_paging(amf_ue_t *amf_ue)
     NGAP_TAIListForPagingItem_t *TAIItem = NULL;
     NGAP_TAI_t *tAI = NULL;
 
-    ogs_assert(amf_ue);
-    ogs_debug("Paging");
+    ogs_assert(nr_tai);
 
     memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
     pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
@@ -1909,11 +1901,9 @@ ogs_pkbuf_t *ngap_build_paging(amf_ue_t *amf_ue)
     aMFPointer = &fiveG_S_TMSI->aMFPointer;
     fiveG_TMSI = &fiveG_S_TMSI->fiveG_TMSI;
 
-    ogs_ngap_uint16_to_AMFSetID(
-            ogs_amf_set_id(&amf_ue->current.guti.amf_id), aMFSetID);
-    ogs_ngap_uint8_to_AMFPointer(
-            ogs_amf_pointer(&amf_ue->current.guti.amf_id), aMFPointer);
-    ogs_asn_uint32_to_OCTET_STRING(amf_ue->current.guti.m_tmsi, fiveG_TMSI);
+    ogs_ngap_uint16_to_AMFSetID(amf_set_id, aMFSetID);
+    ogs_ngap_uint8_to_AMFPointer(amf_pointer, aMFPointer);
+    ogs_asn_uint32_to_OCTET_STRING(m_tmsi, fiveG_TMSI);
 
     ie = CALLOC(1, sizeof(NGAP_PagingIEs_t));
     ASN_SEQUENCE_ADD(&Paging->protocolIEs, ie);
@@ -1928,11 +1918,66 @@ ogs_pkbuf_t *ngap_build_paging(amf_ue_t *amf_ue)
     ASN_SEQUENCE_ADD(&TAIList->list, TAIItem);
 
     tAI = &TAIItem->tAI;
-    ogs_ngap_5gs_tai_to_ASN(&amf_ue->nr_tai, tAI);
+    ogs_ngap_5gs_tai_to_ASN(nr_tai, tAI);
 
     return ogs_ngap_encode(&pdu);
 }
 
+/*
+ * Paging of the TA with the AMF Set ID, AMF Pointer and 5G-TMSI set to
+ * zero. They are patched for every UE.
+ */
+static void build_paging_template(amf_ta_t *ta)
+{
+    ogs_asn_template_t *tmpl = NULL;
+
+    ogs_assert(ta);
+
+    tmpl = &ta->paging.tmpl;
+    ta->paging.built = true;
+
+    if (ogs_asn_template_init(tmpl,
+            build_paging(&ta->tai, 0, 0, 0)) != OGS_OK ||
+        ogs_asn_template_add_field(tmpl,
+            build_paging(&ta->tai, 0x3ff, 0, 0), 10) != OGS_OK ||
+        ogs_asn_template_add_field(tmpl,
+            build_paging(&ta->tai, 0, 0x3f, 0), 6) != OGS_OK ||
+        ogs_asn_template_add_field(tmpl,
+            build_paging(&ta->tai, 0, 0, 0xffffffff), 32) != OGS_OK) {
+        ogs_warn("Paging template not available : encode every Paging");
+        ogs_asn_template_final(tmpl);
+    }
+}
+
+ogs_pkbuf_t *ngap_build_paging(amf_ue_t *amf_ue)
+{
+    amf_ta_t *ta = NULL;
+
+    ogs_assert(amf_ue);
+    ogs_debug("Paging");
+
+    ta = amf_ta_find(&amf_ue->nr_tai);
+    if (ta) {
+        if (ta->paging.built == false)
+            build_paging_template(ta);
+
+        if (ta->paging.tmpl.pkbuf) {
+            uint64_t value[3];
+
+            value[0] = ogs_amf_set_id(&amf_ue->current.guti.amf_id);
+            value[1] = ogs_amf_pointer(&amf_ue->current.guti.amf_id);
+            value[2] = amf_ue->current.guti.m_tmsi;
+
+            return ogs_asn_template_build(&ta->paging.tmpl, value);
+        }
+    }
+
+    return build_paging(&amf_ue->nr_tai,
+            ogs_amf_set_id(&amf_ue->current.guti.amf_id),
+            ogs_amf_pointer(&amf_ue->current.guti.amf_id),
+            amf_ue->current.guti.m_tmsi);
+}
+
 ogs_pkbuf_t *ngap_build_downlink_ran_configuration_transfer(
     NGAP_SONConfigurationTransfer_t *transfer)
 {
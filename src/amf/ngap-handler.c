@@ -366,6 +366,8 @@ void ngap_handle_ng_setup_request(amf_gnb_t *gnb, ogs_ngap_message_t *message)
         gnb->num_of_supported_ta_list++;
     }
 
+    amf_gnb_update_ta(gnb);
+
     if (maximum_number_of_gnbs_is_reached()) {
         ogs_warn("NG-Setup failure:");
         ogs_warn("    Maximum number of gNBs reached");
@@ -4718,6 +4720,8 @@ void ngap_handle_ran_configuration_update(
             gnb->num_of_supported_ta_list++;
         }
 
+        amf_gnb_update_ta(gnb);
+
         if (gnb->num_of_supported_ta_list == 0) {
             ogs_warn("RANConfigurationUpdate failure:");
             ogs_warn("    No supported TA exist in request");
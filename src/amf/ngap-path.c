@@ -68,8 +68,7 @@ int ngap_send_to_gnb(amf_gnb_t *gnb, ogs_pkbuf_t *pkbuf, uint16_t stream_no)
     ogs_sctp_stream_no_in_pkbuf(pkbuf) = stream_no;
 
     if (gnb->sctp.type == SOCK_STREAM) {
-        ogs_sctp_write_to_buffer(&gnb->sctp, pkbuf);
-        return OGS_OK;
+        return ogs_sctp_write_to_buffer(&gnb->sctp, pkbuf);
     } else {
         return ogs_sctp_senddata(gnb->sctp.sock, pkbuf, gnb->sctp.addr);
     }
@@ -457,8 +456,8 @@ int ngap_send_ran_ue_context_release_command(
 int ngap_send_paging(amf_ue_t *amf_ue)
 {
     ogs_pkbuf_t *ngapbuf = NULL;
-    amf_gnb_t *gnb = NULL;
-    int i, j;
+    amf_ta_t *ta = NULL;
+    amf_ta_gnb_t *ta_gnb = NULL;
     int rv;
 
     ogs_debug("NG-Paging");
@@ -468,39 +467,36 @@ int ngap_send_paging(amf_ue_t *amf_ue)
         return OGS_NOTFOUND;
     }
 
-    ogs_list_for_each(&amf_self()->gnb_list, gnb) {
-        for (i = 0; i < gnb->num_of_supported_ta_list; i++) {
-            for (j = 0; j < gnb->supported_ta_list[i].num_of_bplmn_list; j++) {
-                if (memcmp(&gnb->supported_ta_list[i].bplmn_list[j].plmn_id,
-                            &amf_ue->nr_tai.plmn_id, OGS_PLMN_ID_LEN) == 0 &&
-                    gnb->supported_ta_list[i].tac.v == amf_ue->nr_tai.tac.v) {
-
-                    if (amf_ue->t3513.pkbuf) {
-                        ngapbuf = amf_ue->t3513.pkbuf;
-                    } else {
-                        ngapbuf = ngap_build_paging(amf_ue);
-                        if (!ngapbuf) {
-                            ogs_error("ngap_build_paging() failed");
-                            return OGS_ERROR;
-                        }
-                    }
-
-                    amf_ue->t3513.pkbuf = ogs_pkbuf_copy(ngapbuf);
-                    if (!amf_ue->t3513.pkbuf) {
-                        ogs_error("ogs_pkbuf_copy() failed");
-                        ogs_pkbuf_free(ngapbuf);
-                        return OGS_ERROR;
-                    }
-
-                    amf_metrics_inst_global_inc(AMF_METR_GLOB_CTR_MM_PAGING_5G_REQ);
-
-                    rv = ngap_send_to_gnb(gnb, ngapbuf, NGAP_NON_UE_SIGNALLING);
-                    if (rv != OGS_OK) {
-                        ogs_error("ngap_send_to_gnb() failed");
-                        return rv;
-                    }
+    ta = amf_ta_find(&amf_ue->nr_tai);
+    if (ta) {
+        ogs_list_for_each(&ta->gnb_list, ta_gnb) {
+            amf_gnb_t *gnb = ta_gnb->gnb;
+            ogs_assert(gnb);
+
+            if (amf_ue->t3513.pkbuf) {
+                ngapbuf = amf_ue->t3513.pkbuf;
+            } else {
+                ngapbuf = ngap_build_paging(amf_ue);
+                if (!ngapbuf) {
+                    ogs_error("ngap_build_paging() failed");
+                    return OGS_ERROR;
                 }
             }
+
+            amf_ue->t3513.pkbuf = ogs_pkbuf_copy(ngapbuf);
+            if (!amf_ue->t3513.pkbuf) {
+                ogs_error("ogs_pkbuf_copy() failed");
+                ogs_pkbuf_free(ngapbuf);
+                return OGS_ERROR;
+            }
+
+            amf_metrics_inst_global_inc(AMF_METR_GLOB_CTR_MM_PAGING_5G_REQ);
+
+            rv = ngap_send_to_gnb(gnb, ngapbuf, NGAP_NON_UE_SIGNALLING);
+            if (rv != OGS_OK) {
+                ogs_error("ngap_send_to_gnb() failed");
+                return rv;
+            }
         }
     }
 
@@ -126,6 +126,30 @@ int amf_ue_sbi_discover_and_send(
         }
     }
 
+    /*
+     * Keep the UE on the same AUSF/UDM/PCF across its contexts.
+     *
+     * The first authentication of a UE that registers with a SUCI
+     * happens before the SUPI is known, so the AUSF is then chosen
+     * by the SUCI. Once the SUPI is known, it is the key.
+     */
+    if (ogs_sbi_self()->client_selection ==
+            OGS_SBI_CLIENT_SELECTION_CONSISTENT_HASH &&
+        (amf_ue->supi ||
+         (amf_ue->suci && target_nf_type == OpenAPI_nf_type_AUSF)) &&
+        (target_nf_type == OpenAPI_nf_type_AUSF ||
+         target_nf_type == OpenAPI_nf_type_UDM ||
+         target_nf_type == OpenAPI_nf_type_PCF)) {
+        if (!discovery_option) {
+            discovery_option = ogs_sbi_discovery_option_new();
+            ogs_assert(discovery_option);
+        }
+
+        if (!discovery_option->affinity_key)
+            ogs_sbi_discovery_option_set_affinity_key(discovery_option,
+                    amf_ue->supi ? amf_ue->supi : amf_ue->suci);
+    }
+
     xact = ogs_sbi_xact_add(
             amf_ue->id, &amf_ue->sbi, service_type, discovery_option,
             (ogs_sbi_build_f)build, amf_ue, data);
@@ -371,6 +395,8 @@ static int client_discover_cb(
     }
 
     ogs_nnrf_disc_handle_nf_discover_search_result(message.SearchResult);
+    ogs_sbi_discovery_cache_add(target_nf_type, requester_nf_type,
+            discovery_option, message.SearchResult);
 
     nf_instance = ogs_sbi_nf_instance_find_by_discovery_param(
                     target_nf_type, requester_nf_type, discovery_option);
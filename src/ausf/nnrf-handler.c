@@ -52,6 +52,8 @@ void ausf_nnrf_handle_nf_discover(
     }
 
     ogs_nnrf_disc_handle_nf_discover_search_result(SearchResult);
+    ogs_sbi_discovery_cache_add(target_nf_type, requester_nf_type,
+            discovery_option, SearchResult);
 
     nf_instance = ogs_sbi_nf_instance_find_by_discovery_param(
                     target_nf_type, requester_nf_type, discovery_option);
@@ -42,6 +42,16 @@ typedef struct hss_impi_s {
     ogs_list_t impu_list;
 } hss_impi_t;
 
+typedef struct hss_av_cache_s {
+    ogs_lnode_t lnode;
+
+    char *id;
+
+    int num;                    /* vectors in 'av' */
+    int next;                   /* next vector to hand out */
+    hss_auth_vector_t *av;
+} hss_av_cache_t;
+
 typedef struct hss_impu_s {
     ogs_lnode_t lnode;
 
@@ -61,6 +71,7 @@ static int context_initialized = 0;
 static OGS_POOL(imsi_pool, hss_imsi_t);
 static OGS_POOL(impi_pool, hss_impi_t);
 static OGS_POOL(impu_pool, hss_impu_t);
+static OGS_POOL(av_cache_pool, hss_av_cache_t);
 
 static hss_imsi_t *imsi_add(char *id);
 static void imsi_remove(hss_imsi_t *imsi);
@@ -80,6 +91,9 @@ static void impu_remove_all(hss_impi_t *impi);
 static hss_impu_t *impu_find_by_id(char *id);
 static hss_impu_t *impu_find_by_impi_and_id(hss_impi_t *impi, char *id);
 
+static void av_cache_remove(hss_av_cache_t *cache);
+static void av_cache_remove_all(void);
+
 hss_context_t* hss_self(void)
 {
     return &self;
@@ -87,6 +101,8 @@ hss_context_t* hss_self(void)
 
 void hss_context_init(void)
 {
+    int i;
+
     ogs_assert(context_initialized == 0);
 
     /* Initial FreeDiameter Config */
@@ -103,6 +119,7 @@ void hss_context_init(void)
     ogs_pool_init(&imsi_pool, ogs_app()->pool.impi);
     ogs_pool_init(&impi_pool, ogs_app()->pool.impi);
     ogs_pool_init(&impu_pool, ogs_app()->pool.impu);
+    ogs_pool_init(&av_cache_pool, ogs_global_conf()->max.ue);
 
     self.imsi_hash = ogs_hash_make();
     ogs_assert(self.imsi_hash);
@@ -110,19 +127,26 @@ void hss_context_init(void)
     ogs_assert(self.impi_hash);
     self.impu_hash = ogs_hash_make();
     ogs_assert(self.impu_hash);
+    self.av_hash = ogs_hash_make();
+    ogs_assert(self.av_hash);
 
-    ogs_thread_mutex_init(&self.db_lock);
+    for (i = 0; i < HSS_SQN_LOCK_STRIPES; i++)
+        ogs_thread_mutex_init(&self.sqn_lock[i]);
     ogs_thread_mutex_init(&self.cx_lock);
+    ogs_thread_mutex_init(&self.av_lock);
 
     context_initialized = 1;
 }
 
 void hss_context_final(void)
 {
+    int i;
+
     ogs_assert(context_initialized == 1);
 
     imsi_remove_all();
     impi_remove_all();
+    av_cache_remove_all();
 
     ogs_assert(self.imsi_hash);
     ogs_hash_destroy(self.imsi_hash);
@@ -130,13 +154,18 @@ void hss_context_final(void)
     ogs_hash_destroy(self.impi_hash);
     ogs_assert(self.impu_hash);
     ogs_hash_destroy(self.impu_hash);
+    ogs_assert(self.av_hash);
+    ogs_hash_destroy(self.av_hash);
 
     ogs_pool_final(&imsi_pool);
     ogs_pool_final(&impi_pool);
     ogs_pool_final(&impu_pool);
+    ogs_pool_final(&av_cache_pool);
 
-    ogs_thread_mutex_destroy(&self.db_lock);
+    for (i = 0; i < HSS_SQN_LOCK_STRIPES; i++)
+        ogs_thread_mutex_destroy(&self.sqn_lock[i]);
     ogs_thread_mutex_destroy(&self.cx_lock);
+    ogs_thread_mutex_destroy(&self.av_lock);
 
     context_initialized = 0;
 }
@@ -147,6 +176,8 @@ static int hss_context_prepare(void)
     self.diam_config->cnf_port_tls = DIAMETER_SECURE_PORT;
     self.diam_config->stats.priv_stats_size = sizeof(hss_diam_stats_t);
 
+    self.auth_vector_depth = 1;
+
     return OGS_OK;
 }
 
@@ -160,6 +191,13 @@ static int hss_context_validation(void)
         return OGS_ERROR;
     }
 
+    if (self.auth_vector_depth < 1 ||
+        self.auth_vector_depth > HSS_MAX_AUTH_VECTOR_DEPTH) {
+        ogs_error("Invalid hss.auth_vector_depth[%d] in '%s'",
+                self.auth_vector_depth, ogs_app()->file);
+        return OGS_ERROR;
+    }
+
     return OGS_OK;
 }
 
@@ -353,6 +391,9 @@ int hss_context_parse_config(void)
 #else
                     self.use_mongodb_change_stream = false;
 #endif
+                } else if (!strcmp(hss_key, "auth_vector_depth")) {
+                    const char *v = ogs_yaml_iter_value(&hss_iter);
+                    if (v) self.auth_vector_depth = atoi(v);
                 } else if (!strcmp(hss_key, "metrics")) {
                     /* handle config in metrics library */
                 } else
@@ -375,14 +416,12 @@ int hss_db_auth_info(char *imsi_bcd, ogs_dbi_auth_info_t *auth_info)
     ogs_assert(imsi_bcd);
     ogs_assert(auth_info);
 
-    ogs_thread_mutex_lock(&self.db_lock);
     supi = ogs_msprintf("%s-%s", OGS_ID_SUPI_TYPE_IMSI, imsi_bcd);
     ogs_assert(supi);
 
     rv = ogs_dbi_auth_info(supi, auth_info);
 
     ogs_free(supi);
-    ogs_thread_mutex_unlock(&self.db_lock);
 
     return rv;
 }
@@ -394,14 +433,12 @@ int hss_db_update_sqn(char *imsi_bcd, uint8_t *rand, uint64_t sqn)
 
     ogs_assert(imsi_bcd);
 
-    ogs_thread_mutex_lock(&self.db_lock);
     supi = ogs_msprintf("%s-%s", OGS_ID_SUPI_TYPE_IMSI, imsi_bcd);
     ogs_assert(supi);
 
     rv = ogs_dbi_update_sqn(supi, sqn);
 
     ogs_free(supi);
-    ogs_thread_mutex_unlock(&self.db_lock);
 
     return rv;
 }
@@ -413,14 +450,12 @@ int hss_db_update_imeisv(char *imsi_bcd, char *imeisv)
 
     ogs_assert(imsi_bcd);
 
-    ogs_thread_mutex_lock(&self.db_lock);
     supi = ogs_msprintf("%s-%s", OGS_ID_SUPI_TYPE_IMSI, imsi_bcd);
     ogs_assert(supi);
 
     rv = ogs_dbi_update_imeisv(supi, imeisv);
 
     ogs_free(supi);
-    ogs_thread_mutex_unlock(&self.db_lock);
 
     return rv;
 }
@@ -433,14 +468,12 @@ int hss_db_update_mme(char *imsi_bcd, char *mme_host, char *mme_realm,
 
     ogs_assert(imsi_bcd);
 
-    ogs_thread_mutex_lock(&self.db_lock);
     supi = ogs_msprintf("%s-%s", OGS_ID_SUPI_TYPE_IMSI, imsi_bcd);
     ogs_assert(supi);
 
     rv = ogs_dbi_update_mme(supi, mme_host, mme_realm, purge_flag);
 
     ogs_free(supi);
-    ogs_thread_mutex_unlock(&self.db_lock);
 
     return rv;
 }
@@ -452,14 +485,12 @@ int hss_db_increment_sqn(char *imsi_bcd)
 
     ogs_assert(imsi_bcd);
 
-    ogs_thread_mutex_lock(&self.db_lock);
     supi = ogs_msprintf("%s-%s", OGS_ID_SUPI_TYPE_IMSI, imsi_bcd);
     ogs_assert(supi);
 
     rv = ogs_dbi_increment_sqn(supi);
 
     ogs_free(supi);
-    ogs_thread_mutex_unlock(&self.db_lock);
 
     return rv;
 }
@@ -473,14 +504,12 @@ int hss_db_subscription_data(
     ogs_assert(imsi_bcd);
     ogs_assert(subscription_data);
 
-    ogs_thread_mutex_lock(&self.db_lock);
     supi = ogs_msprintf("%s-%s", OGS_ID_SUPI_TYPE_IMSI, imsi_bcd);
     ogs_assert(supi);
 
     rv = ogs_dbi_subscription_data(supi, subscription_data);
 
     ogs_free(supi);
-    ogs_thread_mutex_unlock(&self.db_lock);
 
     return rv;
 }
@@ -492,12 +521,8 @@ int hss_db_msisdn_data(char *imsi_or_msisdn_bcd, ogs_msisdn_data_t *msisdn_data)
     ogs_assert(imsi_or_msisdn_bcd);
     ogs_assert(msisdn_data);
 
-    ogs_thread_mutex_lock(&self.db_lock);
-
     rv = ogs_dbi_msisdn_data(imsi_or_msisdn_bcd, msisdn_data);
 
-    ogs_thread_mutex_unlock(&self.db_lock);
-
     return rv;
 }
 
@@ -509,18 +534,359 @@ int hss_db_ims_data(char *imsi_bcd, ogs_ims_data_t *ims_data)
     ogs_assert(imsi_bcd);
     ogs_assert(ims_data);
 
-    ogs_thread_mutex_lock(&self.db_lock);
     supi = ogs_msprintf("%s-%s", OGS_ID_SUPI_TYPE_IMSI, imsi_bcd);
     ogs_assert(supi);
 
     rv = ogs_dbi_ims_data(supi, ims_data);
 
     ogs_free(supi);
-    ogs_thread_mutex_unlock(&self.db_lock);
 
     return rv;
 }
 
+/*
+ * Authentication vector pre-generation
+ *
+ * Instead of one DB read and one SQN update per authentication,
+ * 'auth_vector_depth' vectors with consecutive SQNs are generated at once
+ * and the whole SQN range is reserved with a single update. The remaining
+ * vectors are handed out from memory in SQN order, so the UE still sees
+ * a strictly increasing SQN. Vectors that are never used only leave
+ * a gap, which is allowed by TS33.102 Annex C.
+ *
+ * A synchronization failure, an authentication over Cx/SWx or
+ * a change of the security data in the DB drops the cached vectors.
+ *
+ * Generating and caching the vectors of a subscriber runs under
+ * the IMSI's SQN lock, as does the SQN read-modify-write of
+ * the Cx/SWx MAR. av_lock only guards av_hash and av_list, so
+ * the DB I/O and Milenage of one IMSI do not block the other subscribers.
+ */
+static ogs_thread_mutex_t *sqn_lock_of(char *imsi_bcd)
+{
+    int klen;
+
+    ogs_assert(imsi_bcd);
+
+    klen = strlen(imsi_bcd);
+    return &self.sqn_lock[
+        ogs_hashfunc_default(imsi_bcd, &klen) % HSS_SQN_LOCK_STRIPES];
+}
+
+static void hss_sqn_lock(char *imsi_bcd)
+{
+    ogs_thread_mutex_lock(sqn_lock_of(imsi_bcd));
+}
+
+static void hss_sqn_unlock(char *imsi_bcd)
+{
+    ogs_thread_mutex_unlock(sqn_lock_of(imsi_bcd));
+}
+
+/* The caller holds the IMSI's SQN lock */
+static int av_generate(char *imsi_bcd, uint8_t *resync,
+        hss_auth_vector_t *av, int num)
+{
+    int rv, i;
+    ogs_dbi_auth_info_t auth_info;
+    uint8_t opc[OGS_KEY_LEN];
+    uint8_t sqn[OGS_SQN_LEN];
+    uint8_t mac_s[OGS_MAC_S_LEN];
+    uint8_t zero[OGS_RAND_LEN];
+    bool fixed_rand = false;
+
+    ogs_assert(imsi_bcd);
+    ogs_assert(av);
+    ogs_assert(num > 0);
+
+    memset(&auth_info, 0, sizeof(auth_info));
+    rv = hss_db_auth_info(imsi_bcd, &auth_info);
+    if (rv != OGS_OK)
+        return OGS_NOTFOUND;
+
+    /* A RAND provisioned in the DB is used as it is */
+    memset(zero, 0, sizeof(zero));
+    if (memcmp(auth_info.rand, zero, OGS_RAND_LEN) != 0)
+        fixed_rand = true;
+
+    if (auth_info.use_opc)
+        memcpy(opc, auth_info.opc, sizeof(opc));
+    else
+        milenage_opc(auth_info.k, auth_info.op, opc);
+
+    if (resync) {
+        ogs_auc_sqn(opc, auth_info.k, resync, resync + OGS_RAND_LEN,
+                sqn, mac_s);
+        if (memcmp(mac_s, resync + OGS_RAND_LEN + OGS_SQN_LEN,
+                    OGS_MAC_S_LEN) != 0) {
+            ogs_error("Re-synch MAC failed for IMSI: %s", imsi_bcd);
+
+            ogs_log_print(OGS_LOG_ERROR, "MAC_S: ");
+            ogs_log_hexdump(OGS_LOG_ERROR, mac_s, OGS_MAC_S_LEN);
+            ogs_log_hexdump(OGS_LOG_ERROR,
+                    resync + OGS_RAND_LEN + OGS_SQN_LEN, OGS_MAC_S_LEN);
+            ogs_log_print(OGS_LOG_ERROR, "SQN: ");
+            ogs_log_hexdump(OGS_LOG_ERROR, sqn, OGS_SQN_LEN);
+
+            return OGS_ERROR;
+        }
+
+        fixed_rand = false;
+        auth_info.sqn = ogs_buffer_to_uint64(sqn, OGS_SQN_LEN);
+        /* 33.102 C.3.4 Guide : IND + 1 */
+        auth_info.sqn = (auth_info.sqn + 32 + 1) & OGS_MAX_SQN;
+    }
+
+    /* Reserve SQN .. SQN + 32*(num-1) */
+    rv = hss_db_update_sqn(imsi_bcd, NULL,
+            (auth_info.sqn + 32 * num) & OGS_MAX_SQN);
+    if (rv != OGS_OK) {
+        ogs_error("Cannot update sqn for IMSI: %s", imsi_bcd);
+        return OGS_ERROR;
+    }
+
+    for (i = 0; i < num; i++) {
+        if (fixed_rand)
+            memcpy(av[i].rand, auth_info.rand, OGS_RAND_LEN);
+        else
+            ogs_random(av[i].rand, OGS_RAND_LEN);
+
+        ogs_uint64_to_buffer((auth_info.sqn + 32 * i) & OGS_MAX_SQN,
+                OGS_SQN_LEN, av[i].sqn);
+
+        av[i].xres_len = sizeof(av[i].xres);
+        milenage_generate(opc, auth_info.amf, auth_info.k,
+                av[i].sqn, av[i].rand,
+                av[i].autn, av[i].ik, av[i].ck, av[i].ak,
+                av[i].xres, &av[i].xres_len);
+    }
+
+    return OGS_OK;
+}
+
+int hss_auth_vector_get(
+        char *imsi_bcd, uint8_t *resync, hss_auth_vector_t *av)
+{
+    int rv;
+    hss_av_cache_t *cache = NULL;
+    hss_auth_vector_t *batch = NULL, *old = NULL;
+
+    ogs_assert(imsi_bcd);
+    ogs_assert(av);
+
+    hss_sqn_lock(imsi_bcd);
+
+    if (self.auth_vector_depth == 1) {
+        rv = av_generate(imsi_bcd, resync, av, 1);
+        hss_sqn_unlock(imsi_bcd);
+        return rv;
+    }
+
+    ogs_thread_mutex_lock(&self.av_lock);
+
+    cache = ogs_hash_get(self.av_hash, imsi_bcd, strlen(imsi_bcd));
+    if (cache && !resync && cache->next < cache->num) {
+        ogs_list_remove(&self.av_list, cache);
+        memcpy(av, &cache->av[cache->next++], sizeof(*av));
+        ogs_list_add(&self.av_list, cache);
+
+        ogs_thread_mutex_unlock(&self.av_lock);
+        hss_sqn_unlock(imsi_bcd);
+        return OGS_OK;
+    }
+
+    ogs_thread_mutex_unlock(&self.av_lock);
+
+    batch = ogs_calloc(self.auth_vector_depth, sizeof(hss_auth_vector_t));
+    ogs_assert(batch);
+
+    rv = av_generate(imsi_bcd, resync, batch, self.auth_vector_depth);
+    if (rv != OGS_OK) {
+        ogs_free(batch);
+        hss_auth_vector_flush(imsi_bcd);
+
+        hss_sqn_unlock(imsi_bcd);
+        return rv;
+    }
+
+    ogs_thread_mutex_lock(&self.av_lock);
+
+    /* The entry may have been evicted or flushed while generating */
+    cache = ogs_hash_get(self.av_hash, imsi_bcd, strlen(imsi_bcd));
+    if (cache) {
+        ogs_list_remove(&self.av_list, cache);
+    } else {
+        ogs_pool_alloc(&av_cache_pool, &cache);
+        if (!cache) {
+            /* Reuse the least recently used one */
+            cache = ogs_list_first(&self.av_list);
+            ogs_assert(cache);
+
+            ogs_list_remove(&self.av_list, cache);
+            ogs_hash_set(self.av_hash, cache->id, strlen(cache->id), NULL);
+            ogs_free(cache->id);
+        } else {
+            memset(cache, 0, sizeof(*cache));
+        }
+
+        cache->id = ogs_strdup(imsi_bcd);
+        ogs_assert(cache->id);
+        ogs_hash_set(self.av_hash, cache->id, strlen(cache->id), cache);
+    }
+
+    old = cache->av;
+    cache->av = batch;
+    cache->num = self.auth_vector_depth;
+    cache->next = 0;
+
+    memcpy(av, &cache->av[cache->next++], sizeof(*av));
+    ogs_list_add(&self.av_list, cache);
+
+    ogs_thread_mutex_unlock(&self.av_lock);
+    hss_sqn_unlock(imsi_bcd);
+
+    if (old) {
+        memset(old, 0, self.auth_vector_depth * sizeof(hss_auth_vector_t));
+        ogs_free(old);
+    }
+
+    return OGS_OK;
+}
+
+void hss_auth_vector_flush(char *imsi_bcd)
+{
+    hss_av_cache_t *cache = NULL;
+
+    ogs_assert(imsi_bcd);
+
+    if (self.auth_vector_depth == 1)
+        return;
+
+    ogs_thread_mutex_lock(&self.av_lock);
+
+    cache = ogs_hash_get(self.av_hash, imsi_bcd, strlen(imsi_bcd));
+    if (cache) {
+        ogs_list_remove(&self.av_list, cache);
+        av_cache_remove(cache);
+    }
+
+    ogs_thread_mutex_unlock(&self.av_lock);
+}
+
+/*
+ * Authentication info of a Cx/SWx MAR, with its SQN reserved.
+ *
+ * The SQN is read, re-synchronized and written back under the IMSI's
+ * SQN lock, so an AIR of the same IMSI cannot reserve the same SQN.
+ * Vectors cached for S6a would fall behind the SQN handed out here.
+ * They are dropped before the DB is written, so a failed update
+ * cannot leave them in place.
+ */
+int hss_mar_auth_info(char *imsi_bcd, uint8_t *resync,
+        ogs_dbi_auth_info_t *auth_info, uint8_t *opc)
+{
+    int rv;
+    uint8_t sqn[OGS_SQN_LEN];
+    uint8_t mac_s[OGS_MAC_S_LEN];
+    uint8_t zero[OGS_RAND_LEN];
+    int result_code = ER_DIAMETER_SUCCESS;
+
+    ogs_assert(imsi_bcd);
+    ogs_assert(auth_info);
+    ogs_assert(opc);
+
+    hss_sqn_lock(imsi_bcd);
+
+    /* DB : HSS Auth-Info */
+    rv = hss_db_auth_info(imsi_bcd, auth_info);
+    if (rv != OGS_OK) {
+        ogs_error("Cannot get IMS-Data for IMSI: %s", imsi_bcd);
+        result_code = OGS_DIAM_CX_ERROR_USER_UNKNOWN;
+        goto out;
+    }
+
+    memset(zero, 0, sizeof(zero));
+    if (memcmp(auth_info->rand, zero, OGS_RAND_LEN) == 0) {
+        ogs_random(auth_info->rand, OGS_RAND_LEN);
+    }
+
+    if (auth_info->use_opc)
+        memcpy(opc, auth_info->opc, OGS_KEY_LEN);
+    else
+        milenage_opc(auth_info->k, auth_info->op, opc);
+
+    if (resync) {
+        ogs_auc_sqn(opc, auth_info->k, resync, resync + OGS_RAND_LEN,
+                sqn, mac_s);
+        if (memcmp(mac_s, resync + OGS_RAND_LEN + OGS_SQN_LEN,
+                    OGS_MAC_S_LEN) != 0) {
+            ogs_error("Re-synch MAC failed for IMSI: %s", imsi_bcd);
+
+            ogs_log_print(OGS_LOG_ERROR, "MAC_S: ");
+            ogs_log_hexdump(OGS_LOG_ERROR, mac_s, OGS_MAC_S_LEN);
+            ogs_log_hexdump(OGS_LOG_ERROR,
+                    resync + OGS_RAND_LEN + OGS_SQN_LEN, OGS_MAC_S_LEN);
+            ogs_log_print(OGS_LOG_ERROR, "SQN: ");
+            ogs_log_hexdump(OGS_LOG_ERROR, sqn, OGS_SQN_LEN);
+
+            result_code = OGS_DIAM_CX_ERROR_AUTH_SCHEME_NOT_SUPPORTED;
+            goto out;
+        }
+
+        ogs_random(auth_info->rand, OGS_RAND_LEN);
+        auth_info->sqn = ogs_buffer_to_uint64(sqn, OGS_SQN_LEN);
+        /* 33.102 C.3.4 Guide : IND + 1 */
+        auth_info->sqn = (auth_info->sqn + 32 + 1) & OGS_MAX_SQN;
+    }
+
+    hss_auth_vector_flush(imsi_bcd);
+
+    rv = hss_db_update_sqn(imsi_bcd, auth_info->rand, auth_info->sqn);
+    if (rv != OGS_OK) {
+        ogs_error("Cannot update rand and sqn for IMSI: %s", imsi_bcd);
+        result_code = OGS_DIAM_CX_ERROR_IN_ASSIGNMENT_TYPE;
+        goto out;
+    }
+
+    rv = hss_db_increment_sqn(imsi_bcd);
+    if (rv != OGS_OK) {
+        ogs_error("Cannot increment sqn for IMSI: %s", imsi_bcd);
+        result_code = OGS_DIAM_CX_ERROR_IN_ASSIGNMENT_TYPE;
+        goto out;
+    }
+
+out:
+    hss_sqn_unlock(imsi_bcd);
+
+    return result_code;
+}
+
+/* 'cache' must already be out of av_list */
+static void av_cache_remove(hss_av_cache_t *cache)
+{
+    ogs_assert(cache);
+
+    ogs_assert(cache->id);
+    ogs_hash_set(self.av_hash, cache->id, strlen(cache->id), NULL);
+    ogs_free(cache->id);
+
+    ogs_assert(cache->av);
+    memset(cache->av, 0, self.auth_vector_depth * sizeof(hss_auth_vector_t));
+    ogs_free(cache->av);
+
+    ogs_pool_free(&av_cache_pool, cache);
+}
+
+static void av_cache_remove_all(void)
+{
+    hss_av_cache_t *cache = NULL, *next = NULL;
+
+    ogs_list_for_each_safe(&self.av_list, next, cache) {
+        ogs_list_remove(&self.av_list, cache);
+        av_cache_remove(cache);
+    }
+}
+
 static hss_imsi_t *imsi_add(char *id)
 {
     hss_imsi_t *imsi = NULL;
@@ -1366,15 +1732,7 @@ static int process_change_stream(const bson_t *document);
 
 int hss_db_poll_change_stream(void)
 {
-    int rv;
-
-    ogs_thread_mutex_lock(&self.db_lock);
-
-    rv = poll_change_stream();
-
-    ogs_thread_mutex_unlock(&self.db_lock);
-
-    return rv;
+    return poll_change_stream();
 }
 
 static int poll_change_stream(void)
@@ -1520,6 +1878,13 @@ int hss_handle_change_event(const bson_t *document)
                         send_idr_flag = true;
                         subdatamask = (subdatamask |
                             OGS_DIAM_S6A_SUBDATA_APN_CONFIG);
+                    } else if (!strncmp(child2_key,
+                                OGS_SECURITY_STRING,
+                                strlen(OGS_SECURITY_STRING)) &&
+                            strcmp(child2_key, OGS_SECURITY_STRING "."
+                                OGS_SQN_STRING) != 0) {
+                        /* Not our own SQN reservation */
+                        hss_auth_vector_flush(imsi_bcd);
                     }
                 }
             }
@@ -36,15 +36,25 @@ extern int __hss_log_domain;
 #undef OGS_LOG_DOMAIN
 #define OGS_LOG_DOMAIN __hss_log_domain
 
+#define HSS_MAX_AUTH_VECTOR_DEPTH 32
+#define HSS_SQN_LOCK_STRIPES 64
+
 typedef struct _hss_context_t {
     const char          *diam_conf_path;/* HSS Diameter conf path */
     ogs_diam_config_t   *diam_config;   /* HSS Diameter config */
     const char          *sms_over_ims;  /* SMS over IMS */
     int                 use_mongodb_change_stream;
 
-    ogs_thread_mutex_t  db_lock;
+    /* SQN read-modify-write, striped by IMSI */
+    ogs_thread_mutex_t  sqn_lock[HSS_SQN_LOCK_STRIPES];
     ogs_thread_mutex_t  cx_lock;
 
+    /* Authentication vectors generated per DB update (1 : no cache) */
+    int                 auth_vector_depth;
+    ogs_thread_mutex_t  av_lock;
+    ogs_list_t          av_list;        /* Least recently used first */
+    ogs_hash_t          *av_hash;       /* hash table (IMSI) */
+
     /* S6A Interface */
     ogs_list_t          imsi_list;
     ogs_hash_t          *imsi_hash;     /* hash table (IMSI) */
@@ -55,6 +65,17 @@ typedef struct _hss_context_t {
     ogs_hash_t          *impu_hash;     /* hash table (IMPU) */
 } hss_context_t;
 
+typedef struct hss_auth_vector_s {
+    uint8_t rand[OGS_RAND_LEN];
+    uint8_t sqn[OGS_SQN_LEN];
+    uint8_t autn[OGS_AUTN_LEN];
+    uint8_t ik[OGS_KEY_LEN];
+    uint8_t ck[OGS_KEY_LEN];
+    uint8_t ak[OGS_AK_LEN];
+    uint8_t xres[OGS_MAX_RES_LEN];
+    size_t xres_len;
+} hss_auth_vector_t;
+
 void hss_context_init(void);
 void hss_context_final(void);
 hss_context_t *hss_self(void);
@@ -76,6 +97,25 @@ int hss_db_msisdn_data(
 
 int hss_db_ims_data(char *imsi_bcd, ogs_ims_data_t *ims_data);
 
+/*
+ * Returns the next authentication vector of the subscriber.
+ *
+ * 'resync' is RAND || AUTS of a synchronization failure, or NULL.
+ * OGS_NOTFOUND if the IMSI is not in the DB, OGS_ERROR on AUTS/DB failure.
+ */
+int hss_auth_vector_get(
+        char *imsi_bcd, uint8_t *resync, hss_auth_vector_t *av);
+void hss_auth_vector_flush(char *imsi_bcd);
+
+/*
+ * Reads the auth info of a Cx/SWx MAR and reserves its SQN.
+ *
+ * 'resync' is RAND || AUTS of the SIP-Authorization AVP, or NULL.
+ * Returns ER_DIAMETER_SUCCESS or the OGS_DIAM_CX_ERROR_* result code.
+ */
+int hss_mar_auth_info(char *imsi_bcd, uint8_t *resync,
+        ogs_dbi_auth_info_t *auth_info, uint8_t *opc);
+
 void hss_cx_associate_identity(char *user_name, char *public_identity);
 bool hss_cx_identity_is_associated(char *user_name, char *public_identity);
 
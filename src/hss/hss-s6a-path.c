@@ -83,19 +83,10 @@ static int hss_ogs_diam_s6a_air_cb(struct msg **msg, struct avp *avp,
     union avp_value val;
 
     char imsi_bcd[OGS_MAX_IMSI_BCD_LEN+1];
-    uint8_t opc[OGS_KEY_LEN];
-    uint8_t sqn[OGS_SQN_LEN];
-    uint8_t autn[OGS_AUTN_LEN];
-    uint8_t ik[OGS_KEY_LEN];
-    uint8_t ck[OGS_KEY_LEN];
-    uint8_t ak[OGS_AK_LEN];
-    uint8_t xres[OGS_MAX_RES_LEN];
     uint8_t kasme[OGS_SHA256_DIGEST_SIZE];
-    size_t xres_len = 8;
-    uint8_t mac_s[OGS_MAC_S_LEN];
 
-    ogs_dbi_auth_info_t auth_info;
-    uint8_t zero[OGS_RAND_LEN];
+    hss_auth_vector_t av;
+    uint8_t *resync = NULL;
     int rv;
     uint32_t result_code = 0;
     ogs_plmn_id_t visited_plmn_id;
@@ -111,7 +102,7 @@ static int hss_ogs_diam_s6a_air_cb(struct msg **msg, struct avp *avp,
 
     /* Initialize variables */
     memset(imsi_bcd, 0, sizeof(imsi_bcd));
-    memset(&auth_info, 0, sizeof(auth_info));
+    memset(&av, 0, sizeof(av));
     memset(&visited_plmn_id, 0, sizeof(visited_plmn_id));
 
     /* Create answer header */
@@ -151,27 +142,6 @@ static int hss_ogs_diam_s6a_air_cb(struct msg **msg, struct avp *avp,
     ogs_cpystrn(imsi_bcd, (char*)hdr->avp_value->os.data,
         ogs_min(hdr->avp_value->os.len, OGS_MAX_IMSI_BCD_LEN)+1);
 
-    /* Get authentication info from database */
-    rv = hss_db_auth_info(imsi_bcd, &auth_info);
-    if (rv != OGS_OK) {
-        ogs_warn("Failed to get auth info for IMSI: %s", imsi_bcd);
-        result_code = OGS_DIAM_S6A_ERROR_USER_UNKNOWN;
-        error_occurred = 1;
-        goto out;
-    }
-
-    /* Generate RAND if not set */
-    memset(zero, 0, sizeof(zero));
-    if (memcmp(auth_info.rand, zero, OGS_RAND_LEN) == 0) {
-        ogs_random(auth_info.rand, OGS_RAND_LEN);
-    }
-
-    /* Calculate OPC */
-    if (auth_info.use_opc)
-        memcpy(opc, auth_info.opc, sizeof(opc));
-    else
-        milenage_opc(auth_info.k, auth_info.op, opc);
-
     /* Check for re-synchronization */
     ret = fd_msg_search_avp(qry, ogs_diam_s6a_req_eutran_auth_info, &avp);
     if (ret == 0 && avp) {
@@ -179,49 +149,20 @@ static int hss_ogs_diam_s6a_air_cb(struct msg **msg, struct avp *avp,
                                 &avpch);
         if (ret == 0 && avpch) {
             ret = fd_msg_avp_hdr(avpch, &hdr);
-            if (ret == 0 && hdr) {
-                ogs_auc_sqn(opc, auth_info.k,
-                        hdr->avp_value->os.data,
-                        hdr->avp_value->os.data + OGS_RAND_LEN,
-                        sqn, mac_s);
-                if (memcmp(mac_s, hdr->avp_value->os.data +
-                            OGS_RAND_LEN + OGS_SQN_LEN, OGS_MAC_S_LEN) == 0) {
-                    ogs_random(auth_info.rand, OGS_RAND_LEN);
-                    auth_info.sqn = ogs_buffer_to_uint64(sqn, OGS_SQN_LEN);
-                    /* 33.102 C.3.4 Guide : IND + 1 */
-                    auth_info.sqn = (auth_info.sqn + 32 + 1) & OGS_MAX_SQN;
-                } else {
-                    ogs_error("Re-synch MAC failed for IMSI: %s", imsi_bcd);
-
-                    ogs_log_print(OGS_LOG_ERROR, "MAC_S: ");
-                    ogs_log_hexdump(OGS_LOG_ERROR, mac_s, OGS_MAC_S_LEN);
-                    ogs_log_hexdump(OGS_LOG_ERROR,
-                            (void*)(hdr->avp_value->os.data +
-                                OGS_RAND_LEN + OGS_SQN_LEN),
-                            OGS_MAC_S_LEN);
-                    ogs_log_print(OGS_LOG_ERROR, "SQN: ");
-                    ogs_log_hexdump(OGS_LOG_ERROR, sqn, OGS_SQN_LEN);
-
-                    result_code = OGS_DIAM_S6A_AUTHENTICATION_DATA_UNAVAILABLE;
-                    error_occurred = 1;
-                    goto out;
-                }
-            }
+            if (ret == 0 && hdr)
+                resync = hdr->avp_value->os.data;
         }
     }
 
-    /* Update SQN in database */
-    rv = hss_db_update_sqn(imsi_bcd, auth_info.rand, auth_info.sqn);
-    if (rv != OGS_OK) {
-        ogs_error("Cannot update rand and sqn for IMSI: %s", imsi_bcd);
-        result_code = OGS_DIAM_S6A_AUTHENTICATION_DATA_UNAVAILABLE;
+    /* Get authentication vector (from DB or pre-generated) */
+    rv = hss_auth_vector_get(imsi_bcd, resync, &av);
+    if (rv == OGS_NOTFOUND) {
+        ogs_warn("Failed to get auth info for IMSI: %s", imsi_bcd);
+        result_code = OGS_DIAM_S6A_ERROR_USER_UNKNOWN;
         error_occurred = 1;
         goto out;
-    }
-
-    rv = hss_db_increment_sqn(imsi_bcd);
-    if (rv != OGS_OK) {
-        ogs_error("Cannot increment sqn for IMSI: %s", imsi_bcd);
+    } else if (rv != OGS_OK) {
+        ogs_error("Cannot get auth vector for IMSI: %s", imsi_bcd);
         result_code = OGS_DIAM_S6A_AUTHENTICATION_DATA_UNAVAILABLE;
         error_occurred = 1;
         goto out;
@@ -254,11 +195,8 @@ static int hss_ogs_diam_s6a_air_cb(struct msg **msg, struct avp *avp,
     memcpy(&visited_plmn_id, hdr->avp_value->os.data,
             ogs_min(hdr->avp_value->os.len, sizeof(visited_plmn_id)));
 
-    /* Generate authentication vectors */
-    milenage_generate(opc, auth_info.amf, auth_info.k,
-        ogs_uint64_to_buffer(auth_info.sqn, OGS_SQN_LEN, sqn), auth_info.rand,
-        autn, ik, ck, ak, xres, &xres_len);
-    ogs_auc_kasme(ck, ik, hdr->avp_value->os.data, sqn, ak, kasme);
+    /* KASME depends on the serving network */
+    ogs_auc_kasme(av.ck, av.ik, hdr->avp_value->os.data, av.sqn, av.ak, kasme);
 
     /* Set the Authentication-Info */
     ret = fd_msg_avp_new(ogs_diam_s6a_authentication_info, 0, &avp);
@@ -282,7 +220,7 @@ static int hss_ogs_diam_s6a_air_cb(struct msg **msg, struct avp *avp,
         error_occurred = 1;
         goto out;
     }
-    val.os.data = auth_info.rand;
+    val.os.data = av.rand;
     val.os.len = OGS_KEY_LEN;
     ret = fd_msg_avp_setvalue(avp_rand, &val);
     if (ret != 0) {
@@ -304,8 +242,8 @@ static int hss_ogs_diam_s6a_air_cb(struct msg **msg, struct avp *avp,
         error_occurred = 1;
         goto out;
     }
-    val.os.data = xres;
-    val.os.len = xres_len;
+    val.os.data = av.xres;
+    val.os.len = av.xres_len;
     ret = fd_msg_avp_setvalue(avp_xres, &val);
     if (ret != 0) {
         ogs_error("Failed to set XRES value");
@@ -326,7 +264,7 @@ static int hss_ogs_diam_s6a_air_cb(struct msg **msg, struct avp *avp,
         error_occurred = 1;
         goto out;
     }
-    val.os.data = autn;
+    val.os.data = av.autn;
     val.os.len = OGS_AUTN_LEN;
     ret = fd_msg_avp_setvalue(avp_autn, &val);
     if (ret != 0) {
@@ -46,7 +46,7 @@ static int hss_ogs_diam_swx_fb_cb(struct msg **msg, struct avp *avp,
 static int hss_ogs_diam_swx_mar_cb(struct msg **msg, struct avp *avp,
         struct session *session, void *opaque, enum disp_action *act)
 {
-    int rv, ret;
+    int ret;
     uint32_t result_code = 0;
     struct msg *ans = NULL, *qry = NULL;
     struct avp *sip_auth_data_item_avp = NULL;
@@ -61,7 +61,7 @@ static int hss_ogs_diam_swx_mar_cb(struct msg **msg, struct avp *avp,
     char imsi_bcd[OGS_MAX_IMSI_BCD_LEN+1];
 
     ogs_dbi_auth_info_t auth_info;
-    uint8_t zero[OGS_RAND_LEN];
+    uint8_t *resync = NULL;
     uint8_t authenticate[OGS_KEY_LEN*2];
     uint8_t opc[OGS_KEY_LEN];
     uint8_t sqn[OGS_SQN_LEN];
@@ -71,7 +71,6 @@ static int hss_ogs_diam_swx_mar_cb(struct msg **msg, struct avp *avp,
     uint8_t ak[OGS_AK_LEN];
     uint8_t xres[OGS_MAX_RES_LEN];
     size_t xres_len = 8;
-    uint8_t mac_s[OGS_MAC_S_LEN];
 
     int error_occurred = 0;
 
@@ -185,72 +184,17 @@ static int hss_ogs_diam_swx_mar_cb(struct msg **msg, struct avp *avp,
         goto out;
     }
 
-    /* DB : HSS Auth-Info */
-    rv = hss_db_auth_info(imsi_bcd, &auth_info);
-    if (rv != OGS_OK) {
-        ogs_error("Cannot get IMS-Data for IMSI: %s", imsi_bcd);
-        result_code = OGS_DIAM_CX_ERROR_USER_UNKNOWN;
-        error_occurred = 1;
-        goto out;
-    }
-
-    memset(zero, 0, sizeof(zero));
-    if (memcmp(auth_info.rand, zero, OGS_RAND_LEN) == 0) {
-        ogs_random(auth_info.rand, OGS_RAND_LEN);
-    }
-
-    if (auth_info.use_opc)
-        memcpy(opc, auth_info.opc, sizeof(opc));
-    else
-        milenage_opc(auth_info.k, auth_info.op, opc);
-
     /* Get the SIP-Authorization AVP */
     ret = fd_msg_search_avp(sip_auth_data_item_avp,
             ogs_diam_cx_sip_authorization, &sip_authorization_avp);
     if (ret == 0 && sip_authorization_avp) {
         ret = fd_msg_avp_hdr(sip_authorization_avp, &hdr);
-        if (ret == 0 && hdr) {
-            ogs_auc_sqn(opc, auth_info.k,
-                    hdr->avp_value->os.data,
-                    hdr->avp_value->os.data + OGS_RAND_LEN,
-                    sqn, mac_s);
-            if (memcmp(mac_s, hdr->avp_value->os.data +
-                        OGS_RAND_LEN + OGS_SQN_LEN, OGS_MAC_S_LEN) == 0) {
-                ogs_random(auth_info.rand, OGS_RAND_LEN);
-                auth_info.sqn = ogs_buffer_to_uint64(sqn, OGS_SQN_LEN);
-                /* 33.102 C.3.4 Guide : IND + 1 */
-                auth_info.sqn = (auth_info.sqn + 32 + 1) & OGS_MAX_SQN;
-            } else {
-                ogs_error("Re-synch MAC failed for IMSI: %s", imsi_bcd);
-
-                ogs_log_print(OGS_LOG_ERROR, "MAC_S: ");
-                ogs_log_hexdump(OGS_LOG_ERROR, mac_s, OGS_MAC_S_LEN);
-                ogs_log_hexdump(OGS_LOG_ERROR,
-                    (void*)(hdr->avp_value->os.data +
-                        OGS_RAND_LEN + OGS_SQN_LEN),
-                    OGS_MAC_S_LEN);
-                ogs_log_print(OGS_LOG_ERROR, "SQN: ");
-                ogs_log_hexdump(OGS_LOG_ERROR, sqn, OGS_SQN_LEN);
-
-                result_code = OGS_DIAM_CX_ERROR_AUTH_SCHEME_NOT_SUPPORTED;
-                error_occurred = 1;
-                goto out;
-            }
-        }
-    }
-
-    rv = hss_db_update_sqn(imsi_bcd, auth_info.rand, auth_info.sqn);
-    if (rv != OGS_OK) {
-        ogs_error("Cannot update rand and sqn for IMSI: %s", imsi_bcd);
-        result_code = OGS_DIAM_CX_ERROR_IN_ASSIGNMENT_TYPE;
-        error_occurred = 1;
-        goto out;
+        if (ret == 0 && hdr)
+            resync = hdr->avp_value->os.data;
     }
 
-    rv = hss_db_increment_sqn(imsi_bcd);
-    if (rv != OGS_OK) {
-        ogs_error("Cannot increment sqn for IMSI: %s", imsi_bcd);
-        result_code = OGS_DIAM_CX_ERROR_IN_ASSIGNMENT_TYPE;
+    result_code = hss_mar_auth_info(imsi_bcd, resync, &auth_info, opc);
+    if (result_code != ER_DIAMETER_SUCCESS) {
         error_occurred = 1;
         goto out;
     }
@@ -35,7 +35,9 @@
  *         "sctp": {
  *           "peer": "[192.168.168.254]:36412",
  *           "max_out_streams": 10,
- *           "next_ostream_id": 3
+ *           "next_ostream_id": 3,
+ *           "write_queue": 0,
+ *           "write_queue_peak": 5
  *         },
  *         "setup_success": true
  *       },
@@ -187,6 +189,12 @@ size_t mme_dump_enb_info_paged(char *buf, size_t buflen, size_t page, size_t pag
             if (!cJSON_AddNumberToObject(sctp, "next_ostream_id", (double)(unsigned)enb->ostream_id)) {
                 cJSON_Delete(sctp); cJSON_Delete(s1); cJSON_Delete(e); oom = true; break;
             }
+            if (!cJSON_AddNumberToObject(sctp, "write_queue", (double)enb->sctp.write_queue_depth)) {
+                cJSON_Delete(sctp); cJSON_Delete(s1); cJSON_Delete(e); oom = true; break;
+            }
+            if (!cJSON_AddNumberToObject(sctp, "write_queue_peak", (double)enb->sctp.write_queue_peak)) {
+                cJSON_Delete(sctp); cJSON_Delete(s1); cJSON_Delete(e); oom = true; break;
+            }
 
             cJSON_AddItemToObjectCS(s1, "sctp", sctp);
             cJSON_AddItemToObjectCS(e, "s1", s1);
@@ -65,6 +65,16 @@ mme_metrics_spec_def_t mme_metrics_spec_def_global[_MME_METR_GLOB_MAX] = {
     .name = "enb",
     .description = "eNodeBs",
 },
+[MME_METR_GLOB_GAUGE_S1AP_WRITE_QUEUE] = {
+    .type = OGS_METRICS_METRIC_TYPE_GAUGE,
+    .name = "s1ap_write_queue",
+    .description = "S1AP messages waiting for the eNB SCTP associations",
+},
+[MME_METR_GLOB_GAUGE_S1AP_WRITE_QUEUE_MAX] = {
+    .type = OGS_METRICS_METRIC_TYPE_GAUGE,
+    .name = "s1ap_write_queue_max",
+    .description = "S1AP messages waiting for the most backlogged eNB",
+},
 };
 int mme_metrics_init_inst_global(void)
 {
@@ -76,6 +86,22 @@ int mme_metrics_free_inst_global(void)
     return mme_metrics_free_inst(mme_metrics_inst_global, _MME_METR_GLOB_MAX);
 }
 
+/* Write queues of the eNB associations, refreshed on each scrape */
+static void mme_metrics_collect_s1ap(void)
+{
+    mme_enb_t *enb = NULL;
+    int total = 0, max = 0;
+
+    ogs_list_for_each(&mme_self()->enb_list, enb) {
+        total += enb->sctp.write_queue_depth;
+        if (enb->sctp.write_queue_depth > max)
+            max = enb->sctp.write_queue_depth;
+    }
+
+    mme_metrics_inst_global_set(MME_METR_GLOB_GAUGE_S1AP_WRITE_QUEUE, total);
+    mme_metrics_inst_global_set(MME_METR_GLOB_GAUGE_S1AP_WRITE_QUEUE_MAX, max);
+}
+
 void mme_metrics_init(void)
 {
     ogs_metrics_context_t *ctx = ogs_metrics_self();
@@ -85,6 +111,7 @@ void mme_metrics_init(void)
             _MME_METR_GLOB_MAX);
 
     mme_metrics_init_inst_global();
+    ogs_metrics_register_collector(mme_metrics_collect_s1ap);
 }
 
 void mme_metrics_final(void)
@@ -71,6 +71,8 @@ static bool compare_ue_info(mme_sgw_t *node, enb_ue_t *enb_ue);
 static mme_sgw_t *selected_sgw_node(mme_sgw_t *current, enb_ue_t *enb_ue);
 static mme_sgw_t *changed_sgw_node(mme_sgw_t *current, enb_ue_t *enb_ue);
 
+static void enb_remove_ta(mme_enb_t *enb);
+
 void mme_context_init(void)
 {
     ogs_assert(context_initialized == 0);
@@ -143,6 +145,8 @@ void mme_context_init(void)
     ogs_assert(self.mme_s11_teid_hash);
     self.mme_gn_teid_hash = ogs_hash_make();
     ogs_assert(self.mme_gn_teid_hash);
+    self.ta_hash = ogs_hash_make();
+    ogs_assert(self.ta_hash);
 
     ogs_list_init(&self.mme_ue_list);
 
@@ -177,6 +181,8 @@ void mme_context_final(void)
     ogs_hash_destroy(self.mme_s11_teid_hash);
     ogs_assert(self.mme_gn_teid_hash);
     ogs_hash_destroy(self.mme_gn_teid_hash);
+    ogs_assert(self.ta_hash);
+    ogs_hash_destroy(self.ta_hash);
 
     ogs_pool_final(&m_tmsi_pool);
     ogs_pool_final(&mme_emerg_pool);
@@ -3182,6 +3188,7 @@ mme_enb_t *mme_enb_add(ogs_sock_t *sock, ogs_sockaddr_t *addr)
     enb->ostream_id = 0;
 
     ogs_list_init(&enb->enb_ue_list);
+    ogs_list_init(&enb->ta_enb_list);
 
     ogs_hash_set(self.enb_addr_hash,
             enb->sctp.addr, sizeof(ogs_sockaddr_t), enb);
@@ -3217,6 +3224,8 @@ int mme_enb_remove(mme_enb_t *enb)
     if (enb->enb_id_presence == true)
         ogs_hash_set(self.enb_id_hash, &enb->enb_id, sizeof(enb->enb_id), NULL);
 
+    enb_remove_ta(enb);
+
     /*
      * CHECK:
      *
@@ -3293,6 +3302,95 @@ mme_enb_t *mme_enb_find_by_id(ogs_pool_id_t id)
     return ogs_pool_find_by_id(&mme_enb_pool, id);
 }
 
+static void ta_remove(mme_ta_t *ta)
+{
+    int i;
+
+    ogs_assert(ta);
+    ogs_assert(ogs_list_empty(&ta->enb_list));
+
+    ogs_hash_set(self.ta_hash, &ta->tai, sizeof(ta->tai), NULL);
+
+    for (i = 0; i < MME_NUM_OF_CN_DOMAIN; i++)
+        if (ta->paging[i].built)
+            ogs_asn_template_final(&ta->paging[i].tmpl);
+
+    ogs_free(ta);
+}
+
+static void enb_remove_ta(mme_enb_t *enb)
+{
+    mme_ta_enb_t *ta_enb = NULL, *next_ta_enb = NULL;
+    mme_ta_t *ta = NULL;
+
+    ogs_assert(enb);
+
+    ogs_list_for_each_entry_safe(
+            &enb->ta_enb_list, next_ta_enb, ta_enb, enb_lnode) {
+        ta = ta_enb->ta;
+        ogs_assert(ta);
+
+        ogs_list_remove(&enb->ta_enb_list, &ta_enb->enb_lnode);
+        ogs_list_remove(&ta->enb_list, ta_enb);
+        ogs_free(ta_enb);
+
+        if (ogs_list_empty(&ta->enb_list))
+            ta_remove(ta);
+    }
+}
+
+/*
+ * Rebuilds the TAI index of the eNB from its Supported TAs.
+ * Must be called whenever enb->supported_ta_list is changed.
+ */
+void mme_enb_update_ta(mme_enb_t *enb)
+{
+    mme_ta_enb_t *ta_enb = NULL;
+    mme_ta_t *ta = NULL;
+    int i;
+
+    ogs_assert(enb);
+
+    enb_remove_ta(enb);
+
+    for (i = 0; i < enb->num_of_supported_ta_list; i++) {
+        ta = mme_ta_find(&enb->supported_ta_list[i]);
+        if (!ta) {
+            ta = ogs_calloc(1, sizeof(*ta));
+            ogs_assert(ta);
+            memcpy(&ta->tai, &enb->supported_ta_list[i], sizeof(ta->tai));
+            ogs_list_init(&ta->enb_list);
+            ogs_hash_set(self.ta_hash, &ta->tai, sizeof(ta->tai), ta);
+        } else {
+            /* Skip the TAI listed twice by the eNB */
+            bool found = false;
+
+            ogs_list_for_each(&ta->enb_list, ta_enb) {
+                if (ta_enb->enb == enb) {
+                    found = true;
+                    break;
+                }
+            }
+            if (found)
+                continue;
+        }
+
+        ta_enb = ogs_calloc(1, sizeof(*ta_enb));
+        ogs_assert(ta_enb);
+        ta_enb->ta = ta;
+        ta_enb->enb = enb;
+
+        ogs_list_add(&ta->enb_list, ta_enb);
+        ogs_list_add(&enb->ta_enb_list, &ta_enb->enb_lnode);
+    }
+}
+
+mme_ta_t *mme_ta_find(const ogs_eps_tai_t *tai)
+{
+    ogs_assert(tai);
+    return (mme_ta_t *)ogs_hash_get(self.ta_hash, tai, sizeof(*tai));
+}
+
 /** enb_ue_context handling function */
 enb_ue_t *enb_ue_add(mme_enb_t *enb, uint32_t enb_ue_s1ap_id)
 {
@@ -3863,6 +3961,9 @@ void mme_ue_remove(mme_ue_t *mme_ue)
 
     ogs_pool_free(&mme_s11_teid_pool, mme_ue->mme_s11_teid_node);
     ogs_pool_free(&mme_gn_teid_pool, mme_ue->gn.mme_gn_teid_node);
+
+    ogs_nas_security_cache_clear(&mme_ue->nas_security_cache);
+
     ogs_pool_id_free(&mme_ue_pool, mme_ue);
 
     ogs_info("[Removed] Number of MME-UEs is now %d",
@@ -163,6 +163,8 @@ typedef struct mme_context_s {
     ogs_hash_t *mme_s11_teid_hash;  /* hash table (MME-S11-TEID : MME_UE) */
     ogs_hash_t *mme_gn_teid_hash;  /* hash table (MME-GN-TEID : MME_UE) */
 
+    ogs_hash_t *ta_hash;        /* hash table (TAI : MME_TA) */
+
     struct {
         struct {
             ogs_time_t value;       /* Timer Value(Seconds) */
@@ -277,8 +279,37 @@ typedef struct mme_enb_s {
 
     ogs_list_t      enb_ue_list;
 
+    ogs_list_t      ta_enb_list;    /* list of mme_ta_enb_t */
+
 } mme_enb_t;
 
+/*
+ * Tracking Area served by one or more eNBs
+ *
+ * eNBs are indexed by the TAIs of their Supported TAs so that a Paging
+ * is sent without scanning every eNB. The Paging of the TA is encoded
+ * once and only the UE identity is patched for every UE.
+ */
+#define MME_NUM_OF_CN_DOMAIN    2   /* S1AP_CNDomain_ps, S1AP_CNDomain_cs */
+
+typedef struct mme_ta_s {
+    ogs_eps_tai_t   tai;
+    ogs_list_t      enb_list;   /* list of mme_ta_enb_t */
+
+    struct {
+        bool        built;      /* Template has been encoded */
+        ogs_asn_template_t tmpl;/* tmpl.pkbuf is NULL if it cannot be used */
+    } paging[MME_NUM_OF_CN_DOMAIN];
+} mme_ta_t;
+
+typedef struct mme_ta_enb_s {
+    ogs_lnode_t     lnode;      /* listed in mme_ta_t->enb_list */
+    ogs_lnode_t     enb_lnode;  /* listed in mme_enb_t->ta_enb_list */
+
+    mme_ta_t        *ta;
+    mme_enb_t       *enb;
+} mme_ta_enb_t;
+
 typedef struct mme_emerg_s {
     ogs_lnode_t     lnode;
     ogs_pool_id_t   id;
@@ -585,6 +616,7 @@ struct mme_ue_s {
     /* Integrity and ciphering keys */
     uint8_t         knas_int[OGS_SHA256_DIGEST_SIZE/2];
     uint8_t         knas_enc[OGS_SHA256_DIGEST_SIZE/2];
+    ogs_nas_security_cache_t nas_security_cache;
     /* Downlink counter */
     uint32_t        dl_count;
     /* Uplink counter (24-bit stored in i32) */
@@ -1105,6 +1137,9 @@ int mme_enb_set_enb_id(mme_enb_t *enb, uint32_t enb_id);
 int mme_enb_sock_type(ogs_sock_t *sock);
 mme_enb_t *mme_enb_find_by_id(ogs_pool_id_t id);
 
+void mme_enb_update_ta(mme_enb_t *enb);
+mme_ta_t *mme_ta_find(const ogs_eps_tai_t *tai);
+
 enb_ue_t *enb_ue_add(mme_enb_t *enb, uint32_t enb_ue_s1ap_id);
 void enb_ue_remove(enb_ue_t *enb_ue);
 void enb_ue_switch_to_enb(enb_ue_t *enb_ue, mme_enb_t *new_enb);
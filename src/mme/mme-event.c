@@ -130,8 +130,12 @@ void mme_sctp_event_push(mme_event_e id,
     if (rv != OGS_OK) {
         ogs_error("ogs_queue_push() failed:%d", (int)rv);
         ogs_free(e->addr);
-        if (e->pkbuf)
+        while (e->pkbuf) {
+            /* S1AP messages may be chained through pkbuf->lnode */
+            ogs_pkbuf_t *next_pkbuf = ogs_list_next(e->pkbuf);
             ogs_pkbuf_free(e->pkbuf);
+            e->pkbuf = next_pkbuf;
+        }
         mme_event_free(e);
     }
 #if HAVE_USRSCTP
@@ -194,28 +194,43 @@ void mme_state_operational(ogs_fsm_t *s, mme_event_t *e)
         ogs_assert(addr->ogs_sa_family == AF_INET ||
                 addr->ogs_sa_family == AF_INET6);
 
-        enb = mme_enb_find_by_addr(addr);
-        ogs_free(addr);
+        /* The messages received in a row are chained through pkbuf->lnode */
+        do {
+            ogs_pkbuf_t *next_pkbuf = ogs_list_next(pkbuf);
 
-        ogs_assert(enb);
-        ogs_assert(OGS_FSM_STATE(&enb->sm));
+            /* The previous message may have removed the eNB */
+            enb = mme_enb_find_by_addr(addr);
+            if (!enb) {
+                ogs_error("eNB has already been removed");
+                ogs_pkbuf_free(pkbuf);
+                pkbuf = next_pkbuf;
+                continue;
+            }
+            ogs_assert(OGS_FSM_STATE(&enb->sm));
 
-        rc = ogs_s1ap_decode(&s1ap_message, pkbuf);
-        if (rc == OGS_OK) {
-            e->enb_id = enb->id;
-            e->s1ap_message = &s1ap_message;
-            ogs_fsm_dispatch(&enb->sm, e);
-        } else {
-            ogs_warn("Cannot decode S1AP message");
-            r = s1ap_send_error_indication(
-                    enb, NULL, NULL, S1AP_Cause_PR_protocol,
-                    S1AP_CauseProtocol_abstract_syntax_error_falsely_constructed_message);
-            ogs_expect(r == OGS_OK);
-            ogs_assert(r != OGS_ERROR);
-        }
+            e->pkbuf = pkbuf;
 
-        ogs_s1ap_free(&s1ap_message);
-        ogs_pkbuf_free(pkbuf);
+            rc = ogs_s1ap_decode(&s1ap_message, pkbuf);
+            if (rc == OGS_OK) {
+                e->enb_id = enb->id;
+                e->s1ap_message = &s1ap_message;
+                ogs_fsm_dispatch(&enb->sm, e);
+            } else {
+                ogs_warn("Cannot decode S1AP message");
+                r = s1ap_send_error_indication(
+                        enb, NULL, NULL, S1AP_Cause_PR_protocol,
+                        S1AP_CauseProtocol_abstract_syntax_error_falsely_constructed_message);
+                ogs_expect(r == OGS_OK);
+                ogs_assert(r != OGS_ERROR);
+            }
+
+            ogs_s1ap_free(&s1ap_message);
+            ogs_pkbuf_free(pkbuf);
+
+            pkbuf = next_pkbuf;
+        } while (pkbuf);
+
+        ogs_free(addr);
         break;
 
     case MME_EVENT_S1AP_TIMER:
@@ -74,6 +74,10 @@ ogs_pkbuf_t *nas_eps_security_encode(
     h.protocol_discriminator = message->h.protocol_discriminator;
     h.sequence_number = (mme_ue->dl_count & 0xff);
 
+    /*
+     * The message is ciphered and protected in place. The security header
+     * is pushed into the headroom reserved by the encoder.
+     */
     new = ogs_nas_eps_plain_encode(message);
     if (!new) {
         ogs_error("ogs_nas_eps_plain_encode() failed");
@@ -82,7 +86,8 @@ ogs_pkbuf_t *nas_eps_security_encode(
 
     if (ciphered) {
         /* encrypt NAS message */
-        ogs_nas_encrypt(mme_ue->selected_enc_algorithm,
+        ogs_nas_encrypt_with_cache(&mme_ue->nas_security_cache,
+            mme_ue->selected_enc_algorithm,
             mme_ue->knas_enc, mme_ue->dl_count, NAS_SECURITY_BEARER,
             OGS_NAS_SECURITY_DOWNLINK_DIRECTION, new);
     }
@@ -95,7 +100,8 @@ ogs_pkbuf_t *nas_eps_security_encode(
         uint8_t mac[NAS_SECURITY_MAC_SIZE];
 
         /* calculate NAS MAC(message authentication code) */
-        ogs_nas_mac_calculate(mme_ue->selected_int_algorithm,
+        ogs_nas_mac_calculate_with_cache(&mme_ue->nas_security_cache,
+            mme_ue->selected_int_algorithm,
             mme_ue->knas_int, mme_ue->dl_count, NAS_SECURITY_BEARER, 
             OGS_NAS_SECURITY_DOWNLINK_DIRECTION, new, mac);
         memcpy(&h.message_authentication_code, mac, sizeof(mac));
@@ -124,7 +130,6 @@ int nas_eps_security_decode(mme_ue_t *mme_ue,
 #define SHORT_MAC_SIZE 2
         ogs_nas_ksi_and_sequence_number_t *ksi_and_sequence_number =
             (ogs_nas_ksi_and_sequence_number_t *)(pkbuf->data + 1);
-        uint8_t original_mac[SHORT_MAC_SIZE];
         uint8_t estimated_sequence_number;
         uint8_t sequence_number_high_3bit;
         uint8_t mac[NAS_SECURITY_MAC_SIZE];
@@ -148,14 +153,14 @@ int nas_eps_security_decode(mme_ue_t *mme_ue,
             mme_ue->ul_count.overflow++;
         mme_ue->ul_count.sqn = estimated_sequence_number;
 
-        memcpy(original_mac, pkbuf->data + 2, SHORT_MAC_SIZE);
-
+        /* The short MAC is not part of the MAC input */
         ogs_pkbuf_trim(pkbuf, 2);
-        ogs_nas_mac_calculate(mme_ue->selected_int_algorithm,
+        ogs_nas_mac_calculate_with_cache(&mme_ue->nas_security_cache,
+            mme_ue->selected_int_algorithm,
             mme_ue->knas_int, mme_ue->ul_count.i32, NAS_SECURITY_BEARER,
             OGS_NAS_SECURITY_UPLINK_DIRECTION, pkbuf, mac);
 
-        ogs_pkbuf_put_data(pkbuf, original_mac, SHORT_MAC_SIZE);
+        ogs_assert(ogs_pkbuf_put(pkbuf, SHORT_MAC_SIZE));
         if (memcmp(mac + 2, pkbuf->data + 2, 2) != 0) {
             ogs_warn("NAS MAC verification failed(%x%x != %x%x)",
                     mac[2], mac[3],
@@ -202,13 +207,12 @@ int nas_eps_security_decode(mme_ue_t *mme_ue,
         if (security_header_type.integrity_protected) {
             uint8_t mac[NAS_SECURITY_MAC_SIZE];
             uint32_t mac32;
-            uint32_t original_mac = h->message_authentication_code;
 
             /* calculate NAS MAC(message authentication code) */
-            ogs_nas_mac_calculate(mme_ue->selected_int_algorithm,
+            ogs_nas_mac_calculate_with_cache(&mme_ue->nas_security_cache,
+                mme_ue->selected_int_algorithm,
                 mme_ue->knas_int, mme_ue->ul_count.i32, NAS_SECURITY_BEARER, 
                 OGS_NAS_SECURITY_UPLINK_DIRECTION, pkbuf, mac);
-            h->message_authentication_code = original_mac;
 
             memcpy(&mac32, mac, NAS_SECURITY_MAC_SIZE);
             if (h->message_authentication_code != mac32) {
@@ -227,7 +231,8 @@ int nas_eps_security_decode(mme_ue_t *mme_ue,
                 ogs_error("Cannot decrypt Malformed NAS Message");
                 return OGS_ERROR;
             }
-            ogs_nas_encrypt(mme_ue->selected_enc_algorithm,
+            ogs_nas_encrypt_with_cache(&mme_ue->nas_security_cache,
+                mme_ue->selected_enc_algorithm,
                 mme_ue->knas_enc, mme_ue->ul_count.i32, NAS_SECURITY_BEARER,
                 OGS_NAS_SECURITY_UPLINK_DIRECTION, pkbuf);
         }
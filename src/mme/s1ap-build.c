@@ -274,6 +274,7 @@ ogs_pkbuf_t *s1ap_build_downlink_nas_transport(
     enb_ue_t *enb_ue, ogs_pkbuf_t *emmbuf)
 {
     S1AP_S1AP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     S1AP_InitiatingMessage_t *initiatingMessage = NULL;
     S1AP_DownlinkNASTransport_t *DownlinkNASTransport = NULL;
 
@@ -288,6 +289,7 @@ ogs_pkbuf_t *s1ap_build_downlink_nas_transport(
     ogs_debug("DownlinkNASTransport");
 
     memset(&pdu, 0, sizeof (S1AP_S1AP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(S1AP_InitiatingMessage_t));
 
@@ -334,12 +336,9 @@ ogs_pkbuf_t *s1ap_build_downlink_nas_transport(
     *MME_UE_S1AP_ID = enb_ue->mme_ue_s1ap_id;
     *ENB_UE_S1AP_ID = enb_ue->enb_ue_s1ap_id;
 
-    NAS_PDU->size = emmbuf->len;
-    NAS_PDU->buf = CALLOC(NAS_PDU->size, sizeof(uint8_t));
-    memcpy(NAS_PDU->buf, emmbuf->data, NAS_PDU->size);
-    ogs_pkbuf_free(emmbuf);
+    ogs_asn_pkbuf_to_OCTET_STRING(&adopted, emmbuf, NAS_PDU);
 
-    return ogs_s1ap_encode(&pdu);
+    return ogs_s1ap_encode_adopted(&pdu, &adopted);
 }
 
 static void fill_e_rab_to_be_setup(
@@ -423,6 +422,7 @@ ogs_pkbuf_t *s1ap_build_initial_context_setup_request(
             mme_ue_t *mme_ue, ogs_pkbuf_t *emmbuf)
 {
     S1AP_S1AP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     S1AP_InitiatingMessage_t *initiatingMessage = NULL;
     S1AP_InitialContextSetupRequest_t *InitialContextSetupRequest = NULL;
 
@@ -447,6 +447,7 @@ ogs_pkbuf_t *s1ap_build_initial_context_setup_request(
     ogs_debug("InitialContextSetupRequest");
 
     memset(&pdu, 0, sizeof (S1AP_S1AP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(S1AP_InitiatingMessage_t));
 
@@ -551,11 +552,8 @@ ogs_pkbuf_t *s1ap_build_initial_context_setup_request(
                 ogs_debug("    NASPdu[%p:%d]", emmbuf, emmbuf->len);
 
                 nasPdu = (S1AP_NAS_PDU_t *)CALLOC(1, sizeof(S1AP_NAS_PDU_t));
-                nasPdu->size = emmbuf->len;
-                nasPdu->buf = CALLOC(nasPdu->size, sizeof(uint8_t));
-                memcpy(nasPdu->buf, emmbuf->data, nasPdu->size);
+                ogs_asn_pkbuf_to_OCTET_STRING(&adopted, emmbuf, nasPdu);
                 e_rab->nAS_PDU = nasPdu;
-                ogs_pkbuf_free(emmbuf);
 
                 ogs_log_hexdump(OGS_LOG_DEBUG, nasPdu->buf, nasPdu->size);
 
@@ -610,11 +608,8 @@ ogs_pkbuf_t *s1ap_build_initial_context_setup_request(
                     ogs_debug("    NASPdu[%p:%d]", emmbuf, emmbuf->len);
 
                     nasPdu = (S1AP_NAS_PDU_t *)CALLOC(1, sizeof(S1AP_NAS_PDU_t));
-                    nasPdu->size = emmbuf->len;
-                    nasPdu->buf = CALLOC(nasPdu->size, sizeof(uint8_t));
-                    memcpy(nasPdu->buf, emmbuf->data, nasPdu->size);
+                    ogs_asn_pkbuf_to_OCTET_STRING(&adopted, emmbuf, nasPdu);
                     e_rab->nAS_PDU = nasPdu;
-                    ogs_pkbuf_free(emmbuf);
 
                     ogs_log_hexdump(OGS_LOG_DEBUG, nasPdu->buf, nasPdu->size);
 
@@ -651,9 +646,10 @@ ogs_pkbuf_t *s1ap_build_initial_context_setup_request(
                         bearer->ebi, bearer->qos.index, bearer->sgw_s1u_teid);
             }
         }
-        ogs_error("Before ogs_s1ap_free()");
-        ogs_s1ap_free(&pdu);
-        ogs_error("After ogs_s1ap_free()");
+        ogs_error("Before ogs_asn_free()");
+        ogs_asn_adopted_release(&adopted);
+        ogs_asn_free(&asn_DEF_S1AP_S1AP_PDU, &pdu);
+        ogs_error("After ogs_asn_free()");
         return NULL;
     }
 
@@ -844,7 +840,7 @@ ogs_pkbuf_t *s1ap_build_initial_context_setup_request(
             NRUESecurityCapabilities->nRintegrityProtectionAlgorithms.size);
     }
 
-    return ogs_s1ap_encode(&pdu);
+    return ogs_s1ap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *s1ap_build_ue_context_modification_request(mme_ue_t *mme_ue)
@@ -1065,6 +1061,7 @@ ogs_pkbuf_t *s1ap_build_e_rab_setup_request(
     int rv;
 
     S1AP_S1AP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     S1AP_InitiatingMessage_t *initiatingMessage = NULL;
     S1AP_E_RABSetupRequest_t *E_RABSetupRequest = NULL;
 
@@ -1092,6 +1089,7 @@ ogs_pkbuf_t *s1ap_build_e_rab_setup_request(
     ogs_debug("E-RABSetupRequest");
 
     memset(&pdu, 0, sizeof (S1AP_S1AP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(S1AP_InitiatingMessage_t));
 
@@ -1200,18 +1198,16 @@ ogs_pkbuf_t *s1ap_build_e_rab_setup_request(
     ogs_debug("    SGW-S1U-TEID[%d]", bearer->sgw_s1u_teid);
 
     nasPdu = &e_rab->nAS_PDU;
-    nasPdu->size = esmbuf->len;
-    nasPdu->buf = CALLOC(nasPdu->size, sizeof(uint8_t));
-    memcpy(nasPdu->buf, esmbuf->data, nasPdu->size);
-    ogs_pkbuf_free(esmbuf);
+    ogs_asn_pkbuf_to_OCTET_STRING(&adopted, esmbuf, nasPdu);
 
-    return ogs_s1ap_encode(&pdu);
+    return ogs_s1ap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *s1ap_build_e_rab_modify_request(
             mme_bearer_t *bearer, ogs_pkbuf_t *esmbuf)
 {
     S1AP_S1AP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     S1AP_InitiatingMessage_t *initiatingMessage = NULL;
     S1AP_E_RABModifyRequest_t *E_RABModifyRequest = NULL;
 
@@ -1240,6 +1236,7 @@ ogs_pkbuf_t *s1ap_build_e_rab_modify_request(
     ogs_debug("E-RABModifyRequest");
 
     memset(&pdu, 0, sizeof (S1AP_S1AP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(S1AP_InitiatingMessage_t));
 
@@ -1332,12 +1329,9 @@ ogs_pkbuf_t *s1ap_build_e_rab_modify_request(
     }
 
     nasPdu = &e_rab->nAS_PDU;
-    nasPdu->size = esmbuf->len;
-    nasPdu->buf = CALLOC(nasPdu->size, sizeof(uint8_t));
-    memcpy(nasPdu->buf, esmbuf->data, nasPdu->size);
-    ogs_pkbuf_free(esmbuf);
+    ogs_asn_pkbuf_to_OCTET_STRING(&adopted, esmbuf, nasPdu);
 
-    return ogs_s1ap_encode(&pdu);
+    return ogs_s1ap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *s1ap_build_e_rab_release_command(
@@ -1345,6 +1339,7 @@ ogs_pkbuf_t *s1ap_build_e_rab_release_command(
         S1AP_Cause_PR group, long cause)
 {
     S1AP_S1AP_PDU_t pdu;
+    ogs_asn_adopted_t adopted;
     S1AP_InitiatingMessage_t *initiatingMessage = NULL;
     S1AP_E_RABReleaseCommand_t *E_RABReleaseCommand = NULL;
 
@@ -1372,6 +1367,7 @@ ogs_pkbuf_t *s1ap_build_e_rab_release_command(
     ogs_debug("E-RABReleaseCommand");
 
     memset(&pdu, 0, sizeof (S1AP_S1AP_PDU_t));
+    memset(&adopted, 0, sizeof(adopted));
     pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
     pdu.choice.initiatingMessage = CALLOC(1, sizeof(S1AP_InitiatingMessage_t));
 
@@ -1462,12 +1458,9 @@ ogs_pkbuf_t *s1ap_build_e_rab_release_command(
     ogs_debug("    EBI[%d] Gruop[%d] Cause[%d]",
             bearer->ebi, group, (int)cause);
 
-    nasPdu->size = esmbuf->len;
-    nasPdu->buf = CALLOC(nasPdu->size, sizeof(uint8_t));
-    memcpy(nasPdu->buf, esmbuf->data, nasPdu->size);
-    ogs_pkbuf_free(esmbuf);
+    ogs_asn_pkbuf_to_OCTET_STRING(&adopted, esmbuf, nasPdu);
 
-    return ogs_s1ap_encode(&pdu);
+    return ogs_s1ap_encode_adopted(&pdu, &adopted);
 }
 
 ogs_pkbuf_t *s1ap_build_e_rab_modification_confirm(mme_ue_t *mme_ue)
@@ -1565,8 +1558,8 @@ ogs_pkbuf_t *s1ap_build_e_rab_modification_confirm(mme_ue_t *mme_ue)
     return ogs_s1ap_encode(&pdu);
 }
 
-ogs_pkbuf_t *s1ap_build_paging(
-        mme_ue_t *mme_ue, S1AP_CNDomain_t cn_domain)
+static ogs_pkbuf_t *build_paging(ogs_eps_tai_t *tai, S1AP_CNDomain_t cn_domain,
+        uint16_t index_value, uint8_t mme_code, uint32_t m_tmsi)
 {
     S1AP_S1AP_PDU_t pdu;
     S1AP_InitiatingMessage_t *initiatingMessage = NULL;
@@ -1582,13 +1575,7 @@ ogs_pkbuf_t *s1ap_build_paging(
     S1AP_TAIItemIEs_t *item = NULL;
     S1AP_TAIItem_t *tai_item = NULL;
 
-    uint16_t index_value;
-    uint64_t ue_imsi_value = 0;
-    int i = 0;
-
-    ogs_assert(mme_ue);
-
-    ogs_debug("Paging");
+    ogs_assert(tai);
 
     memset(&pdu, 0, sizeof (S1AP_S1AP_PDU_t));
     pdu.present = S1AP_S1AP_PDU_PR_initiatingMessage;
@@ -1637,36 +1624,19 @@ ogs_pkbuf_t *s1ap_build_paging(
 
     TAIList = &ie->value.choice.TAIList;
 
-    /* Set UE Identity Index value : IMSI mod 4096 */
+    /* Set UE Identity Index value : 10bit */
     UEIdentityIndexValue->size = 2;
     UEIdentityIndexValue->buf =
         CALLOC(UEIdentityIndexValue->size, sizeof(uint8_t));
-
-    /* Conver string to value */
-    for (i = 0; i < strlen(mme_ue->imsi_bcd); i++) {
-        ue_imsi_value = ue_imsi_value*10 + (mme_ue->imsi_bcd[i] - '0');
-    }
-
-    /* index(10bit) = ue_imsi_value mod 1024 */
-    index_value = ue_imsi_value % 1024;
     UEIdentityIndexValue->buf[0] = index_value >> 2;
-    UEIdentityIndexValue->buf[1] = (index_value & 0x3f) << 6;
+    UEIdentityIndexValue->buf[1] = (index_value & 0x3) << 6;
     UEIdentityIndexValue->bits_unused = 6;
 
     /* Set Paging Identity */
     UEPagingID->present = S1AP_UEPagingID_PR_s_TMSI;
     UEPagingID->choice.s_TMSI = CALLOC(1, sizeof(S1AP_S_TMSI_t));
-    ogs_asn_uint8_to_OCTET_STRING(mme_ue->current.guti.mme_code,
-            &UEPagingID->choice.s_TMSI->mMEC);
-
-    ogs_asn_uint32_to_OCTET_STRING(mme_ue->current.guti.m_tmsi,
-            &UEPagingID->choice.s_TMSI->m_TMSI);
-
-    ogs_debug("    MME_CODE[%d] M_TMSI[0x%x]",
-            mme_ue->current.guti.mme_code, mme_ue->current.guti.m_tmsi);
-    ogs_debug("    CN_DOMAIN[%s]",
-            cn_domain == S1AP_CNDomain_cs ? "CS" :
-                cn_domain == S1AP_CNDomain_ps ? "PS" : "Unknown");
+    ogs_asn_uint8_to_OCTET_STRING(mme_code, &UEPagingID->choice.s_TMSI->mMEC);
+    ogs_asn_uint32_to_OCTET_STRING(m_tmsi, &UEPagingID->choice.s_TMSI->m_TMSI);
 
     *CNDomain = cn_domain;
 
@@ -1679,13 +1649,87 @@ ogs_pkbuf_t *s1ap_build_paging(
 
     tai_item = &item->value.choice.TAIItem;
 
-    ogs_s1ap_buffer_to_OCTET_STRING(&mme_ue->tai.plmn_id, sizeof(ogs_plmn_id_t),
+    ogs_s1ap_buffer_to_OCTET_STRING(&tai->plmn_id, sizeof(ogs_plmn_id_t),
             &tai_item->tAI.pLMNidentity);
-    ogs_asn_uint16_to_OCTET_STRING(mme_ue->tai.tac, &tai_item->tAI.tAC);
+    ogs_asn_uint16_to_OCTET_STRING(tai->tac, &tai_item->tAI.tAC);
 
     return ogs_s1ap_encode(&pdu);
 }
 
+/*
+ * Paging of the TA with the UE Identity Index value, MME Code and M-TMSI
+ * set to zero. They are patched for every UE.
+ */
+static void build_paging_template(mme_ta_t *ta, S1AP_CNDomain_t cn_domain)
+{
+    ogs_asn_template_t *tmpl = NULL;
+
+    ogs_assert(ta);
+    ogs_assert(cn_domain < MME_NUM_OF_CN_DOMAIN);
+
+    tmpl = &ta->paging[cn_domain].tmpl;
+    ta->paging[cn_domain].built = true;
+
+    if (ogs_asn_template_init(tmpl,
+            build_paging(&ta->tai, cn_domain, 0, 0, 0)) != OGS_OK ||
+        ogs_asn_template_add_field(tmpl,
+            build_paging(&ta->tai, cn_domain, 0x3ff, 0, 0), 10) != OGS_OK ||
+        ogs_asn_template_add_field(tmpl,
+            build_paging(&ta->tai, cn_domain, 0, 0xff, 0), 8) != OGS_OK ||
+        ogs_asn_template_add_field(tmpl,
+            build_paging(&ta->tai, cn_domain, 0, 0, 0xffffffff), 32) != OGS_OK) {
+        ogs_warn("Paging template not available : encode every Paging");
+        ogs_asn_template_final(tmpl);
+    }
+}
+
+ogs_pkbuf_t *s1ap_build_paging(
+        mme_ue_t *mme_ue, S1AP_CNDomain_t cn_domain)
+{
+    mme_ta_t *ta = NULL;
+
+    uint16_t index_value;
+    uint64_t ue_imsi_value = 0;
+    int i = 0;
+
+    ogs_assert(mme_ue);
+
+    ogs_debug("Paging");
+
+    /* Conver string to value */
+    for (i = 0; i < strlen(mme_ue->imsi_bcd); i++) {
+        ue_imsi_value = ue_imsi_value*10 + (mme_ue->imsi_bcd[i] - '0');
+    }
+
+    /* index(10bit) = ue_imsi_value mod 1024 */
+    index_value = ue_imsi_value % 1024;
+
+    ogs_debug("    MME_CODE[%d] M_TMSI[0x%x]",
+            mme_ue->current.guti.mme_code, mme_ue->current.guti.m_tmsi);
+    ogs_debug("    CN_DOMAIN[%s]",
+            cn_domain == S1AP_CNDomain_cs ? "CS" :
+                cn_domain == S1AP_CNDomain_ps ? "PS" : "Unknown");
+
+    ta = mme_ta_find(&mme_ue->tai);
+    if (ta && cn_domain >= 0 && cn_domain < MME_NUM_OF_CN_DOMAIN) {
+        if (ta->paging[cn_domain].built == false)
+            build_paging_template(ta, cn_domain);
+
+        if (ta->paging[cn_domain].tmpl.pkbuf) {
+            uint64_t value[3];
+
+            value[0] = index_value;
+            value[1] = mme_ue->current.guti.mme_code;
+            value[2] = mme_ue->current.guti.m_tmsi;
+
+            return ogs_asn_template_build(&ta->paging[cn_domain].tmpl, value);
+        }
+    }
+
+    return build_paging(&mme_ue->tai, cn_domain, index_value,
+            mme_ue->current.guti.mme_code, mme_ue->current.guti.m_tmsi);
+}
+
 ogs_pkbuf_t *s1ap_build_mme_configuration_transfer(
         S1AP_SONConfigurationTransfer_t *son_configuration_transfer)
 {
@@ -2453,9 +2497,9 @@ ogs_pkbuf_t *s1ap_build_handover_request(
                         bearer->ebi, bearer->qos.index, bearer->sgw_s1u_teid);
             }
         }
-        ogs_error("Before ogs_s1ap_free()");
-        ogs_s1ap_free(&pdu);
-        ogs_error("After ogs_s1ap_free()");
+        ogs_error("Before ogs_asn_free()");
+        ogs_asn_free(&asn_DEF_S1AP_S1AP_PDU, &pdu);
+        ogs_error("After ogs_asn_free()");
         return NULL;
     }
 
@@ -69,8 +69,7 @@ int s1ap_send_to_enb(mme_enb_t *enb, ogs_pkbuf_t *pkbuf, uint16_t stream_no)
     ogs_sctp_stream_no_in_pkbuf(pkbuf) = stream_no;
 
     if (enb->sctp.type == SOCK_STREAM) {
-        ogs_sctp_write_to_buffer(&enb->sctp, pkbuf);
-        return OGS_OK;
+        return ogs_sctp_write_to_buffer(&enb->sctp, pkbuf);
     } else {
         return ogs_sctp_senddata(enb->sctp.sock, pkbuf, enb->sctp.addr);
     }
@@ -493,8 +492,8 @@ int s1ap_send_ue_context_release_command(
 int s1ap_send_paging(mme_ue_t *mme_ue, S1AP_CNDomain_t cn_domain)
 {
     ogs_pkbuf_t *s1apbuf = NULL;
-    mme_enb_t *enb = NULL;
-    int i;
+    mme_ta_t *ta = NULL;
+    mme_ta_enb_t *ta_enb = NULL;
     int rv;
 
     ogs_debug("S1-Paging");
@@ -505,34 +504,33 @@ int s1ap_send_paging(mme_ue_t *mme_ue, S1AP_CNDomain_t cn_domain)
     }
 
     /* Find enB with matched TAI */
-    ogs_list_for_each(&mme_self()->enb_list, enb) {
-        for (i = 0; i < enb->num_of_supported_ta_list; i++) {
-
-            if (memcmp(&enb->supported_ta_list[i], &mme_ue->tai,
-                        sizeof(ogs_eps_tai_t)) == 0) {
-
-                if (mme_ue->t3413.pkbuf) {
-                    s1apbuf = mme_ue->t3413.pkbuf;
-                } else {
-                    s1apbuf = s1ap_build_paging(mme_ue, cn_domain);
-                    if (!s1apbuf) {
-                        ogs_error("s1ap_build_paging() failed");
-                        return OGS_ERROR;
-                    }
-                }
-
-                mme_ue->t3413.pkbuf = ogs_pkbuf_copy(s1apbuf);
-                if (!mme_ue->t3413.pkbuf) {
-                    ogs_error("ogs_pkbuf_copy() failed");
-                    ogs_pkbuf_free(s1apbuf);
+    ta = mme_ta_find(&mme_ue->tai);
+    if (ta) {
+        ogs_list_for_each(&ta->enb_list, ta_enb) {
+            mme_enb_t *enb = ta_enb->enb;
+            ogs_assert(enb);
+
+            if (mme_ue->t3413.pkbuf) {
+                s1apbuf = mme_ue->t3413.pkbuf;
+            } else {
+                s1apbuf = s1ap_build_paging(mme_ue, cn_domain);
+                if (!s1apbuf) {
+                    ogs_error("s1ap_build_paging() failed");
                     return OGS_ERROR;
                 }
+            }
 
-                rv = s1ap_send_to_enb(enb, s1apbuf, S1AP_NON_UE_SIGNALLING);
-                if (rv != OGS_OK) {
-                    ogs_error("s1ap_send_to_enb() failed");
-                    return rv;
-                }
+            mme_ue->t3413.pkbuf = ogs_pkbuf_copy(s1apbuf);
+            if (!mme_ue->t3413.pkbuf) {
+                ogs_error("ogs_pkbuf_copy() failed");
+                ogs_pkbuf_free(s1apbuf);
+                return OGS_ERROR;
+            }
+
+            rv = s1ap_send_to_enb(enb, s1apbuf, S1AP_NON_UE_SIGNALLING);
+            if (rv != OGS_OK) {
+                ogs_error("s1ap_send_to_enb() failed");
+                return rv;
             }
         }
     }
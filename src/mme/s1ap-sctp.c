@@ -31,6 +31,11 @@ static void lksctp_accept_handler(short when, ogs_socket_t fd, void *data);
 void s1ap_accept_handler(ogs_sock_t *sock);
 void s1ap_recv_handler(ogs_sock_t *sock);
 
+static void handle_notification(ogs_sock_t *sock,
+        ogs_pkbuf_t *pkbuf, ogs_sockaddr_t *from, int flags);
+static void push_message_list(ogs_sock_t *sock,
+        ogs_list_t *message_list, ogs_sockaddr_t *from);
+
 ogs_sock_t *s1ap_server(ogs_socknode_t *node)
 {
     char buf[OGS_ADDRSTRLEN];
@@ -120,134 +125,168 @@ void s1ap_accept_handler(ogs_sock_t *sock)
     }
 }
 
+/*
+ * Reads every message pending on the association, up to
+ * OGS_SCTP_MAX_RECV_PER_EVENT, in a pkbuf of its own size.
+ *
+ * Consecutive messages from the same peer are queued as one
+ * MME_EVENT_S1AP_MESSAGE event, chained through pkbuf->lnode.
+ * Notifications are handled in order with the messages.
+ */
 void s1ap_recv_handler(ogs_sock_t *sock)
 {
-    ogs_pkbuf_t *pkbuf;
-    int size;
-    ogs_sockaddr_t *addr = NULL;
-    ogs_sockaddr_t from;
+    ogs_pkbuf_t *pkbuf = NULL;
+    ogs_list_t message_list;
+    ogs_sockaddr_t from, message_from;
     ogs_sctp_info_t sinfo;
-    int flags = 0;
+    int i, size, flags = 0;
 
     ogs_assert(sock);
 
-    pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
-    ogs_assert(pkbuf);
-    ogs_pkbuf_put(pkbuf, OGS_MAX_SDU_LEN);
-    size = ogs_sctp_recvmsg(
-            sock, pkbuf->data, pkbuf->len, &from, &sinfo, &flags);
-    if (size < 0 || size >= OGS_MAX_SDU_LEN) {
-        ogs_error("ogs_sctp_recvmsg(%d) failed(%d:%s)",
-                size, errno, strerror(errno));
-        ogs_pkbuf_free(pkbuf);
-        return;
-    }
+    ogs_list_init(&message_list);
+    memset(&message_from, 0, sizeof(message_from));
 
-    if (flags & MSG_NOTIFICATION) {
-        union sctp_notification *not =
-            (union sctp_notification *)pkbuf->data;
-
-        switch(not->sn_header.sn_type) {
-        case SCTP_ASSOC_CHANGE :
-            ogs_debug("SCTP_ASSOC_CHANGE:"
-                    "[T:%d, F:0x%x, S:%d, I/O:%d/%d]", 
-                    not->sn_assoc_change.sac_type,
-                    not->sn_assoc_change.sac_flags,
-                    not->sn_assoc_change.sac_state,
-                    not->sn_assoc_change.sac_inbound_streams,
-                    not->sn_assoc_change.sac_outbound_streams);
-
-            if (not->sn_assoc_change.sac_state == SCTP_COMM_UP) {
-                ogs_debug("SCTP_COMM_UP");
-
-                if ((not->sn_assoc_change.sac_outbound_streams-1) >= 1) {
-                    /* NEXT_ID(MAX >= MIN) */
-                    addr = ogs_calloc(1, sizeof(ogs_sockaddr_t));
-                    ogs_assert(addr);
-                    memcpy(addr, &from, sizeof(ogs_sockaddr_t));
-
-                    s1ap_event_push(MME_EVENT_S1AP_LO_SCTP_COMM_UP,
-                            sock, addr, NULL,
-                            not->sn_assoc_change.sac_inbound_streams,
-                            not->sn_assoc_change.sac_outbound_streams);
-                } else
-                    ogs_error("Invalid sn_assoc_change.sac_outbound_streams %d",
-                            not->sn_assoc_change.sac_outbound_streams);
-            } else if (not->sn_assoc_change.sac_state == SCTP_SHUTDOWN_COMP ||
-                    not->sn_assoc_change.sac_state == SCTP_COMM_LOST) {
-
-                if (not->sn_assoc_change.sac_state == SCTP_SHUTDOWN_COMP)
-                    ogs_debug("SCTP_SHUTDOWN_COMP");
-                if (not->sn_assoc_change.sac_state == SCTP_COMM_LOST)
-                    ogs_debug("SCTP_COMM_LOST");
+    for (i = 0; i < OGS_SCTP_MAX_RECV_PER_EVENT; i++) {
+        size = ogs_sctp_recvpkbuf(sock, &pkbuf, &from, &sinfo, &flags);
+        if (size < 0)
+            break;
 
-                addr = ogs_calloc(1, sizeof(ogs_sockaddr_t));
-                ogs_assert(addr);
-                memcpy(addr, &from, sizeof(ogs_sockaddr_t));
+        ogs_assert(pkbuf);
+
+        if (flags & MSG_NOTIFICATION) {
+            push_message_list(sock, &message_list, &message_from);
 
-                s1ap_event_push(MME_EVENT_S1AP_LO_CONNREFUSED,
-                        sock, addr, NULL, 0, 0);
+            handle_notification(sock, pkbuf, &from, flags);
+            ogs_pkbuf_free(pkbuf);
+        } else if (flags & MSG_EOR) {
+            if (memcmp(&from, &message_from, sizeof(ogs_sockaddr_t)) != 0) {
+                push_message_list(sock, &message_list, &message_from);
+                memcpy(&message_from, &from, sizeof(ogs_sockaddr_t));
             }
+
+            ogs_list_add(&message_list, pkbuf);
+        } else {
+            ogs_error("ogs_sctp_recvmsg(%d) failed(%d:%s-0x%x)",
+                    size, errno, strerror(errno), flags);
+            ogs_pkbuf_free(pkbuf);
             break;
+        }
+    }
 
-        case SCTP_SHUTDOWN_EVENT :
-            ogs_debug("SCTP_SHUTDOWN_EVENT:[T:%d, F:0x%x, L:%d]",
-                    not->sn_shutdown_event.sse_type,
-                    not->sn_shutdown_event.sse_flags,
-                    not->sn_shutdown_event.sse_length);
+    push_message_list(sock, &message_list, &message_from);
+}
+
+static void handle_notification(ogs_sock_t *sock,
+        ogs_pkbuf_t *pkbuf, ogs_sockaddr_t *from, int flags)
+{
+    union sctp_notification *not =
+        (union sctp_notification *)pkbuf->data;
+    ogs_sockaddr_t *addr = NULL;
+
+    switch(not->sn_header.sn_type) {
+    case SCTP_ASSOC_CHANGE :
+        ogs_debug("SCTP_ASSOC_CHANGE:"
+                "[T:%d, F:0x%x, S:%d, I/O:%d/%d]", 
+                not->sn_assoc_change.sac_type,
+                not->sn_assoc_change.sac_flags,
+                not->sn_assoc_change.sac_state,
+                not->sn_assoc_change.sac_inbound_streams,
+                not->sn_assoc_change.sac_outbound_streams);
+
+        if (not->sn_assoc_change.sac_state == SCTP_COMM_UP) {
+            ogs_debug("SCTP_COMM_UP");
+
+            if ((not->sn_assoc_change.sac_outbound_streams-1) >= 1) {
+                /* NEXT_ID(MAX >= MIN) */
+                addr = ogs_calloc(1, sizeof(ogs_sockaddr_t));
+                ogs_assert(addr);
+                memcpy(addr, from, sizeof(ogs_sockaddr_t));
+
+                s1ap_event_push(MME_EVENT_S1AP_LO_SCTP_COMM_UP,
+                        sock, addr, NULL,
+                        not->sn_assoc_change.sac_inbound_streams,
+                        not->sn_assoc_change.sac_outbound_streams);
+            } else
+                ogs_error("Invalid sn_assoc_change.sac_outbound_streams %d",
+                        not->sn_assoc_change.sac_outbound_streams);
+        } else if (not->sn_assoc_change.sac_state == SCTP_SHUTDOWN_COMP ||
+                not->sn_assoc_change.sac_state == SCTP_COMM_LOST) {
+
+            if (not->sn_assoc_change.sac_state == SCTP_SHUTDOWN_COMP)
+                ogs_debug("SCTP_SHUTDOWN_COMP");
+            if (not->sn_assoc_change.sac_state == SCTP_COMM_LOST)
+                ogs_debug("SCTP_COMM_LOST");
 
             addr = ogs_calloc(1, sizeof(ogs_sockaddr_t));
             ogs_assert(addr);
-            memcpy(addr, &from, sizeof(ogs_sockaddr_t));
+            memcpy(addr, from, sizeof(ogs_sockaddr_t));
 
             s1ap_event_push(MME_EVENT_S1AP_LO_CONNREFUSED,
                     sock, addr, NULL, 0, 0);
-            break;
+        }
+        break;
+
+    case SCTP_SHUTDOWN_EVENT :
+        ogs_debug("SCTP_SHUTDOWN_EVENT:[T:%d, F:0x%x, L:%d]",
+                not->sn_shutdown_event.sse_type,
+                not->sn_shutdown_event.sse_flags,
+                not->sn_shutdown_event.sse_length);
+
+        addr = ogs_calloc(1, sizeof(ogs_sockaddr_t));
+        ogs_assert(addr);
+        memcpy(addr, from, sizeof(ogs_sockaddr_t));
+
+        s1ap_event_push(MME_EVENT_S1AP_LO_CONNREFUSED,
+                sock, addr, NULL, 0, 0);
+        break;
 
-        case SCTP_SEND_FAILED :
+    case SCTP_SEND_FAILED :
 #if HAVE_USRSCTP
-            ogs_error("SCTP_SEND_FAILED:[T:%d, F:0x%x, S:%d]",
-                    not->sn_send_failed_event.ssfe_type,
-                    not->sn_send_failed_event.ssfe_flags,
-                    not->sn_send_failed_event.ssfe_error);
+        ogs_error("SCTP_SEND_FAILED:[T:%d, F:0x%x, S:%d]",
+                not->sn_send_failed_event.ssfe_type,
+                not->sn_send_failed_event.ssfe_flags,
+                not->sn_send_failed_event.ssfe_error);
 #else
-            ogs_error("SCTP_SEND_FAILED:[T:%d, F:0x%x, S:%d]",
-                    not->sn_send_failed.ssf_type,
-                    not->sn_send_failed.ssf_flags,
-                    not->sn_send_failed.ssf_error);
+        ogs_error("SCTP_SEND_FAILED:[T:%d, F:0x%x, S:%d]",
+                not->sn_send_failed.ssf_type,
+                not->sn_send_failed.ssf_flags,
+                not->sn_send_failed.ssf_error);
 #endif
-            break;
-
-        case SCTP_PEER_ADDR_CHANGE:
-            ogs_warn("SCTP_PEER_ADDR_CHANGE:[T:%d, F:0x%x, S:%d]", 
-                    not->sn_paddr_change.spc_type,
-                    not->sn_paddr_change.spc_flags,
-                    not->sn_paddr_change.spc_error);
-            break;
-        case SCTP_REMOTE_ERROR:
-            ogs_warn("SCTP_REMOTE_ERROR:[T:%d, F:0x%x, S:%d]", 
-                    not->sn_remote_error.sre_type,
-                    not->sn_remote_error.sre_flags,
-                    not->sn_remote_error.sre_error);
-            break;
-        default :
-            ogs_error("Discarding event with unknown flags:0x%x type:0x%x",
-                    flags, not->sn_header.sn_type);
-            break;
-        }
-    } else if (flags & MSG_EOR) {
-        ogs_pkbuf_trim(pkbuf, size);
+        break;
+
+    case SCTP_PEER_ADDR_CHANGE:
+        ogs_warn("SCTP_PEER_ADDR_CHANGE:[T:%d, F:0x%x, S:%d]", 
+                not->sn_paddr_change.spc_type,
+                not->sn_paddr_change.spc_flags,
+                not->sn_paddr_change.spc_error);
+        break;
+    case SCTP_REMOTE_ERROR:
+        ogs_warn("SCTP_REMOTE_ERROR:[T:%d, F:0x%x, S:%d]", 
+                not->sn_remote_error.sre_type,
+                not->sn_remote_error.sre_flags,
+                not->sn_remote_error.sre_error);
+        break;
+    default :
+        ogs_error("Discarding event with unknown flags:0x%x type:0x%x",
+                flags, not->sn_header.sn_type);
+        break;
+    }
+}
 
-        addr = ogs_calloc(1, sizeof(ogs_sockaddr_t));
-        ogs_assert(addr);
-        memcpy(addr, &from, sizeof(ogs_sockaddr_t));
+static void push_message_list(ogs_sock_t *sock,
+        ogs_list_t *message_list, ogs_sockaddr_t *from)
+{
+    ogs_sockaddr_t *addr = NULL;
 
-        s1ap_event_push(MME_EVENT_S1AP_MESSAGE, sock, addr, pkbuf, 0, 0);
+    if (ogs_list_empty(message_list) == true)
         return;
-    } else {
-        ogs_error("ogs_sctp_recvmsg(%d) failed(%d:%s-0x%x)",
-                size, errno, strerror(errno), flags);
-    }
 
-    ogs_pkbuf_free(pkbuf);
+    addr = ogs_calloc(1, sizeof(ogs_sockaddr_t));
+    ogs_assert(addr);
+    memcpy(addr, from, sizeof(ogs_sockaddr_t));
+
+    s1ap_event_push(MME_EVENT_S1AP_MESSAGE,
+            sock, addr, ogs_list_first(message_list), 0, 0);
+
+    ogs_list_init(message_list);
 }
@@ -989,6 +989,8 @@ bool nrf_nnrf_handle_nf_discover(
     ogs_sbi_nf_instance_t *nf_instance = NULL;
     ogs_sbi_discovery_option_t *discovery_option = NULL;
 
+    ogs_sbi_nf_type_node_t *type_node = NULL;
+
     OpenAPI_search_result_t *SearchResult = NULL;
     OpenAPI_nf_profile_t *NFProfile = NULL;
     OpenAPI_lnode_t *node = NULL;
@@ -1087,7 +1089,12 @@ bool nrf_nnrf_handle_nf_discover(
     ogs_assert(SearchResult->nf_instances);
 
     i = 0;
-    ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
+    /* Only NF Instances of the target NF type are candidates */
+    ogs_list_for_each(ogs_sbi_nf_instance_type_list(
+                recvmsg->param.target_nf_type), type_node) {
+        nf_instance = type_node->nf_instance;
+        ogs_assert(nf_instance);
+
         if (NF_INSTANCE_EXCLUDED_FROM_DISCOVERY(nf_instance))
             continue;
 
@@ -1169,11 +1176,12 @@ bool nrf_nnrf_handle_nf_discover(
 
         nrf_assoc_t *assoc = NULL;
 
-        ogs_list_for_each(&ogs_sbi_self()->nf_instance_list, nf_instance) {
-            if (NF_INSTANCE_ID_IS_SELF(nf_instance->id))
-                continue;
+        ogs_list_for_each(ogs_sbi_nf_instance_type_list(
+                    OpenAPI_nf_type_NRF), type_node) {
+            nf_instance = type_node->nf_instance;
+            ogs_assert(nf_instance);
 
-            if (nf_instance->nf_type != OpenAPI_nf_type_NRF)
+            if (NF_INSTANCE_ID_IS_SELF(nf_instance->id))
                 continue;
 
             if (ogs_sbi_discovery_option_target_plmn_list_is_matched(
@@ -51,6 +51,16 @@ ogs_metrics_spec_t *pcf_metrics_spec_global[_PCF_METR_GLOB_MAX];
 ogs_metrics_inst_t *pcf_metrics_inst_global[_PCF_METR_GLOB_MAX];
 pcf_metrics_spec_def_t pcf_metrics_spec_def_global[_PCF_METR_GLOB_MAX] = {
 /* Global Counters: */
+[PCF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_HIT] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "sbi_discovery_cache_hit",
+    .description = "NF discoveries answered from the discovery cache",
+},
+[PCF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_MISS] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "sbi_discovery_cache_miss",
+    .description = "NF discoveries not found in the discovery cache",
+},
 /* Global Gauges: */
 };
 int pcf_metrics_init_inst_global(void)
@@ -186,6 +196,23 @@ int pcf_metrics_free_inst_by_slice(ogs_metrics_inst_t **inst)
     return pcf_metrics_free_inst(inst, _PCF_METR_BY_SLICE_MAX);
 }
 
+/* Counters of the SBI library, refreshed on each scrape */
+static void pcf_metrics_collect_sbi(void)
+{
+    static uint64_t hit, miss; /* Published so far */
+    ogs_sbi_discovery_cache_stat_t stat;
+
+    ogs_sbi_discovery_cache_stat(&stat);
+
+    pcf_metrics_inst_global_add(
+            PCF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_HIT, stat.hit - hit);
+    pcf_metrics_inst_global_add(
+            PCF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_MISS, stat.miss - miss);
+
+    hit = stat.hit;
+    miss = stat.miss;
+}
+
 void pcf_metrics_init(void)
 {
     ogs_metrics_context_t *ctx = ogs_metrics_self();
@@ -197,6 +224,7 @@ void pcf_metrics_init(void)
             pcf_metrics_spec_def_by_slice, _PCF_METR_BY_SLICE_MAX);
 
     pcf_metrics_init_inst_global();
+    ogs_metrics_register_collector(pcf_metrics_collect_sbi);
     pcf_metrics_init_by_slice();
 }
 
@@ -8,6 +8,8 @@ extern "C" {
 #endif
 
 typedef enum pcf_metric_type_global_s {
+    PCF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_HIT,
+    PCF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_MISS,
     _PCF_METR_GLOB_MAX,
 } pcf_metric_type_global_t;
 extern ogs_metrics_inst_t *pcf_metrics_inst_global[_PCF_METR_GLOB_MAX];
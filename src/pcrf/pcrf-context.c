@@ -48,8 +48,6 @@ void pcrf_context_init(void)
     ogs_log_install_domain(&__ogs_dbi_domain, "dbi", ogs_core()->log.level);
     ogs_log_install_domain(&__pcrf_log_domain, "pcrf", ogs_core()->log.level);
 
-    ogs_thread_mutex_init(&self.db_lock);
-
     ogs_thread_mutex_init(&self.hash_lock);
     self.ip_hash = ogs_hash_make();
     ogs_assert(self.ip_hash);
@@ -64,8 +62,6 @@ void pcrf_context_final(void)
     ogs_hash_destroy(self.ip_hash);
     ogs_thread_mutex_destroy(&self.hash_lock);
 
-    ogs_thread_mutex_destroy(&self.db_lock);
-
     context_initialized = 0;
 }
 
@@ -398,8 +394,6 @@ int pcrf_db_qos_data(
     ogs_assert(apn);
     ogs_assert(session_data);
 
-    ogs_thread_mutex_lock(&self.db_lock);
-
     memset(session_data, 0, sizeof(*session_data));
 
     supi = ogs_msprintf("%s-%s", OGS_ID_SUPI_TYPE_IMSI, imsi_bcd);
@@ -427,7 +421,6 @@ int pcrf_db_qos_data(
     }
 
     ogs_free(supi);
-    ogs_thread_mutex_unlock(&self.db_lock);
 
     return rv;
 }
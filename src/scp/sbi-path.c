@@ -36,9 +36,8 @@ static bool send_request(
         ogs_sbi_request_t *request, bool do_not_remove_custom_header,
         scp_assoc_t *assoc);
 
-static void copy_request(
-        ogs_sbi_request_t *target, ogs_sbi_request_t *source,
-        bool do_not_remove_custom_header);
+static void strip_request_headers(
+        ogs_sbi_request_t *request, bool do_not_remove_custom_header);
 
 int scp_sbi_open(void)
 {
@@ -1014,20 +1013,28 @@ static bool send_request(
         scp_assoc_t *assoc)
 {
     bool rc;
-    ogs_sbi_request_t scp_request;
-    char *uri_apiroot = NULL;
+    char *uri_apiroot = NULL, *uri = NULL, *next_uri = NULL;
 
     ogs_assert(client);
     ogs_assert(request);
+    ogs_assert(request->http.headers);
     ogs_assert(assoc);
 
-    /* Copy Request for sending SCP */
-    copy_request(&scp_request, request, do_not_remove_custom_header);
-    ogs_assert(scp_request.http.headers);
+    /*
+     * The received request is sent again by the client engine, which
+     * encodes it as a new HTTP/2 request. Frames are not relayed.
+     *
+     * Only the headers that must not go to the next hop are removed
+     * and the URI is replaced for the time of sending, so the header
+     * table and the content are not copied before the client does.
+     * The request is kept by the server stream until the response,
+     * so it can be sent again after the discovery.
+     */
+    strip_request_headers(request, do_not_remove_custom_header);
 
     /* Added Custom Header(Target-apiRoot) */
     if (assoc->target_apiroot)
-        ogs_sbi_header_set(scp_request.http.headers,
+        ogs_sbi_header_set(request->http.headers,
                 OGS_SBI_CUSTOM_TARGET_APIROOT, assoc->target_apiroot);
 
     /* Client ApiRoot */
@@ -1035,48 +1042,39 @@ static bool send_request(
     ogs_assert(uri_apiroot);
 
     /* Setup New URI */
-    scp_request.h.uri = ogs_msprintf("%s%s", uri_apiroot, request->h.uri);
-    ogs_assert(scp_request.h.uri);
+    next_uri = ogs_msprintf("%s%s", uri_apiroot, request->h.uri);
+    ogs_assert(next_uri);
+
+    uri = request->h.uri;
+    request->h.uri = next_uri;
 
     /* Send the HTTP Request with New URI and HTTP Headers */
-    rc = ogs_sbi_client_send_request(client, client_cb, &scp_request, assoc);
+    rc = ogs_sbi_client_send_request(client, client_cb, request, assoc);
     ogs_expect(rc == true);
 
-    ogs_sbi_http_hash_free(scp_request.http.headers);
-    ogs_free(scp_request.h.uri);
+    /* The client may have replaced the URI to add the query parameters */
+    ogs_free(request->h.uri);
+    request->h.uri = uri;
+
     ogs_free(uri_apiroot);
 
     return rc;
 }
 
-static void copy_request(
-        ogs_sbi_request_t *target, ogs_sbi_request_t *source,
-        bool do_not_remove_custom_header)
+static void strip_request_headers(
+        ogs_sbi_request_t *request, bool do_not_remove_custom_header)
 {
     ogs_hash_index_t *hi;
 
-    ogs_assert(source);
-    ogs_assert(target);
-
-    memset(target, 0, sizeof(*target));
-
-    /* HTTP method/params/content */
-    target->h.method = source->h.method;
-    target->http.params = source->http.params;
-    target->http.content = source->http.content;
-    target->http.content_length = source->http.content_length;
+    ogs_assert(request);
+    ogs_assert(request->http.headers);
 
-    /* HTTP Headers
-     *
+    /*
      * To remove the followings,
      *   Scheme - https
      *   Authority - scp.open5gs.org
      */
-    target->http.headers = ogs_hash_make();
-    ogs_assert(target->http.headers);
-
-    /* Extract HTTP Header */
-    for (hi = ogs_hash_first(source->http.headers);
+    for (hi = ogs_hash_first(request->http.headers);
             hi; hi = ogs_hash_next(hi)) {
         char *key = (char *)ogs_hash_this_key(hi);
         char *val = ogs_hash_this_val(hi);
@@ -1091,15 +1089,20 @@ static void copy_request(
          *  Each header field consists of a name followed by a colon (":")
          *  and the field value. Field names are case-insensitive.
          */
-        if (do_not_remove_custom_header == false &&
-            !strcasecmp(key, OGS_SBI_CUSTOM_TARGET_APIROOT)) {
+        if (!strcasecmp(key, OGS_SBI_CUSTOM_TARGET_APIROOT)) {
+            if (do_not_remove_custom_header == true)
+                continue;
         } else if (do_not_remove_custom_header == false &&
             !strncasecmp(key, OGS_SBI_CUSTOM_DISCOVERY_COMMON,
                 strlen(OGS_SBI_CUSTOM_DISCOVERY_COMMON))) {
         } else if (!strcasecmp(key, OGS_SBI_SCHEME)) {
         } else if (!strcasecmp(key, OGS_SBI_AUTHORITY)) {
         } else {
-            ogs_sbi_header_set(target->http.headers, key, val);
+            continue;
         }
+
+        ogs_hash_set(request->http.headers, key, strlen(key), NULL);
+        ogs_free(key);
+        ogs_free(val);
     }
 }
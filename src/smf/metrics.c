@@ -100,6 +100,16 @@ smf_metrics_spec_def_t smf_metrics_spec_def_global[_SMF_METR_GLOB_MAX] = {
     .name = "fivegs_smffunction_sm_n4sessionreportsucc",
     .description = "Number of successful N4 session reports evidented by SMF",
 },
+[SMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_HIT] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "sbi_discovery_cache_hit",
+    .description = "NF discoveries answered from the discovery cache",
+},
+[SMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_MISS] = {
+    .type = OGS_METRICS_METRIC_TYPE_COUNTER,
+    .name = "sbi_discovery_cache_miss",
+    .description = "NF discoveries not found in the discovery cache",
+},
 /* Global Gauges: */
 [SMF_METR_GLOB_GAUGE_UES_ACTIVE] = {
     .type = OGS_METRICS_METRIC_TYPE_GAUGE,
@@ -493,6 +503,23 @@ int smf_metrics_free_inst_by_cause(ogs_metrics_inst_t **inst)
     return smf_metrics_free_inst(inst, _SMF_METR_BY_CAUSE_MAX);
 }
 
+/* Counters of the SBI library, refreshed on each scrape */
+static void smf_metrics_collect_sbi(void)
+{
+    static uint64_t hit, miss; /* Published so far */
+    ogs_sbi_discovery_cache_stat_t stat;
+
+    ogs_sbi_discovery_cache_stat(&stat);
+
+    smf_metrics_inst_global_add(
+            SMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_HIT, stat.hit - hit);
+    smf_metrics_inst_global_add(
+            SMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_MISS, stat.miss - miss);
+
+    hit = stat.hit;
+    miss = stat.miss;
+}
+
 void smf_metrics_init(void)
 {
     ogs_metrics_context_t *ctx = ogs_metrics_self();
@@ -512,6 +539,7 @@ void smf_metrics_init(void)
             smf_metrics_spec_def_by_cause, _SMF_METR_BY_CAUSE_MAX);
 
     smf_metrics_init_inst_global();
+    ogs_metrics_register_collector(smf_metrics_collect_sbi);
     smf_metrics_init_by_slice();
     smf_metrics_init_by_5qi();
     smf_metrics_init_by_cause();
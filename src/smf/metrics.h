@@ -19,6 +19,8 @@ typedef enum smf_metric_type_global_s {
     SMF_METR_GLOB_CTR_SM_N4SESSIONESTABREQ,
     SMF_METR_GLOB_CTR_SM_N4SESSIONREPORT,
     SMF_METR_GLOB_CTR_SM_N4SESSIONREPORTSUCC,
+    SMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_HIT,
+    SMF_METR_GLOB_CTR_SBI_DISCOVERY_CACHE_MISS,
     SMF_METR_GLOB_GAUGE_UES_ACTIVE,
     SMF_METR_GLOB_GAUGE_BEARERS_ACTIVE,
     SMF_METR_GLOB_GAUGE_GTP1_PDPCTXS_ACTIVE,
@@ -252,7 +252,7 @@ int ngap_handle_pdu_session_resource_setup_response_transfer(
 
     rv = OGS_OK;
 cleanup:
-    ogs_asn_free(
+    ogs_asn_free_decoded(
             &asn_DEF_NGAP_PDUSessionResourceSetupResponseTransfer, &message);
     return rv;
 }
@@ -382,7 +382,7 @@ int ngap_handle_pdu_session_resource_setup_unsuccessful_transfer(
 
     rv = OGS_OK;
 cleanup:
-    ogs_asn_free(
+    ogs_asn_free_decoded(
         &asn_DEF_NGAP_PDUSessionResourceSetupUnsuccessfulTransfer, &message);
     return rv;
 }
@@ -496,7 +496,7 @@ int ngap_handle_pdu_session_resource_modify_response_transfer(
     rv = OGS_OK;
 
 cleanup:
-    ogs_asn_free(
+    ogs_asn_free_decoded(
             &asn_DEF_NGAP_PDUSessionResourceModifyResponseTransfer, &message);
     return rv;
 }
@@ -687,7 +687,7 @@ int ngap_handle_path_switch_request_transfer(
     rv = OGS_OK;
 
 cleanup:
-    ogs_asn_free(&asn_DEF_NGAP_PathSwitchRequestTransfer, &message);
+    ogs_asn_free_decoded(&asn_DEF_NGAP_PathSwitchRequestTransfer, &message);
     return rv;
 }
 
@@ -738,7 +738,7 @@ int ngap_handle_handover_required_transfer(
     rv = OGS_OK;
 
 cleanup:
-    ogs_asn_free(&asn_DEF_NGAP_HandoverRequiredTransfer, &message);
+    ogs_asn_free_decoded(&asn_DEF_NGAP_HandoverRequiredTransfer, &message);
     return rv;
 }
 
@@ -945,6 +945,7 @@ int ngap_handle_handover_request_ack(
     rv = OGS_OK;
 
 cleanup:
-    ogs_asn_free(&asn_DEF_NGAP_HandoverRequestAcknowledgeTransfer, &message);
+    ogs_asn_free_decoded(
+            &asn_DEF_NGAP_HandoverRequestAcknowledgeTransfer, &message);
     return rv;
 }
@@ -18,6 +18,7 @@
  */
 
 #include "sbi-path.h"
+#include "suci.h"
 
 static udm_context_t self;
 
@@ -87,11 +88,24 @@ udm_context_t *udm_self(void)
 
 static int udm_context_prepare(void)
 {
+    self.suci.cache = ogs_global_conf()->max.ue;
+
     return OGS_OK;
 }
 
 static int udm_context_validation(void)
 {
+    if (self.suci.worker < 0 || self.suci.cache < 0) {
+        ogs_error("Invalid suci.worker[%d] or suci.cache[%d] in '%s'",
+                self.suci.worker, self.suci.cache, ogs_app()->file);
+        return OGS_ERROR;
+    }
+    if (self.suci.worker && !self.suci.cache) {
+        ogs_error("suci.worker requires suci.cache in '%s'",
+                ogs_app()->file);
+        return OGS_ERROR;
+    }
+
     return OGS_OK;
 }
 
@@ -134,6 +148,21 @@ int udm_context_parse_config(void)
                 } else if (!strcmp(udm_key, "hnet")) {
                     rv = ogs_sbi_context_parse_hnet_config(&udm_iter);
                     if (rv != OGS_OK) return rv;
+                } else if (!strcmp(udm_key, "suci")) {
+                    ogs_yaml_iter_t suci_iter;
+                    ogs_yaml_iter_recurse(&udm_iter, &suci_iter);
+                    while (ogs_yaml_iter_next(&suci_iter)) {
+                        const char *suci_key = ogs_yaml_iter_key(&suci_iter);
+                        ogs_assert(suci_key);
+                        if (!strcmp(suci_key, "worker")) {
+                            const char *v = ogs_yaml_iter_value(&suci_iter);
+                            if (v) self.suci.worker = atoi(v);
+                        } else if (!strcmp(suci_key, "cache")) {
+                            const char *v = ogs_yaml_iter_value(&suci_iter);
+                            if (v) self.suci.cache = atoi(v);
+                        } else
+                            ogs_warn("unknown key `%s`", suci_key);
+                    }
                 } else
                     ogs_warn("unknown key `%s`", udm_key);
             }
@@ -178,7 +207,7 @@ udm_ue_t *udm_ue_add(char *suci)
         return NULL;
     }
 
-    udm_ue->supi = ogs_supi_from_supi_or_suci(udm_ue->suci);
+    udm_ue->supi = udm_supi_from_supi_or_suci(udm_ue->suci);
     if (!udm_ue->supi) {
         ogs_error("No memory for udm_ue->supi [%s]", suci);
         ogs_free(udm_ue->suci);
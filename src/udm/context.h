@@ -42,6 +42,11 @@ typedef struct udm_context_s {
     ogs_hash_t      *supi_hash;
     ogs_hash_t      *sdm_subscription_id_hash;
 
+    struct {
+        int worker;     /* de-concealment threads, 0 : in the UDM thread */
+        int cache;      /* SUCI->SUPI cache entries, 0 : disabled */
+    } suci;
+
 } udm_context_t;
 
 struct udm_ue_s {
@@ -29,6 +29,15 @@ extern "C" {
 typedef struct udm_ue_s udm_ue_t;
 typedef struct udm_sess_s udm_sess_t;
 
+typedef enum {
+    UDM_EVENT_BASE = OGS_MAX_NUM_OF_PROTO_EVENT,
+
+    UDM_EVENT_SUCI_DECONCEALED,
+
+    MAX_NUM_OF_UDM_EVENT,
+
+} udm_event_e;
+
 typedef struct udm_event_s {
     ogs_event_t h;
 
@@ -18,6 +18,7 @@
  */
 
 #include "sbi-path.h"
+#include "suci.h"
 
 static ogs_thread_t *thread;
 static void udm_main(void *data);
@@ -47,6 +48,8 @@ int udm_initialize(void)
     rv = udm_sbi_open();
     if (rv != OGS_OK) return rv;
 
+    udm_suci_init();
+
     thread = ogs_thread_create(udm_main, NULL);
     if (!thread) return OGS_ERROR;
 
@@ -88,6 +91,8 @@ void udm_terminate(void)
     ogs_thread_destroy(thread);
     ogs_timer_delete(t_termination_holding);
 
+    udm_suci_final();
+
     udm_sbi_close();
 
     udm_context_final();
@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "suci.h"
+
+/*
+ * SUCI->SUPI cache
+ *
+ * The key is the whole SUCI including the scheme output, so only
+ * a retransmission of the same SUCI hits.
+ *
+ * A failed de-concealment is cached as well (supi == NULL), but only
+ * for UDM_SUCI_NEGATIVE_TTL. That is enough for the requests parked on
+ * a worker job to find the result when they are dispatched again, and
+ * for a burst of retransmissions of a bogus SUCI. A SUCI that failed
+ * because of a transient condition (e.g. a home network key that is
+ * being rotated) is computed again afterwards.
+ *
+ * Only the UDM thread touches the cache.
+ */
+#define UDM_SUCI_NEGATIVE_TTL ogs_time_from_sec(1)
+
+typedef struct udm_suci_cache_s {
+    ogs_lnode_t lnode;
+
+    char *suci;
+    char *supi;
+    ogs_time_t expires; /* monotonic, failures only */
+} udm_suci_cache_t;
+
+static OGS_POOL(suci_cache_pool, udm_suci_cache_t);
+static ogs_list_t suci_cache_list; /* Least recently used first */
+static ogs_hash_t *suci_cache_hash;
+
+/*
+ * De-concealment workers
+ *
+ * A job is owned by the UDM thread except for 'supi' which is written by
+ * the worker before UDM_EVENT_SUCI_DECONCEALED is queued. Requests for
+ * the same SUCI that arrive while the job is running wait on the job.
+ */
+typedef struct udm_suci_waiter_s {
+    ogs_lnode_t lnode;
+
+    ogs_pool_id_t stream_id;
+    ogs_sbi_request_t *request;
+} udm_suci_waiter_t;
+
+struct udm_suci_job_s {
+    char *suci;
+    char *supi;
+
+    ogs_list_t waiter_list;
+};
+
+static ogs_queue_t *job_queue;
+static ogs_hash_t *pending_hash;
+static ogs_thread_t **worker;
+static int num_of_worker;
+
+static void suci_worker(void *data);
+static void job_free(udm_suci_job_t *job);
+
+void udm_suci_init(void)
+{
+    int i;
+
+    if (udm_self()->suci.cache) {
+        ogs_pool_init(&suci_cache_pool, udm_self()->suci.cache);
+        ogs_list_init(&suci_cache_list);
+        suci_cache_hash = ogs_hash_make();
+        ogs_assert(suci_cache_hash);
+    }
+
+    num_of_worker = udm_self()->suci.worker;
+    if (!num_of_worker)
+        return;
+
+    ogs_assert(udm_self()->suci.cache);
+
+    job_queue = ogs_queue_create(ogs_global_conf()->max.ue);
+    ogs_assert(job_queue);
+    pending_hash = ogs_hash_make();
+    ogs_assert(pending_hash);
+
+    worker = ogs_calloc(num_of_worker, sizeof(ogs_thread_t *));
+    ogs_assert(worker);
+    for (i = 0; i < num_of_worker; i++) {
+        worker[i] = ogs_thread_create(suci_worker, NULL);
+        ogs_assert(worker[i]);
+    }
+
+    ogs_info("SUCI de-concealment : %d worker(s), %d cache entries",
+            num_of_worker, udm_self()->suci.cache);
+}
+
+static void cache_remove(udm_suci_cache_t *entry)
+{
+    ogs_assert(entry);
+
+    ogs_list_remove(&suci_cache_list, entry);
+    ogs_hash_set(suci_cache_hash, entry->suci, strlen(entry->suci), NULL);
+    ogs_free(entry->suci);
+    if (entry->supi)
+        ogs_free(entry->supi);
+    ogs_pool_free(&suci_cache_pool, entry);
+}
+
+void udm_suci_final(void)
+{
+    udm_suci_cache_t *entry = NULL, *next_entry = NULL;
+    ogs_hash_index_t *hi = NULL;
+    int i;
+
+    if (num_of_worker) {
+        ogs_queue_term(job_queue);
+        for (i = 0; i < num_of_worker; i++)
+            ogs_thread_destroy(worker[i]);
+        ogs_free(worker);
+        num_of_worker = 0;
+
+        /*
+         * Every job is in the pending hash until the UDM thread handles
+         * its completion, so this also releases the jobs that are left
+         * in the queues.
+         */
+        for (hi = ogs_hash_first(pending_hash); hi; hi = ogs_hash_next(hi))
+            job_free(ogs_hash_this_val(hi));
+        ogs_hash_destroy(pending_hash);
+        ogs_queue_destroy(job_queue);
+    }
+
+    if (suci_cache_hash) {
+        ogs_list_for_each_safe(&suci_cache_list, next_entry, entry)
+            cache_remove(entry);
+        ogs_hash_destroy(suci_cache_hash);
+        suci_cache_hash = NULL;
+        ogs_pool_final(&suci_cache_pool);
+    }
+}
+
+/* suci-<type>-<mcc>-<mnc>-<routing>-<scheme>-<pki>-<output> */
+static bool suci_is_concealed(const char *supi_or_suci)
+{
+    const char *p = supi_or_suci;
+    int i;
+
+    if (strncmp(p, "suci-", 5) != 0)
+        return false;
+
+    for (i = 0; i < 5; i++) {
+        p = strchr(p, '-');
+        if (!p)
+            return false;
+        p++;
+    }
+
+    /* Null scheme is only a copy of the MSIN */
+    return strncmp(p, "0-", 2) != 0;
+}
+
+static udm_suci_cache_t *cache_find(char *suci)
+{
+    udm_suci_cache_t *entry = NULL;
+
+    if (!suci_cache_hash)
+        return NULL;
+
+    entry = ogs_hash_get(suci_cache_hash, suci, strlen(suci));
+    if (!entry)
+        return NULL;
+
+    if (!entry->supi && ogs_monotonic_coarse() >= entry->expires) {
+        cache_remove(entry);
+        return NULL;
+    }
+
+    ogs_list_remove(&suci_cache_list, entry);
+    ogs_list_add(&suci_cache_list, entry);
+
+    return entry;
+}
+
+static void cache_add(char *suci, char *supi)
+{
+    udm_suci_cache_t *entry = NULL;
+
+    if (!suci_cache_hash)
+        return;
+
+    entry = ogs_hash_get(suci_cache_hash, suci, strlen(suci));
+    if (entry)
+        cache_remove(entry);
+
+    if (!suci_cache_pool.avail) {
+        /* Evict the least recently used one */
+        entry = ogs_list_first(&suci_cache_list);
+        ogs_assert(entry);
+        cache_remove(entry);
+    }
+
+    ogs_pool_alloc(&suci_cache_pool, &entry);
+    ogs_assert(entry);
+    memset(entry, 0, sizeof(*entry));
+
+    entry->suci = ogs_strdup(suci);
+    ogs_assert(entry->suci);
+    if (supi) {
+        entry->supi = ogs_strdup(supi);
+        ogs_assert(entry->supi);
+    } else {
+        entry->expires = ogs_monotonic_coarse() + UDM_SUCI_NEGATIVE_TTL;
+    }
+
+    ogs_hash_set(suci_cache_hash, entry->suci, strlen(entry->suci), entry);
+    ogs_list_add(&suci_cache_list, entry);
+}
+
+bool udm_suci_cached(char *suci)
+{
+    udm_suci_cache_t *entry = NULL;
+
+    ogs_assert(suci);
+
+    if (!suci_cache_hash)
+        return false;
+
+    entry = ogs_hash_get(suci_cache_hash, suci, strlen(suci));
+    if (!entry)
+        return false;
+
+    return entry->supi || ogs_monotonic_coarse() < entry->expires;
+}
+
+char *udm_supi_from_supi_or_suci(char *supi_or_suci)
+{
+    udm_suci_cache_t *entry = NULL;
+    char *supi = NULL;
+
+    ogs_assert(supi_or_suci);
+
+    if (!suci_is_concealed(supi_or_suci))
+        return ogs_supi_from_supi_or_suci(supi_or_suci);
+
+    entry = cache_find(supi_or_suci);
+    if (entry) {
+        if (!entry->supi) {
+            ogs_error("De-concealment failed [%s]", supi_or_suci);
+            return NULL;
+        }
+        supi = ogs_strdup(entry->supi);
+        ogs_expect(supi);
+        return supi;
+    }
+
+    supi = ogs_supi_from_supi_or_suci(supi_or_suci);
+    cache_add(supi_or_suci, supi);
+
+    return supi;
+}
+
+bool udm_suci_deconceal(
+        char *suci, ogs_pool_id_t stream_id, ogs_sbi_request_t *request)
+{
+    udm_suci_job_t *job = NULL;
+    udm_suci_waiter_t *waiter = NULL;
+    int rv;
+
+    ogs_assert(suci);
+    ogs_assert(request);
+
+    if (!num_of_worker)
+        return false;
+
+    if (!suci_is_concealed(suci))
+        return false;
+
+    if (cache_find(suci))
+        return false;
+
+    waiter = ogs_calloc(1, sizeof(*waiter));
+    if (!waiter) {
+        ogs_error("ogs_calloc() failed");
+        return false;
+    }
+    waiter->stream_id = stream_id;
+    waiter->request = request;
+
+    job = ogs_hash_get(pending_hash, suci, strlen(suci));
+    if (job) {
+        ogs_list_add(&job->waiter_list, waiter);
+        return true;
+    }
+
+    job = ogs_calloc(1, sizeof(*job));
+    if (!job) {
+        ogs_error("ogs_calloc() failed");
+        ogs_free(waiter);
+        return false;
+    }
+    job->suci = ogs_strdup(suci);
+    if (!job->suci) {
+        ogs_error("ogs_strdup() failed");
+        ogs_free(job);
+        ogs_free(waiter);
+        return false;
+    }
+    ogs_list_add(&job->waiter_list, waiter);
+
+    rv = ogs_queue_trypush(job_queue, job);
+    if (rv != OGS_OK) {
+        /* Workers are saturated : do it in the UDM thread */
+        ogs_warn("ogs_queue_trypush() failed:%d", (int)rv);
+        job_free(job);
+        return false;
+    }
+
+    ogs_hash_set(pending_hash, job->suci, strlen(job->suci), job);
+
+    return true;
+}
+
+void udm_suci_handle_deconcealed(udm_suci_job_t *job)
+{
+    udm_suci_waiter_t *waiter = NULL, *next_waiter = NULL;
+    udm_event_t *e = NULL;
+    ogs_sbi_stream_t *stream = NULL;
+    int rv;
+
+    ogs_assert(job);
+
+    ogs_hash_set(pending_hash, job->suci, strlen(job->suci), NULL);
+    cache_add(job->suci, job->supi);
+
+    /* Dispatch the requests again. They now hit the cache. */
+    ogs_list_for_each_safe(&job->waiter_list, next_waiter, waiter) {
+        e = udm_event_new(OGS_EVENT_SBI_SERVER);
+        ogs_assert(e);
+
+        e->h.sbi.request = waiter->request;
+        e->h.sbi.data = OGS_UINT_TO_POINTER(waiter->stream_id);
+
+        rv = ogs_queue_push(ogs_app()->queue, e);
+        if (rv != OGS_OK) {
+            ogs_error("ogs_queue_push() failed:%d", (int)rv);
+            ogs_event_free(e);
+
+            stream = ogs_sbi_stream_find_by_id(waiter->stream_id);
+            if (stream)
+                ogs_assert(true ==
+                    ogs_sbi_server_send_error(stream,
+                        OGS_SBI_HTTP_STATUS_SERVICE_UNAVAILABLE,
+                        NULL, "Cannot queue request", job->suci, NULL));
+        }
+    }
+
+    job_free(job);
+}
+
+static void suci_worker(void *data)
+{
+    udm_suci_job_t *job = NULL;
+    udm_event_t *e = NULL;
+    int rv;
+
+    for ( ;; ) {
+        rv = ogs_queue_pop(job_queue, (void **)&job);
+        if (rv == OGS_DONE)
+            break;
+        if (rv != OGS_OK)
+            continue;
+
+        ogs_assert(job);
+        job->supi = ogs_supi_from_suci(job->suci);
+
+        e = udm_event_new(UDM_EVENT_SUCI_DECONCEALED);
+        ogs_assert(e);
+        e->h.sbi.data = job;
+
+        rv = ogs_queue_push(ogs_app()->queue, e);
+        if (rv != OGS_OK) {
+            /* The job is released by udm_suci_final() */
+            if (rv != OGS_DONE)
+                ogs_error("ogs_queue_push() failed:%d", (int)rv);
+            ogs_event_free(e);
+            continue;
+        }
+
+        ogs_pollset_notify(ogs_app()->pollset);
+    }
+}
+
+static void job_free(udm_suci_job_t *job)
+{
+    udm_suci_waiter_t *waiter = NULL, *next_waiter = NULL;
+
+    ogs_assert(job);
+
+    ogs_list_for_each_safe(&job->waiter_list, next_waiter, waiter) {
+        ogs_list_remove(&job->waiter_list, waiter);
+        ogs_free(waiter);
+    }
+
+    ogs_free(job->suci);
+    if (job->supi)
+        ogs_free(job->supi);
+    ogs_free(job);
+}
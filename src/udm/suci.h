@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef UDM_SUCI_H
+#define UDM_SUCI_H
+
+#include "context.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct udm_suci_job_s udm_suci_job_t;
+
+void udm_suci_init(void);
+void udm_suci_final(void);
+
+/*
+ * Same as ogs_supi_from_supi_or_suci(), but the result of the ECIES
+ * de-concealment is kept in a bounded SUCI->SUPI cache.
+ */
+char *udm_supi_from_supi_or_suci(char *supi_or_suci);
+
+/* Whether 'suci' has a live cache entry. The LRU order is not changed. */
+bool udm_suci_cached(char *suci);
+
+/*
+ * Hands the de-concealment of 'suci' to a worker thread.
+ *
+ * Returns true if the request has been queued. In that case the caller
+ * must not reply : once the SUPI is in the cache, UDM_EVENT_SUCI_DECONCEALED
+ * dispatches the same SBI request again.
+ *
+ * Returns false if there is nothing to offload (no worker, not a concealed
+ * SUCI, or already cached) and the caller continues synchronously.
+ */
+bool udm_suci_deconceal(
+        char *suci, ogs_pool_id_t stream_id, ogs_sbi_request_t *request);
+void udm_suci_handle_deconcealed(udm_suci_job_t *job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UDM_SUCI_H */
@@ -19,6 +19,7 @@
 
 #include "sbi-path.h"
 #include "nnrf-handler.h"
+#include "suci.h"
 
 void udm_state_initial(ogs_fsm_t *s, udm_event_t *e)
 {
@@ -176,7 +177,15 @@ void udm_state_operational(ogs_fsm_t *s, udm_event_t *e)
             }
 
             if (!udm_ue) {
-                supi = ogs_supi_from_supi_or_suci(
+                /*
+                 * ECIES de-concealment goes to a worker thread and
+                 * the request comes back once the SUPI is cached.
+                 */
+                if (udm_suci_deconceal(message.h.resource.component[0],
+                            stream_id, request) == true)
+                    break;
+
+                supi = udm_supi_from_supi_or_suci(
                     message.h.resource.component[0]);
                 if (supi) {
                     udm_ue = udm_ue_find_by_supi(supi);
@@ -270,6 +279,11 @@ void udm_state_operational(ogs_fsm_t *s, udm_event_t *e)
         ogs_sbi_message_free(&message);
         break;
 
+    case UDM_EVENT_SUCI_DECONCEALED:
+        ogs_assert(e->h.sbi.data);
+        udm_suci_handle_deconcealed(e->h.sbi.data);
+        break;
+
     case OGS_EVENT_SBI_CLIENT:
         ogs_assert(e);
 
@@ -881,7 +881,8 @@ void upf_sess_urr_acc_add(upf_sess_t *sess, ogs_pfcp_urr_t *urr, size_t size, bo
         urr_acc->dl_pkts++;
     }
 
-    urr_acc->time_of_last_packet = ogs_time_now();
+    /* Called per packet: the time of the current poll iteration is enough */
+    urr_acc->time_of_last_packet = ogs_time_now_coarse();
     if (urr_acc->time_of_first_packet == 0)
         urr_acc->time_of_first_packet = urr_acc->time_of_last_packet;
 
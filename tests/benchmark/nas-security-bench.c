@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * NAS security throughput
+ *
+ * Runs the integrity and ciphering algorithms on NAS PDUs of
+ * <size> bytes as the AMF/MME do, i.e. through the security context
+ * cache, and Milenage authentication vector generation as the HSS/UDM do.
+ *
+ * 128-EIA2 and 128-EEA2 are also run without the cache, which expands
+ * the AES key for every message. The KDF row derives the KAUSF, XRES*
+ * and HXRES* of a 5G HE AV from the Milenage output.
+ *
+ *   nas-security-bench [-s size] [-n iterations]
+ */
+
+#include "ogs-nas-common.h"
+
+#define DEFAULT_SIZE 64
+#define DEFAULT_ITERATIONS 100000
+
+typedef enum {
+    BENCH_EIA1 = 0,
+    BENCH_EIA2,
+    BENCH_EIA3,
+    BENCH_EEA1,
+    BENCH_EEA2,
+    BENCH_EEA3,
+    BENCH_EIA2_NO_CACHE,
+    BENCH_EEA2_NO_CACHE,
+    BENCH_MILENAGE,
+    BENCH_KDF,
+
+    MAX_NUM_OF_BENCH,
+} bench_e;
+
+static const char *bench_name[MAX_NUM_OF_BENCH] = {
+    "128-EIA1", "128-EIA2", "128-EIA3",
+    "128-EEA1", "128-EEA2", "128-EEA3",
+    "128-EIA2 no cache", "128-EEA2 no cache",
+    "milenage", "5G HE AV KDF",
+};
+
+static char serving_network_name[] = "5G:mnc070.mcc999.3gppnetwork.org";
+
+static const uint8_t key[OGS_KEY_LEN] = {
+    0x2b, 0xd6, 0x45, 0x9f, 0x82, 0xc5, 0xb3, 0x00,
+    0x95, 0x2c, 0x49, 0x10, 0x48, 0x81, 0xff, 0x48,
+};
+
+static void run(bench_e bench, int size, int iterations)
+{
+    ogs_nas_security_cache_t cache;
+    ogs_pkbuf_t *pkbuf = NULL;
+    uint8_t knas[OGS_KEY_LEN];
+    uint8_t mac[4];
+    uint8_t opc[OGS_KEY_LEN], amf[OGS_AMF_LEN] = { 0x80, 0x00 };
+    uint8_t sqn[OGS_SQN_LEN], _rand[OGS_RAND_LEN];
+    uint8_t autn[OGS_AUTN_LEN], ik[OGS_KEY_LEN], ck[OGS_KEY_LEN];
+    uint8_t ak[OGS_AK_LEN], res[OGS_MAX_RES_LEN];
+    uint8_t kausf[OGS_SHA256_DIGEST_SIZE];
+    uint8_t xres_star[OGS_MAX_RES_LEN], hxres_star[OGS_MAX_RES_LEN];
+    size_t res_len;
+    ogs_time_t start, elapsed;
+    double seconds;
+    int i;
+
+    memset(&cache, 0, sizeof(cache));
+    memcpy(knas, key, sizeof(knas));
+
+    pkbuf = ogs_pkbuf_alloc(NULL, OGS_NAS_HEADROOM+size);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_reserve(pkbuf, OGS_NAS_HEADROOM);
+    ogs_pkbuf_put(pkbuf, size);
+    for (i = 0; i < size; i++)
+        pkbuf->data[i] = i;
+
+    memcpy(opc, key, sizeof(opc));
+    memset(sqn, 0, sizeof(sqn));
+    ogs_random(_rand, sizeof(_rand));
+
+    res_len = sizeof(res);
+    milenage_generate(opc, amf, key, sqn, _rand,
+            autn, ik, ck, ak, res, &res_len);
+
+    start = ogs_get_monotonic_time();
+
+    for (i = 0; i < iterations; i++) {
+        switch (bench) {
+        case BENCH_EIA1:
+        case BENCH_EIA2:
+        case BENCH_EIA3:
+            ogs_nas_mac_calculate_with_cache(&cache,
+                    OGS_NAS_SECURITY_ALGORITHMS_128_EIA1 + bench - BENCH_EIA1,
+                    knas, i, 1, OGS_NAS_SECURITY_UPLINK_DIRECTION,
+                    pkbuf, mac);
+            break;
+        case BENCH_EEA1:
+        case BENCH_EEA2:
+        case BENCH_EEA3:
+            ogs_nas_encrypt_with_cache(&cache,
+                    OGS_NAS_SECURITY_ALGORITHMS_128_EEA1 + bench - BENCH_EEA1,
+                    knas, i, 1, OGS_NAS_SECURITY_DOWNLINK_DIRECTION, pkbuf);
+            break;
+        case BENCH_EIA2_NO_CACHE:
+            ogs_nas_mac_calculate(OGS_NAS_SECURITY_ALGORITHMS_128_EIA2,
+                    knas, i, 1, OGS_NAS_SECURITY_UPLINK_DIRECTION,
+                    pkbuf, mac);
+            break;
+        case BENCH_EEA2_NO_CACHE:
+            ogs_nas_encrypt(OGS_NAS_SECURITY_ALGORITHMS_128_EEA2,
+                    knas, i, 1, OGS_NAS_SECURITY_DOWNLINK_DIRECTION, pkbuf);
+            break;
+        case BENCH_MILENAGE:
+            sqn[5] = i;
+            res_len = sizeof(res);
+            milenage_generate(opc, amf, key, sqn, _rand,
+                    autn, ik, ck, ak, res, &res_len);
+            break;
+        case BENCH_KDF:
+            ogs_kdf_kausf(ck, ik, serving_network_name, autn, kausf);
+            ogs_kdf_xres_star(ck, ik, serving_network_name, _rand,
+                    res, res_len, xres_star);
+            ogs_kdf_hxres_star(_rand, xres_star, hxres_star);
+            break;
+        default:
+            ogs_assert_if_reached();
+        }
+    }
+
+    elapsed = ogs_get_monotonic_time() - start;
+    seconds = (double)elapsed / OGS_USEC_PER_SEC;
+
+    if (bench == BENCH_MILENAGE || bench == BENCH_KDF)
+        printf("%-17s %6s %12.1f %10s\n", bench_name[bench], "-",
+                seconds > 0 ? iterations / seconds : 0, "-");
+    else
+        printf("%-17s %6d %12.1f %10.1f\n", bench_name[bench], size,
+                seconds > 0 ? iterations / seconds : 0,
+                seconds > 0 ?
+                    (double)iterations * size / seconds / (1024*1024) : 0);
+    fflush(stdout);
+
+    ogs_nas_security_cache_clear(&cache);
+    ogs_pkbuf_free(pkbuf);
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n"
+        "Options:\n"
+        "   -s size        : NAS PDU size in bytes (default: %d)\n"
+        "   -n iterations  : iterations per algorithm (default: %d)\n"
+        "   -h             : show this message and exit\n",
+        name, DEFAULT_SIZE, DEFAULT_ITERATIONS);
+}
+
+int main(int argc, const char *const argv[])
+{
+    int i, opt;
+    ogs_getopt_t options;
+    int size = DEFAULT_SIZE;
+    int iterations = DEFAULT_ITERATIONS;
+    ogs_pkbuf_config_t config;
+
+    ogs_getopt_init(&options, (char**)argv);
+    while ((opt = ogs_getopt(&options, "s:n:h")) != -1) {
+        switch (opt) {
+        case 's':
+            size = atoi(options.optarg);
+            break;
+        case 'n':
+            iterations = atoi(options.optarg);
+            break;
+        case 'h':
+            usage(argv[0]);
+            return OGS_OK;
+        case '?':
+            fprintf(stderr, "%s: %s\n", argv[0], options.errmsg);
+            usage(argv[0]);
+            return OGS_ERROR;
+        default:
+            fprintf(stderr, "%s: should not be reached\n", OGS_FUNC);
+            return OGS_ERROR;
+        }
+    }
+
+    if (size <= 0 || size > OGS_MAX_SDU_LEN || iterations <= 0) {
+        fprintf(stderr, "%s: invalid size or iterations\n", argv[0]);
+        return OGS_ERROR;
+    }
+
+    ogs_core_initialize();
+
+    ogs_pkbuf_default_init(&config);
+    ogs_pkbuf_default_create(&config);
+
+    printf("%-17s %6s %12s %10s\n", "algorithm", "size", "ops/s", "MB/s");
+
+    for (i = 0; i < MAX_NUM_OF_BENCH; i++)
+        run(i, size, iterations);
+
+    ogs_pkbuf_default_destroy();
+    ogs_core_terminate();
+
+    return OGS_OK;
+}
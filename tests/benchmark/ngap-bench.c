@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * NGAP encode/decode throughput
+ *
+ * Builds and APER-encodes InitialUEMessage and DownlinkNASTransport
+ * as the gNB/AMF do, then decodes and frees them as the AMF does.
+ * Allocations are counted by ogs_mem_num_of_alloc(), including
+ * the chunks carved from the pooled arena of the decoded tree.
+ *
+ *   ngap-bench [-n iterations]
+ */
+
+#include "ogs-ngap.h"
+
+#define DEFAULT_ITERATIONS 100000
+
+typedef enum {
+    BENCH_INITIAL_UE_MESSAGE = 0,
+    BENCH_DOWNLINK_NAS_TRANSPORT,
+
+    MAX_NUM_OF_BENCH,
+} bench_e;
+
+static const char *bench_name[MAX_NUM_OF_BENCH] = {
+    "InitialUEMessage", "DownlinkNASTransport",
+};
+
+/* Registration request */
+static const uint8_t nas_pdu[] = {
+    0x7e, 0x00, 0x41, 0x79, 0x00, 0x0d, 0x01, 0x99, 0xf9, 0x07, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x13, 0x2e, 0x04, 0xf0, 0xf0, 0xf0,
+    0xf0,
+};
+
+static ogs_pkbuf_t *build_initial_ue_message(uint32_t ran_ue_ngap_id)
+{
+    NGAP_NGAP_PDU_t pdu;
+    NGAP_InitiatingMessage_t *initiatingMessage = NULL;
+    NGAP_InitialUEMessage_t *InitialUEMessage = NULL;
+
+    NGAP_InitialUEMessage_IEs_t *ie = NULL;
+    NGAP_UserLocationInformation_t *UserLocationInformation = NULL;
+    NGAP_UserLocationInformationNR_t *userLocationInformationNR = NULL;
+
+    ogs_nr_cgi_t nr_cgi;
+    ogs_5gs_tai_t nr_tai;
+
+    memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
+    pdu.choice.initiatingMessage =
+        CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
+
+    initiatingMessage = pdu.choice.initiatingMessage;
+    initiatingMessage->procedureCode = NGAP_ProcedureCode_id_InitialUEMessage;
+    initiatingMessage->criticality = NGAP_Criticality_ignore;
+    initiatingMessage->value.present =
+        NGAP_InitiatingMessage__value_PR_InitialUEMessage;
+
+    InitialUEMessage = &initiatingMessage->value.choice.InitialUEMessage;
+
+    ie = CALLOC(1, sizeof(NGAP_InitialUEMessage_IEs_t));
+    ASN_SEQUENCE_ADD(&InitialUEMessage->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID;
+    ie->criticality = NGAP_Criticality_reject;
+    ie->value.present = NGAP_InitialUEMessage_IEs__value_PR_RAN_UE_NGAP_ID;
+    ie->value.choice.RAN_UE_NGAP_ID = ran_ue_ngap_id;
+
+    ie = CALLOC(1, sizeof(NGAP_InitialUEMessage_IEs_t));
+    ASN_SEQUENCE_ADD(&InitialUEMessage->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_NAS_PDU;
+    ie->criticality = NGAP_Criticality_reject;
+    ie->value.present = NGAP_InitialUEMessage_IEs__value_PR_NAS_PDU;
+    ogs_asn_buffer_to_OCTET_STRING((void *)nas_pdu, sizeof(nas_pdu),
+            &ie->value.choice.NAS_PDU);
+
+    ie = CALLOC(1, sizeof(NGAP_InitialUEMessage_IEs_t));
+    ASN_SEQUENCE_ADD(&InitialUEMessage->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_UserLocationInformation;
+    ie->criticality = NGAP_Criticality_reject;
+    ie->value.present =
+        NGAP_InitialUEMessage_IEs__value_PR_UserLocationInformation;
+
+    UserLocationInformation = &ie->value.choice.UserLocationInformation;
+
+    memset(&nr_cgi, 0, sizeof(nr_cgi));
+    ogs_plmn_id_build(&nr_cgi.plmn_id, 999, 70, 2);
+    nr_cgi.cell_id = 0x40001;
+
+    memset(&nr_tai, 0, sizeof(nr_tai));
+    ogs_plmn_id_build(&nr_tai.plmn_id, 999, 70, 2);
+    nr_tai.tac.v = 1;
+
+    userLocationInformationNR =
+            CALLOC(1, sizeof(NGAP_UserLocationInformationNR_t));
+    ogs_ngap_nr_cgi_to_ASN(&nr_cgi, &userLocationInformationNR->nR_CGI);
+    ogs_ngap_5gs_tai_to_ASN(&nr_tai, &userLocationInformationNR->tAI);
+
+    UserLocationInformation->present =
+        NGAP_UserLocationInformation_PR_userLocationInformationNR;
+    UserLocationInformation->choice.userLocationInformationNR =
+        userLocationInformationNR;
+
+    ie = CALLOC(1, sizeof(NGAP_InitialUEMessage_IEs_t));
+    ASN_SEQUENCE_ADD(&InitialUEMessage->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_RRCEstablishmentCause;
+    ie->criticality = NGAP_Criticality_ignore;
+    ie->value.present =
+        NGAP_InitialUEMessage_IEs__value_PR_RRCEstablishmentCause;
+    ie->value.choice.RRCEstablishmentCause =
+        NGAP_RRCEstablishmentCause_mo_Signalling;
+
+    ie = CALLOC(1, sizeof(NGAP_InitialUEMessage_IEs_t));
+    ASN_SEQUENCE_ADD(&InitialUEMessage->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_UEContextRequest;
+    ie->criticality = NGAP_Criticality_ignore;
+    ie->value.present = NGAP_InitialUEMessage_IEs__value_PR_UEContextRequest;
+    ie->value.choice.UEContextRequest = NGAP_UEContextRequest_requested;
+
+    return ogs_ngap_encode(&pdu);
+}
+
+static ogs_pkbuf_t *build_downlink_nas_transport(
+        uint32_t ran_ue_ngap_id, uint64_t amf_ue_ngap_id)
+{
+    NGAP_NGAP_PDU_t pdu;
+    NGAP_InitiatingMessage_t *initiatingMessage = NULL;
+    NGAP_DownlinkNASTransport_t *DownlinkNASTransport = NULL;
+
+    NGAP_DownlinkNASTransport_IEs_t *ie = NULL;
+
+    memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
+    pdu.choice.initiatingMessage =
+        CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
+
+    initiatingMessage = pdu.choice.initiatingMessage;
+    initiatingMessage->procedureCode =
+        NGAP_ProcedureCode_id_DownlinkNASTransport;
+    initiatingMessage->criticality = NGAP_Criticality_ignore;
+    initiatingMessage->value.present =
+        NGAP_InitiatingMessage__value_PR_DownlinkNASTransport;
+
+    DownlinkNASTransport =
+        &initiatingMessage->value.choice.DownlinkNASTransport;
+
+    ie = CALLOC(1, sizeof(NGAP_DownlinkNASTransport_IEs_t));
+    ASN_SEQUENCE_ADD(&DownlinkNASTransport->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_AMF_UE_NGAP_ID;
+    ie->criticality = NGAP_Criticality_reject;
+    ie->value.present = NGAP_DownlinkNASTransport_IEs__value_PR_AMF_UE_NGAP_ID;
+    asn_uint642INTEGER(&ie->value.choice.AMF_UE_NGAP_ID, amf_ue_ngap_id);
+
+    ie = CALLOC(1, sizeof(NGAP_DownlinkNASTransport_IEs_t));
+    ASN_SEQUENCE_ADD(&DownlinkNASTransport->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_RAN_UE_NGAP_ID;
+    ie->criticality = NGAP_Criticality_reject;
+    ie->value.present = NGAP_DownlinkNASTransport_IEs__value_PR_RAN_UE_NGAP_ID;
+    ie->value.choice.RAN_UE_NGAP_ID = ran_ue_ngap_id;
+
+    ie = CALLOC(1, sizeof(NGAP_DownlinkNASTransport_IEs_t));
+    ASN_SEQUENCE_ADD(&DownlinkNASTransport->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_NAS_PDU;
+    ie->criticality = NGAP_Criticality_reject;
+    ie->value.present = NGAP_DownlinkNASTransport_IEs__value_PR_NAS_PDU;
+    ogs_asn_buffer_to_OCTET_STRING((void *)nas_pdu, sizeof(nas_pdu),
+            &ie->value.choice.NAS_PDU);
+
+    return ogs_ngap_encode(&pdu);
+}
+
+static void run(bench_e bench, int iterations)
+{
+    ogs_ngap_message_t message;
+    ogs_pkbuf_t *pkbuf = NULL;
+    ogs_time_t start, encode_time = 0, decode_time = 0;
+    uint64_t num_of_alloc, encode_alloc = 0, decode_alloc = 0;
+    int i, rv, len = 0;
+
+    for (i = 0; i < iterations; i++) {
+        start = ogs_get_monotonic_time();
+        num_of_alloc = ogs_mem_num_of_alloc();
+
+        switch (bench) {
+        case BENCH_INITIAL_UE_MESSAGE:
+            pkbuf = build_initial_ue_message(i);
+            break;
+        case BENCH_DOWNLINK_NAS_TRANSPORT:
+            pkbuf = build_downlink_nas_transport(i, i);
+            break;
+        default:
+            ogs_assert_if_reached();
+        }
+        ogs_assert(pkbuf);
+
+        encode_alloc += ogs_mem_num_of_alloc() - num_of_alloc;
+        encode_time += ogs_get_monotonic_time() - start;
+
+        len = pkbuf->len;
+
+        start = ogs_get_monotonic_time();
+        num_of_alloc = ogs_mem_num_of_alloc();
+
+        rv = ogs_ngap_decode(&message, pkbuf);
+        ogs_assert(rv == OGS_OK);
+        ogs_ngap_free(&message);
+
+        decode_alloc += ogs_mem_num_of_alloc() - num_of_alloc;
+        decode_time += ogs_get_monotonic_time() - start;
+
+        ogs_pkbuf_free(pkbuf);
+    }
+
+    printf("%-21s %5d %12.1f %10.1f %12.1f %10.1f\n", bench_name[bench], len,
+            encode_time > 0 ?
+                (double)iterations * OGS_USEC_PER_SEC / encode_time : 0,
+            (double)encode_alloc / iterations,
+            decode_time > 0 ?
+                (double)iterations * OGS_USEC_PER_SEC / decode_time : 0,
+            (double)decode_alloc / iterations);
+    fflush(stdout);
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n"
+        "Options:\n"
+        "   -n iterations  : iterations per message (default: %d)\n"
+        "   -h             : show this message and exit\n",
+        name, DEFAULT_ITERATIONS);
+}
+
+int main(int argc, const char *const argv[])
+{
+    int i, opt;
+    ogs_getopt_t options;
+    int iterations = DEFAULT_ITERATIONS;
+    ogs_pkbuf_config_t config;
+
+    ogs_getopt_init(&options, (char**)argv);
+    while ((opt = ogs_getopt(&options, "n:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            iterations = atoi(options.optarg);
+            break;
+        case 'h':
+            usage(argv[0]);
+            return OGS_OK;
+        case '?':
+            fprintf(stderr, "%s: %s\n", argv[0], options.errmsg);
+            usage(argv[0]);
+            return OGS_ERROR;
+        default:
+            fprintf(stderr, "%s: should not be reached\n", OGS_FUNC);
+            return OGS_ERROR;
+        }
+    }
+
+    if (iterations <= 0) {
+        fprintf(stderr, "%s: invalid iterations\n", argv[0]);
+        return OGS_ERROR;
+    }
+
+    ogs_core_initialize();
+
+    ogs_pkbuf_default_init(&config);
+    ogs_pkbuf_default_create(&config);
+
+    printf("%-21s %5s %12s %10s %12s %10s\n", "message", "size",
+            "encode/s", "allocs", "decode/s", "allocs");
+
+    for (i = 0; i < MAX_NUM_OF_BENCH; i++)
+        run(i, iterations);
+
+    ogs_pkbuf_default_destroy();
+    ogs_core_terminate();
+
+    return OGS_OK;
+}
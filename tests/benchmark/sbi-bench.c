@@ -0,0 +1,680 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * SBI load generator
+ *
+ * An ogs_sbi_server_t and an ogs_sbi_client_t run in the same event loop.
+ * The client keeps <concurrency> requests in flight until <requests>
+ * responses are received, and the server answers every request with
+ * a representative body. Both sides build and parse the messages
+ * as an NF does, so the figures include the JSON codec.
+ *
+ *   sbi-bench [-p nrf|udm|smf|all] [-e curl|nghttp2]
+ *             [-c concurrency] [-n requests] [-a address] [-P port]
+ *
+ * Allocations are the number of ogs_malloc()/ogs_calloc() calls
+ * per request, client and server together.
+ */
+
+#include "ogs-sbi.h"
+
+#define DEFAULT_CONCURRENCY 16
+#define DEFAULT_REQUESTS 10000
+#define DEFAULT_ADDRESS "127.0.0.250"
+#define DEFAULT_PORT 7777
+
+#define NUM_OF_SEARCH_RESULT 4
+
+typedef enum {
+    BENCH_PAYLOAD_NRF = 0,
+    BENCH_PAYLOAD_UDM,
+    BENCH_PAYLOAD_SMF,
+
+    MAX_NUM_OF_BENCH_PAYLOAD,
+} bench_payload_e;
+
+static const char *bench_payload_name[MAX_NUM_OF_BENCH_PAYLOAD] = {
+    "nrf", "udm", "smf",
+};
+
+typedef struct bench_slot_s {
+    ogs_sbi_request_t *request;
+    ogs_time_t start;
+} bench_slot_t;
+
+static struct {
+    ogs_sbi_client_t *client;
+
+    bench_payload_e payload;
+    int concurrency;
+    int requests;
+
+    bench_slot_t *slot;
+    ogs_time_t *latency;
+
+    int sent;
+    int completed;
+    int failed;
+} bench;
+
+static ogs_sbi_request_t *build_request(bench_payload_e payload)
+{
+    ogs_sbi_message_t message;
+    ogs_sbi_request_t *request = NULL;
+
+    OpenAPI_sm_context_create_data_t SmContextCreateData;
+    OpenAPI_snssai_t s_nssai;
+    OpenAPI_plmn_id_nid_t plmn_id_nid;
+    OpenAPI_guami_t guami;
+
+    switch (payload) {
+    case BENCH_PAYLOAD_NRF:
+        request = ogs_nnrf_disc_build_discover(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, NULL);
+        break;
+
+    case BENCH_PAYLOAD_UDM:
+        memset(&message, 0, sizeof(message));
+        message.h.method = (char *)OGS_SBI_HTTP_METHOD_GET;
+        message.h.service.name = (char *)OGS_SBI_SERVICE_NAME_NUDM_SDM;
+        message.h.api.version = (char *)OGS_SBI_API_V2;
+        message.h.resource.component[0] = (char *)"imsi-001010000000001";
+        message.h.resource.component[1] =
+            (char *)OGS_SBI_RESOURCE_NAME_AM_DATA;
+
+        request = ogs_sbi_build_request(&message);
+        break;
+
+    case BENCH_PAYLOAD_SMF:
+        plmn_id_nid.mcc = (char *)"001";
+        plmn_id_nid.mnc = (char *)"01";
+        plmn_id_nid.nid = NULL;
+
+        s_nssai.sst = 1;
+        s_nssai.sd = (char *)"000001";
+
+        guami.plmn_id = &plmn_id_nid;
+        guami.amf_id = (char *)"020040";
+
+        memset(&SmContextCreateData, 0, sizeof(SmContextCreateData));
+        SmContextCreateData.supi = (char *)"imsi-001010000000001";
+        SmContextCreateData.pei = (char *)"imeisv-4370816125816151";
+        SmContextCreateData.is_pdu_session_id = true;
+        SmContextCreateData.pdu_session_id = 5;
+        SmContextCreateData.dnn = (char *)"internet";
+        SmContextCreateData.s_nssai = &s_nssai;
+        SmContextCreateData.serving_nf_id =
+            (char *)"6c1a4b2e-6f3c-41ee-a3a8-0d4c2bb1f7a1";
+        SmContextCreateData.guami = &guami;
+        SmContextCreateData.serving_network = &plmn_id_nid;
+        SmContextCreateData.an_type = OpenAPI_access_type_3GPP_ACCESS;
+        SmContextCreateData.rat_type = OpenAPI_rat_type_NR;
+        SmContextCreateData.ue_time_zone = (char *)"+00:00";
+        SmContextCreateData.sm_context_status_uri = (char *)
+            "http://127.0.0.5:7777/namf-callback/v1/"
+            "imsi-001010000000001/sm-context-status/5";
+
+        memset(&message, 0, sizeof(message));
+        message.h.method = (char *)OGS_SBI_HTTP_METHOD_POST;
+        message.h.service.name =
+            (char *)OGS_SBI_SERVICE_NAME_NSMF_PDUSESSION;
+        message.h.api.version = (char *)OGS_SBI_API_V1;
+        message.h.resource.component[0] =
+            (char *)OGS_SBI_RESOURCE_NAME_SM_CONTEXTS;
+        message.SmContextCreateData = &SmContextCreateData;
+
+        request = ogs_sbi_build_request(&message);
+        break;
+
+    default:
+        ogs_fatal("Unknown payload [%d]", payload);
+        ogs_assert_if_reached();
+    }
+
+    ogs_assert(request);
+
+    return request;
+}
+
+static ogs_sbi_response_t *build_nrf_response(ogs_sbi_message_t *recvmsg)
+{
+    ogs_sbi_message_t message;
+    ogs_sbi_response_t *response = NULL;
+    int i;
+
+    OpenAPI_search_result_t SearchResult;
+    OpenAPI_nf_profile_t NFProfile[NUM_OF_SEARCH_RESULT];
+    char nf_instance_id[NUM_OF_SEARCH_RESULT][OGS_UUID_FORMATTED_LENGTH + 1];
+    OpenAPI_plmn_id_t plmn_id;
+    OpenAPI_snssai_t s_nssai;
+    ogs_uuid_t uuid;
+
+    plmn_id.mcc = (char *)"001";
+    plmn_id.mnc = (char *)"01";
+
+    s_nssai.sst = 1;
+    s_nssai.sd = (char *)"000001";
+
+    memset(&SearchResult, 0, sizeof(SearchResult));
+    SearchResult.is_validity_period = true;
+    SearchResult.validity_period = 3600;
+    SearchResult.nf_instances = OpenAPI_list_create();
+    ogs_assert(SearchResult.nf_instances);
+
+    for (i = 0; i < NUM_OF_SEARCH_RESULT; i++) {
+        ogs_uuid_get(&uuid);
+        ogs_uuid_format(nf_instance_id[i], &uuid);
+
+        memset(&NFProfile[i], 0, sizeof(NFProfile[i]));
+        NFProfile[i].nf_instance_id = nf_instance_id[i];
+        NFProfile[i].nf_type = recvmsg->param.target_nf_type;
+        NFProfile[i].nf_status = OpenAPI_nf_status_REGISTERED;
+        NFProfile[i].is_heart_beat_timer = true;
+        NFProfile[i].heart_beat_timer = 10;
+        NFProfile[i].is_priority = true;
+        NFProfile[i].priority = 1;
+        NFProfile[i].is_capacity = true;
+        NFProfile[i].capacity = 100;
+        NFProfile[i].is_load = true;
+        NFProfile[i].load = i * 10;
+
+        NFProfile[i].plmn_list = OpenAPI_list_create();
+        ogs_assert(NFProfile[i].plmn_list);
+        OpenAPI_list_add(NFProfile[i].plmn_list, &plmn_id);
+
+        NFProfile[i].s_nssais = OpenAPI_list_create();
+        ogs_assert(NFProfile[i].s_nssais);
+        OpenAPI_list_add(NFProfile[i].s_nssais, &s_nssai);
+
+        NFProfile[i].ipv4_addresses = OpenAPI_list_create();
+        ogs_assert(NFProfile[i].ipv4_addresses);
+        OpenAPI_list_add(NFProfile[i].ipv4_addresses, (char *)"127.0.0.4");
+
+        OpenAPI_list_add(SearchResult.nf_instances, &NFProfile[i]);
+    }
+
+    memset(&message, 0, sizeof(message));
+    message.SearchResult = &SearchResult;
+
+    response = ogs_sbi_build_response(&message, OGS_SBI_HTTP_STATUS_OK);
+    ogs_assert(response);
+
+    for (i = 0; i < NUM_OF_SEARCH_RESULT; i++) {
+        OpenAPI_list_free(NFProfile[i].plmn_list);
+        OpenAPI_list_free(NFProfile[i].s_nssais);
+        OpenAPI_list_free(NFProfile[i].ipv4_addresses);
+    }
+    OpenAPI_list_free(SearchResult.nf_instances);
+
+    return response;
+}
+
+static ogs_sbi_response_t *build_udm_response(ogs_sbi_message_t *recvmsg)
+{
+    ogs_sbi_message_t message;
+    ogs_sbi_response_t *response = NULL;
+
+    OpenAPI_access_and_mobility_subscription_data_t
+        AccessAndMobilitySubscriptionData;
+    OpenAPI_ambr_rm_t subscribed_ue_ambr;
+    OpenAPI_nssai_t nssai;
+    OpenAPI_snssai_t s_nssai[2];
+
+    subscribed_ue_ambr.uplink = (char *)"1 Gbps";
+    subscribed_ue_ambr.downlink = (char *)"2 Gbps";
+
+    s_nssai[0].sst = 1;
+    s_nssai[0].sd = NULL;
+    s_nssai[1].sst = 1;
+    s_nssai[1].sd = (char *)"000001";
+
+    memset(&nssai, 0, sizeof(nssai));
+    nssai.default_single_nssais = OpenAPI_list_create();
+    ogs_assert(nssai.default_single_nssais);
+    OpenAPI_list_add(nssai.default_single_nssais, &s_nssai[0]);
+    nssai.single_nssais = OpenAPI_list_create();
+    ogs_assert(nssai.single_nssais);
+    OpenAPI_list_add(nssai.single_nssais, &s_nssai[1]);
+
+    memset(&AccessAndMobilitySubscriptionData, 0,
+            sizeof(AccessAndMobilitySubscriptionData));
+    AccessAndMobilitySubscriptionData.gpsis = OpenAPI_list_create();
+    ogs_assert(AccessAndMobilitySubscriptionData.gpsis);
+    OpenAPI_list_add(AccessAndMobilitySubscriptionData.gpsis,
+            (char *)"msisdn-0100000001");
+    AccessAndMobilitySubscriptionData.subscribed_ue_ambr =
+        &subscribed_ue_ambr;
+    AccessAndMobilitySubscriptionData.nssai = &nssai;
+
+    memset(&message, 0, sizeof(message));
+    message.AccessAndMobilitySubscriptionData =
+        &AccessAndMobilitySubscriptionData;
+
+    response = ogs_sbi_build_response(&message, OGS_SBI_HTTP_STATUS_OK);
+    ogs_assert(response);
+
+    OpenAPI_list_free(AccessAndMobilitySubscriptionData.gpsis);
+    OpenAPI_list_free(nssai.default_single_nssais);
+    OpenAPI_list_free(nssai.single_nssais);
+
+    return response;
+}
+
+static ogs_sbi_response_t *build_smf_response(ogs_sbi_message_t *recvmsg)
+{
+    ogs_sbi_message_t message;
+    ogs_sbi_response_t *response = NULL;
+    char *location = NULL;
+
+    OpenAPI_sm_context_created_data_t SmContextCreatedData;
+
+    if (!recvmsg->SmContextCreateData) {
+        ogs_error("No SmContextCreateData");
+        return NULL;
+    }
+
+    memset(&SmContextCreatedData, 0, sizeof(SmContextCreatedData));
+    SmContextCreatedData.is_pdu_session_id = true;
+    SmContextCreatedData.pdu_session_id =
+        recvmsg->SmContextCreateData->pdu_session_id;
+    SmContextCreatedData.s_nssai = recvmsg->SmContextCreateData->s_nssai;
+    SmContextCreatedData.gpsi = (char *)"msisdn-0100000001";
+
+    location = ogs_msprintf("%s/1", recvmsg->h.uri);
+    ogs_assert(location);
+
+    memset(&message, 0, sizeof(message));
+    message.http.location = location;
+    message.SmContextCreatedData = &SmContextCreatedData;
+
+    response = ogs_sbi_build_response(&message, OGS_SBI_HTTP_STATUS_CREATED);
+    ogs_assert(response);
+
+    ogs_free(location);
+
+    return response;
+}
+
+static void handle_request(ogs_sbi_stream_t *stream, ogs_sbi_request_t *request)
+{
+    int rv;
+    ogs_sbi_message_t message;
+    ogs_sbi_response_t *response = NULL;
+
+    ogs_assert(stream);
+    ogs_assert(request);
+
+    rv = ogs_sbi_parse_request(&message, request);
+    if (rv != OGS_OK) {
+        ogs_error("ogs_sbi_parse_request() failed");
+        ogs_assert(true ==
+            ogs_sbi_server_send_error(stream,
+                OGS_SBI_HTTP_STATUS_BAD_REQUEST,
+                NULL, "cannot parse HTTP message", NULL, NULL));
+        return;
+    }
+
+    SWITCH(message.h.service.name)
+    CASE(OGS_SBI_SERVICE_NAME_NNRF_DISC)
+        response = build_nrf_response(&message);
+        break;
+    CASE(OGS_SBI_SERVICE_NAME_NUDM_SDM)
+        response = build_udm_response(&message);
+        break;
+    CASE(OGS_SBI_SERVICE_NAME_NSMF_PDUSESSION)
+        response = build_smf_response(&message);
+        break;
+    DEFAULT
+        ogs_error("Invalid API name [%s]", message.h.service.name);
+    END
+
+    if (response)
+        ogs_assert(true == ogs_sbi_server_send_response(stream, response));
+    else
+        ogs_assert(true ==
+            ogs_sbi_server_send_error(stream,
+                OGS_SBI_HTTP_STATUS_BAD_REQUEST, &message,
+                "Invalid request", NULL, NULL));
+
+    ogs_sbi_message_free(&message);
+}
+
+static int client_cb(int status, ogs_sbi_response_t *response, void *data)
+{
+    ogs_event_t *e = NULL;
+    int rv;
+
+    /* The client is being stopped */
+    if (status == OGS_DONE)
+        return OGS_OK;
+
+    if (status != OGS_OK)
+        ogs_warn("client_cb() failed [%d]", status);
+
+    /* A failed request is also reported so that the slot is reused */
+    e = ogs_event_new(OGS_EVENT_SBI_CLIENT);
+    ogs_assert(e);
+    e->sbi.response = response;
+    e->sbi.data = data;
+
+    rv = ogs_queue_push(ogs_app()->queue, e);
+    if (rv != OGS_OK) {
+        ogs_error("ogs_queue_push() failed:%d", (int)rv);
+        if (response)
+            ogs_sbi_response_free(response);
+        ogs_event_free(e);
+        return OGS_ERROR;
+    }
+
+    return OGS_OK;
+}
+
+static void send_request(bench_slot_t *slot)
+{
+    ogs_assert(slot);
+    ogs_assert(slot->request == NULL);
+
+    slot->request = build_request(bench.payload);
+    slot->start = ogs_get_monotonic_time();
+    bench.sent++;
+
+    if (ogs_sbi_client_send_request(
+                bench.client, client_cb, slot->request, slot) == false) {
+        ogs_fatal("ogs_sbi_client_send_request() failed");
+        ogs_assert_if_reached();
+    }
+}
+
+static void handle_response(bench_slot_t *slot, ogs_sbi_response_t *response)
+{
+    int rv;
+    ogs_sbi_message_t message;
+
+    ogs_assert(slot);
+    ogs_assert(slot->request);
+
+    bench.latency[bench.completed++] = ogs_get_monotonic_time() - slot->start;
+
+    if (response) {
+        rv = ogs_sbi_parse_response(&message, response);
+        if (rv != OGS_OK || response->status >= 300) {
+            ogs_error("Invalid response [%d]", response->status);
+            bench.failed++;
+        }
+        ogs_sbi_message_free(&message);
+        ogs_sbi_response_free(response);
+    } else {
+        bench.failed++;
+    }
+
+    ogs_sbi_request_free(slot->request);
+    slot->request = NULL;
+
+    if (bench.sent < bench.requests)
+        send_request(slot);
+}
+
+static void dispatch(ogs_event_t *e)
+{
+    ogs_assert(e);
+
+    switch (e->id) {
+    case OGS_EVENT_SBI_SERVER:
+        handle_request(e->sbi.data, e->sbi.request);
+        break;
+    case OGS_EVENT_SBI_CLIENT:
+        handle_response(e->sbi.data, e->sbi.response);
+        break;
+    default:
+        ogs_error("Unknown event [%s]", ogs_event_get_name(e));
+        break;
+    }
+}
+
+static int compare_time(const void *a, const void *b)
+{
+    ogs_time_t x = *(const ogs_time_t *)a;
+    ogs_time_t y = *(const ogs_time_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void run(bench_payload_e payload)
+{
+    int i, rv;
+    ogs_time_t start, elapsed;
+    uint64_t num_of_alloc;
+    double seconds;
+
+    bench.payload = payload;
+    bench.sent = 0;
+    bench.completed = 0;
+    bench.failed = 0;
+
+    num_of_alloc = ogs_mem_num_of_alloc();
+    start = ogs_get_monotonic_time();
+
+    for (i = 0; i < bench.concurrency && bench.sent < bench.requests; i++)
+        send_request(&bench.slot[i]);
+
+    while (bench.completed < bench.requests) {
+        ogs_pollset_poll(ogs_app()->pollset,
+                ogs_timer_mgr_next(ogs_app()->timer_mgr));
+        ogs_timer_mgr_expire(ogs_app()->timer_mgr);
+
+        for ( ;; ) {
+            ogs_event_t *e = NULL;
+
+            rv = ogs_queue_trypop(ogs_app()->queue, (void**)&e);
+            ogs_assert(rv != OGS_ERROR);
+
+            if (rv == OGS_DONE || rv == OGS_RETRY)
+                break;
+
+            ogs_assert(e);
+            dispatch(e);
+            ogs_event_free(e);
+        }
+    }
+
+    elapsed = ogs_get_monotonic_time() - start;
+    num_of_alloc = ogs_mem_num_of_alloc() - num_of_alloc;
+
+    qsort(bench.latency, bench.completed, sizeof(ogs_time_t), compare_time);
+    seconds = (double)elapsed / OGS_USEC_PER_SEC;
+
+    printf("%-4s %-8s %6d %8d %10.1f %10.3f %10.3f %10.1f %6d\n",
+            bench_payload_name[payload],
+            ogs_sbi_self()->client_engine == OGS_SBI_CLIENT_ENGINE_NGHTTP2 ?
+                "nghttp2" : "curl",
+            bench.concurrency, bench.completed,
+            seconds > 0 ? bench.completed / seconds : 0,
+            (double)bench.latency[bench.completed / 2] / 1000,
+            (double)bench.latency[(bench.completed * 99) / 100] / 1000,
+            (double)num_of_alloc / bench.completed,
+            bench.failed);
+    fflush(stdout);
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n"
+        "Options:\n"
+        "   -p payload     : nrf, udm, smf or all (default: all)\n"
+        "   -e engine      : curl or nghttp2 (default: curl)\n"
+        "   -c concurrency : requests in flight (default: %d)\n"
+        "   -n requests    : number of requests (default: %d)\n"
+        "   -a address     : server address (default: %s)\n"
+        "   -P port        : server port (default: %d)\n"
+        "   -h             : show this message and exit\n",
+        name, DEFAULT_CONCURRENCY, DEFAULT_REQUESTS,
+        DEFAULT_ADDRESS, DEFAULT_PORT);
+}
+
+int main(int argc, const char *const argv[])
+{
+    int rv, i, opt;
+    ogs_getopt_t options;
+    struct {
+        const char *payload;
+        const char *engine;
+        const char *address;
+        int port;
+    } optarg;
+    ogs_sockaddr_t *addr = NULL;
+    ogs_sbi_server_t *server = NULL;
+
+    memset(&optarg, 0, sizeof(optarg));
+    optarg.payload = "all";
+    optarg.engine = "curl";
+    optarg.address = DEFAULT_ADDRESS;
+    optarg.port = DEFAULT_PORT;
+
+    memset(&bench, 0, sizeof(bench));
+    bench.concurrency = DEFAULT_CONCURRENCY;
+    bench.requests = DEFAULT_REQUESTS;
+
+    ogs_getopt_init(&options, (char**)argv);
+    while ((opt = ogs_getopt(&options, "p:e:c:n:a:P:h")) != -1) {
+        switch (opt) {
+        case 'p':
+            optarg.payload = options.optarg;
+            break;
+        case 'e':
+            optarg.engine = options.optarg;
+            break;
+        case 'c':
+            bench.concurrency = atoi(options.optarg);
+            break;
+        case 'n':
+            bench.requests = atoi(options.optarg);
+            break;
+        case 'a':
+            optarg.address = options.optarg;
+            break;
+        case 'P':
+            optarg.port = atoi(options.optarg);
+            break;
+        case 'h':
+            usage(argv[0]);
+            return OGS_OK;
+        case '?':
+            fprintf(stderr, "%s: %s\n", argv[0], options.errmsg);
+            usage(argv[0]);
+            return OGS_ERROR;
+        default:
+            fprintf(stderr, "%s: should not be reached\n", OGS_FUNC);
+            return OGS_ERROR;
+        }
+    }
+
+    if (bench.concurrency <= 0 || bench.requests <= 0) {
+        fprintf(stderr, "%s: invalid concurrency or requests\n", argv[0]);
+        return OGS_ERROR;
+    }
+
+    for (i = 0; i < MAX_NUM_OF_BENCH_PAYLOAD; i++)
+        if (!strcmp(optarg.payload, bench_payload_name[i]))
+            break;
+    if (i == MAX_NUM_OF_BENCH_PAYLOAD && strcmp(optarg.payload, "all")) {
+        fprintf(stderr, "%s: unknown payload `%s`\n",
+                argv[0], optarg.payload);
+        return OGS_ERROR;
+    }
+
+    if (strcmp(optarg.engine, "curl") && strcmp(optarg.engine, "nghttp2")) {
+        fprintf(stderr, "%s: unknown engine `%s`\n", argv[0], optarg.engine);
+        return OGS_ERROR;
+    }
+
+    ogs_core_initialize();
+    ogs_app_context_init();
+    ogs_app_config_init();
+    ogs_app_global_conf_prepare();
+
+    /* No configuration file : only the SBI deadline is needed */
+    ogs_local_conf()->time.message.sbi.connection_deadline =
+        ogs_time_from_sec(10);
+
+    ogs_pkbuf_default_create(&ogs_global_conf()->pkbuf_config);
+
+    ogs_app()->queue = ogs_queue_create(ogs_app()->pool.event);
+    ogs_assert(ogs_app()->queue);
+    ogs_app()->timer_mgr = ogs_timer_mgr_create(ogs_app()->pool.timer);
+    ogs_assert(ogs_app()->timer_mgr);
+    ogs_app()->pollset = ogs_pollset_create(ogs_app()->pool.socket);
+    ogs_assert(ogs_app()->pollset);
+
+    ogs_sbi_context_init(OpenAPI_nf_type_NRF);
+
+    if (!strcmp(optarg.engine, "nghttp2"))
+        ogs_sbi_self()->client_engine = OGS_SBI_CLIENT_ENGINE_NGHTTP2;
+
+    rv = ogs_getaddrinfo(&addr, AF_UNSPEC, optarg.address, optarg.port, 0);
+    ogs_assert(rv == OGS_OK);
+
+    server = ogs_sbi_server_add(NULL, OpenAPI_uri_scheme_http, addr, NULL);
+    ogs_assert(server);
+    ogs_assert(OGS_OK == ogs_sbi_server_start_all(ogs_sbi_server_handler));
+
+    bench.client = ogs_sbi_client_add(
+            OpenAPI_uri_scheme_http, NULL, 0, addr, NULL);
+    ogs_assert(bench.client);
+
+    ogs_freeaddrinfo(addr);
+
+    bench.slot = ogs_calloc(bench.concurrency, sizeof(bench_slot_t));
+    ogs_assert(bench.slot);
+    bench.latency = ogs_calloc(bench.requests, sizeof(ogs_time_t));
+    ogs_assert(bench.latency);
+
+    printf("%-4s %-8s %6s %8s %10s %10s %10s %10s %6s\n",
+            "api", "engine", "conc", "requests",
+            "req/s", "p50(ms)", "p99(ms)", "alloc/req", "failed");
+
+    rv = OGS_OK;
+
+    for (i = 0; i < MAX_NUM_OF_BENCH_PAYLOAD; i++) {
+        if (strcmp(optarg.payload, "all") &&
+            strcmp(optarg.payload, bench_payload_name[i]))
+            continue;
+
+        run(i);
+        if (bench.failed)
+            rv = OGS_ERROR;
+    }
+
+    ogs_free(bench.slot);
+    ogs_free(bench.latency);
+
+    ogs_sbi_client_stop_all();
+    ogs_sbi_server_stop_all();
+
+    ogs_sbi_context_final();
+
+    ogs_app_config_final();
+    ogs_app_context_final();
+
+    ogs_pkbuf_default_destroy();
+
+    ogs_core_terminate();
+
+    return rv == OGS_OK ? 0 : 1;
+}
@@ -248,7 +248,7 @@ void testngap_handle_initial_context_setup_request(
                 }
             }
 
-            ogs_asn_free(
+            ogs_asn_free_decoded(
                     &asn_DEF_NGAP_PDUSessionResourceSetupRequestTransfer,
                     &n2sm_message);
 
@@ -435,7 +435,7 @@ void testngap_handle_pdu_session_resource_setup_request(
                 }
             }
 
-            ogs_asn_free(
+            ogs_asn_free_decoded(
                     &asn_DEF_NGAP_PDUSessionResourceSetupRequestTransfer,
                     &n2sm_message);
 
@@ -541,7 +541,7 @@ void testngap_handle_pdu_session_resource_modify_request(
                     }
                 }
 
-                ogs_asn_free(
+                ogs_asn_free_decoded(
                         &asn_DEF_NGAP_PDUSessionResourceModifyRequestTransfer,
                         &n2sm_message);
 
@@ -672,7 +672,7 @@ void testngap_handle_handover_request(
                 }
             }
 
-            ogs_asn_free(
+            ogs_asn_free_decoded(
                     &asn_DEF_NGAP_PDUSessionResourceSetupRequestTransfer,
                     &n2sm_message);
 
@@ -778,7 +778,7 @@ void testngap_handle_handover_command(
                 }
             }
 
-            ogs_asn_free(
+            ogs_asn_free_decoded(
                     &asn_DEF_NGAP_HandoverCommandTransfer,
                     &n2sm_message);
 
@@ -35,6 +35,7 @@ abts_suite *test_socket(abts_suite *suite);
 abts_suite *test_queue(abts_suite *suite);
 abts_suite *test_poll(abts_suite *suite);
 abts_suite *test_tlv(abts_suite *suite);
+abts_suite *test_tlv_msg(abts_suite *suite);
 abts_suite *test_fsm(abts_suite *suite);
 abts_suite *test_hash(abts_suite *suite);
 abts_suite *test_uuid(abts_suite *suite);
@@ -57,6 +58,7 @@ const struct testlist {
     {test_queue},
     {test_poll},
     {test_tlv},
+    {test_tlv_msg},
     {test_fsm},
     {test_hash},
     {test_uuid},
@@ -74,6 +74,160 @@ static void test4_func(abts_case *tc, void *data)
 #endif
 }
 
+#if OGS_USE_TALLOC == 1
+static void *test5_ptr[16];
+
+static void test5_thread(void *data)
+{
+    int i;
+
+    for (i = 0; i < OGS_ARRAY_SIZE(test5_ptr); i++) {
+        test5_ptr[i] = ogs_strdup("thread");
+        ogs_assert(test5_ptr[i]);
+    }
+}
+#endif
+
+static void test5_func(abts_case *tc, void *data)
+{
+#if OGS_USE_TALLOC == 1
+    ogs_thread_t *thread;
+    int i;
+
+    thread = ogs_thread_create(test5_thread, NULL);
+    ABTS_PTR_NOTNULL(tc, thread);
+    ogs_thread_destroy(thread);
+
+    /* Freed by another thread than the one it was allocated from */
+    for (i = 0; i < OGS_ARRAY_SIZE(test5_ptr); i++) {
+        ABTS_STR_EQUAL(tc, "thread", test5_ptr[i]);
+        ogs_free(test5_ptr[i]);
+    }
+#endif
+}
+
+static void test6_func(abts_case *tc, void *data)
+{
+#if OGS_USE_TALLOC == 1
+    ogs_mem_arena_t *arena = NULL, *prev = NULL;
+    char *p, *q, *r;
+    size_t size;
+
+    size = talloc_total_size(__ogs_talloc_core);
+
+    arena = ogs_mem_arena_create("test");
+    ABTS_PTR_NOTNULL(tc, arena);
+
+    prev = ogs_mem_arena_switch(arena);
+    ABTS_PTR_EQUAL(tc, NULL, prev);
+
+    p = ogs_malloc(128);
+    ABTS_PTR_NOTNULL(tc, p);
+    q = ogs_msprintf("%d-%s", 1, "arena");
+    ABTS_PTR_NOTNULL(tc, q);
+    q = ogs_mstrcatf(q, "-%d", 2);
+    ABTS_STR_EQUAL(tc, "1-arena-2", q);
+
+    prev = ogs_mem_arena_switch(prev);
+    ABTS_PTR_EQUAL(tc, arena, prev);
+
+    r = ogs_realloc(p, 256);
+    ABTS_PTR_NOTNULL(tc, r);
+    ABTS_TRUE(tc, talloc_total_size(__ogs_talloc_core) > size);
+
+    /* Free a single chunk, and release the others at once */
+    ogs_free(q);
+    ogs_mem_arena_destroy(arena);
+
+    ABTS_INT_EQUAL(tc, size, talloc_total_size(__ogs_talloc_core));
+#endif
+}
+
+#if OGS_USE_TALLOC == 1
+static char *test7_parent;
+static char *test7_child;
+
+static void test7_thread(void *data)
+{
+    test7_child = ogs_talloc_strdup(test7_parent, "child");
+    ogs_assert(test7_child);
+}
+#endif
+
+static void test7_func(abts_case *tc, void *data)
+{
+#if OGS_USE_TALLOC == 1
+    ogs_thread_t *thread;
+    void *pool;
+    char *p;
+    size_t size;
+
+    size = talloc_total_size(__ogs_talloc_core);
+
+    /* Child allocated by another thread stays in the arena of its parent */
+    test7_parent = ogs_strdup("parent");
+    ABTS_PTR_NOTNULL(tc, test7_parent);
+
+    thread = ogs_thread_create(test7_thread, NULL);
+    ABTS_PTR_NOTNULL(tc, thread);
+    ogs_thread_destroy(thread);
+
+    ABTS_STR_EQUAL(tc, "child", test7_child);
+    ABTS_TRUE(tc, talloc_total_size(__ogs_talloc_core) > size);
+
+    ogs_free(test7_parent);
+    ABTS_INT_EQUAL(tc, size, talloc_total_size(__ogs_talloc_core));
+
+    /* Raw talloc context */
+    pool = talloc_pool(__ogs_talloc_core, 1024);
+    ABTS_PTR_NOTNULL(tc, pool);
+    p = ogs_talloc_strdup(pool, "pool");
+    ABTS_STR_EQUAL(tc, "pool", p);
+    ogs_talloc_free(p, OGS_FILE_LINE);
+    talloc_free(pool);
+
+    ABTS_INT_EQUAL(tc, size, talloc_total_size(__ogs_talloc_core));
+#endif
+}
+
+static void test8_func(abts_case *tc, void *data)
+{
+#if OGS_USE_TALLOC == 1
+    ogs_mem_arena_t *arena = NULL, *prev = NULL;
+    uint64_t num_of_alloc;
+    char *p;
+    size_t size;
+
+    size = talloc_total_size(__ogs_talloc_core);
+    num_of_alloc = ogs_mem_num_of_alloc();
+
+    arena = ogs_mem_arena_create_pool("test", 1024);
+    ABTS_PTR_NOTNULL(tc, arena);
+
+    prev = ogs_mem_arena_switch(arena);
+    p = ogs_strdup("pool");
+    ABTS_STR_EQUAL(tc, "pool", p);
+    ogs_mem_arena_switch(prev);
+
+    ogs_mem_arena_destroy(arena);
+    ABTS_INT_EQUAL(tc, size, talloc_total_size(__ogs_talloc_core));
+
+    /* The pooled arena is recycled, not allocated again */
+    ABTS_PTR_EQUAL(tc, arena, ogs_mem_arena_create_pool("test", 1024));
+
+    prev = ogs_mem_arena_switch(arena);
+    p = ogs_strdup("pool");
+    ABTS_STR_EQUAL(tc, "pool", p);
+    ogs_mem_arena_switch(prev);
+
+    ogs_mem_arena_destroy(arena);
+    ABTS_INT_EQUAL(tc, size, talloc_total_size(__ogs_talloc_core));
+
+    /* The arena once, and each chunk carved from the pool */
+    ABTS_INT_EQUAL(tc, 3, ogs_mem_num_of_alloc() - num_of_alloc);
+#endif
+}
+
 abts_suite *test_memory(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -82,6 +236,10 @@ abts_suite *test_memory(abts_suite *suite)
     abts_run_test(suite, test2_func, NULL);
     abts_run_test(suite, test3_func, NULL);
     abts_run_test(suite, test4_func, NULL);
+    abts_run_test(suite, test5_func, NULL);
+    abts_run_test(suite, test6_func, NULL);
+    abts_run_test(suite, test7_func, NULL);
+    abts_run_test(suite, test8_func, NULL);
 
     return suite;
 }
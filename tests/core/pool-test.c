@@ -228,6 +228,71 @@ static void test3_func(abts_case *tc, void *data)
     ogs_pool_final(&testpool);
 }
 
+typedef struct {
+    char data[1024];
+} bignode_t;
+
+#define SIZE_OF_BIGPOOL 1024
+
+static OGS_POOL(bigpool, bignode_t);
+
+static void test4_stat(const ogs_pool_stat_t *stat, void *data)
+{
+    int *found = data;
+
+    if (stat->name && !strcmp(stat->name, "&bigpool")) {
+        (*found)++;
+        ogs_assert(stat->size == SIZE_OF_BIGPOOL);
+        ogs_assert(stat->used == 1);
+        ogs_assert(stat->high_water == 3);
+        ogs_assert(stat->failed == 0);
+    }
+}
+
+static void test4_func(abts_case *tc, void *data)
+{
+    bignode_t *node[SIZE_OF_BIGPOOL+1];
+    int i, found = 0;
+
+    /* Large enough to be reserved with a mapping */
+    ogs_pool_init(&bigpool, SIZE_OF_BIGPOOL);
+
+    ogs_pool_alloc(&bigpool, &node[0]);
+    ogs_pool_alloc(&bigpool, &node[1]);
+    ogs_pool_alloc(&bigpool, &node[2]);
+    ABTS_INT_EQUAL(tc, 3, ogs_pool_high_water(&bigpool));
+    ogs_pool_free(&bigpool, node[1]);
+    ogs_pool_free(&bigpool, node[2]);
+    ABTS_INT_EQUAL(tc, 3, ogs_pool_high_water(&bigpool));
+
+    ogs_pool_stat_foreach(test4_stat, &found);
+    ABTS_INT_EQUAL(tc, 1, found);
+
+    /* Fresh nodes are handed out before the released ones */
+    for (i = 1; i < SIZE_OF_BIGPOOL; i++) {
+        ogs_pool_alloc(&bigpool, &node[i]);
+        ABTS_PTR_NOTNULL(tc, node[i]);
+        memset(node[i], 0xff, sizeof(*node[i]));
+    }
+    ABTS_INT_EQUAL(tc, 4, ogs_pool_index(&bigpool, node[1]));
+    ABTS_INT_EQUAL(tc, 2, ogs_pool_index(&bigpool, node[SIZE_OF_BIGPOOL-2]));
+    ABTS_INT_EQUAL(tc, 3, ogs_pool_index(&bigpool, node[SIZE_OF_BIGPOOL-1]));
+    ABTS_INT_EQUAL(tc, SIZE_OF_BIGPOOL, ogs_pool_high_water(&bigpool));
+
+    ogs_pool_alloc(&bigpool, &node[SIZE_OF_BIGPOOL]);
+    ABTS_PTR_EQUAL(tc, NULL, node[SIZE_OF_BIGPOOL]);
+    ABTS_INT_EQUAL(tc, 1, ogs_pool_failed(&bigpool));
+
+    for (i = 0; i < SIZE_OF_BIGPOOL; i++)
+        ogs_pool_free(&bigpool, node[i]);
+
+    ogs_pool_final(&bigpool);
+
+    found = 0;
+    ogs_pool_stat_foreach(test4_stat, &found);
+    ABTS_INT_EQUAL(tc, 0, found);
+}
+
 abts_suite *test_pool(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -235,6 +300,7 @@ abts_suite *test_pool(abts_suite *suite)
     abts_run_test(suite, test1_func, NULL);
     abts_run_test(suite, test2_func, NULL);
     abts_run_test(suite, test3_func, NULL);
+    abts_run_test(suite, test4_func, NULL);
 
     return suite;
 }
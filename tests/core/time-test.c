@@ -100,6 +100,60 @@ static void test_imp_gmt(abts_case *tc, void *data)
     ABTS_TRUE(tc, now == imp);
 }
 
+static void coarse_thread_main(void *data)
+{
+    int *fresh = data;
+    ogs_time_t now, monotonic;
+
+    /* No pollset : every call reads the clock */
+    now = ogs_time_now_coarse();
+    monotonic = ogs_monotonic_coarse();
+    ogs_usleep(1000);
+    *fresh = now < ogs_time_now_coarse() &&
+        monotonic < ogs_monotonic_coarse();
+}
+
+static void test_coarse(abts_case *tc, void *data)
+{
+    ogs_thread_t *thread;
+    int fresh = 0;
+
+    ogs_time_t before, after, now, monotonic;
+
+    before = ogs_time_now();
+    ogs_time_update();
+    after = ogs_time_now();
+
+    now = ogs_time_now_coarse();
+    ABTS_TRUE(tc, before <= now && now <= after);
+    monotonic = ogs_monotonic_coarse();
+    ABTS_TRUE(tc, monotonic <= ogs_get_monotonic_time());
+
+    /* The cached value does not move until the next update */
+    ogs_usleep(1000);
+    ABTS_TRUE(tc, now == ogs_time_now_coarse());
+    ABTS_TRUE(tc, monotonic == ogs_monotonic_coarse());
+
+    ogs_time_update();
+    ABTS_TRUE(tc, now < ogs_time_now_coarse());
+    ABTS_TRUE(tc, monotonic < ogs_monotonic_coarse());
+
+    /* Read lazily on the first call after invalidation */
+    now = ogs_time_now_coarse();
+    ogs_usleep(1000);
+    ogs_time_invalidate();
+    ogs_usleep(1000);
+    ABTS_TRUE(tc, now < ogs_time_now_coarse());
+    now = ogs_time_now_coarse();
+    ogs_usleep(1000);
+    ABTS_TRUE(tc, now == ogs_time_now_coarse());
+
+    thread = ogs_thread_create(coarse_thread_main, &fresh);
+    ABTS_PTR_NOTNULL(tc, thread);
+    ogs_thread_destroy(thread);
+    ABTS_INT_EQUAL(tc, 1, fresh);
+}
+
 abts_suite *test_time(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -109,6 +163,7 @@ abts_suite *test_time(abts_suite *suite)
     abts_run_test(suite, test_get_gmt, NULL);
     abts_run_test(suite, test_get_lt, NULL);
     abts_run_test(suite, test_imp_gmt, NULL);
+    abts_run_test(suite, test_coarse, NULL);
 
     return suite;
 }
@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-core.h"
+#include "core/abts.h"
+
+/*
+ * A GTPv2-like message (OGS_TLV_MODE_T1_L2_I1)
+ *
+ * U8 (T:1,I:0), U8 (T:1,I:1),
+ * up to 3 x Group (T:10) of { U16 (T:2), STR (T:3), Inner (T:11) of
+ * { U32 (T:5) } }, FIXED (T:7, 4 octets), BIG (T:6)
+ */
+typedef struct test_tlv_inner_s {
+    ogs_tlv_presence_t presence;
+    ogs_tlv_uint32_t u32;
+} test_tlv_inner_t;
+
+typedef struct test_tlv_group_s {
+    ogs_tlv_presence_t presence;
+    ogs_tlv_uint16_t u16;
+    ogs_tlv_octet_t str;
+    test_tlv_inner_t inner;
+} test_tlv_group_t;
+
+typedef struct test_tlv_msg_s {
+    ogs_tlv_uint8_t u8_0;
+    ogs_tlv_uint8_t u8_1;
+    test_tlv_group_t group[3];
+    ogs_tlv_octet_t fixed;
+    ogs_tlv_octet_t big;
+} test_tlv_msg_t;
+
+static ogs_tlv_desc_t desc_u8_0 = {
+    OGS_TLV_UINT8, "U8", 1, 1, 0, sizeof(ogs_tlv_uint8_t), { NULL } };
+static ogs_tlv_desc_t desc_u8_1 = {
+    OGS_TLV_UINT8, "U8", 1, 1, 1, sizeof(ogs_tlv_uint8_t), { NULL } };
+static ogs_tlv_desc_t desc_u16 = {
+    OGS_TLV_UINT16, "U16", 2, 2, 0, sizeof(ogs_tlv_uint16_t), { NULL } };
+static ogs_tlv_desc_t desc_str = {
+    OGS_TLV_VAR_STR, "STR", 3, 0, 0, sizeof(ogs_tlv_octet_t), { NULL } };
+static ogs_tlv_desc_t desc_u32 = {
+    OGS_TLV_UINT32, "U32", 5, 4, 0, sizeof(ogs_tlv_uint32_t), { NULL } };
+static ogs_tlv_desc_t desc_big = {
+    OGS_TLV_VAR_STR, "BIG", 6, 0, 0, sizeof(ogs_tlv_octet_t), { NULL } };
+static ogs_tlv_desc_t desc_fixed = {
+    OGS_TLV_FIXED_STR, "FIXED", 7, 4, 0, sizeof(ogs_tlv_octet_t), { NULL } };
+static ogs_tlv_desc_t desc_inner = {
+    OGS_TLV_COMPOUND, "Inner", 11, 0, 0, sizeof(test_tlv_inner_t), {
+        &desc_u32,
+        NULL,
+    }
+};
+static ogs_tlv_desc_t desc_group = {
+    OGS_TLV_COMPOUND, "Group", 10, 0, 0, sizeof(test_tlv_group_t), {
+        &desc_u16,
+        &desc_str,
+        &desc_inner,
+        NULL,
+    }
+};
+static ogs_tlv_desc_t desc_msg = {
+    OGS_TLV_MESSAGE, "Message", 0, 0, 0, 0, {
+        &desc_u8_0,
+        &desc_u8_1,
+        &desc_group, &ogs_tlv_desc_more3,
+        &desc_fixed,
+        &desc_big,
+        NULL,
+    }
+};
+
+#define TEST_BIG_LEN 300
+
+static uint8_t test_msg_encoded[] = {
+    0x01, 0x00, 0x01, 0x00, 0x11,
+    0x01, 0x00, 0x01, 0x01, 0x22,
+    0x0a, 0x00, 0x18, 0x00,
+        0x02, 0x00, 0x02, 0x00, 0x01, 0x02,
+        0x03, 0x00, 0x02, 0x00, 'a', 'b',
+        0x0b, 0x00, 0x08, 0x00,
+            0x05, 0x00, 0x04, 0x00, 0x0a, 0x0b, 0x0c, 0x0d,
+    0x0a, 0x00, 0x06, 0x00,
+        0x02, 0x00, 0x02, 0x00, 0x03, 0x04,
+    0x07, 0x00, 0x04, 0x00, 0xde, 0xad, 0xbe, 0xef,
+    0x06, 0x01, 0x2c, 0x00, /* TEST_BIG_LEN octets of 0x5a follow */
+};
+
+static uint8_t test_fixed[4] = { 0xde, 0xad, 0xbe, 0xef };
+static uint8_t test_big[TEST_BIG_LEN];
+
+static void test_msg_fill(test_tlv_msg_t *msg)
+{
+    memset(msg, 0, sizeof(*msg));
+
+    msg->u8_0.presence = 1;
+    msg->u8_0.u8 = 0x11;
+    msg->u8_1.presence = 1;
+    msg->u8_1.u8 = 0x22;
+
+    msg->group[0].presence = 1;
+    msg->group[0].u16.presence = 1;
+    msg->group[0].u16.u16 = 0x0102;
+    msg->group[0].str.presence = 1;
+    msg->group[0].str.data = (char *)"ab";
+    msg->group[0].str.len = 2;
+    msg->group[0].inner.presence = 1;
+    msg->group[0].inner.u32.presence = 1;
+    msg->group[0].inner.u32.u32 = 0x0a0b0c0d;
+
+    msg->group[1].presence = 1;
+    msg->group[1].u16.presence = 1;
+    msg->group[1].u16.u16 = 0x0304;
+
+    msg->fixed.presence = 1;
+    msg->fixed.data = test_fixed;
+    msg->fixed.len = sizeof(test_fixed);
+
+    memset(test_big, 0x5a, sizeof(test_big));
+    msg->big.presence = 1;
+    msg->big.data = test_big;
+    msg->big.len = sizeof(test_big);
+}
+
+static ogs_pkbuf_t *test_pkbuf(const uint8_t *data, int len)
+{
+    ogs_pkbuf_t *pkbuf = ogs_pkbuf_alloc(NULL, len);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_put_data(pkbuf, data, len);
+    return pkbuf;
+}
+
+static void test1_func(abts_case *tc, void *data)
+{
+    test_tlv_msg_t msg;
+    ogs_pkbuf_t *pkbuf;
+    int len = sizeof(test_msg_encoded);
+
+    test_msg_fill(&msg);
+
+    pkbuf = ogs_tlv_build_msg(&desc_msg, &msg, OGS_TLV_MODE_T1_L2_I1);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+    ABTS_INT_EQUAL(tc, len + TEST_BIG_LEN, pkbuf->len);
+    ABTS_TRUE(tc, memcmp(pkbuf->data, test_msg_encoded, len) == 0);
+    ABTS_TRUE(tc, memcmp(pkbuf->data + len, test_big, TEST_BIG_LEN) == 0);
+
+    /* Nothing of the caller's message is changed by the encoder */
+    ABTS_INT_EQUAL(tc, 0x0102, msg.group[0].u16.u16);
+    ABTS_INT_EQUAL(tc, 0x0a0b0c0d, msg.group[0].inner.u32.u32);
+
+    ogs_pkbuf_free(pkbuf);
+}
+
+static void test2_func(abts_case *tc, void *data)
+{
+    test_tlv_msg_t msg;
+    ogs_pkbuf_t *pkbuf;
+    int rv, len = sizeof(test_msg_encoded);
+
+    memset(test_big, 0x5a, sizeof(test_big));
+    pkbuf = ogs_pkbuf_alloc(NULL, len + TEST_BIG_LEN);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_put_data(pkbuf, test_msg_encoded, len);
+    ogs_pkbuf_put_data(pkbuf, test_big, TEST_BIG_LEN);
+
+    memset(&msg, 0, sizeof(msg));
+    rv = ogs_tlv_parse_msg(&msg, &desc_msg, pkbuf, OGS_TLV_MODE_T1_L2_I1);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    /* Instances of the same type */
+    ABTS_INT_EQUAL(tc, 1, msg.u8_0.presence);
+    ABTS_INT_EQUAL(tc, 0x11, msg.u8_0.u8);
+    ABTS_INT_EQUAL(tc, 1, msg.u8_1.presence);
+    ABTS_INT_EQUAL(tc, 0x22, msg.u8_1.u8);
+
+    /* Repeated and nested groups */
+    ABTS_INT_EQUAL(tc, 1, msg.group[0].presence);
+    ABTS_INT_EQUAL(tc, 0x0102, msg.group[0].u16.u16);
+    ABTS_INT_EQUAL(tc, 2, msg.group[0].str.len);
+    ABTS_TRUE(tc, memcmp(msg.group[0].str.data, "ab", 2) == 0);
+    ABTS_INT_EQUAL(tc, 1, msg.group[0].inner.presence);
+    ABTS_INT_EQUAL(tc, 1, msg.group[0].inner.u32.presence);
+    ABTS_INT_EQUAL(tc, 0x0a0b0c0d, msg.group[0].inner.u32.u32);
+
+    ABTS_INT_EQUAL(tc, 1, msg.group[1].presence);
+    ABTS_INT_EQUAL(tc, 0x0304, msg.group[1].u16.u16);
+    ABTS_INT_EQUAL(tc, 0, msg.group[1].str.presence);
+    ABTS_INT_EQUAL(tc, 0, msg.group[1].inner.presence);
+
+    ABTS_INT_EQUAL(tc, 0, msg.group[2].presence);
+
+    ABTS_INT_EQUAL(tc, 4, msg.fixed.len);
+    ABTS_TRUE(tc, memcmp(msg.fixed.data, test_fixed, 4) == 0);
+
+    /* Two-octet length */
+    ABTS_INT_EQUAL(tc, TEST_BIG_LEN, msg.big.len);
+    ABTS_TRUE(tc, memcmp(msg.big.data, test_big, TEST_BIG_LEN) == 0);
+
+    ogs_pkbuf_free(pkbuf);
+}
+
+/*
+ * A PFCP-like message (OGS_TLV_MODE_T2_L2)
+ *
+ * U16 (T:275), up to 2 x Group (T:1) of { U32 (T:2), NULL (T:3) },
+ * STR (T:32769)
+ */
+typedef struct test_tlv_pgroup_s {
+    ogs_tlv_presence_t presence;
+    ogs_tlv_uint32_t u32;
+    ogs_tlv_null_t null;
+} test_tlv_pgroup_t;
+
+typedef struct test_tlv_pmsg_s {
+    ogs_tlv_uint16_t u16;
+    test_tlv_pgroup_t group[2];
+    ogs_tlv_octet_t str;
+} test_tlv_pmsg_t;
+
+static ogs_tlv_desc_t desc_p_u16 = {
+    OGS_TLV_UINT16, "U16", 275, 2, 0, sizeof(ogs_tlv_uint16_t), { NULL } };
+static ogs_tlv_desc_t desc_p_u32 = {
+    OGS_TLV_UINT32, "U32", 2, 4, 0, sizeof(ogs_tlv_uint32_t), { NULL } };
+static ogs_tlv_desc_t desc_p_null = {
+    OGS_TLV_NULL, "NULL", 3, 0, 0, sizeof(ogs_tlv_null_t), { NULL } };
+static ogs_tlv_desc_t desc_p_str = {
+    OGS_TLV_VAR_STR, "STR", 32769, 0, 0, sizeof(ogs_tlv_octet_t), { NULL } };
+static ogs_tlv_desc_t desc_p_group = {
+    OGS_TLV_COMPOUND, "Group", 1, 0, 0, sizeof(test_tlv_pgroup_t), {
+        &desc_p_u32,
+        &desc_p_null,
+        NULL,
+    }
+};
+static ogs_tlv_desc_t desc_pmsg = {
+    OGS_TLV_MESSAGE, "Message", 0, 0, 0, 0, {
+        &desc_p_u16,
+        &desc_p_group, &ogs_tlv_desc_more2,
+        &desc_p_str,
+        NULL,
+    }
+};
+
+static uint8_t test_pmsg_encoded[] = {
+    0x01, 0x13, 0x00, 0x02, 0xab, 0xcd,
+    0x00, 0x01, 0x00, 0x08,
+        0x00, 0x02, 0x00, 0x04, 0x01, 0x02, 0x03, 0x04,
+    0x00, 0x01, 0x00, 0x0c,
+        0x00, 0x02, 0x00, 0x04, 0x05, 0x06, 0x07, 0x08,
+        0x00, 0x03, 0x00, 0x00,
+    0x80, 0x01, 0x00, 0x03, 'x', 'y', 'z',
+};
+
+static void test3_func(abts_case *tc, void *data)
+{
+    test_tlv_pmsg_t msg;
+    ogs_pkbuf_t *pkbuf;
+    int rv;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.u16.presence = 1;
+    msg.u16.u16 = 0xabcd;
+    msg.group[0].presence = 1;
+    msg.group[0].u32.presence = 1;
+    msg.group[0].u32.u32 = 0x01020304;
+    msg.group[1].presence = 1;
+    msg.group[1].u32.presence = 1;
+    msg.group[1].u32.u32 = 0x05060708;
+    msg.group[1].null.presence = 1;
+    msg.str.presence = 1;
+    msg.str.data = (char *)"xyz";
+    msg.str.len = 3;
+
+    pkbuf = ogs_tlv_build_msg(&desc_pmsg, &msg, OGS_TLV_MODE_T2_L2);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+    ABTS_INT_EQUAL(tc, sizeof(test_pmsg_encoded), pkbuf->len);
+    ABTS_TRUE(tc, memcmp(pkbuf->data,
+                test_pmsg_encoded, sizeof(test_pmsg_encoded)) == 0);
+    ogs_pkbuf_free(pkbuf);
+
+    pkbuf = test_pkbuf(test_pmsg_encoded, sizeof(test_pmsg_encoded));
+    memset(&msg, 0, sizeof(msg));
+    rv = ogs_tlv_parse_msg(&msg, &desc_pmsg, pkbuf, OGS_TLV_MODE_T2_L2);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 0xabcd, msg.u16.u16);
+    ABTS_INT_EQUAL(tc, 0x01020304, msg.group[0].u32.u32);
+    ABTS_INT_EQUAL(tc, 0, msg.group[0].null.presence);
+    ABTS_INT_EQUAL(tc, 0x05060708, msg.group[1].u32.u32);
+    ABTS_INT_EQUAL(tc, 1, msg.group[1].null.presence);
+    ABTS_INT_EQUAL(tc, 3, msg.str.len);
+    ABTS_TRUE(tc, memcmp(msg.str.data, "xyz", 3) == 0);
+    ogs_pkbuf_free(pkbuf);
+}
+
+static int test_parse(
+        ogs_tlv_desc_t *desc, void *msg, int size, int mode,
+        const uint8_t *data, int len)
+{
+    ogs_pkbuf_t *pkbuf = test_pkbuf(data, len);
+    int rv;
+
+    memset(msg, 0, size);
+    rv = ogs_tlv_parse_msg(msg, desc, pkbuf, mode);
+    ogs_pkbuf_free(pkbuf);
+
+    return rv;
+}
+
+static void test4_func(abts_case *tc, void *data)
+{
+    test_tlv_msg_t msg;
+    test_tlv_pmsg_t pmsg;
+    ogs_pkbuf_t *pkbuf;
+    ogs_log_level_e level;
+    int rv;
+
+    /* Spare bits of the instance octet are ignored */
+    static const uint8_t spare[] = { 0x01, 0x00, 0x01, 0xf1, 0x22 };
+
+    /* Header cut short */
+    static const uint8_t short_header[] = { 0x01, 0x00, 0x01 };
+    /* Value cut short */
+    static const uint8_t short_value[] = {
+        0x06, 0x00, 0x05, 0x00, 'a', 'b' };
+    /* Child running past the end of its group */
+    static const uint8_t short_group[] = {
+        0x0a, 0x00, 0x05, 0x00,
+            0x02, 0x00, 0x02, 0x00, 0x01, 0x02 };
+    /* Leaf length not allowed by its type */
+    static const uint8_t bad_u8[] = { 0x01, 0x00, 0x02, 0x00, 0x11, 0x22 };
+    static const uint8_t bad_fixed[] = {
+        0x07, 0x00, 0x03, 0x00, 0xde, 0xad, 0xbe };
+    static const uint8_t bad_null[] = {
+        0x00, 0x01, 0x00, 0x05,
+            0x00, 0x03, 0x00, 0x01, 0x00 };
+
+    rv = test_parse(&desc_msg, &msg, sizeof(msg), OGS_TLV_MODE_T1_L2_I1,
+            spare, sizeof(spare));
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_INT_EQUAL(tc, 0, msg.u8_0.presence);
+    ABTS_INT_EQUAL(tc, 1, msg.u8_1.presence);
+    ABTS_INT_EQUAL(tc, 0x22, msg.u8_1.u8);
+
+    level = ogs_log_get_domain_level(OGS_LOG_DOMAIN);
+    ogs_log_set_domain_level(OGS_LOG_DOMAIN, OGS_LOG_FATAL);
+
+    rv = test_parse(&desc_msg, &msg, sizeof(msg), OGS_TLV_MODE_T1_L2_I1,
+            short_header, sizeof(short_header));
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+    rv = test_parse(&desc_msg, &msg, sizeof(msg), OGS_TLV_MODE_T1_L2_I1,
+            short_value, sizeof(short_value));
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+    rv = test_parse(&desc_msg, &msg, sizeof(msg), OGS_TLV_MODE_T1_L2_I1,
+            short_group, sizeof(short_group));
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+    rv = test_parse(&desc_msg, &msg, sizeof(msg), OGS_TLV_MODE_T1_L2_I1,
+            bad_u8, sizeof(bad_u8));
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+    rv = test_parse(&desc_msg, &msg, sizeof(msg), OGS_TLV_MODE_T1_L2_I1,
+            bad_fixed, sizeof(bad_fixed));
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+    rv = test_parse(&desc_pmsg, &pmsg, sizeof(pmsg), OGS_TLV_MODE_T2_L2,
+            bad_null, sizeof(bad_null));
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+
+    /* Every prefix of a valid message is rejected */
+    for (rv = 1; rv < sizeof(test_pmsg_encoded); rv++) {
+        if (rv == 6 || rv == 18 || rv == 34)
+            continue; /* These end on an IE boundary */
+        ABTS_INT_EQUAL(tc, OGS_ERROR, test_parse(
+                    &desc_pmsg, &pmsg, sizeof(pmsg), OGS_TLV_MODE_T2_L2,
+                    test_pmsg_encoded, rv));
+    }
+
+    /* A variable-length IE cannot be encoded empty */
+    test_msg_fill(&msg);
+    msg.group[0].str.len = 0;
+    pkbuf = ogs_tlv_build_msg(&desc_msg, &msg, OGS_TLV_MODE_T1_L2_I1);
+    ABTS_PTR_EQUAL(tc, NULL, pkbuf);
+
+    ogs_log_set_domain_level(OGS_LOG_DOMAIN, level);
+}
+
+abts_suite *test_tlv_msg(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, test1_func, NULL);
+    abts_run_test(suite, test2_func, NULL);
+    abts_run_test(suite, test3_func, NULL);
+    abts_run_test(suite, test4_func, NULL);
+
+    return suite;
+}
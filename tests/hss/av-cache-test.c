@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hss/hss-context.h"
+#include "core/abts.h"
+
+#define AV_TEST_IMSI1 "999700000077001"
+#define AV_TEST_IMSI2 "999700000077002"
+#define AV_TEST_IMSI_UNKNOWN "999700000077099"
+
+#define AV_TEST_K "465B5CE8B199B49FAA5F0A2EE238A6BC"
+#define AV_TEST_OPC "E8ED289DEBA952E4283B54E88E6183CA"
+
+#define AV_TEST_DEPTH 4
+#define AV_TEST_GETS 16
+
+static int subscriber_insert(char *imsi_bcd, int64_t sqn)
+{
+    int rv;
+    ogs_mongoc_client_t client;
+    bson_t *key = NULL, *doc = NULL;
+    bson_error_t error;
+
+    rv = ogs_mongoc_client_pop(&client);
+    if (rv != OGS_OK)
+        return rv;
+
+    key = BCON_NEW("imsi", BCON_UTF8(imsi_bcd));
+    ogs_assert(key);
+    mongoc_collection_remove(client.subscriber,
+            MONGOC_REMOVE_NONE, key, NULL, &error);
+    bson_destroy(key);
+
+    doc = BCON_NEW(
+            "imsi", BCON_UTF8(imsi_bcd),
+            "security", "{",
+                "k", BCON_UTF8(AV_TEST_K),
+                "opc", BCON_UTF8(AV_TEST_OPC),
+                "amf", BCON_UTF8("8000"),
+                "sqn", BCON_INT64(sqn),
+            "}");
+    ogs_assert(doc);
+    if (mongoc_collection_insert(client.subscriber,
+                MONGOC_INSERT_NONE, doc, NULL, &error) != true) {
+        ogs_error("mongoc_collection_insert() failed: %s", error.message);
+        rv = OGS_ERROR;
+    }
+    bson_destroy(doc);
+
+    ogs_mongoc_client_push(&client);
+
+    return rv;
+}
+
+static uint64_t db_sqn(abts_case *tc, char *imsi_bcd)
+{
+    int rv;
+    ogs_dbi_auth_info_t auth_info;
+
+    memset(&auth_info, 0, sizeof(auth_info));
+    rv = hss_db_auth_info(imsi_bcd, &auth_info);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    return auth_info.sqn;
+}
+
+/* As stored, before hss_db_auth_info() reduces it to 48 bits */
+static int64_t db_stored_sqn(char *imsi_bcd)
+{
+    ogs_mongoc_client_t client;
+    mongoc_cursor_t *cursor = NULL;
+    const bson_t *doc = NULL;
+    bson_t *query = NULL;
+    bson_iter_t iter, child_iter;
+    int64_t sqn = -1;
+
+    if (ogs_mongoc_client_pop(&client) != OGS_OK)
+        return -1;
+
+    query = BCON_NEW("imsi", BCON_UTF8(imsi_bcd));
+    ogs_assert(query);
+    cursor = mongoc_collection_find_with_opts(
+            client.subscriber, query, NULL, NULL);
+    ogs_assert(cursor);
+
+    if (mongoc_cursor_next(cursor, &doc) &&
+        bson_iter_init(&iter, doc) &&
+        bson_iter_find_descendant(&iter, "security.sqn", &child_iter))
+        sqn = bson_iter_as_int64(&child_iter);
+
+    mongoc_cursor_destroy(cursor);
+    bson_destroy(query);
+
+    ogs_mongoc_client_push(&client);
+
+    return sqn;
+}
+
+static uint64_t av_sqn(hss_auth_vector_t *av)
+{
+    return ogs_buffer_to_uint64(av->sqn, OGS_SQN_LEN);
+}
+
+/* The vector must still match its own RAND once served from the cache */
+static void check_xres(abts_case *tc, hss_auth_vector_t *av)
+{
+    uint8_t k[OGS_KEY_LEN], opc[OGS_KEY_LEN];
+    uint8_t xres[OGS_MAX_RES_LEN];
+
+    ogs_hex_from_string(AV_TEST_K, k, sizeof(k));
+    ogs_hex_from_string(AV_TEST_OPC, opc, sizeof(opc));
+
+    milenage_f2345(opc, k, av->rand, xres, NULL, NULL, NULL, NULL);
+    ABTS_INT_EQUAL(tc, 8, av->xres_len);
+    ABTS_TRUE(tc, memcmp(xres, av->xres, av->xres_len) == 0);
+}
+
+/* RAND || AUTS of a synchronization failure reporting 'sqn_ms' */
+static void build_resync(uint8_t *rand, uint64_t sqn_ms, uint8_t *resync)
+{
+    uint8_t k[OGS_KEY_LEN], opc[OGS_KEY_LEN];
+    uint8_t sqn[OGS_SQN_LEN], akstar[OGS_AK_LEN];
+    uint8_t amf[OGS_AMF_LEN] = { 0, 0 };
+    uint8_t *auts = resync + OGS_RAND_LEN;
+    int i;
+
+    ogs_hex_from_string(AV_TEST_K, k, sizeof(k));
+    ogs_hex_from_string(AV_TEST_OPC, opc, sizeof(opc));
+
+    memcpy(resync, rand, OGS_RAND_LEN);
+
+    milenage_f2345(opc, k, rand, NULL, NULL, NULL, NULL, akstar);
+    ogs_uint64_to_buffer(sqn_ms, OGS_SQN_LEN, sqn);
+    milenage_f1(opc, k, rand, sqn, amf, NULL, auts + OGS_SQN_LEN);
+    for (i = 0; i < OGS_SQN_LEN; i++)
+        auts[i] = sqn[i] ^ akstar[i];
+}
+
+static void av_cache_test1(abts_case *tc, void *data)
+{
+    int rv, i;
+    hss_auth_vector_t av;
+
+    rv = subscriber_insert(AV_TEST_IMSI1, 64);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    /* Depth 1 : one vector and one SQN update per request */
+    hss_self()->auth_vector_depth = 1;
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 64);
+    ABTS_TRUE(tc, db_sqn(tc, AV_TEST_IMSI1) == 96);
+    check_xres(tc, &av);
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 96);
+    ABTS_TRUE(tc, db_sqn(tc, AV_TEST_IMSI1) == 128);
+
+    /* Depth N : the first request reserves N SQNs at once */
+    hss_self()->auth_vector_depth = AV_TEST_DEPTH;
+
+    for (i = 0; i < AV_TEST_DEPTH; i++) {
+        rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+        ABTS_INT_EQUAL(tc, OGS_OK, rv);
+        ABTS_TRUE(tc, av_sqn(&av) == 128 + 32 * i);
+        ABTS_TRUE(tc,
+            db_sqn(tc, AV_TEST_IMSI1) == 128 + 32 * AV_TEST_DEPTH);
+        check_xres(tc, &av);
+    }
+
+    /* The cache is used up : the next range is reserved */
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 128 + 32 * AV_TEST_DEPTH);
+    ABTS_TRUE(tc, db_sqn(tc, AV_TEST_IMSI1) == 128 + 64 * AV_TEST_DEPTH);
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI_UNKNOWN, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_NOTFOUND, rv);
+
+    hss_auth_vector_flush(AV_TEST_IMSI1);
+    hss_self()->auth_vector_depth = 1;
+}
+
+static void av_cache_test2(abts_case *tc, void *data)
+{
+    int rv;
+    hss_auth_vector_t av;
+    uint8_t resync[OGS_RAND_LEN + OGS_AUTS_LEN];
+
+    hss_self()->auth_vector_depth = AV_TEST_DEPTH;
+
+    rv = subscriber_insert(AV_TEST_IMSI1, 64);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 64);
+
+    /* A flush (Cx/SWx, DB change) drops the rest of the range */
+    hss_auth_vector_flush(AV_TEST_IMSI1);
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 64 + 32 * AV_TEST_DEPTH);
+
+    /* Synchronization failure : restart from SQN_MS + IND + 1 */
+    build_resync(av.rand, 1000, resync);
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, resync, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 1033);
+    ABTS_TRUE(tc, db_sqn(tc, AV_TEST_IMSI1) == 1033 + 32 * AV_TEST_DEPTH);
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 1065);
+
+    /* A broken AUTS fails and drops the cached vectors */
+    build_resync(av.rand, 2000, resync);
+    resync[OGS_RAND_LEN + OGS_AUTS_LEN - 1] ^= 0x01;
+
+    ogs_log_set_domain_level(__hss_log_domain, OGS_LOG_FATAL);
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, resync, &av);
+    ogs_log_set_domain_level(__hss_log_domain, ogs_core()->log.level);
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 1033 + 32 * AV_TEST_DEPTH);
+
+    hss_auth_vector_flush(AV_TEST_IMSI1);
+    hss_self()->auth_vector_depth = 1;
+}
+
+typedef struct av_thread_s {
+    char *imsi_bcd;
+    int rv;
+    uint64_t sqn[AV_TEST_GETS];
+} av_thread_t;
+
+static void av_thread_main(void *data)
+{
+    av_thread_t *t = data;
+    hss_auth_vector_t av;
+    int i;
+
+    for (i = 0; i < AV_TEST_GETS; i++) {
+        t->rv = hss_auth_vector_get(t->imsi_bcd, NULL, &av);
+        if (t->rv != OGS_OK)
+            return;
+        t->sqn[i] = av_sqn(&av);
+    }
+}
+
+static void av_cache_test3(abts_case *tc, void *data)
+{
+    int rv, i, j, n;
+    av_thread_t t[4];
+    ogs_thread_t *thread[4];
+    bool seen[2 * AV_TEST_GETS];
+
+    hss_self()->auth_vector_depth = AV_TEST_DEPTH;
+
+    rv = subscriber_insert(AV_TEST_IMSI1, 64);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    rv = subscriber_insert(AV_TEST_IMSI2, 64);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    /* Two threads per IMSI */
+    memset(t, 0, sizeof(t));
+    for (i = 0; i < 4; i++) {
+        t[i].imsi_bcd = i < 2 ? AV_TEST_IMSI1 : AV_TEST_IMSI2;
+        thread[i] = ogs_thread_create(av_thread_main, &t[i]);
+        ABTS_PTR_NOTNULL(tc, thread[i]);
+    }
+    for (i = 0; i < 4; i++)
+        ogs_thread_destroy(thread[i]);
+
+    for (n = 0; n < 2; n++) {
+        /*
+         * Every SQN is handed out once, and no range is reserved
+         * without being used : requests of one IMSI are serialized.
+         */
+        memset(seen, 0, sizeof(seen));
+        for (i = 2 * n; i < 2 * n + 2; i++) {
+            ABTS_INT_EQUAL(tc, OGS_OK, t[i].rv);
+            for (j = 0; j < AV_TEST_GETS; j++) {
+                int slot = (t[i].sqn[j] - 64) / 32;
+
+                ABTS_TRUE(tc, slot >= 0 && slot < 2 * AV_TEST_GETS);
+                if (slot < 0 || slot >= 2 * AV_TEST_GETS)
+                    continue;
+                ABTS_TRUE(tc, seen[slot] == false);
+                seen[slot] = true;
+
+                /* Each thread sees its SQNs in increasing order */
+                if (j > 0)
+                    ABTS_TRUE(tc, t[i].sqn[j] > t[i].sqn[j-1]);
+            }
+        }
+
+        ABTS_TRUE(tc, db_sqn(tc, n == 0 ? AV_TEST_IMSI1 : AV_TEST_IMSI2) ==
+                64 + 32 * 2 * AV_TEST_GETS);
+    }
+
+    hss_auth_vector_flush(AV_TEST_IMSI1);
+    hss_auth_vector_flush(AV_TEST_IMSI2);
+    hss_self()->auth_vector_depth = 1;
+}
+
+static void av_cache_test4(abts_case *tc, void *data)
+{
+    int rv, result_code;
+    hss_auth_vector_t av;
+    ogs_dbi_auth_info_t auth_info;
+    uint8_t opc[OGS_KEY_LEN];
+    uint8_t resync[OGS_RAND_LEN + OGS_AUTS_LEN];
+
+    hss_self()->auth_vector_depth = AV_TEST_DEPTH;
+
+    rv = subscriber_insert(AV_TEST_IMSI1, 64);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 64);
+
+    /* A MAR takes the next SQN and drops the vectors cached for S6a */
+    result_code = hss_mar_auth_info(AV_TEST_IMSI1, NULL, &auth_info, opc);
+    ABTS_INT_EQUAL(tc, ER_DIAMETER_SUCCESS, result_code);
+    ABTS_TRUE(tc, auth_info.sqn == 64 + 32 * AV_TEST_DEPTH);
+    ABTS_TRUE(tc, db_sqn(tc, AV_TEST_IMSI1) == 96 + 32 * AV_TEST_DEPTH);
+
+    rv = hss_auth_vector_get(AV_TEST_IMSI1, NULL, &av);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_TRUE(tc, av_sqn(&av) == 96 + 32 * AV_TEST_DEPTH);
+
+    /* Synchronization failure : restart from SQN_MS + IND + 1 */
+    build_resync(av.rand, 1000, resync);
+
+    result_code = hss_mar_auth_info(AV_TEST_IMSI1, resync, &auth_info, opc);
+    ABTS_INT_EQUAL(tc, ER_DIAMETER_SUCCESS, result_code);
+    ABTS_TRUE(tc, auth_info.sqn == 1033);
+    ABTS_TRUE(tc, db_sqn(tc, AV_TEST_IMSI1) == 1065);
+
+    resync[OGS_RAND_LEN + OGS_AUTS_LEN - 1] ^= 0x01;
+
+    ogs_log_set_domain_level(__hss_log_domain, OGS_LOG_FATAL);
+    result_code = hss_mar_auth_info(AV_TEST_IMSI1, resync, &auth_info, opc);
+    ABTS_INT_EQUAL(tc,
+            OGS_DIAM_CX_ERROR_AUTH_SCHEME_NOT_SUPPORTED, result_code);
+    result_code = hss_mar_auth_info(
+            AV_TEST_IMSI_UNKNOWN, NULL, &auth_info, opc);
+    ABTS_INT_EQUAL(tc, OGS_DIAM_CX_ERROR_USER_UNKNOWN, result_code);
+    ogs_log_set_domain_level(__hss_log_domain, ogs_core()->log.level);
+
+    /* The stored SQN wraps at 48 bits */
+    rv = subscriber_insert(AV_TEST_IMSI1, OGS_MAX_SQN - 15);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    result_code = hss_mar_auth_info(AV_TEST_IMSI1, NULL, &auth_info, opc);
+    ABTS_INT_EQUAL(tc, ER_DIAMETER_SUCCESS, result_code);
+    ABTS_TRUE(tc, auth_info.sqn == OGS_MAX_SQN - 15);
+    ABTS_TRUE(tc, db_stored_sqn(AV_TEST_IMSI1) == 16);
+
+    hss_auth_vector_flush(AV_TEST_IMSI1);
+    hss_self()->auth_vector_depth = 1;
+}
+
+abts_suite *test_av_cache(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, av_cache_test1, NULL);
+    abts_run_test(suite, av_cache_test2, NULL);
+    abts_run_test(suite, av_cache_test3, NULL);
+    abts_run_test(suite, av_cache_test4, NULL);
+
+    return suite;
+}
@@ -29,6 +29,9 @@
 #define TEST4_PORT 7741
 #define TEST5_PORT 7751
 #define TEST5_PORT2 7752
+#define TEST6_PORT 7761
+#define TEST6_NUM 8
+#define TEST7_PORT 7771
 #define PPID 12345
 
 #ifndef AI_PASSIVE
@@ -320,6 +323,149 @@ static void test5_func(abts_case *tc, void *data)
     ABTS_INT_EQUAL(tc, OGS_OK, rv);
 }
 
+static ogs_thread_t *test6_thread;
+static void test6_main(void *data)
+{
+    abts_case *tc = data;
+    int rv, i;
+    ogs_sock_t *sctp;
+    char str[STRLEN];
+    ssize_t size;
+    ogs_sctp_info_t sinfo;
+    ogs_sockaddr_t *addr;
+    ogs_sockaddr_t from;
+
+    rv = ogs_getaddrinfo(&addr, AF_UNSPEC, NULL, TEST6_PORT, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    sctp = ogs_sctp_client(SOCK_SEQPACKET, addr, NULL, NULL);
+    ABTS_PTR_NOTNULL(tc, sctp);
+
+    /* Sent with a single ogs_sctp_sendpkbufs() : still in order */
+    for (i = 0; i < TEST6_NUM; i++) {
+        size = ogs_sctp_recvdata(sctp, str, STRLEN, &from, &sinfo);
+        ABTS_INT_EQUAL(tc, strlen(DATASTR) + i, size);
+#if !HAVE_USRSCTP
+        ABTS_INT_EQUAL(tc, PPID + i, sinfo.ppid);
+#endif
+    }
+
+    ogs_sctp_destroy(sctp);
+    rv = ogs_freeaddrinfo(addr);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+}
+
+static void test6_func(abts_case *tc, void *data)
+{
+    int rv, i;
+    ogs_sock_t *sctp, *sctp2;
+    ogs_sockaddr_t *addr;
+    ogs_pkbuf_t *pkbuf[TEST6_NUM];
+
+    rv = ogs_getaddrinfo(&addr, AF_INET6, NULL, TEST6_PORT, AI_PASSIVE);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    sctp = ogs_sctp_server(SOCK_STREAM, addr, NULL);
+    ABTS_PTR_NOTNULL(tc, sctp);
+
+    test6_thread = ogs_thread_create(test6_main, tc);
+    ABTS_PTR_NOTNULL(tc, test6_thread);
+
+    sctp2 = ogs_sctp_accept(sctp);
+    ABTS_PTR_NOTNULL(tc, sctp2);
+
+    for (i = 0; i < TEST6_NUM; i++) {
+        pkbuf[i] = ogs_pkbuf_alloc(NULL, STRLEN);
+        ABTS_PTR_NOTNULL(tc, pkbuf[i]);
+        ogs_pkbuf_put_data(pkbuf[i], DATASTR, strlen(DATASTR));
+        memset(ogs_pkbuf_put(pkbuf[i], i), 'x', i);
+
+        ogs_sctp_ppid_in_pkbuf(pkbuf[i]) = PPID + i;
+        ogs_sctp_stream_no_in_pkbuf(pkbuf[i]) = 0;
+    }
+
+    rv = ogs_sctp_sendpkbufs(sctp2, pkbuf, TEST6_NUM, NULL);
+    ABTS_INT_EQUAL(tc, TEST6_NUM, rv);
+
+    for (i = 0; i < TEST6_NUM; i++)
+        ogs_pkbuf_free(pkbuf[i]);
+
+    ogs_thread_destroy(test6_thread);
+
+    ogs_sctp_destroy(sctp2);
+    ogs_sctp_destroy(sctp);
+
+    rv = ogs_freeaddrinfo(addr);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+}
+
+static void test7_func(abts_case *tc, void *data)
+{
+    int rv, i;
+    ogs_sock_t *sctp;
+    ogs_sockaddr_t *addr;
+    ogs_sctp_sock_t assoc;
+    ogs_pkbuf_t *pkbuf, *next_pkbuf;
+
+    /* Nothing polls here, so the queue is never drained */
+    ogs_assert(!ogs_app()->pollset);
+    ogs_app()->pollset = ogs_pollset_create(16);
+    ABTS_PTR_NOTNULL(tc, ogs_app()->pollset);
+
+    rv = ogs_getaddrinfo(&addr, AF_INET, NULL, TEST7_PORT, AI_PASSIVE);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    sctp = ogs_sctp_server(SOCK_STREAM, addr, NULL);
+    ABTS_PTR_NOTNULL(tc, sctp);
+
+    memset(&assoc, 0, sizeof(assoc));
+    assoc.type = SOCK_STREAM;
+    assoc.sock = sctp;
+
+    for (i = 0; i < OGS_SCTP_MAX_WRITE_QUEUE; i++) {
+        pkbuf = ogs_pkbuf_alloc(NULL, strlen(DATASTR));
+        ABTS_PTR_NOTNULL(tc, pkbuf);
+        ogs_pkbuf_put_data(pkbuf, DATASTR, strlen(DATASTR));
+        ogs_sctp_ppid_in_pkbuf(pkbuf) = PPID;
+        ogs_sctp_stream_no_in_pkbuf(pkbuf) = 0;
+
+        rv = ogs_sctp_write_to_buffer(&assoc, pkbuf);
+        ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    }
+    ABTS_INT_EQUAL(tc, OGS_SCTP_MAX_WRITE_QUEUE, assoc.write_queue_depth);
+    ABTS_PTR_NOTNULL(tc, assoc.poll.write);
+
+    /* Past the cap the message is dropped without failing the caller */
+    ogs_log_set_domain_level(__ogs_sctp_domain, OGS_LOG_FATAL);
+    for (i = 0; i < TEST6_NUM; i++) {
+        pkbuf = ogs_pkbuf_alloc(NULL, strlen(DATASTR));
+        ABTS_PTR_NOTNULL(tc, pkbuf);
+        ogs_pkbuf_put_data(pkbuf, DATASTR, strlen(DATASTR));
+        ogs_sctp_ppid_in_pkbuf(pkbuf) = PPID;
+        ogs_sctp_stream_no_in_pkbuf(pkbuf) = 0;
+
+        rv = ogs_sctp_write_to_buffer(&assoc, pkbuf);
+        ABTS_INT_EQUAL(tc, OGS_NOTFOUND, rv);
+    }
+    ogs_log_set_domain_level(__ogs_sctp_domain, OGS_LOG_ERROR);
+
+    ABTS_INT_EQUAL(tc, OGS_SCTP_MAX_WRITE_QUEUE, assoc.write_queue_depth);
+    ABTS_INT_EQUAL(tc, OGS_SCTP_MAX_WRITE_QUEUE, assoc.write_queue_peak);
+    ABTS_INT_EQUAL(tc, OGS_SCTP_MAX_WRITE_QUEUE,
+            ogs_list_count(&assoc.write_queue));
+
+    ogs_pollset_remove(assoc.poll.write);
+    ogs_list_for_each_safe(&assoc.write_queue, next_pkbuf, pkbuf) {
+        ogs_list_remove(&assoc.write_queue, pkbuf);
+        ogs_pkbuf_free(pkbuf);
+    }
+
+    ogs_sctp_destroy(sctp);
+
+    rv = ogs_freeaddrinfo(addr);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    ogs_pollset_destroy(ogs_app()->pollset);
+    ogs_app()->pollset = NULL;
+}
+
 abts_suite *test_sctp(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -329,6 +475,8 @@ abts_suite *test_sctp(abts_suite *suite)
     abts_run_test(suite, test3_func, NULL);
     abts_run_test(suite, test4_func, NULL);
     abts_run_test(suite, test5_func, NULL);
+    abts_run_test(suite, test6_func, NULL);
+    abts_run_test(suite, test7_func, NULL);
 
     return suite;
 }
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "udm/context.h"
+#include "core/abts.h"
+
+abts_suite *test_suci(abts_suite *suite);
+
+const struct testlist {
+    abts_suite *(*func)(abts_suite *suite);
+} alltests[] = {
+    {test_suci},
+    {NULL},
+};
+
+static void terminate(void)
+{
+    udm_context_final();
+    ogs_sbi_context_final();
+
+    ogs_app_terminate();
+}
+
+static void initialize(const char *const argv[])
+{
+    int rv;
+
+    rv = ogs_app_initialize(NULL, DEFAULT_CONFIG_FILENAME, argv);
+    ogs_assert(rv == OGS_OK);
+
+    rv = ogs_app_parse_local_conf("udm");
+    ogs_assert(rv == OGS_OK);
+
+    ogs_sbi_context_init(OpenAPI_nf_type_UDM);
+    udm_context_init();
+
+    /* Home network keys : the UDM thread itself is not started */
+    rv = udm_context_parse_config();
+    ogs_assert(rv == OGS_OK);
+}
+
+int main(int argc, const char *const argv[])
+{
+    int rv, i;
+    const char *argv_out[argc+3]; /* '-e error' is always added */
+
+    abts_suite *suite = NULL;
+
+    rv = abts_main(argc, argv, argv_out);
+    if (rv != OGS_OK) return rv;
+
+    initialize(argv_out);
+    atexit(terminate);
+
+    for (i = 0; alltests[i].func; i++)
+        suite = alltests[i].func(suite);
+
+    return abts_report(suite);
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "udm/suci.h"
+#include "core/abts.h"
+
+/* Profile A and B test vectors, also used by tests/registration/ecc-test.c */
+#define SUCI_PROFILE_A \
+    "suci-0-999-70-0-1-1-" \
+    "b2e92f836055a255837debf850b528997ce0201cb82adfe4be1f587d07d8457d" \
+    "7ee4435e1978dc897bff24129c"
+#define SUCI_PROFILE_B \
+    "suci-0-999-70-0-2-2-" \
+    "039aab8376597021e855679a9778ea0b67396e68c66df32c0f41e9acca2da9b9" \
+    "d1cdd22e34965500e9242e65f58c"
+
+/* Same scheme output as SUCI_PROFILE_A, with a broken MAC tag */
+#define SUCI_BAD_MAC \
+    "suci-0-999-70-0-1-1-" \
+    "b2e92f836055a255837debf850b528997ce0201cb82adfe4be1f587d07d8457d" \
+    "7ee4435e1978dc897bff24129d"
+
+#define SUCI_NULL_SCHEME "suci-0-999-70-0-0-0-0000000001"
+
+static void suci_init(int worker, int cache)
+{
+    udm_self()->suci.worker = worker;
+    udm_self()->suci.cache = cache;
+    udm_suci_init();
+
+    /* A failed de-concealment is expected in these tests */
+    ogs_log_set_domain_level(__ogs_sbi_domain, OGS_LOG_FATAL);
+    ogs_log_set_domain_level(__udm_log_domain, OGS_LOG_FATAL);
+}
+
+static void check_supi(abts_case *tc, char *suci)
+{
+    char *supi1 = NULL, *supi2 = NULL;
+
+    supi1 = udm_supi_from_supi_or_suci(suci);
+    ABTS_PTR_NOTNULL(tc, supi1);
+    supi2 = ogs_supi_from_suci(suci);
+    ABTS_PTR_NOTNULL(tc, supi2);
+    ABTS_STR_EQUAL(tc, supi2, supi1);
+
+    ogs_free(supi1);
+    ogs_free(supi2);
+}
+
+static udm_event_t *pop_event(abts_case *tc)
+{
+    udm_event_t *e = NULL;
+    int rv;
+
+    rv = ogs_queue_timedpop(ogs_app()->queue,
+            (void **)&e, ogs_time_from_sec(5));
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_PTR_NOTNULL(tc, e);
+
+    return e;
+}
+
+static void suci_test1(abts_case *tc, void *data)
+{
+    char *supi = NULL;
+
+    /* No worker, room for two SUCIs */
+    suci_init(0, 2);
+
+    check_supi(tc, (char *)SUCI_PROFILE_A);
+    check_supi(tc, (char *)SUCI_PROFILE_B);
+    ABTS_TRUE(tc, udm_suci_cached((char *)SUCI_PROFILE_A));
+    ABTS_TRUE(tc, udm_suci_cached((char *)SUCI_PROFILE_B));
+
+    /* Profile A becomes the most recently used one */
+    check_supi(tc, (char *)SUCI_PROFILE_A);
+
+    /* A failure takes the place of the least recently used one */
+    supi = udm_supi_from_supi_or_suci((char *)SUCI_BAD_MAC);
+    ABTS_PTR_EQUAL(tc, NULL, supi);
+    ABTS_TRUE(tc, udm_suci_cached((char *)SUCI_BAD_MAC));
+    ABTS_TRUE(tc, udm_suci_cached((char *)SUCI_PROFILE_A));
+    ABTS_TRUE(tc, !udm_suci_cached((char *)SUCI_PROFILE_B));
+
+    /* The null scheme is a copy of the MSIN : never cached */
+    supi = udm_supi_from_supi_or_suci((char *)SUCI_NULL_SCHEME);
+    ABTS_PTR_NOTNULL(tc, supi);
+    ABTS_STR_EQUAL(tc, "imsi-999700000000001", supi);
+    ogs_free(supi);
+    ABTS_TRUE(tc, !udm_suci_cached((char *)SUCI_NULL_SCHEME));
+
+    /* A failure is only remembered for a short time */
+    ogs_msleep(1100);
+    ogs_time_invalidate();
+    ABTS_TRUE(tc, !udm_suci_cached((char *)SUCI_BAD_MAC));
+    ABTS_TRUE(tc, udm_suci_cached((char *)SUCI_PROFILE_A));
+
+    supi = udm_supi_from_supi_or_suci((char *)SUCI_BAD_MAC);
+    ABTS_PTR_EQUAL(tc, NULL, supi);
+    ABTS_TRUE(tc, udm_suci_cached((char *)SUCI_BAD_MAC));
+
+    udm_suci_final();
+}
+
+static void suci_test2(abts_case *tc, void *data)
+{
+    ogs_sbi_request_t *request1 = NULL, *request2 = NULL;
+    udm_event_t *e = NULL;
+    char *supi = NULL;
+    int rv;
+
+    suci_init(2, 4);
+
+    request1 = ogs_sbi_request_new();
+    ABTS_PTR_NOTNULL(tc, request1);
+    request2 = ogs_sbi_request_new();
+    ABTS_PTR_NOTNULL(tc, request2);
+
+    /* Nothing to offload */
+    ABTS_TRUE(tc, !udm_suci_deconceal(
+                (char *)SUCI_NULL_SCHEME, 1, request1));
+
+    /* The second request for the same SUCI waits on the first job */
+    ABTS_TRUE(tc, udm_suci_deconceal((char *)SUCI_PROFILE_A, 1, request1));
+    ABTS_TRUE(tc, udm_suci_deconceal((char *)SUCI_PROFILE_A, 2, request2));
+    ABTS_TRUE(tc, !udm_suci_cached((char *)SUCI_PROFILE_A));
+
+    e = pop_event(tc);
+    ABTS_INT_EQUAL(tc, UDM_EVENT_SUCI_DECONCEALED, e->h.id);
+    udm_suci_handle_deconcealed(e->h.sbi.data);
+    ogs_event_free(e);
+
+    ABTS_TRUE(tc, udm_suci_cached((char *)SUCI_PROFILE_A));
+
+    /* Both requests are dispatched again, in arrival order */
+    e = pop_event(tc);
+    ABTS_INT_EQUAL(tc, OGS_EVENT_SBI_SERVER, e->h.id);
+    ABTS_PTR_EQUAL(tc, request1, e->h.sbi.request);
+    ABTS_INT_EQUAL(tc, 1, OGS_POINTER_TO_UINT(e->h.sbi.data));
+    ogs_event_free(e);
+
+    e = pop_event(tc);
+    ABTS_INT_EQUAL(tc, OGS_EVENT_SBI_SERVER, e->h.id);
+    ABTS_PTR_EQUAL(tc, request2, e->h.sbi.request);
+    ABTS_INT_EQUAL(tc, 2, OGS_POINTER_TO_UINT(e->h.sbi.data));
+    ogs_event_free(e);
+
+    rv = ogs_queue_trypop(ogs_app()->queue, (void **)&e);
+    ABTS_INT_EQUAL(tc, OGS_RETRY, rv);
+
+    /* Dispatched again, they are answered from the cache */
+    ABTS_TRUE(tc, !udm_suci_deconceal((char *)SUCI_PROFILE_A, 1, request1));
+    check_supi(tc, (char *)SUCI_PROFILE_A);
+
+    /* A failure is cached so that the waiters do not loop */
+    ABTS_TRUE(tc, udm_suci_deconceal((char *)SUCI_BAD_MAC, 1, request1));
+
+    e = pop_event(tc);
+    ABTS_INT_EQUAL(tc, UDM_EVENT_SUCI_DECONCEALED, e->h.id);
+    udm_suci_handle_deconcealed(e->h.sbi.data);
+    ogs_event_free(e);
+
+    e = pop_event(tc);
+    ABTS_INT_EQUAL(tc, OGS_EVENT_SBI_SERVER, e->h.id);
+    ABTS_PTR_EQUAL(tc, request1, e->h.sbi.request);
+    ogs_event_free(e);
+
+    ABTS_TRUE(tc, !udm_suci_deconceal((char *)SUCI_BAD_MAC, 1, request1));
+    supi = udm_supi_from_supi_or_suci((char *)SUCI_BAD_MAC);
+    ABTS_PTR_EQUAL(tc, NULL, supi);
+
+    ogs_sbi_request_free(request1);
+    ogs_sbi_request_free(request2);
+
+    udm_suci_final();
+}
+
+abts_suite *test_suci(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, suci_test1, NULL);
+    abts_run_test(suite, suci_test2, NULL);
+
+    return suite;
+}
@@ -17,17 +17,13 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include "ogs-core.h"
+#include "ogs-sbi.h"
 #include "core/abts.h"
 
 extern int __ogs_s1ap_domain;
 extern int __ogs_ngap_domain;
 extern int __ogs_nas_domain;
 extern int __ogs_gtp_domain;
-extern int __ogs_sbi_domain;
-
-void ogs_sbi_message_init(int num_of_request_pool, int num_of_response_pool);
-void ogs_sbi_message_final(void);
 
 abts_suite *test_proto_message(abts_suite *suite);
 abts_suite *test_s1ap_message(abts_suite *suite);
@@ -35,6 +31,7 @@ abts_suite *test_nas_message(abts_suite *suite);
 abts_suite *test_gtp_message(abts_suite *suite);
 abts_suite *test_ngap_message(abts_suite *suite);
 abts_suite *test_sbi_message(abts_suite *suite);
+abts_suite *test_sbi_context(abts_suite *suite);
 abts_suite *test_security(abts_suite *suite);
 abts_suite *test_crash(abts_suite *suite);
 
@@ -47,6 +44,7 @@ const struct testlist {
     {test_gtp_message},
     {test_ngap_message},
     {test_sbi_message},
+    {test_sbi_context},
     {test_security},
     {test_crash},
     {NULL},
@@ -54,7 +52,8 @@ const struct testlist {
 
 static void terminate(void)
 {
-    ogs_sbi_message_final();
+    ogs_sbi_context_final();
+    ogs_app_context_final();
 
     ogs_pkbuf_default_destroy();
 
@@ -100,13 +99,21 @@ int main(int argc, const char *const argv[])
     ogs_pkbuf_default_init(&config);
     ogs_pkbuf_default_create(&config);
 
-    ogs_sbi_message_init(32, 32);
-
     ogs_log_install_domain(&__ogs_s1ap_domain, "s1ap", OGS_LOG_ERROR);
     ogs_log_install_domain(&__ogs_ngap_domain, "ngap", OGS_LOG_ERROR);
     ogs_log_install_domain(&__ogs_nas_domain, "nas", OGS_LOG_ERROR);
     ogs_log_install_domain(&__ogs_gtp_domain, "gtp", OGS_LOG_ERROR);
-    ogs_log_install_domain(&__ogs_sbi_domain, "sbi", OGS_LOG_ERROR);
+
+    /* The SBI context installs the "sbi" log domain by itself */
+    ogs_app_context_init();
+    ogs_app()->pool.message = 32;
+    ogs_app()->pool.event = 32;
+    ogs_app()->pool.stream = 32;
+    ogs_app()->pool.nf = 32;
+    ogs_app()->pool.nf_service = 32;
+    ogs_app()->pool.xact = 32;
+    ogs_app()->pool.subscription = 32;
+    ogs_sbi_context_init(OpenAPI_nf_type_AMF);
 
     atexit(terminate);
 
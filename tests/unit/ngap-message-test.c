@@ -372,6 +372,266 @@ static void ngap_message_test5_issues2934(abts_case *tc, void *data)
     ogs_pkbuf_free(ngapbuf);
 }
 
+static ogs_pkbuf_t *build_paging(ogs_5gs_tai_t *nr_tai,
+        uint16_t amf_set_id, uint8_t amf_pointer, uint32_t m_tmsi)
+{
+    NGAP_NGAP_PDU_t pdu;
+    NGAP_InitiatingMessage_t *initiatingMessage = NULL;
+    NGAP_Paging_t *Paging = NULL;
+
+    NGAP_PagingIEs_t *ie = NULL;
+
+    NGAP_UEPagingIdentity_t *UEPagingIdentity = NULL;
+    NGAP_FiveG_S_TMSI_t *fiveG_S_TMSI = NULL;
+    NGAP_AMFSetID_t *aMFSetID = NULL;
+    NGAP_AMFPointer_t *aMFPointer = NULL;
+    NGAP_FiveG_TMSI_t *fiveG_TMSI = NULL;
+    NGAP_TAIListForPaging_t *TAIList = NULL;
+    NGAP_TAIListForPagingItem_t *TAIItem = NULL;
+    NGAP_TAI_t *tAI = NULL;
+
+    ogs_assert(nr_tai);
+
+    memset(&pdu, 0, sizeof (NGAP_NGAP_PDU_t));
+    pdu.present = NGAP_NGAP_PDU_PR_initiatingMessage;
+    pdu.choice.initiatingMessage = CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
+
+    initiatingMessage = pdu.choice.initiatingMessage;
+    initiatingMessage->procedureCode = NGAP_ProcedureCode_id_Paging;
+    initiatingMessage->criticality = NGAP_Criticality_ignore;
+    initiatingMessage->value.present = NGAP_InitiatingMessage__value_PR_Paging;
+
+    Paging = &initiatingMessage->value.choice.Paging;
+
+    ie = CALLOC(1, sizeof(NGAP_PagingIEs_t));
+    ASN_SEQUENCE_ADD(&Paging->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_UEPagingIdentity;
+    ie->criticality = NGAP_Criticality_ignore;
+    ie->value.present = NGAP_PagingIEs__value_PR_UEPagingIdentity;
+
+    UEPagingIdentity = &ie->value.choice.UEPagingIdentity;
+
+    UEPagingIdentity->present = NGAP_UEPagingIdentity_PR_fiveG_S_TMSI;
+    UEPagingIdentity->choice.fiveG_S_TMSI = fiveG_S_TMSI =
+        CALLOC(1, sizeof(NGAP_FiveG_S_TMSI_t));
+    ogs_assert(fiveG_S_TMSI);
+
+    aMFSetID = &fiveG_S_TMSI->aMFSetID;
+    aMFPointer = &fiveG_S_TMSI->aMFPointer;
+    fiveG_TMSI = &fiveG_S_TMSI->fiveG_TMSI;
+
+    ogs_ngap_uint16_to_AMFSetID(amf_set_id, aMFSetID);
+    ogs_ngap_uint8_to_AMFPointer(amf_pointer, aMFPointer);
+    ogs_asn_uint32_to_OCTET_STRING(m_tmsi, fiveG_TMSI);
+
+    ie = CALLOC(1, sizeof(NGAP_PagingIEs_t));
+    ASN_SEQUENCE_ADD(&Paging->protocolIEs, ie);
+
+    ie->id = NGAP_ProtocolIE_ID_id_TAIListForPaging;
+    ie->criticality = NGAP_Criticality_ignore;
+    ie->value.present = NGAP_PagingIEs__value_PR_TAIListForPaging;
+
+    TAIList = &ie->value.choice.TAIListForPaging;
+
+    TAIItem = CALLOC(1, sizeof(NGAP_TAIListForPagingItem_t));
+    ASN_SEQUENCE_ADD(&TAIList->list, TAIItem);
+
+    tAI = &TAIItem->tAI;
+    ogs_ngap_5gs_tai_to_ASN(nr_tai, tAI);
+
+    return ogs_ngap_encode(&pdu);
+}
+
+static void ngap_message_test6(abts_case *tc, void *data)
+{
+    ogs_asn_template_t tmpl;
+    ogs_5gs_tai_t tai;
+    ogs_pkbuf_t *expected = NULL, *pkbuf = NULL;
+    uint64_t value[3];
+    int rv, i;
+
+    memset(&tai, 0, sizeof(tai));
+    ogs_plmn_id_build(&tai.plmn_id, 999, 70, 2);
+    tai.tac.v = 0x123456;
+
+    rv = ogs_asn_template_init(&tmpl, build_paging(&tai, 0, 0, 0));
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    rv = ogs_asn_template_add_field(&tmpl, build_paging(&tai, 0x3ff, 0, 0), 10);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    rv = ogs_asn_template_add_field(&tmpl, build_paging(&tai, 0, 0x3f, 0), 6);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    rv = ogs_asn_template_add_field(
+            &tmpl, build_paging(&tai, 0, 0, 0xffffffff), 32);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    for (i = 0; i < 1000; i++) {
+        ogs_random(value, sizeof(value));
+        value[0] &= 0x3ff;
+        value[1] &= 0x3f;
+        value[2] &= 0xffffffff;
+
+        pkbuf = ogs_asn_template_build(&tmpl, value);
+        ABTS_PTR_NOTNULL(tc, pkbuf);
+        expected = build_paging(&tai, value[0], value[1], value[2]);
+        ABTS_PTR_NOTNULL(tc, expected);
+
+        ABTS_INT_EQUAL(tc, expected->len, pkbuf->len);
+        ABTS_TRUE(tc, memcmp(expected->data, pkbuf->data, pkbuf->len) == 0);
+
+        ogs_pkbuf_free(expected);
+        ogs_pkbuf_free(pkbuf);
+    }
+
+    /* The field must not change the length of the PDU */
+    rv = ogs_asn_template_add_field(&tmpl, build_paging(&tai, 0, 0, 0), 8);
+    ABTS_INT_EQUAL(tc, OGS_ERROR, rv);
+
+    ogs_asn_template_final(&tmpl);
+}
+
+static void ngap_message_test7(abts_case *tc, void *data)
+{
+    /* 5GMM Status */
+    const char *payload =
+        "7e005c00 0d0199f9 07f0ff00 00000020"
+        "3190";
+
+    NGAP_NAS_PDU_t NAS_PDU[OGS_ASN_MAX_ADOPTED_PKBUF+1];
+    ogs_asn_adopted_t list1, list2;
+    ogs_pkbuf_t *gmmbuf = NULL, *copied = NULL, *adopted = NULL;
+    char hexbuf[OGS_HUGE_LEN];
+    int i;
+
+    ogs_hex_from_string(payload, hexbuf, sizeof(hexbuf));
+    memset(NAS_PDU, 0, sizeof(NAS_PDU));
+    memset(&list1, 0, sizeof(list1));
+    memset(&list2, 0, sizeof(list2));
+
+    /* Adopting the NAS PDU encodes the same as copying it */
+    ogs_asn_buffer_to_OCTET_STRING(hexbuf, 18, &NAS_PDU[0]);
+    copied = ogs_asn_encode(&asn_DEF_NGAP_NAS_PDU, &NAS_PDU[0]);
+    ABTS_PTR_NOTNULL(tc, copied);
+
+    gmmbuf = ogs_pkbuf_alloc(NULL, 18);
+    ogs_assert(gmmbuf);
+    ogs_pkbuf_put_data(gmmbuf, hexbuf, 18);
+
+    ogs_asn_pkbuf_to_OCTET_STRING(&list1, gmmbuf, &NAS_PDU[0]);
+    ABTS_PTR_EQUAL(tc, gmmbuf->data, NAS_PDU[0].buf);
+    ABTS_INT_EQUAL(tc, 1, list1.num);
+
+    /* A second PDU built meanwhile is encoded on its own */
+    gmmbuf = ogs_pkbuf_alloc(NULL, 18);
+    ogs_assert(gmmbuf);
+    ogs_pkbuf_put_data(gmmbuf, hexbuf, 18);
+
+    ogs_asn_pkbuf_to_OCTET_STRING(&list2, gmmbuf, &NAS_PDU[1]);
+    adopted = ogs_asn_encode_adopted(
+            &asn_DEF_NGAP_NAS_PDU, &NAS_PDU[1], &list2);
+    ABTS_PTR_NOTNULL(tc, adopted);
+    ABTS_PTR_EQUAL(tc, NULL, NAS_PDU[1].buf);
+    ABTS_INT_EQUAL(tc, 0, list2.num);
+    ogs_pkbuf_free(adopted);
+
+    ABTS_INT_EQUAL(tc, 18, NAS_PDU[0].size);
+    ABTS_TRUE(tc, memcmp(NAS_PDU[0].buf, hexbuf, 18) == 0);
+
+    adopted = ogs_asn_encode_adopted(
+            &asn_DEF_NGAP_NAS_PDU, &NAS_PDU[0], &list1);
+    ABTS_PTR_NOTNULL(tc, adopted);
+    ABTS_PTR_EQUAL(tc, NULL, NAS_PDU[0].buf);
+    ABTS_INT_EQUAL(tc, 0, list1.num);
+    ABTS_INT_EQUAL(tc, copied->len, adopted->len);
+    ABTS_TRUE(tc, memcmp(copied->data, adopted->data, copied->len) == 0);
+
+    ogs_pkbuf_free(copied);
+    ogs_pkbuf_free(adopted);
+
+    /* Once the list is full, the NAS PDU is copied */
+    for (i = 0; i < OGS_ASN_MAX_ADOPTED_PKBUF+1; i++) {
+        gmmbuf = ogs_pkbuf_alloc(NULL, 18);
+        ogs_assert(gmmbuf);
+        ogs_pkbuf_put_data(gmmbuf, hexbuf, 18);
+
+        ogs_asn_pkbuf_to_OCTET_STRING(&list1, gmmbuf, &NAS_PDU[i]);
+    }
+    ABTS_INT_EQUAL(tc, OGS_ASN_MAX_ADOPTED_PKBUF, list1.num);
+
+    for (i = 0; i < OGS_ASN_MAX_ADOPTED_PKBUF+1; i++) {
+        ABTS_INT_EQUAL(tc, 18, NAS_PDU[i].size);
+        ABTS_TRUE(tc, memcmp(NAS_PDU[i].buf, hexbuf, 18) == 0);
+    }
+
+    /* A builder giving up releases the list before freeing the PDU */
+    ogs_asn_adopted_release(&list1);
+    for (i = 0; i < OGS_ASN_MAX_ADOPTED_PKBUF; i++)
+        ABTS_PTR_EQUAL(tc, NULL, NAS_PDU[i].buf);
+    ABTS_PTR_NOTNULL(tc, NAS_PDU[OGS_ASN_MAX_ADOPTED_PKBUF].buf);
+
+    for (i = 0; i < OGS_ASN_MAX_ADOPTED_PKBUF+1; i++)
+        ogs_asn_free(&asn_DEF_NGAP_NAS_PDU, &NAS_PDU[i]);
+}
+
+static void ngap_message_test8(abts_case *tc, void *data)
+{
+    /* NGReset */
+    const char *payload = "0014001300000200 0f400200c0005800 06400160010001";
+
+    /* One more than the decode arenas of a thread */
+    ogs_ngap_message_t message[9];
+    ogs_pkbuf_t *pkbuf;
+    char hexbuf[OGS_HUGE_LEN];
+    size_t size;
+    int i, rv;
+
+    pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_put_data(pkbuf,
+            ogs_hex_from_string(payload, hexbuf, sizeof(hexbuf)), 23);
+
+    /* Once the arenas are used up, the message is still decoded */
+    for (i = 0; i < 9; i++) {
+        rv = ogs_ngap_decode(&message[i], pkbuf);
+        ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    }
+
+    /*
+     * A PDU built in a structure whose decoded tree was just freed
+     * is released by walking it, without touching the other arenas
+     */
+    ogs_ngap_free(&message[0]);
+    size = talloc_total_size(__ogs_talloc_core);
+
+    message[0].present = NGAP_NGAP_PDU_PR_initiatingMessage;
+    message[0].choice.initiatingMessage =
+        CALLOC(1, sizeof(NGAP_InitiatingMessage_t));
+    ogs_assert(message[0].choice.initiatingMessage);
+    message[0].choice.initiatingMessage->procedureCode =
+        NGAP_ProcedureCode_id_NGReset;
+    ogs_ngap_free(&message[0]);
+
+    ABTS_INT_EQUAL(tc, size, talloc_total_size(__ogs_talloc_core));
+
+    for (i = 1; i < 9; i++) {
+        ABTS_INT_EQUAL(tc,
+                NGAP_NGAP_PDU_PR_initiatingMessage, message[i].present);
+        ABTS_INT_EQUAL(tc, NGAP_ProcedureCode_id_NGReset,
+                message[i].choice.initiatingMessage->procedureCode);
+        ogs_ngap_free(&message[i]);
+    }
+
+    /* The arenas are free again */
+    for (i = 0; i < 8; i++) {
+        rv = ogs_ngap_decode(&message[i], pkbuf);
+        ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    }
+    for (i = 0; i < 8; i++)
+        ogs_ngap_free(&message[i]);
+
+    ogs_pkbuf_free(pkbuf);
+}
+
 abts_suite *test_ngap_message(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -383,6 +643,9 @@ abts_suite *test_ngap_message(abts_suite *suite)
     abts_run_test(suite, ngap_message_test3, NULL);
     abts_run_test(suite, ngap_message_test4, NULL);
     abts_run_test(suite, ngap_message_test5_issues2934, NULL);
+    abts_run_test(suite, ngap_message_test6, NULL);
+    abts_run_test(suite, ngap_message_test7, NULL);
+    abts_run_test(suite, ngap_message_test8, NULL);
 
     return suite;
 }
@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-sbi.h"
+#include "core/abts.h"
+
+static int count_nf_type(OpenAPI_nf_type_e nf_type,
+        ogs_sbi_nf_instance_t *nf_instance, bool *found)
+{
+    ogs_sbi_nf_type_node_t *node = NULL;
+    int count = 0;
+
+    *found = false;
+    ogs_list_for_each(ogs_sbi_nf_instance_type_list(nf_type), node) {
+        if (node->nf_instance == nf_instance)
+            *found = true;
+        count++;
+    }
+
+    return count;
+}
+
+static ogs_sbi_nf_instance_t *add_registered_nf_instance(
+        char *id, OpenAPI_nf_type_e nf_type)
+{
+    ogs_sbi_nf_instance_t *nf_instance = NULL;
+
+    nf_instance = ogs_sbi_nf_instance_add();
+    ogs_assert(nf_instance);
+    ogs_sbi_nf_instance_set_id(nf_instance, id);
+    ogs_sbi_nf_instance_set_type(nf_instance, nf_type);
+
+    /* The cache only hands out instances the NRF reported as registered */
+    OGS_FSM_TRAN(&nf_instance->sm, ogs_sbi_nf_state_registered);
+
+    return nf_instance;
+}
+
+static ogs_sbi_discovery_option_t *discovery_option_for(
+        char *service_name1, char *service_name2,
+        ogs_s_nssai_t *s_nssai1, ogs_s_nssai_t *s_nssai2)
+{
+    ogs_sbi_discovery_option_t *discovery_option = NULL;
+
+    discovery_option = ogs_sbi_discovery_option_new();
+    ogs_assert(discovery_option);
+
+    ogs_sbi_discovery_option_add_service_names(
+            discovery_option, service_name1);
+    ogs_sbi_discovery_option_add_service_names(
+            discovery_option, service_name2);
+    ogs_sbi_discovery_option_add_snssais(discovery_option, s_nssai1);
+    ogs_sbi_discovery_option_add_snssais(discovery_option, s_nssai2);
+
+    return discovery_option;
+}
+
+static void sbi_context_test1(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *a = NULL, *b = NULL, *c = NULL;
+    ogs_sbi_discovery_option_t *discovery_option = NULL;
+    bool found;
+
+    a = ogs_sbi_nf_instance_add();
+    ABTS_PTR_NOTNULL(tc, a);
+    ogs_sbi_nf_instance_set_id(a, (char *)"nf-instance-a");
+    ogs_sbi_nf_instance_set_type(a, OpenAPI_nf_type_SMF);
+
+    b = ogs_sbi_nf_instance_add();
+    ABTS_PTR_NOTNULL(tc, b);
+    ogs_sbi_nf_instance_set_id(b, (char *)"nf-instance-b");
+    ogs_sbi_nf_instance_set_type(b, OpenAPI_nf_type_SMF);
+
+    c = ogs_sbi_nf_instance_add();
+    ABTS_PTR_NOTNULL(tc, c);
+    ogs_sbi_nf_instance_set_id(c, (char *)"nf-instance-c");
+    ogs_sbi_nf_instance_set_type(c, OpenAPI_nf_type_UDM);
+
+    /* Lookup by ID */
+    ABTS_PTR_EQUAL(tc, a, ogs_sbi_nf_instance_find((char *)"nf-instance-a"));
+    ABTS_PTR_EQUAL(tc, b, ogs_sbi_nf_instance_find((char *)"nf-instance-b"));
+    ABTS_PTR_EQUAL(tc, c, ogs_sbi_nf_instance_find((char *)"nf-instance-c"));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_nf_instance_find((char *)"unknown"));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_nf_instance_find(NULL));
+
+    /* Lookup by NF type */
+    ABTS_INT_EQUAL(tc, 2, count_nf_type(OpenAPI_nf_type_SMF, a, &found));
+    ABTS_TRUE(tc, found);
+    ABTS_INT_EQUAL(tc, 2, count_nf_type(OpenAPI_nf_type_SMF, b, &found));
+    ABTS_TRUE(tc, found);
+    ABTS_INT_EQUAL(tc, 1, count_nf_type(OpenAPI_nf_type_UDM, c, &found));
+    ABTS_TRUE(tc, found);
+    ABTS_INT_EQUAL(tc, 0, count_nf_type(OpenAPI_nf_type_PCF, a, &found));
+
+    /* Discovery walks the type list in insertion order */
+    ABTS_PTR_EQUAL(tc, a, ogs_sbi_nf_instance_find_by_discovery_param(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, NULL));
+
+    /* A specific NF instance is looked up by ID only */
+    discovery_option = ogs_sbi_discovery_option_new();
+    ABTS_PTR_NOTNULL(tc, discovery_option);
+    ogs_sbi_discovery_option_set_target_nf_instance_id(
+            discovery_option, (char *)"nf-instance-b");
+    ABTS_PTR_EQUAL(tc, b, ogs_sbi_nf_instance_find_by_discovery_param(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, discovery_option));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_nf_instance_find_by_discovery_param(
+                OpenAPI_nf_type_UDM, OpenAPI_nf_type_AMF, discovery_option));
+    ogs_sbi_discovery_option_free(discovery_option);
+
+    /* Type change moves the instance to the other list */
+    ogs_sbi_nf_instance_set_type(c, OpenAPI_nf_type_SMF);
+    ABTS_INT_EQUAL(tc, 3, count_nf_type(OpenAPI_nf_type_SMF, c, &found));
+    ABTS_TRUE(tc, found);
+    ABTS_INT_EQUAL(tc, 0, count_nf_type(OpenAPI_nf_type_UDM, c, &found));
+
+    /* Removal */
+    ogs_sbi_nf_instance_remove(a);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_nf_instance_find((char *)"nf-instance-a"));
+    ABTS_INT_EQUAL(tc, 2, count_nf_type(OpenAPI_nf_type_SMF, b, &found));
+    ABTS_TRUE(tc, found);
+
+    ogs_sbi_nf_instance_remove(b);
+    ogs_sbi_nf_instance_remove(c);
+    ABTS_INT_EQUAL(tc, 0, count_nf_type(OpenAPI_nf_type_SMF, NULL, &found));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_nf_instance_find((char *)"nf-instance-b"));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_nf_instance_find((char *)"nf-instance-c"));
+}
+
+static void sbi_context_test2(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *old = NULL, *new = NULL;
+    bool found;
+
+    /* Registered, deregistered, then registered again with the same ID */
+    old = ogs_sbi_nf_instance_add();
+    ABTS_PTR_NOTNULL(tc, old);
+    ogs_sbi_nf_instance_set_id(old, (char *)"nf-instance-reg");
+    ogs_sbi_nf_instance_set_type(old, OpenAPI_nf_type_PCF);
+    ABTS_PTR_EQUAL(tc, old,
+            ogs_sbi_nf_instance_find((char *)"nf-instance-reg"));
+
+    ogs_sbi_nf_instance_remove(old);
+    ABTS_PTR_EQUAL(tc, NULL,
+            ogs_sbi_nf_instance_find((char *)"nf-instance-reg"));
+    ABTS_INT_EQUAL(tc, 0, count_nf_type(OpenAPI_nf_type_PCF, NULL, &found));
+
+    new = ogs_sbi_nf_instance_add();
+    ABTS_PTR_NOTNULL(tc, new);
+    ogs_sbi_nf_instance_set_id(new, (char *)"nf-instance-reg");
+    ogs_sbi_nf_instance_set_type(new, OpenAPI_nf_type_PCF);
+    ABTS_PTR_EQUAL(tc, new,
+            ogs_sbi_nf_instance_find((char *)"nf-instance-reg"));
+    ABTS_INT_EQUAL(tc, 1, count_nf_type(OpenAPI_nf_type_PCF, new, &found));
+    ABTS_TRUE(tc, found);
+
+    /* Two instances with the same ID : the first one wins until removed */
+    old = ogs_sbi_nf_instance_add();
+    ABTS_PTR_NOTNULL(tc, old);
+    ogs_sbi_nf_instance_set_id(old, (char *)"nf-instance-reg");
+    ogs_sbi_nf_instance_set_type(old, OpenAPI_nf_type_PCF);
+    ABTS_PTR_EQUAL(tc, new,
+            ogs_sbi_nf_instance_find((char *)"nf-instance-reg"));
+
+    ogs_sbi_nf_instance_remove(new);
+    ABTS_PTR_EQUAL(tc, old,
+            ogs_sbi_nf_instance_find((char *)"nf-instance-reg"));
+
+    /* Changing the ID re-indexes the instance */
+    ogs_sbi_nf_instance_set_id(old, (char *)"nf-instance-renamed");
+    ABTS_PTR_EQUAL(tc, NULL,
+            ogs_sbi_nf_instance_find((char *)"nf-instance-reg"));
+    ABTS_PTR_EQUAL(tc, old,
+            ogs_sbi_nf_instance_find((char *)"nf-instance-renamed"));
+
+    ogs_sbi_nf_instance_remove(old);
+    ABTS_INT_EQUAL(tc, 0, count_nf_type(OpenAPI_nf_type_PCF, NULL, &found));
+}
+
+static void sbi_context_test3(abts_case *tc, void *data)
+{
+    ogs_sbi_nf_instance_t *a = NULL, *b = NULL;
+    ogs_sbi_discovery_option_t *option1 = NULL, *option2 = NULL;
+    ogs_sbi_discovery_cache_stat_t stat1, stat2;
+    ogs_s_nssai_t s_nssai1, s_nssai2;
+    OpenAPI_search_result_t SearchResult;
+    OpenAPI_nf_profile_t NFProfile;
+
+    a = add_registered_nf_instance(
+            (char *)"nf-instance-cache-a", OpenAPI_nf_type_SMF);
+    b = add_registered_nf_instance(
+            (char *)"nf-instance-cache-b", OpenAPI_nf_type_UDM);
+
+    s_nssai1.sst = 1;
+    s_nssai1.sd.v = 0x000080;
+    s_nssai2.sst = 2;
+    s_nssai2.sd.v = OGS_S_NSSAI_NO_SD_VALUE;
+
+    /* Same parameters, added in a different order */
+    option1 = discovery_option_for(
+            (char *)OGS_SBI_SERVICE_NAME_NSMF_PDUSESSION,
+            (char *)OGS_SBI_SERVICE_NAME_NSMF_EVENT_EXPOSURE,
+            &s_nssai1, &s_nssai2);
+    option2 = discovery_option_for(
+            (char *)OGS_SBI_SERVICE_NAME_NSMF_EVENT_EXPOSURE,
+            (char *)OGS_SBI_SERVICE_NAME_NSMF_PDUSESSION,
+            &s_nssai2, &s_nssai1);
+
+    memset(&NFProfile, 0, sizeof(NFProfile));
+    NFProfile.nf_instance_id = a->id;
+    NFProfile.nf_type = OpenAPI_nf_type_SMF;
+
+    memset(&SearchResult, 0, sizeof(SearchResult));
+    SearchResult.nf_instances = OpenAPI_list_create();
+    ABTS_PTR_NOTNULL(tc, SearchResult.nf_instances);
+    OpenAPI_list_add(SearchResult.nf_instances, &NFProfile);
+
+    ogs_sbi_discovery_cache_stat(&stat1);
+
+    /* No validityPeriod : nothing is cached */
+    ogs_sbi_discovery_cache_add(OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF,
+            option1, &SearchResult);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option1));
+
+    SearchResult.is_validity_period = true;
+    SearchResult.validity_period = 1;
+    ogs_sbi_discovery_cache_add(OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF,
+            option1, &SearchResult);
+
+    /* Key normalization */
+    ABTS_PTR_EQUAL(tc, a, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option1));
+    ABTS_PTR_EQUAL(tc, a, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option2));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, NULL));
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_SMF, option1));
+
+    ogs_sbi_discovery_cache_stat(&stat2);
+    ABTS_TRUE(tc, stat2.hit == stat1.hit + 2);
+    ABTS_TRUE(tc, stat2.miss == stat1.miss + 3);
+    ABTS_INT_EQUAL(tc, stat1.entries + 1, stat2.entries);
+
+    /* Expiry after validityPeriod */
+    ogs_msleep(1100);
+    ogs_time_invalidate();
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option2));
+
+    ogs_sbi_discovery_cache_stat(&stat1);
+    ABTS_TRUE(tc, stat1.expired == stat2.expired + 1);
+    ABTS_INT_EQUAL(tc, stat2.entries - 1, stat1.entries);
+
+    /* Invalidation by NF type, as on an NRF notification */
+    SearchResult.validity_period = 3600;
+    ogs_sbi_discovery_cache_add(OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF,
+            option1, &SearchResult);
+    ABTS_PTR_EQUAL(tc, a, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option1));
+
+    ogs_sbi_discovery_cache_invalidate(OpenAPI_nf_type_UDM);
+    ABTS_PTR_EQUAL(tc, a, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option1));
+
+    ogs_sbi_discovery_cache_invalidate(OpenAPI_nf_type_SMF);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option1));
+
+    ogs_sbi_discovery_cache_stat(&stat2);
+    ABTS_TRUE(tc, stat2.invalidated == stat1.invalidated + 1);
+    ABTS_INT_EQUAL(tc, stat1.entries, stat2.entries);
+
+    /* NF deregistration : the cached ID no longer resolves */
+    ogs_sbi_discovery_cache_add(OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF,
+            option1, &SearchResult);
+    ABTS_PTR_EQUAL(tc, a, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option1));
+
+    OGS_FSM_TRAN(&a->sm, ogs_sbi_nf_state_de_registered);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option1));
+
+    OGS_FSM_TRAN(&a->sm, ogs_sbi_nf_state_registered);
+    ogs_sbi_discovery_cache_add(OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF,
+            option1, &SearchResult);
+    ogs_sbi_nf_instance_remove(a);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_discovery_cache_find(
+                OpenAPI_nf_type_SMF, OpenAPI_nf_type_AMF, option1));
+
+    ogs_sbi_discovery_cache_stat(&stat1);
+    ABTS_INT_EQUAL(tc, stat2.entries, stat1.entries);
+
+    OpenAPI_list_free(SearchResult.nf_instances);
+    ogs_sbi_discovery_option_free(option1);
+    ogs_sbi_discovery_option_free(option2);
+
+    ogs_sbi_nf_instance_remove(b);
+}
+
+abts_suite *test_sbi_context(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, sbi_context_test1, NULL);
+    abts_run_test(suite, sbi_context_test2, NULL);
+    abts_run_test(suite, sbi_context_test3, NULL);
+
+    return suite;
+}
@@ -1021,6 +1021,393 @@ static void sbi_message_test10(abts_case *tc, void *param)
     }
 }
 
+static void sbi_message_test11(abts_case *tc, void *data)
+{
+    int rv, i;
+    OpenAPI_lnode_t *entry;
+
+    ogs_sbi_message_t message1, message2;
+    ogs_sbi_response_t *response = NULL;
+
+    OpenAPI_search_result_t SearchResult;
+    OpenAPI_nf_profile_t *nf_profile1;
+    OpenAPI_nf_profile_t *nf_profile2;
+
+    /*
+     * Round-trip a SearchResult through build_json()/parse_json().
+     * Build it twice : nothing may be carried over from one encoding
+     * to the next.
+     */
+    for (i = 0; i < 2; i++) {
+        memset(&SearchResult, 0, sizeof(SearchResult));
+        SearchResult.is_validity_period = true;
+        SearchResult.validity_period = 3600;
+        SearchResult.nf_instances = OpenAPI_list_create();
+        ABTS_PTR_NOTNULL(tc, SearchResult.nf_instances);
+
+        nf_profile1 = ogs_calloc(1, sizeof(*nf_profile1));
+        ABTS_PTR_NOTNULL(tc, nf_profile1);
+        nf_profile1->nf_instance_id = "NF_INSTANCE_ID";
+        nf_profile1->nf_type = OpenAPI_nf_type_AUSF;
+        nf_profile1->nf_status = OpenAPI_nf_status_REGISTERED;
+        nf_profile1->is_priority = true;
+        nf_profile1->priority = 10;
+        nf_profile1->is_capacity = true;
+        nf_profile1->capacity = 100;
+        OpenAPI_list_add(SearchResult.nf_instances, nf_profile1);
+
+        memset(&message1, 0, sizeof(message1));
+        message1.SearchResult = &SearchResult;
+
+        response = ogs_sbi_build_response(&message1, OGS_SBI_HTTP_STATUS_OK);
+        ABTS_PTR_NOTNULL(tc, response);
+        ABTS_PTR_NOTNULL(tc, response->http.content);
+
+        OpenAPI_list_free(SearchResult.nf_instances);
+        ogs_free(nf_profile1);
+
+        response->h.method = ogs_strdup(OGS_SBI_HTTP_METHOD_GET);
+        response->h.uri = ogs_strdup("/nnrf-disc/v1/nf-instances");
+
+        rv = ogs_sbi_parse_response(&message2, response);
+        ABTS_INT_EQUAL(tc, OGS_OK, rv);
+        ABTS_PTR_NOTNULL(tc, message2.SearchResult);
+
+        ABTS_TRUE(tc, message2.SearchResult->is_validity_period);
+        ABTS_INT_EQUAL(tc, 3600, message2.SearchResult->validity_period);
+        ABTS_PTR_NOTNULL(tc, message2.SearchResult->nf_instances);
+
+        entry = message2.SearchResult->nf_instances->first;
+        ABTS_PTR_NOTNULL(tc, entry);
+        nf_profile2 = entry->data;
+        ABTS_PTR_NOTNULL(tc, nf_profile2);
+        ABTS_STR_EQUAL(tc, "NF_INSTANCE_ID", nf_profile2->nf_instance_id);
+        ABTS_INT_EQUAL(tc, OpenAPI_nf_type_AUSF, nf_profile2->nf_type);
+        ABTS_INT_EQUAL(tc, 10, nf_profile2->priority);
+        ABTS_INT_EQUAL(tc, 100, nf_profile2->capacity);
+        ABTS_PTR_EQUAL(tc, NULL, entry->next);
+
+        ogs_sbi_message_free(&message2);
+        ogs_sbi_response_free(response);
+    }
+}
+
+static ogs_sbi_request_t *round_trip_request(abts_case *tc,
+        ogs_sbi_message_t *message1, ogs_sbi_message_t *message2)
+{
+    int rv;
+    ogs_sbi_request_t *request = NULL;
+
+    request = ogs_sbi_build_request(message1);
+    ABTS_PTR_NOTNULL(tc, request);
+    ABTS_PTR_NOTNULL(tc, request->http.content);
+
+    rv = ogs_sbi_parse_request(message2, request);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    return request;
+}
+
+static ogs_sbi_response_t *round_trip_response(abts_case *tc,
+        ogs_sbi_message_t *message1, int status,
+        const char *method, const char *uri, ogs_sbi_message_t *message2)
+{
+    int rv;
+    ogs_sbi_response_t *response = NULL;
+
+    response = ogs_sbi_build_response(message1, status);
+    ABTS_PTR_NOTNULL(tc, response);
+    ABTS_PTR_NOTNULL(tc, response->http.content);
+
+    response->h.method = ogs_strdup(method);
+    response->h.uri = ogs_strdup(uri);
+
+    rv = ogs_sbi_parse_response(message2, response);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    return response;
+}
+
+static void sbi_message_test12(abts_case *tc, void *data)
+{
+    ogs_sbi_message_t message1, message2;
+    ogs_sbi_request_t *request = NULL;
+
+    OpenAPI_sm_context_create_data_t SmContextCreateData;
+    OpenAPI_sm_context_update_data_t SmContextUpdateData;
+    OpenAPI_nf_profile_t NFProfile;
+    OpenAPI_snssai_t sNssai;
+    OpenAPI_plmn_id_nid_t plmn_id;
+    OpenAPI_guami_t guami;
+
+    /* SmContextCreateData */
+    memset(&plmn_id, 0, sizeof(plmn_id));
+    plmn_id.mcc = (char *)"999";
+    plmn_id.mnc = (char *)"70";
+
+    memset(&guami, 0, sizeof(guami));
+    guami.plmn_id = &plmn_id;
+    guami.amf_id = (char *)"020040";
+
+    memset(&sNssai, 0, sizeof(sNssai));
+    sNssai.sst = 1;
+    sNssai.sd = (char *)"000080";
+
+    memset(&SmContextCreateData, 0, sizeof(SmContextCreateData));
+    SmContextCreateData.supi = (char *)"imsi-999700000000001";
+    SmContextCreateData.is_pdu_session_id = true;
+    SmContextCreateData.pdu_session_id = 5;
+    SmContextCreateData.dnn = (char *)"internet";
+    SmContextCreateData.s_nssai = &sNssai;
+    SmContextCreateData.serving_nf_id = (char *)"AMF_INSTANCE_ID";
+    SmContextCreateData.guami = &guami;
+    SmContextCreateData.serving_network = &plmn_id;
+    SmContextCreateData.an_type = OpenAPI_access_type_3GPP_ACCESS;
+    SmContextCreateData.rat_type = OpenAPI_rat_type_NR;
+    SmContextCreateData.sm_context_status_uri =
+        (char *)"http://127.0.0.5:7777/namf-callback/v1/imsi/sm-context-status/5";
+
+    memset(&message1, 0, sizeof(message1));
+    message1.h.method = (char *)OGS_SBI_HTTP_METHOD_POST;
+    message1.h.uri = (char *)"/nsmf-pdusession/v1/sm-contexts";
+    message1.SmContextCreateData = &SmContextCreateData;
+
+    request = round_trip_request(tc, &message1, &message2);
+    ABTS_PTR_NOTNULL(tc, message2.SmContextCreateData);
+    ABTS_STR_EQUAL(tc, "imsi-999700000000001",
+            message2.SmContextCreateData->supi);
+    ABTS_TRUE(tc, message2.SmContextCreateData->is_pdu_session_id);
+    ABTS_INT_EQUAL(tc, 5, message2.SmContextCreateData->pdu_session_id);
+    ABTS_STR_EQUAL(tc, "internet", message2.SmContextCreateData->dnn);
+    ABTS_PTR_NOTNULL(tc, message2.SmContextCreateData->s_nssai);
+    ABTS_INT_EQUAL(tc, 1, message2.SmContextCreateData->s_nssai->sst);
+    ABTS_STR_EQUAL(tc, "000080", message2.SmContextCreateData->s_nssai->sd);
+    ABTS_STR_EQUAL(tc, "AMF_INSTANCE_ID",
+            message2.SmContextCreateData->serving_nf_id);
+    ABTS_PTR_NOTNULL(tc, message2.SmContextCreateData->guami);
+    ABTS_STR_EQUAL(tc, "020040",
+            message2.SmContextCreateData->guami->amf_id);
+    ABTS_PTR_NOTNULL(tc, message2.SmContextCreateData->serving_network);
+    ABTS_STR_EQUAL(tc, "999",
+            message2.SmContextCreateData->serving_network->mcc);
+    ABTS_STR_EQUAL(tc, "70",
+            message2.SmContextCreateData->serving_network->mnc);
+    ABTS_INT_EQUAL(tc, OpenAPI_access_type_3GPP_ACCESS,
+            message2.SmContextCreateData->an_type);
+    ABTS_INT_EQUAL(tc, OpenAPI_rat_type_NR,
+            message2.SmContextCreateData->rat_type);
+    ABTS_STR_EQUAL(tc, SmContextCreateData.sm_context_status_uri,
+            message2.SmContextCreateData->sm_context_status_uri);
+    ogs_sbi_message_free(&message2);
+    ogs_sbi_request_free(request);
+
+    /* SmContextUpdateData */
+    memset(&SmContextUpdateData, 0, sizeof(SmContextUpdateData));
+    SmContextUpdateData.pei = (char *)"imeisv-4370816125816151";
+    SmContextUpdateData.an_type = OpenAPI_access_type_3GPP_ACCESS;
+    SmContextUpdateData.up_cnx_state = OpenAPI_up_cnx_state_ACTIVATING;
+
+    memset(&message1, 0, sizeof(message1));
+    message1.h.method = (char *)OGS_SBI_HTTP_METHOD_POST;
+    message1.h.uri = (char *)"/nsmf-pdusession/v1/sm-contexts/1/modify";
+    message1.SmContextUpdateData = &SmContextUpdateData;
+
+    request = round_trip_request(tc, &message1, &message2);
+    ABTS_PTR_NOTNULL(tc, message2.SmContextUpdateData);
+    ABTS_STR_EQUAL(tc, "imeisv-4370816125816151",
+            message2.SmContextUpdateData->pei);
+    ABTS_INT_EQUAL(tc, OpenAPI_access_type_3GPP_ACCESS,
+            message2.SmContextUpdateData->an_type);
+    ABTS_INT_EQUAL(tc, OpenAPI_up_cnx_state_ACTIVATING,
+            message2.SmContextUpdateData->up_cnx_state);
+    ogs_sbi_message_free(&message2);
+    ogs_sbi_request_free(request);
+
+    /* NFProfile */
+    memset(&NFProfile, 0, sizeof(NFProfile));
+    NFProfile.nf_instance_id = (char *)"NF_INSTANCE_ID";
+    NFProfile.nf_type = OpenAPI_nf_type_SMF;
+    NFProfile.nf_status = OpenAPI_nf_status_REGISTERED;
+    NFProfile.is_heart_beat_timer = true;
+    NFProfile.heart_beat_timer = 10;
+    NFProfile.is_load = true;
+    NFProfile.load = 40;
+
+    memset(&message1, 0, sizeof(message1));
+    message1.h.method = (char *)OGS_SBI_HTTP_METHOD_PUT;
+    message1.h.uri = (char *)"/nnrf-nfm/v1/nf-instances/NF_INSTANCE_ID";
+    message1.NFProfile = &NFProfile;
+
+    request = round_trip_request(tc, &message1, &message2);
+    ABTS_PTR_NOTNULL(tc, message2.NFProfile);
+    ABTS_STR_EQUAL(tc, "NF_INSTANCE_ID", message2.NFProfile->nf_instance_id);
+    ABTS_INT_EQUAL(tc, OpenAPI_nf_type_SMF, message2.NFProfile->nf_type);
+    ABTS_INT_EQUAL(tc, OpenAPI_nf_status_REGISTERED,
+            message2.NFProfile->nf_status);
+    ABTS_INT_EQUAL(tc, 10, message2.NFProfile->heart_beat_timer);
+    ABTS_INT_EQUAL(tc, 40, message2.NFProfile->load);
+    ogs_sbi_message_free(&message2);
+    ogs_sbi_request_free(request);
+}
+
+static void sbi_message_test13(abts_case *tc, void *data)
+{
+    ogs_sbi_message_t message1, message2;
+    ogs_sbi_response_t *response = NULL;
+    OpenAPI_lnode_t *entry;
+    OpenAPI_map_t *map = NULL;
+
+    OpenAPI_ue_authentication_ctx_t UeAuthenticationCtx;
+    OpenAPI_ue_authentication_ctx_5g_auth_data_t AV5G_AKA;
+    OpenAPI_links_value_schema_t LinksValueSchemeValue;
+    OpenAPI_map_t *LinksValueScheme = NULL;
+
+    OpenAPI_authentication_info_result_t AuthenticationInfoResult;
+    OpenAPI_authentication_vector_t AuthenticationVector;
+
+    OpenAPI_access_and_mobility_subscription_data_t
+        AccessAndMobilitySubscriptionData;
+    OpenAPI_ambr_rm_t subscribed_ue_ambr;
+
+    /* UeAuthenticationCtx */
+    memset(&AV5G_AKA, 0, sizeof(AV5G_AKA));
+    AV5G_AKA.rand = (char *)"4a0d3ff2eec4b1f9b1a5e2b0d3ff2eec";
+    AV5G_AKA.autn = (char *)"d3ff2eec4a0d80001a5e2b0d3ff2eec4";
+    AV5G_AKA.hxres_star = (char *)"b1f9b1a5e2b0d3ff2eec4a0d3ff2eec4";
+
+    memset(&LinksValueSchemeValue, 0, sizeof(LinksValueSchemeValue));
+    LinksValueSchemeValue.href = (char *)"http://127.0.0.11:7777"
+        "/nausf-auth/v1/ue-authentications/1/5g-aka-confirmation";
+    LinksValueScheme = OpenAPI_map_create(
+            (char *)OGS_SBI_RESOURCE_NAME_5G_AKA, &LinksValueSchemeValue);
+    ABTS_PTR_NOTNULL(tc, LinksValueScheme);
+
+    memset(&UeAuthenticationCtx, 0, sizeof(UeAuthenticationCtx));
+    UeAuthenticationCtx.auth_type = OpenAPI_auth_type_5G_AKA;
+    UeAuthenticationCtx._5g_auth_data = &AV5G_AKA;
+    UeAuthenticationCtx._links = OpenAPI_list_create();
+    ABTS_PTR_NOTNULL(tc, UeAuthenticationCtx._links);
+    OpenAPI_list_add(UeAuthenticationCtx._links, LinksValueScheme);
+
+    memset(&message1, 0, sizeof(message1));
+    message1.http.content_type = (char *)OGS_SBI_CONTENT_3GPPHAL_TYPE;
+    message1.UeAuthenticationCtx = &UeAuthenticationCtx;
+
+    response = round_trip_response(tc,
+            &message1, OGS_SBI_HTTP_STATUS_CREATED,
+            OGS_SBI_HTTP_METHOD_POST, "/nausf-auth/v1/ue-authentications",
+            &message2);
+
+    OpenAPI_list_free(UeAuthenticationCtx._links);
+    OpenAPI_map_free(LinksValueScheme);
+
+    ABTS_PTR_NOTNULL(tc, message2.UeAuthenticationCtx);
+    ABTS_INT_EQUAL(tc, OpenAPI_auth_type_5G_AKA,
+            message2.UeAuthenticationCtx->auth_type);
+    ABTS_PTR_NOTNULL(tc, message2.UeAuthenticationCtx->_5g_auth_data);
+    ABTS_STR_EQUAL(tc, AV5G_AKA.rand,
+            message2.UeAuthenticationCtx->_5g_auth_data->rand);
+    ABTS_STR_EQUAL(tc, AV5G_AKA.autn,
+            message2.UeAuthenticationCtx->_5g_auth_data->autn);
+    ABTS_STR_EQUAL(tc, AV5G_AKA.hxres_star,
+            message2.UeAuthenticationCtx->_5g_auth_data->hxres_star);
+    ABTS_PTR_NOTNULL(tc, message2.UeAuthenticationCtx->_links);
+    entry = message2.UeAuthenticationCtx->_links->first;
+    ABTS_PTR_NOTNULL(tc, entry);
+    map = entry->data;
+    ABTS_PTR_NOTNULL(tc, map);
+    ABTS_STR_EQUAL(tc, OGS_SBI_RESOURCE_NAME_5G_AKA, map->key);
+    ABTS_PTR_NOTNULL(tc, map->value);
+    ABTS_STR_EQUAL(tc, LinksValueSchemeValue.href,
+            ((OpenAPI_links_value_schema_t *)map->value)->href);
+    ogs_sbi_message_free(&message2);
+    ogs_sbi_response_free(response);
+
+    /* AuthenticationInfoResult */
+    memset(&AuthenticationVector, 0, sizeof(AuthenticationVector));
+    AuthenticationVector.av_type = OpenAPI_av_type_5G_HE_AKA;
+    AuthenticationVector.rand = AV5G_AKA.rand;
+    AuthenticationVector.autn = AV5G_AKA.autn;
+    AuthenticationVector.xres_star = (char *)"e2b0d3ff2eec4a0d3ff2eec4b1f9b1a5";
+    AuthenticationVector.kausf =
+        (char *)"0d3ff2eec4b1f9b1a5e2b0d3ff2eec4a"
+                "4a0d3ff2eec4b1f9b1a5e2b0d3ff2eec";
+
+    memset(&AuthenticationInfoResult, 0, sizeof(AuthenticationInfoResult));
+    AuthenticationInfoResult.auth_type = OpenAPI_auth_type_5G_AKA;
+    AuthenticationInfoResult.supi = (char *)"imsi-999700000000001";
+    AuthenticationInfoResult.authentication_vector = &AuthenticationVector;
+
+    memset(&message1, 0, sizeof(message1));
+    message1.AuthenticationInfoResult = &AuthenticationInfoResult;
+
+    response = round_trip_response(tc, &message1, OGS_SBI_HTTP_STATUS_OK,
+            OGS_SBI_HTTP_METHOD_POST, "/nudm-ueau/v1/suci-0-999-70-0-0-0-1"
+            "/security-information/generate-auth-data", &message2);
+    ABTS_PTR_NOTNULL(tc, message2.AuthenticationInfoResult);
+    ABTS_INT_EQUAL(tc, OpenAPI_auth_type_5G_AKA,
+            message2.AuthenticationInfoResult->auth_type);
+    ABTS_STR_EQUAL(tc, "imsi-999700000000001",
+            message2.AuthenticationInfoResult->supi);
+    ABTS_PTR_NOTNULL(tc,
+            message2.AuthenticationInfoResult->authentication_vector);
+    ABTS_INT_EQUAL(tc, OpenAPI_av_type_5G_HE_AKA,
+            message2.AuthenticationInfoResult->authentication_vector->av_type);
+    ABTS_STR_EQUAL(tc, AuthenticationVector.rand,
+            message2.AuthenticationInfoResult->authentication_vector->rand);
+    ABTS_STR_EQUAL(tc, AuthenticationVector.xres_star,
+            message2.AuthenticationInfoResult->
+                authentication_vector->xres_star);
+    ABTS_STR_EQUAL(tc, AuthenticationVector.kausf,
+            message2.AuthenticationInfoResult->authentication_vector->kausf);
+    ogs_sbi_message_free(&message2);
+    ogs_sbi_response_free(response);
+
+    /* AccessAndMobilitySubscriptionData */
+    memset(&subscribed_ue_ambr, 0, sizeof(subscribed_ue_ambr));
+    subscribed_ue_ambr.uplink = (char *)"1 Gbps";
+    subscribed_ue_ambr.downlink = (char *)"2 Gbps";
+
+    memset(&AccessAndMobilitySubscriptionData, 0,
+            sizeof(AccessAndMobilitySubscriptionData));
+    AccessAndMobilitySubscriptionData.gpsis = OpenAPI_list_create();
+    ABTS_PTR_NOTNULL(tc, AccessAndMobilitySubscriptionData.gpsis);
+    OpenAPI_list_add(AccessAndMobilitySubscriptionData.gpsis,
+            (char *)"msisdn-0900000000");
+    AccessAndMobilitySubscriptionData.subscribed_ue_ambr =
+        &subscribed_ue_ambr;
+    AccessAndMobilitySubscriptionData.is_rfsp_index = true;
+    AccessAndMobilitySubscriptionData.rfsp_index = 7;
+
+    memset(&message1, 0, sizeof(message1));
+    message1.AccessAndMobilitySubscriptionData =
+        &AccessAndMobilitySubscriptionData;
+
+    response = round_trip_response(tc, &message1, OGS_SBI_HTTP_STATUS_OK,
+            OGS_SBI_HTTP_METHOD_GET,
+            "/nudm-sdm/v2/imsi-999700000000001/am-data", &message2);
+
+    OpenAPI_list_free(AccessAndMobilitySubscriptionData.gpsis);
+
+    ABTS_PTR_NOTNULL(tc, message2.AccessAndMobilitySubscriptionData);
+    ABTS_PTR_NOTNULL(tc, message2.AccessAndMobilitySubscriptionData->gpsis);
+    entry = message2.AccessAndMobilitySubscriptionData->gpsis->first;
+    ABTS_PTR_NOTNULL(tc, entry);
+    ABTS_STR_EQUAL(tc, "msisdn-0900000000", entry->data);
+    ABTS_PTR_EQUAL(tc, NULL, entry->next);
+    ABTS_PTR_NOTNULL(tc,
+            message2.AccessAndMobilitySubscriptionData->subscribed_ue_ambr);
+    ABTS_STR_EQUAL(tc, "1 Gbps", message2.AccessAndMobilitySubscriptionData->
+            subscribed_ue_ambr->uplink);
+    ABTS_STR_EQUAL(tc, "2 Gbps", message2.AccessAndMobilitySubscriptionData->
+            subscribed_ue_ambr->downlink);
+    ABTS_TRUE(tc, message2.AccessAndMobilitySubscriptionData->is_rfsp_index);
+    ABTS_INT_EQUAL(tc, 7,
+            message2.AccessAndMobilitySubscriptionData->rfsp_index);
+    ogs_sbi_message_free(&message2);
+    ogs_sbi_response_free(response);
+}
+
 abts_suite *test_sbi_message(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -1035,6 +1422,9 @@ abts_suite *test_sbi_message(abts_suite *suite)
     abts_run_test(suite, sbi_message_test8, NULL);
     abts_run_test(suite, sbi_message_test9, NULL);
     abts_run_test(suite, sbi_message_test10, NULL);
+    abts_run_test(suite, sbi_message_test11, NULL);
+    abts_run_test(suite, sbi_message_test12, NULL);
+    abts_run_test(suite, sbi_message_test13, NULL);
 
     return suite;
 }
@@ -184,26 +184,32 @@ static void security_test5(abts_case *tc, void *data)
     uint8_t ck[16];
     uint8_t plain[SECURITY_TEST5_LEN];
     uint8_t tmp[SECURITY_TEST5_LEN];
+    uint8_t odd[SECURITY_TEST5_LEN];
+    SNOW_CTX ctx;
     ogs_pkbuf_t *pkbuf = NULL;
 
-#if 0 /* Issue #2581 : snow_3g_f8 have memory problem */
     snow_3g_f8(
         ogs_hex_from_string(_ck, ck, sizeof(ck)),
         0x72a4f20f, 0x0c, 1,
         ogs_hex_from_string(_plain, plain, sizeof(plain)),
         SECURITY_TEST5_BIT_LEN);
-#else
-    SNOW_CTX ctx;
-
-    ogs_hex_from_string(_plain, plain, sizeof(plain));
-    SNOW_init(0x72a4f20f, 0x0c, 1,
-        ogs_hex_from_string(_ck, ck, sizeof(ck)), &ctx);
-    SNOW(SECURITY_TEST5_LEN, plain, plain, &ctx);
-#endif
     ABTS_TRUE(tc, memcmp(plain, 
         ogs_hex_from_string(_cipher, tmp, sizeof(tmp)),
         SECURITY_TEST5_LEN) == 0);
 
+    /*
+     * Issue #2581 : length not a multiple of 32 bits.
+     * snow_3g_f8() must agree with the byte-oriented SNOW()
+     * and must not touch data beyond the last byte.
+     */
+    ogs_hex_from_string(_plain, odd, sizeof(odd));
+    snow_3g_f8(ck, 0x72a4f20f, 0x0c, 1, odd, (SECURITY_TEST5_LEN-1) * 8);
+    ogs_hex_from_string(_plain, tmp, sizeof(tmp));
+    SNOW_init(0x72a4f20f, 0x0c, 1, (const char *)ck, &ctx);
+    SNOW(SECURITY_TEST5_LEN-1, tmp, tmp, &ctx);
+    ABTS_TRUE(tc, memcmp(odd, tmp, SECURITY_TEST5_LEN-1) == 0);
+    ABTS_INT_EQUAL(tc, tmp[SECURITY_TEST5_LEN-1], odd[SECURITY_TEST5_LEN-1]);
+
     pkbuf = ogs_pkbuf_alloc(NULL, OGS_NAS_HEADROOM+SECURITY_TEST5_LEN);
     ogs_assert(pkbuf);
     ogs_pkbuf_reserve(pkbuf, OGS_NAS_HEADROOM);
@@ -407,6 +413,103 @@ static void security_test9(abts_case *tc, void *data)
     ogs_pkbuf_free(pkbuf);
 }
 
+static void security_test10(abts_case *tc, void *data)
+{
+    /* 128-EIA2/128-EEA2 with the key schedule cached across messages */
+    const char *_k1 = "2bd6459f 82c440e0 952c4910 4805ff48";
+    const char *_k2 = "d3c5d592 327fb11c 4035c668 0af8c6d1";
+    const char *_plain = "7ec61272 743bf161 4726446a 6c38ced1"
+        "66f6ca76 eb543004 4286346c ef130f92 922b0345";
+    uint8_t k1[16], k2[16], plain[36];
+    uint8_t mac[4], expected[4];
+    ogs_nas_security_cache_t cache;
+    ogs_pkbuf_t *pkbuf = NULL, *expected_pkbuf = NULL;
+    int i;
+
+    ogs_hex_from_string(_k1, k1, sizeof(k1));
+    ogs_hex_from_string(_k2, k2, sizeof(k2));
+    ogs_hex_from_string(_plain, plain, sizeof(plain));
+
+    memset(&cache, 0, sizeof(cache));
+
+    for (i = 0; i < 4; i++) {
+        /* Switch the key half-way to force a refresh of the cache */
+        uint8_t *key = i < 2 ? k1 : k2;
+
+        pkbuf = ogs_pkbuf_alloc(NULL, OGS_NAS_HEADROOM+sizeof(plain));
+        ogs_assert(pkbuf);
+        ogs_pkbuf_reserve(pkbuf, OGS_NAS_HEADROOM);
+        ogs_pkbuf_put_data(pkbuf, plain, sizeof(plain));
+
+        expected_pkbuf = ogs_pkbuf_copy(pkbuf);
+        ogs_assert(expected_pkbuf);
+
+        ogs_nas_mac_calculate_with_cache(&cache,
+                OGS_NAS_SECURITY_ALGORITHMS_128_EIA2,
+                key, i, 0x1a, 1, pkbuf, mac);
+        ogs_nas_mac_calculate(OGS_NAS_SECURITY_ALGORITHMS_128_EIA2,
+                key, i, 0x1a, 1, expected_pkbuf, expected);
+        ABTS_TRUE(tc, memcmp(mac, expected, 4) == 0);
+
+        ogs_nas_encrypt_with_cache(&cache,
+                OGS_NAS_SECURITY_ALGORITHMS_128_EEA2,
+                key, i, 0x0c, 1, pkbuf);
+        ogs_nas_encrypt(OGS_NAS_SECURITY_ALGORITHMS_128_EEA2,
+                key, i, 0x0c, 1, expected_pkbuf);
+        ABTS_INT_EQUAL(tc, expected_pkbuf->len, pkbuf->len);
+        ABTS_TRUE(tc,
+                memcmp(pkbuf->data, expected_pkbuf->data, pkbuf->len) == 0);
+
+        ogs_pkbuf_free(expected_pkbuf);
+        ogs_pkbuf_free(pkbuf);
+    }
+
+    ogs_nas_security_cache_clear(&cache);
+    ABTS_INT_EQUAL(tc, 0, cache.int_ready);
+    ABTS_INT_EQUAL(tc, 0, cache.enc_ready);
+}
+
+static void security_test11(abts_case *tc, void *data)
+{
+    /* 128-EIA2 over a NAS PDU without headroom, which is left untouched */
+    const char *_ik = "d3c5d592 327fb11c 4035c668 0af8c6d1";
+    uint8_t ik[16];
+    uint8_t message[48];
+    uint8_t m[8+sizeof(message)];
+    uint8_t mact[16];
+    uint8_t mac[4];
+    uint32_t count = 0x398a59b4;
+    uint32_t count_be = htonl(count);
+    ogs_pkbuf_t *pkbuf = NULL;
+    int i, len;
+
+    ogs_hex_from_string(_ik, ik, sizeof(ik));
+    for (i = 0; i < sizeof(message); i++)
+        message[i] = i * 7 + 1;
+
+    for (len = 1; len <= sizeof(message); len++) {
+        memset(m, 0, 8);
+        memcpy(m, &count_be, sizeof(count_be));
+        m[4] = ((0x1a << 3) | (1 << 2));
+        memcpy(m+8, message, len);
+
+        ogs_aes_cmac_calculate(mact, ik, m, 8+len);
+
+        pkbuf = ogs_pkbuf_alloc(NULL, len);
+        ogs_assert(pkbuf);
+        ogs_pkbuf_put_data(pkbuf, message, len);
+
+        ogs_nas_mac_calculate(OGS_NAS_SECURITY_ALGORITHMS_128_EIA2,
+                ik, count, 0x1a, 1, pkbuf, mac);
+        ABTS_TRUE(tc, memcmp(mac, mact, 4) == 0);
+
+        ABTS_INT_EQUAL(tc, len, pkbuf->len);
+        ABTS_TRUE(tc, memcmp(pkbuf->data, message, len) == 0);
+
+        ogs_pkbuf_free(pkbuf);
+    }
+}
+
 abts_suite *test_security(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -420,6 +523,8 @@ abts_suite *test_security(abts_suite *suite)
     abts_run_test(suite, security_test7, NULL);
     abts_run_test(suite, security_test8, NULL);
     abts_run_test(suite, security_test9, NULL);
+    abts_run_test(suite, security_test10, NULL);
+    abts_run_test(suite, security_test11, NULL);
 
     return suite;
 }